@@ -16,6 +16,19 @@
 // 12.06.2022: Updated Charge Current logic - 1) Start conditions are charging state and fan speed; 2) Display kW for 15sec and revert to SOC
 // 12.31.2022: Fix charge current functions Fix regen power and motor power Fix Glide and drive add code All in leaf.cpp
 // 15.09.2023: When using esp32 u3 and version 3 chips change Using ESP32 (SJA1000) Internal Bus Controller - Initialization speed to 1000E instead of 500E
+// 10.16.2026: Bridge task pinned to core 1, web/OTA housekeeping task on core 0
+// 10.16.2026: Event log of the bridge task printed by the housekeeping task
+// 10.16.2026: Frame scheduler for synthesized inverter messages advanced on the timer tick
+// 10.16.2026: RX->TX latency histograms on /latency and the websocket ("latency", "latency reset")
+// 10.16.2026: Per-ID bus statistics on /busstats (JSON, "?format=bin" for the binary snapshot)
+// 10.16.2026: Torque/regen maps edited on /torquemap.html, served and stored through /torquemap (NVS)
+// 10.16.2026: /settings parsed in place by settings_parser.cpp (keys in any order, errors reported), same
+//             commands on the websocket ("set", "get", "latency")
+// 10.16.2026: Settings and torque maps in one CRC protected NVS blob (config_store.h), read once at boot and
+//             written once per change burst by the housekeeping task
+// 10.16.2026: OTA selections published as one live_config.h snapshot, the bridge task reads it lock-free
+// 10.16.2026: Binary live telemetry on the websocket ("telemetry <hz>"), sent by the housekeeping task
+// 10.16.2026: CAN sniffer on the websocket ("sniff ids=...;bus=...;every=..."), batches sent by the housekeeping task
 //——————————————————————————————————————————————————————————————————————————————
 
 //——————————————————————————————————————————————————————————————————————————————
@@ -46,16 +59,23 @@
 #include <AsyncElegantOTA.h>
 #include "SPIFFS.h"
 #include "helper_functions.h"
+#include "diagnostics.h"
+#include "bus_stats.h"
+#include "task_monitor.h"
+#include "event_log.h"
+#include "frame_scheduler.h"
+#include "torque_map.h"
+#include "settings_parser.h"
+#include "config_store.h"
+#include "telemetry.h"
+#include "can_sniffer.h"
 
 #include <Preferences.h>
 Preferences prefs;
 void PREF_Init(void);
-uint8_t Vehicle_Selection;
-uint8_t Inverter_Upgrade_110Kw_160Kw;
-uint8_t Battery_Selection;
-uint8_t Battery_Saver;
-uint8_t Glide_In_Drive;
-uint8_t Current_Control;
+void PREF_Save(void);
+bool Set_Torque_Map(const char * text);
+static const char * const tmap_pref_keys[TMAP_COUNT] = {"TMapPower", "TMapRegen"};   //version 0 keys
 
 //——————————————————————————————————————————————————————————————————————————————
 // Web Socket Prototypes
@@ -63,6 +83,13 @@ uint8_t Current_Control;
 void initWebSocket();
 void onEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType type,
              void *arg, uint8_t *data, size_t len);
+void handleWebSocketMessage(AsyncWebSocketClient *client, void *arg, uint8_t *data, size_t len);
+void wsCommandLatency(AsyncWebSocketClient *client, const char *args, size_t len);
+void wsCommandSet(AsyncWebSocketClient *client, const char *args, size_t len);
+void wsCommandGet(AsyncWebSocketClient *client, const char *args, size_t len);
+void wsCommandTelemetry(AsyncWebSocketClient *client, const char *args, size_t len);
+void wsCommandSniff(AsyncWebSocketClient *client, const char *args, size_t len);
+telem_send_result_t wsTelemetrySend(uint32_t client_id, const uint8_t *data, size_t len);
 void notifyClients(String type);
 String GetConfigValue(String type);
 
@@ -70,7 +97,6 @@ String GetConfigValue(String type);
 // LED Indicator
 //——————————————————————————————————————————————————————————————————————————————
 #define LED_BUILTIN 2
-#define INTERVAL_1SEC     (1000000 / T_POLLING)
 uint32_t counter_1sec = 0;
 
 //——————————————————————————————————————————————————————————————————————————————
@@ -80,10 +106,28 @@ hw_timer_t * timer = NULL;
 portMUX_TYPE timerMux = portMUX_INITIALIZER_UNLOCKED;
 volatile uint32_t timerOsTick = 0;
 
+//——————————————————————————————————————————————————————————————————————————————
+// Tasks
+//——————————————————————————————————————————————————————————————————————————————
+TaskHandle_t bridgeTaskHandle = NULL;
+TaskHandle_t housekeepingTaskHandle = NULL;
+void BridgeTask(void * parameter);
+void HousekeepingTask(void * parameter);
+
 void IRAM_ATTR onTimer(){
+  BaseType_t taskWoken = pdFALSE;
+
   portENTER_CRITICAL_ISR(&timerMux);
   timerOsTick++;   // Increment the counter and set the time of ISR
   portEXIT_CRITICAL_ISR(&timerMux);  
+
+  // Wake the bridge task for its polling tick
+  if(NULL != bridgeTaskHandle) {
+    vTaskNotifyGiveFromISR(bridgeTaskHandle, &taskWoken);
+    if(pdFALSE != taskWoken) {
+      portYIELD_FROM_ISR();
+    }
+  }
 }  
 
 void initTimer(void) {
@@ -168,17 +212,85 @@ void setup () {
   [](AsyncWebServerRequest * request) {
     if (request->hasParam("body", true)) {
       AsyncWebParameter* p = request->getParam("body", true);
+      char reply[SETP_ERROR_SIZE + 8];
       Serial.println(p->value().c_str());
-      request->send(200, "text/plain", "OK");
 
-      //Call routine to process the new web request
-      WebRequestProcessing( p->value().c_str() );
+      //Call routine to process the new web request, reply "OK" or the first unknown/invalid key
+      WebRequestProcessing(p->value().c_str(), p->value().length(), reply, sizeof(reply));
+      request->send(200, "text/plain", reply);
     }
     else{
       request->send(200, "text/plain", "Fail");
       }
   });
 
+  //Bridge diagnostics (JSON), "/diag?reset=1" clears the histograms after reading
+  server.on("/diag", HTTP_GET, [](AsyncWebServerRequest * request)
+  {
+    static char diag_json[DIAG_JSON_SIZE];
+    DIAG_BuildJson(diag_json, sizeof(diag_json));
+    if (request->hasParam("reset")) {
+      DIAG_Reset();
+    }
+    request->send(200, "application/json", diag_json);
+  });
+
+  //RX->TX latency histograms with buckets (JSON), "/latency?reset=1" clears them after reading
+  server.on("/latency", HTTP_GET, [](AsyncWebServerRequest * request)
+  {
+    static char latency_json[DIAG_LATENCY_JSON_SIZE];
+    DIAG_BuildLatencyJson(latency_json, sizeof(latency_json));
+    if (request->hasParam("reset")) {
+      DIAG_ResetLatency();
+    }
+    request->send(200, "application/json", latency_json);
+  });
+
+  //Per-ID statistics of the received traffic, streamed (up to BUS_STATS_MAX_IDS IDs per channel)
+  server.on("/busstats", HTTP_GET, [](AsyncWebServerRequest * request)
+  {
+    bool binary = request->hasParam("format") && (request->getParam("format")->value() == "bin");
+    AsyncResponseStream * response = request->beginResponseStream(binary ? "application/octet-stream" : "application/json");
+    if (binary) {
+      BUSSTAT_WriteBinary(*response);
+    }
+    else {
+      BUSSTAT_WriteJson(*response);
+    }
+    request->send(response);
+  });
+
+  //CAN sniffer page, the frames come over the websocket ("sniff")
+  server.on("/sniffer.html", HTTP_GET, [](AsyncWebServerRequest * request)
+  {
+    request->send(SPIFFS, "/sniffer.html", String(), false);
+  });
+
+  //Torque/regen maps in the text form of torque_map.h: GET "/torquemap?map=regen" (default power),
+  //POST "map=power;x=...;y=...;v=..." or "map=power;off" as text/plain
+  server.on("/torquemap.html", HTTP_GET, [](AsyncWebServerRequest * request)
+  {
+    request->send(SPIFFS, "/torquemap.html", String(), false);
+  });
+
+  server.on("/torquemap", HTTP_GET, [](AsyncWebServerRequest * request)
+  {
+    char text[TMAP_TEXT_SIZE];
+    uint8_t map = (request->hasParam("map") && (request->getParam("map")->value() == TMAP_Name(TMAP_REGEN))) ? TMAP_REGEN : TMAP_POWER;
+    TMAP_Format(map, text, sizeof(text));
+    request->send(200, "text/plain", text);
+  });
+
+  server.on("/torquemap", HTTP_POST, [](AsyncWebServerRequest * request)
+  {
+    if (request->hasParam("body", true) && Set_Torque_Map(request->getParam("body", true)->value().c_str())) {
+      request->send(200, "text/plain", "OK");
+    }
+    else {
+      request->send(200, "text/plain", "Fail");
+    }
+  });
+
   server.serveStatic("/static/", SPIFFS, "/static/");
   server.onNotFound(notFound);
   AsyncElegantOTA.begin(&server);
@@ -186,81 +298,239 @@ void setup () {
   Serial.println("[Server] [HTTP] OK");
 
   LEAF_CAN_Bridge_Manager_Init();
+
+  //--- Start the tasks: bridge pipeline on core 1, web/OTA housekeeping on core 0 (next to WiFi)
+  xTaskCreatePinnedToCore(BridgeTask, "bridge", BRIDGE_TASK_STACK_SIZE, NULL,
+                          BRIDGE_TASK_PRIORITY, &bridgeTaskHandle, BRIDGE_TASK_CORE);
+  xTaskCreatePinnedToCore(HousekeepingTask, "housekeeping", HOUSEKEEPING_TASK_STACK_SIZE, NULL,
+                          HOUSEKEEPING_TASK_PRIORITY, &housekeepingTaskHandle, HOUSEKEEPING_TASK_CORE);
+  TASKMON_Register(TASK_ID_BRIDGE, "bridge", bridgeTaskHandle, BRIDGE_TASK_CORE, BRIDGE_TASK_PRIORITY);
+  TASKMON_Register(TASK_ID_HOUSEKEEPING, "housekeeping", housekeepingTaskHandle, HOUSEKEEPING_TASK_CORE, HOUSEKEEPING_TASK_PRIORITY);
+  #ifdef CAN_CH2_ENABLED
+  CAN2_SetRxNotifyTask(bridgeTaskHandle);
+  #endif //CAN_CH2_ENABLED
 }
 
 //——————————————————————————————————————————————————————————————————————————————
 // Main Loop (never ending loop)
 //——————————————————————————————————————————————————————————————————————————————
+// All work is done by BridgeTask and HousekeepingTask, the Arduino loop task is not needed.
 void loop () {
-  //---------------------------------------------------------------------------------
-  // HIGH PRIORITY TASK (CONSIDERED REAL TIME, BASED ON CAN ISR)
-  //---------------------------------------------------------------------------------
-  // Important: CAN Reception Interrupt is handled by ACAN2515 library
-  // Checking the available messages received at maximum speed (or unconditional) is ok.
-  // The control is done by the library (available(), receive() methods)
-  // The good thing is the ACAN2515 receive buffer size is 32, therefore it is less likely to have receive overflow
-  // ToDo: If needed, we can increase the buffer size higher than 32  
-  //#if defined(CAN_BRIDGE_FOR_LEAF)
-    if( NISSAN_LEAF_CONFIG() )
-    {
-		LEAF_CAN_Bridge_Manager();
-    }
-    //else if( NISSAN_ENV200() )
-    {
-		//ENV200_CAN_Bridge_Manager();
- //   }
-//	else
-//	{
-		//Not valid vehicle configuration
-	}
-  //#else
-    //#error "Invalid vehicle or target vehicle is not defined!"
-  //#endif
-
-  //---------------------------------------------------------------------------------
-  // LOW PRIORITY TASK (POLLING)
-  //---------------------------------------------------------------------------------
-  // This is only used for transmission buffer management and other tasks.
-  // Refer T_POLLING for the actual frequency (refer config.h)
-  // timerOsTick becomes 1 when 10ms has elapsed. In case of drifting (value > 1), normalize the counter by resetting to 0.
-  if(timerOsTick > 0U) {  
-     
-    timerOsTick = 0U;
+  vTaskDelete(NULL);
+}
 
-    // Timing for Application Tx Buffer handling
-    Schedule_Buffer_Check_CAN(); 
-    
-    //LED indicator every 1 sec
-    counter_1sec++;
-    if(counter_1sec > INTERVAL_1SEC) {
-       counter_1sec = 0;
+//——————————————————————————————————————————————————————————————————————————————
+// Bridge Task (core 1, high priority)
+//——————————————————————————————————————————————————————————————————————————————
+void BridgeTask(void * parameter) {
+  uint32_t passStart;
+
+  for(;;) {
+    // Sleep until the T_POLLING timer or the CAN2 ISR gives a notification.
+    // MCP2515 frames are picked up on the next timer tick (T_POLLING).
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    passStart = TASKMON_PassBegin();
+
+    // Pass boundary: no config snapshot of the previous pass is held any more
+    LCFG_Quiescent();
+
+    //---------------------------------------------------------------------------------
+    // HIGH PRIORITY TASK (CONSIDERED REAL TIME, BASED ON CAN ISR)
+    //---------------------------------------------------------------------------------
+    // Important: CAN Reception Interrupt is handled by ACAN2515 library
+    // Checking the available messages received at maximum speed (or unconditional) is ok.
+    // The control is done by the library (available(), receive() methods)
+    // The good thing is the ACAN2515 receive buffer size is 32, therefore it is less likely to have receive overflow
+    // ToDo: If needed, we can increase the buffer size higher than 32  
+    //#if defined(CAN_BRIDGE_FOR_LEAF)
+      if( NISSAN_LEAF_CONFIG_IN(LCFG_Get()) )
+      {
+  		LEAF_CAN_Bridge_Manager();
+      }
+      //else if( NISSAN_ENV200() )
+      {
+  		//ENV200_CAN_Bridge_Manager();
+   //   }
+  //	else
+  //	{
+  		//Not valid vehicle configuration
+  	}
+    //#else
+      //#error "Invalid vehicle or target vehicle is not defined!"
+    //#endif
+
+    //---------------------------------------------------------------------------------
+    // LOW PRIORITY TASK (POLLING)
+    //---------------------------------------------------------------------------------
+    // This is only used for transmission buffer management and other tasks.
+    // Refer T_POLLING for the actual frequency (refer config.h)
+    // timerOsTick becomes 1 when 10ms has elapsed. In case of drifting (value > 1), normalize the counter by resetting to 0.
+    if(timerOsTick > 0U) {  
+       
+      timerOsTick = 0U;
+
+      // Synthesized periodic frames due by now are queued before the buffers are drained
+      SCHED_Tick(micros());
+
+      // Timing for Application Tx Buffer handling
+      Schedule_Buffer_Check_CAN(); 
+      
+      //Every 1 sec
+      counter_1sec++;
+      if(counter_1sec > INTERVAL_1SEC) {
+         counter_1sec = 0;
+
+         TIMER_Count();  
 
-       digitalWrite (LED_BUILTIN, !digitalRead (LED_BUILTIN));
+         //MCP2515 overflow flags and driver queue peak (SPI access, kept on the core that owns the CAN controllers)
+         CAN_Rx_Monitor();
+      }    
+    }
 
-       TIMER_Count();  
-    }    
+    TASKMON_PassEnd(TASK_ID_BRIDGE, passStart);
   }
-  AsyncElegantOTA.loop();  
-  ws.cleanupClients(); 
 }
 
 //——————————————————————————————————————————————————————————————————————————————
+// Housekeeping Task (core 0, low priority)
+//——————————————————————————————————————————————————————————————————————————————
+// Web requests and websocket events arrive on the AsyncTCP task (core 0). Settings reach BridgeTask
+// (core 1) as one live_config_t snapshot (LCFG_Request/LCFG_Publish, read with LCFG_Get); this task
+// publishes a snapshot queued during the grace period, writes NVS and drains the lock-free buffers.
+void HousekeepingTask(void * parameter) {
+  uint32_t passStart;
+  uint32_t lastSecond = millis();
+
+  for(;;) {
+    passStart = TASKMON_PassBegin();
+
+    AsyncElegantOTA.loop();  
+
+    //Telemetry frames of the subscribed websocket clients that are due (serialized here, not on the CAN core)
+    TELEM_Poll(millis(), wsTelemetrySend);
+
+    //Sniffed frames in batches; a full websocket queue leaves them in the ring and the overflow is reported
+    SNIFF_Poll(millis(), wsTelemetrySend);
+
+    //Settings the web/websocket handlers queued while the previous publish was in its grace period
+    LCFG_PublishPending();
+
+    //Settings changed by the web/websocket handlers: one NVS commit once they are quiet
+    if(CFG_SaveDue(millis())) {
+      PREF_Save();
+    }
+
+    #if defined(EVENT_LOG_ENABLED) && defined(SERIAL_DEBUG_MONITOR)
+    //Format the bridge task records here, at Serial speed, away from the CAN path
+    EVLOG_Drain(Serial, EVENT_LOG_SIZE);
+    #endif //EVENT_LOG_ENABLED && SERIAL_DEBUG_MONITOR
+
+    //LED indicator, websocket cleanup and load report every 1 sec
+    if((millis() - lastSecond) >= 1000U) {
+      lastSecond = millis();
+
+      digitalWrite (LED_BUILTIN, !digitalRead (LED_BUILTIN));
+
+      ws.cleanupClients(); 
+
+      TASKMON_Update();
+    }
+
+    TASKMON_PassEnd(TASK_ID_HOUSEKEEPING, passStart);
+    vTaskDelay(pdMS_TO_TICKS(HOUSEKEEPING_TASK_PERIOD_MS));
+  }
+}
 
 //——————————————————————————————————————————————————————————————————————————————
 // Storage using Preferences
 //——————————————————————————————————————————————————————————————————————————————
+// Version 0: one key per setting (firmware before config_store.h), read once for the conversion
+static bool PREF_LoadKeys(cfg_blob_t * cfg)
+{
+  if(!prefs.isKey("VehSelect")) {
+    return false;
+  }
+  cfg->vehicle          = prefs.getUInt("VehSelect", 0);
+  cfg->inverter         = prefs.getUInt("InvUpgrade", 0);
+  cfg->battery          = prefs.getUInt("BattSelect", 0);
+  cfg->battery_saver    = prefs.getUInt("BattSaver", 0);
+  cfg->glide            = prefs.getUInt("GlideDrive", 0);
+  cfg->current_control  = prefs.getUInt("CurrCont", 0);
+  for(uint8_t map = 0; map < TMAP_COUNT; map++) {
+    if(prefs.isKey(tmap_pref_keys[map]) &&
+       (sizeof(tmap_def_t) != prefs.getBytes(tmap_pref_keys[map], &cfg->maps[map], sizeof(tmap_def_t)))) {
+      memset(&cfg->maps[map], 0, sizeof(tmap_def_t));
+    }
+  }
+  return true;
+}
+
+static void PREF_RemoveKeys(void)
+{
+  static const char * const keys[] = {"VehSelect", "InvUpgrade", "BattSelect", "BattSaver", "GlideDrive", "CurrCont"};
+
+  for(uint8_t i = 0; i < (sizeof(keys) / sizeof(keys[0])); i++) {
+    prefs.remove(keys[i]);
+  }
+  for(uint8_t map = 0; map < TMAP_COUNT; map++) {
+    prefs.remove(tmap_pref_keys[map]);
+  }
+}
+
 void PREF_Init(void)
 {
+  uint8_t stored[CFG_BLOB_MAX];
+  size_t len;
+  cfg_blob_t cfg;
+  live_config_t live;
+  bool keys = false;
+  bool converted = false;
+
   // Open flash reading
   prefs.begin("ESP32", false);  
 
-  // If stored values exist, copy to internal variables; else assign with 0.
-  Vehicle_Selection             = prefs.getUInt("VehSelect", 0);
-  Inverter_Upgrade_110Kw_160Kw  = prefs.getUInt("InvUpgrade", 0);
-  Battery_Selection             = prefs.getUInt("BattSelect", 0);
-  Battery_Saver                 = prefs.getUInt("BattSaver", 0);
-  Glide_In_Drive                = prefs.getUInt("GlideDrive", 0);
-  Current_Control               = prefs.getUInt("CurrCont", 0);
+  // One read of the settings blob; defaults when absent or corrupted
+  len = prefs.getBytes(CFG_PREF_KEY, stored, sizeof(stored));
+  if(!CFG_Load(stored, len, &cfg)) {
+    if(0U != len) {
+      Serial.println("[NVM] settings blob invalid, defaults used");
+    }
+    keys = PREF_LoadKeys(&cfg);
+    converted = keys;
+  }
+  else if(cfg.header.version < CFG_VERSION) {
+    converted = true;   //older layout, rewritten as this version
+  }
+  //A newer layout (firmware downgrade) stays as stored, so its fields survive an upgrade again;
+  //it is only rewritten as this version when a setting is changed
+
+  // Bridge task not started yet: active at once
+  memset(&live, 0, sizeof(live));
+  live.vehicle          = cfg.vehicle;
+  live.inverter         = cfg.inverter;
+  live.battery          = cfg.battery;
+  live.battery_saver    = cfg.battery_saver;
+  live.glide            = cfg.glide;
+  live.current_control  = cfg.current_control;
+  LCFG_Init(&live);
+
+  // Torque/regen maps: absent or invalid maps leave the fixed multipliers in place
+  for(uint8_t map = 0; map < TMAP_COUNT; map++) {
+    if((0U != cfg.maps[map].nx) && !TMAP_Load(map, &cfg.maps[map])) {
+      Serial.printf("[NVM] %s map invalid, ignored\n", TMAP_Name(map));
+    }
+  }
+
+  // Converted layouts are written back at once; the version 0 keys only go once the blob is stored
+  if(converted) {
+    CFG_Seal(&cfg);
+    if(sizeof(cfg) == prefs.putBytes(CFG_PREF_KEY, &cfg, sizeof(cfg))) {
+      if(keys) {
+        PREF_RemoveKeys();
+      }
+      Serial.printf("[NVM] settings converted to version %u\n", (unsigned)CFG_VERSION);
+    }
+  }
 
   // Close the Preferences
   prefs.end();
@@ -268,22 +538,53 @@ void PREF_Init(void)
   #ifdef DEBUG_NVM_PREFERENCE
   Serial.println("\nStored NVM After Reset Values");  
   Serial.println("\n(Stored NVM) Vehicle_Selection = ");
-  Serial.print(Vehicle_Selection);
+  Serial.print(live.vehicle);
   
   Serial.println("\n(Stored NVM) Inverter_Upgrade_110Kw_160Kw = ");
-  Serial.print(Inverter_Upgrade_110Kw_160Kw);
+  Serial.print(live.inverter);
   
   Serial.println("\n(Stored NVM) Battery_Selection = ");
-  Serial.print(Battery_Selection);
+  Serial.print(live.battery);
   
   Serial.println("\n(Stored NVM) Battery_Saver = ");
-  Serial.print(Battery_Saver);
+  Serial.print(live.battery_saver);
   
   Serial.println("\n(Stored NVM) Glide_In_Drive = ");
-  Serial.print(Glide_In_Drive);
+  Serial.print(live.glide);
 
   Serial.println("\n(Stored NVM) Current_Control = ");
-  Serial.print(Current_Control);
+  Serial.print(live.current_control);
+  #endif //#ifdef DEBUG_NVM_PREFERENCE
+}
+
+// Housekeeping task, CFG_SAVE_DELAY_MS after the last change: the whole blob in one NVS commit
+void PREF_Save(void)
+{
+  cfg_blob_t cfg;
+  live_config_t live;
+
+  LCFG_Snapshot(&live);
+  CFG_Defaults(&cfg);
+  cfg.vehicle          = live.vehicle;
+  cfg.inverter         = live.inverter;
+  cfg.battery          = live.battery;
+  cfg.battery_saver    = live.battery_saver;
+  cfg.glide            = live.glide;
+  cfg.current_control  = live.current_control;
+  for(uint8_t map = 0; map < TMAP_COUNT; map++) {
+    TMAP_GetDef(map, &cfg.maps[map]);   //left zeroed (no map) when not active
+  }
+  CFG_Seal(&cfg);
+
+  prefs.begin("ESP32", false);
+  if(sizeof(cfg) != prefs.putBytes(CFG_PREF_KEY, &cfg, sizeof(cfg))) {
+    CFG_MarkDirty(millis());   //retried after the next quiet period
+    Serial.println("[NVM] settings not saved, retrying");
+  }
+  prefs.end();
+
+  #ifdef DEBUG_NVM_PREFERENCE
+  Serial.printf("\n(NVM) Settings saved, %u bytes\n", (unsigned)sizeof(cfg));
   #endif //#ifdef DEBUG_NVM_PREFERENCE
 }
 
@@ -292,7 +593,7 @@ void PREF_Init(void)
 //——————————————————————————————————————————————————————————————————————————————
 // OTA API
 //——————————————————————————————————————————————————————————————————————————————
-void Set_Vehicle_Selection(String setValue)
+void Set_Vehicle_Selection(live_config_t * cfg, uint8_t setValue)
 {
 
   //-----------------------------------------
@@ -315,51 +616,20 @@ void Set_Vehicle_Selection(String setValue)
 
   // Example: 
   // If OTA "Vehicle Selection" option is "Nissan LEAF 2010-2019"
-  // Set_Vehicle_Selection(inputMessage[0]);
+  // Set_Vehicle_Selection(&cfg, inputMessage[0]);
 
-  // Open the preferences
-  prefs.begin("ESP32", false);
-  
-  if(setValue == "LEAF")
-  {
-    Vehicle_Selection = Vehicle_Selection_Nissan_LEAF_2010_2019;
-  } 
-  else if(setValue == "ENV200")
-  {
-    Vehicle_Selection = Vehicle_Selection_Nissan_ENV200;
-  }
-  else if(setValue == "ZE0")
-  {
-    Vehicle_Selection = Vehicle_Selection_ZE0_2011_2012;
-  }
-  else if(setValue == "AZE0")
-  {
-    Vehicle_Selection = Vehicle_Selection_AZE0_2013_2017;
-  }
-  else if(setValue == "ZE1")
-  {
-    Vehicle_Selection = Vehicle_Selection_ZE1_2018_2022;
-  }
-  else
-  { 
-    Vehicle_Selection = Vehicle_Selection_Nissan_LEAF_2010_2019;    
-  }
-
-  //write to flash
-  prefs.putUInt("VehSelect", Vehicle_Selection);
-
-  // Close the Preferences
-  prefs.end();
+  // setValue is a Vehicle_Selection_xxx code, validated by SETP_Parse()
+  cfg->vehicle = setValue;
 
   //debug value
   #ifdef DEBUG_NVM_PREFERENCE
   Serial.println("\n(New NVM) Vehicle_Selection = ");
-  Serial.print(Vehicle_Selection);
+  Serial.print(cfg->vehicle);
   #endif //#ifdef DEBUG_NVM_PREFERENCE
   
 }
 
-void Set_Inverter_Upgrade_110Kw_160Kw(String setValue)
+void Set_Inverter_Upgrade_110Kw_160Kw(live_config_t * cfg, uint8_t setValue)
 {
   //--------------------------------------
   // Input: Radion Button
@@ -377,42 +647,19 @@ void Set_Inverter_Upgrade_110Kw_160Kw(String setValue)
 
   //Ex:
   // If OTA "Inverter Upgrade 110Kw/160Kw" option is "EM57 Motor with 110Kw inverter"
-  // Set_Inverter_Upgrade_110Kw_160Kw(Inverter_Upgrade_EM57_Motor_with_110Kw_inverter);
+  // Set_Inverter_Upgrade_110Kw_160Kw(&cfg, Inverter_Upgrade_EM57_Motor_with_110Kw_inverter);
 
-  // Open the preferences
-  prefs.begin("ESP32", false);
-  
-  if(setValue == "110")
-  {    
-    Inverter_Upgrade_110Kw_160Kw = Inverter_Upgrade_EM57_Motor_with_110Kw_inverter;
-  }
-  else if(setValue == "160")
-  {
-    Inverter_Upgrade_110Kw_160Kw = Inverter_Upgrade_EM57_Motor_with_160Kw_Inverter;
-  }
-  else if(setValue == "0")
-  {
-    Inverter_Upgrade_110Kw_160Kw = Inverter_Upgrade_Disabled;
-  }
-  else
-  {   
-    Inverter_Upgrade_110Kw_160Kw = Inverter_Upgrade_EM57_Motor_with_110Kw_inverter; 
-  }
-
-  //write to flash
-  prefs.putUInt("InvUpgrade", Inverter_Upgrade_110Kw_160Kw);
-  
-  // Close the Preferences
-  prefs.end();
+  // setValue is an Inverter_Upgrade_xxx code, validated by SETP_Parse()
+  cfg->inverter = setValue;
 
   //debug NVM value
   #ifdef DEBUG_NVM_PREFERENCE
   Serial.println("\n(New NVM) Inverter_Upgrade_110Kw_160Kw = ");
-  Serial.print(Inverter_Upgrade_110Kw_160Kw);
+  Serial.print(cfg->inverter);
   #endif //#ifdef DEBUG_NVM_PREFERENCE
 }
 
-void Set_Battery_Selection(String setValue)
+void Set_Battery_Selection(live_config_t * cfg, uint8_t setValue)
 {
   //--------------------------------------
   // Input: Radio Button
@@ -434,50 +681,20 @@ void Set_Battery_Selection(String setValue)
 
   //Ex:
   // If OTA "Battery Selection" option is "24Kwh"
-  // Set_Battery_Selection(Battery_Selection_24Kwh);
+  // Set_Battery_Selection(&cfg, Battery_Selection_24Kwh);
 
-  // Open the preferences
-  prefs.begin("ESP32", false);
   /*
-  if(setValue == "24")
-  {
-    Battery_Selection = Battery_Selection_24Kwh;
-  }
-  else if(setValue == "30")
-  {
-    Battery_Selection = Battery_Selection_30Kw;
-  }
-  else if(setValue == "40")
-  {
-    Battery_Selection = Battery_Selection_40Kwh;
-  }
-  else if(setValue == "62")
-  {  
-    Battery_Selection = Battery_Selection_62Kwh;
-  }
-  else if(setValue == "-1")
-  {  
-    Battery_Selection = Battery_Selection_BruteForce_30KWh_24KWH_LBC;
-  }
-  else
-  {
-    Battery_Selection = Battery_Selection_24Kwh;
-  }
+  cfg->battery = setValue;
 */
-  // write to flash
-  prefs.putUInt("BattSelect", Battery_Selection);
-
-  // Close the Preferences
-  prefs.end();
 
   //debug NVM value
   #ifdef DEBUG_NVM_PREFERENCE
   Serial.println("\n(New NVM) Battery_Selection = ");
-  Serial.print(Battery_Selection);
+  Serial.print(cfg->battery);
   #endif //#ifdef DEBUG_NVM_PREFERENCE
 }
 
-void Set_Battery_Saver(String setValue)
+void Set_Battery_Saver(live_config_t * cfg, uint8_t setValue)
 {
   //--------------------------------------
   // Input: Radio Button
@@ -497,46 +714,20 @@ void Set_Battery_Saver(String setValue)
 
   //Ex:
   //If OTA "BatterySaver" option is "50%"
-  // Set_Battery_Saver(BatterySaver_50percent);
+  // Set_Battery_Saver(&cfg, BatterySaver_50percent);
 
-  // Open the preferences
-  prefs.begin("ESP32", false);
 /*
-  if(setValue == "50")
-  {  
-    Battery_Saver = BatterySaver_50percent;
-  }
-  else if(setValue == "60")
-  {
-    Battery_Saver = BatterySaver_60percent;
-  }
-  else if(setValue == "80")
-  {
-    Battery_Saver = BatterySaver_80percent;
-  }
-  else if(setValue == "0")
-  {   
-    Battery_Saver = BatterySaver_Disabled;
-  }
-  else
-  {  
-    Battery_Saver = BatterySaver_50percent;    
-  }
-
-  //write to flash 
-  prefs.putUInt("BattSaver", Battery_Saver);
+  cfg->battery_saver = setValue;
 */
-  // Close the Preferences
-  prefs.end();
 
   //debug NVM value
   #ifdef DEBUG_NVM_PREFERENCE
   Serial.println("\n(New NVM) Battery_Saver = ");
-  Serial.print(Battery_Saver);
+  Serial.print(cfg->battery_saver);
   #endif //#ifdef DEBUG_NVM_PREFERENCE
 }
 
-void Set_Glide_In_Drive(String setValue)
+void Set_Glide_In_Drive(live_config_t * cfg, uint8_t setValue)
 {
   //--------------------------------------
   // Input: Radion Button
@@ -552,38 +743,20 @@ void Set_Glide_In_Drive(String setValue)
 
   //Ex:
   // If OTA "Glide in Drive" option is "Enabled"
-  // Set_Glide_In_Drive(Glide_In_Drive_Enabled);
+  // Set_Glide_In_Drive(&cfg, Glide_In_Drive_Enabled);
 
-  // Open the preferences
-  prefs.begin("ESP32", false);
   /*
-  if(setValue == "1")
-  {    
-    Glide_In_Drive = Glide_In_Drive_Enabled;
-  }
-  else if(setValue == "0")
-  {
-    Glide_In_Drive = Glide_In_Drive_Disabled;
-  }
-  else
-  {  
-    Glide_In_Drive = Glide_In_Drive_Enabled;
-  } 
-
-  //write to flash 
-  prefs.putUInt("GlideDrive", Glide_In_Drive); 
-
-  // Close the Preferences */
-  prefs.end();
+  cfg->glide = setValue;
+  */
 
   //debug NVM value
   #ifdef DEBUG_NVM_PREFERENCE
   Serial.println("\n(New NVM) Glide_In_Drive = ");
-  Serial.print(Glide_In_Drive);
+  Serial.print(cfg->glide);
   #endif //DEBUG_NVM_PREFERENCE
 }
 
-void Set_Current_Control(String setValue)
+void Set_Current_Control(live_config_t * cfg, uint8_t setValue)
 {
   //--------------------------------------
   // Input: Radion Button
@@ -607,145 +780,107 @@ void Set_Current_Control(String setValue)
 
   //Ex:
   // If OTA "CurrentControl" option is "1.0 KW"
-  // Set_Current_Control(CurrentControl_1p0_kW);
+  // Set_Current_Control(&cfg, CurrentControl_1p0_kW);
 
-  // Open the preferences
-  prefs.begin("ESP32", false);
  /* 
-  if(setValue == "1")
-  {  
-    Current_Control = CurrentControl_1p0_kW;
-  }
-  else if(setValue == "2")
-  {  
-    Current_Control = CurrentControl_2p0_kW;
-  }
-  else if(setValue == "3")
-  {  
-    Current_Control = CurrentControl_3p0_kW;
-  }
-  else if(setValue == "4")
-  {  
-    Current_Control = CurrentControl_4p0_kW;
+  cfg->current_control = setValue;
+*/
+  //debug NVM value
+  #ifdef DEBUG_NVM_PREFERENCE
+  Serial.println("\n(NVM) Current_Control = ");
+  Serial.print(cfg->current_control);
+  #endif //#ifdef DEBUG_NVM_PREFERENCE
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Torque/regen map from the web page: swapped in for the bridge, stored to NVM with the settings
+//——————————————————————————————————————————————————————————————————————————————
+bool Set_Torque_Map(const char * text)
+{
+  tmap_def_t def;
+  int8_t map = TMAP_Parse(text, &def);
+
+  if(map < 0) {
+    return false;
   }
-  else if(setValue == "6")
-  {  
-    Current_Control = CurrentControl_6p0_kW;
+
+  if(0 == def.nx) {
+    TMAP_Unload(map);
+    CFG_MarkDirty(millis());
   }
-  else if(setValue == "-1")
-  {  
-    Current_Control = CurrentControl_Unrestricted_kW;
+  else if(TMAP_Load(map, &def)) {
+    CFG_MarkDirty(millis());
   }
-  else
-  {    
-    Current_Control = CurrentControl_1p0_kW;    
+  else {
+    map = -1; //rejected, or a second change within TMAP_GRACE_MS
   }
 
-  //write to flash 
-  prefs.putUInt("CurrCont", Current_Control);
-
-  // Close the Preferences
-  prefs.end();
-*/
-  //debug NVM value
   #ifdef DEBUG_NVM_PREFERENCE
-  Serial.println("\n(NVM) Current_Control = ");
-  Serial.print(Current_Control);
+  Serial.println("\n(NVM) Torque map = ");
+  Serial.print(text);
   #endif //#ifdef DEBUG_NVM_PREFERENCE
+
+  return (map >= 0);
 }
 
 //——————————————————————————————————————————————————————————————————————————————
 // Web Request Parsing Routine, configuration values evaluation and storage to NVM
 //——————————————————————————————————————————————————————————————————————————————
-void WebRequestProcessing(const String data)
+bool WebRequestProcessing(const char * data, size_t len, char * reply, size_t reply_len)
 {
-  int len1 = data.length();
-  int len2;
-  int y;
-  char ch;
-  String temp1;
-  String temp2[14];  
-  boolean prevAlphaNum = false;
+  setp_result_t settings;
+  live_config_t cfg;
+  bool valid;
 
   #ifdef DEBUG_WEB_PROCESSING
-  Serial.printf("Parse Length: %d\n", len1);   
+  Serial.printf("Parse Length: %u\n", (unsigned)len);
   Serial.println("String to parse: ");
-  Serial.println(data);
+  Serial.write((const uint8_t *)data, len);
   Serial.println("\n");
   #endif //#ifdef DEBUG_WEB_PROCESSING
 
-  //First formatting
-  //Read all alphanumeric, colon(:), hyphen (-) from the web request
-  for(int x=0; x < len1; x++)
-  {
-    //Check each character
-    ch = data.charAt(x);
-    if(isAlphaNumeric(ch) || isDigit(ch) || ch == '-'  || ch == ':' || isWhitespace(ch))
-    {
-      //store is not space; replace space with ',' and store to temp1 buffer
-      if(!isWhitespace(ch))
-      {
-        temp1 += ch;
-      }
-      else
-      {
-        temp1 += ',';
-      }
-    }
-  }
+  //Key/value pairs in any order, parsed in place; unknown keys and invalid values are skipped and reported
+  valid = SETP_Parse(data, len, &settings);
 
   #ifdef DEBUG_WEB_PROCESSING
-  Serial.println("\nParsed String Temp1: ");
-  Serial.print(temp1);
-  #endif //#ifdef DEBUG_WEB_PROCESSING
-  
-  //Second formatting
-  //From temp1 buffer, read the names and values and store to temp2 buffer in an array organization
-  len2 = temp1.length();
-  y = 0; //this is used to jump to next array
-  for(int x=0; x < len2; x++)
+  for(uint8_t key = 0; key < SETP_KEY_COUNT; key++)
   {
-    ch = temp1.charAt(x);
-    if(isAlphaNumeric(ch) || isDigit(ch) || ch == '-' || ch == ':' || ch == ',')
+    if(settings.present & (1U << key))
     {
-      if(isAlphaNumeric(ch) || isDigit(ch) || ch == '-')
-      {
-        temp2[y] += ch;
-        prevAlphaNum = true;        
-      }
-      else if(ch == ':' || ch == ',')
-      {
-        if(prevAlphaNum == true)
-        {
-          prevAlphaNum = false;
-          y++;
-        }
-      }
-      else
-      {;}
+      Serial.printf("\n(NEW WEB CONFIG)%s = %s\n", SETP_KeyName(key), SETP_ValueName(key, settings.value[key]));
     }
   }
-
-  #ifdef DEBUG_WEB_PROCESSING
-  Serial.println("\n");
-  Serial.println("\n(NEW WEB CONFIG)" + temp2[0] + " = " + temp2[1] + "\n");
-  Serial.println("\n(NEW WEB CONFIG)" + temp2[2] + " = " + temp2[3] + "\n");
-  Serial.println("\n(NEW WEB CONFIG)" + temp2[4] + " = " + temp2[5] + "\n");
-  Serial.println("\n(NEW WEB CONFIG)" + temp2[6] + " = " + temp2[7] + "\n");
-  Serial.println("\n(NEW WEB CONFIG)" + temp2[8] + " = " + temp2[9] + "\n");
-  Serial.println("\n(NEW WEB CONFIG)" + temp2[10] + " = " + temp2[11] + "\n");
-  Serial.println("\n(NEW WEB CONFIG)" + temp2[12] + " = " + temp2[13] + "\n");
   #endif //#ifdef DEBUG_WEB_PROCESSING
 
-  //Copy final parsed values to global data and store to NVM
-  Set_Vehicle_Selection(temp2[1]);
-  Set_Inverter_Upgrade_110Kw_160Kw(temp2[3]);
-  Set_Battery_Selection(temp2[5]);
-  Set_Battery_Saver(temp2[7]);
-  Set_Glide_In_Drive(temp2[9]);
-  Set_Current_Control(temp2[13]);
+  //Apply the parsed values to a copy of the live config, keys not sent keep their value
+  LCFG_Snapshot(&cfg);
+  if(settings.present & (1U << SETP_VEHICLE))         { Set_Vehicle_Selection(&cfg, settings.value[SETP_VEHICLE]); }
+  if(settings.present & (1U << SETP_INVERTER))        { Set_Inverter_Upgrade_110Kw_160Kw(&cfg, settings.value[SETP_INVERTER]); }
+  if(settings.present & (1U << SETP_BATTERY))         { Set_Battery_Selection(&cfg, settings.value[SETP_BATTERY]); }
+  if(settings.present & (1U << SETP_BATTERY_SAVER))   { Set_Battery_Saver(&cfg, settings.value[SETP_BATTERY_SAVER]); }
+  if(settings.present & (1U << SETP_GLIDE))           { Set_Glide_In_Drive(&cfg, settings.value[SETP_GLIDE]); }
+  if(settings.present & (1U << SETP_CURRENT_CONTROL)) { Set_Current_Control(&cfg, settings.value[SETP_CURRENT_CONTROL]); }
+
+  //Publish all of it at once, the bridge uses it from its next frame; written to flash by PREF_Save() once quiet.
+  //Never waits on AsyncTCP: still in the grace period of the last publish, it is queued and the housekeeping
+  //task publishes it after the next bridge pass
+  if(0U != settings.present)
+  {
+    (void)LCFG_Request(&cfg);
+    CFG_MarkDirty(millis());
+  }
+
+  if(valid)
+  {
+    snprintf(reply, reply_len, "OK");
+  }
+  else
+  {
+    snprintf(reply, reply_len, "Fail: %s", settings.error);
+  }
 
   //End of Web request processing
+  return valid;
 }
 
 //——————————————————————————————————————————————————————————————————————————————
@@ -778,15 +913,142 @@ void onEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsEventType
       #ifdef DEBUG_WEB_SOCKET
       Serial.printf("WebSocket client #%u disconnected\n", client->id());
       #endif
+      TELEM_Unsubscribe(client->id());
+      SNIFF_Stop(client->id());
       break;
 	  
     case WS_EVT_DATA:
+      handleWebSocketMessage(client, arg, data, len);
+      break;
+
     case WS_EVT_PONG:
     case WS_EVT_ERROR:
       break;
   }
 }
 
+//Websocket commands: "<name> <args>" in a single text frame, replied to the sending client
+typedef void (*ws_command_handler_t)(AsyncWebSocketClient *client, const char *args, size_t len);
+
+typedef struct {
+  const char *         name;
+  ws_command_handler_t handler;
+} ws_command_t;
+
+static const ws_command_t ws_commands[] = {
+  { "latency",   wsCommandLatency },    //"latency" latency report, "latency reset" also clears it
+  { "set",       wsCommandSet },        //"set Vehicle=LEAF;Inverter=110", same keys as /settings
+  { "get",       wsCommandGet },        //current settings in the "set" form
+  { "telemetry", wsCommandTelemetry },  //"telemetry 10" binary frames (telemetry.h) at 10 Hz, "telemetry 0" stops
+  { "sniff",     wsCommandSniff },      //"sniff ids=1D4,500-5FF;bus=0,2;every=4" raw frames (can_sniffer.h), "sniff off" stops
+};
+
+void handleWebSocketMessage(AsyncWebSocketClient *client, void *arg, uint8_t *data, size_t len) {
+  AwsFrameInfo *info = (AwsFrameInfo*)arg;
+  const char *text = (const char *)data;
+  size_t name_len = 0;
+  size_t args = 0;
+
+  if (!info->final || (info->index != 0) || (info->len != len) || (info->opcode != WS_TEXT)) {
+    return;
+  }
+  while ((name_len < len) && (text[name_len] != ' ')) {
+    name_len++;
+  }
+  args = name_len;
+  while ((args < len) && (text[args] == ' ')) {
+    args++;
+  }
+  for (size_t i = 0; i < (sizeof(ws_commands) / sizeof(ws_commands[0])); i++) {
+    if ((strlen(ws_commands[i].name) == name_len) && (0 == memcmp(text, ws_commands[i].name, name_len))) {
+      ws_commands[i].handler(client, text + args, len - args);
+      return;
+    }
+  }
+  client->text("Fail: unknown command");
+}
+
+void wsCommandLatency(AsyncWebSocketClient *client, const char *args, size_t len) {
+  static char latency_json[DIAG_LATENCY_JSON_SIZE];
+
+  DIAG_BuildLatencyJson(latency_json, sizeof(latency_json));
+  if ((len == 5) && (0 == memcmp(args, "reset", 5))) {
+    DIAG_ResetLatency();
+  }
+  client->text(latency_json);
+}
+
+void wsCommandSet(AsyncWebSocketClient *client, const char *args, size_t len) {
+  char reply[SETP_ERROR_SIZE + 8];
+
+  WebRequestProcessing(args, len, reply, sizeof(reply));
+  client->text(reply);
+
+  //Other open pages follow the change
+  notifyClients("Vehicle");
+  notifyClients("Inverter");
+}
+
+void wsCommandGet(AsyncWebSocketClient *client, const char *args, size_t len) {
+  setp_result_t settings;
+  char text[SETP_TEXT_SIZE];
+  live_config_t cfg;
+
+  LCFG_Snapshot(&cfg);
+  memset(&settings, 0, sizeof(settings));
+  settings.value[SETP_VEHICLE] = cfg.vehicle;
+  settings.value[SETP_INVERTER] = cfg.inverter;
+  settings.value[SETP_BATTERY] = cfg.battery;
+  settings.value[SETP_BATTERY_SAVER] = cfg.battery_saver;
+  settings.value[SETP_GLIDE] = cfg.glide;
+  settings.value[SETP_CURRENT_CONTROL] = cfg.current_control;
+  settings.present = (uint8_t)(((1U << SETP_KEY_COUNT) - 1U) & ~(1U << SETP_CAPACITY));
+  SETP_Format(&settings, text, sizeof(text));
+  client->text(text);
+}
+
+void wsCommandTelemetry(AsyncWebSocketClient *client, const char *args, size_t len) {
+  char reply[40];
+  uint32_t rate = 0;
+  size_t i = 0;
+
+  while ((i < len) && isDigit(args[i]) && (rate <= TELEM_MAX_RATE_HZ)) {
+    rate = (rate * 10U) + (uint32_t)(args[i] - '0');
+    i++;
+  }
+  if ((0U == i) || (i != len) || (rate > TELEM_MAX_RATE_HZ)) {
+    snprintf(reply, sizeof(reply), "Fail: rate 0..%u Hz", (unsigned)TELEM_MAX_RATE_HZ);
+    client->text(reply);
+  }
+  else if (!TELEM_Subscribe(client->id(), (uint16_t)rate)) {
+    client->text("Fail: too many telemetry clients");
+  }
+  else {
+    client->text("OK");
+  }
+}
+
+void wsCommandSniff(AsyncWebSocketClient *client, const char *args, size_t len) {
+  char reply[SNIFF_REPLY_SIZE];
+
+  SNIFF_Command(client->id(), args, len, reply, sizeof(reply));
+  client->text(reply);
+}
+
+//Housekeeping task: a full websocket queue skips the period (telemetry) or keeps the batch (sniffer)
+telem_send_result_t wsTelemetrySend(uint32_t client_id, const uint8_t *data, size_t len) {
+  AsyncWebSocketClient *client = ws.client(client_id);
+
+  if ((NULL == client) || (WS_CONNECTED != client->status())) {
+    return TELEM_GONE;
+  }
+  if (!client->canSend()) {
+    return TELEM_BUSY;
+  }
+  client->binary((const char *)data, len);
+  return TELEM_SENT;
+}
+
 void notifyClients(String type) { 
   
   #ifdef DEBUG_WEB_SOCKET
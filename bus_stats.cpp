@@ -0,0 +1,219 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Per-ID bus statistics of the received traffic (served on /busstats)
+// 10.16.2026: Frame count, inter-arrival period and jitter, last payload and last-seen time
+// 10.17.2026: 29-bit frames counted apart instead of folded into the 11-bit table
+//——————————————————————————————————————————————————————————————————————————————
+// A full entry for each of the 2048 IDs on every channel would take ~240KB, so each channel has a
+// byte per 11-bit ID holding the slot (+1) of its entry in a pool of BUS_STATS_MAX_IDS entries,
+// assigned in order of first appearance. An update is one byte load for the slot and the loads
+// and stores of a single entry; IDs arriving after the pool is full are only counted in overflow.
+// The table is indexed by the 11-bit ID: 29-bit frames (none on the LEAF buses) are only counted
+// in extended, masking them would merge unrelated IDs into one entry.
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include "bus_stats.h"
+#include "can_driver.h"
+#include "config.h"
+
+#if (BUS_STATS_MAX_IDS > 255)
+#error "BUS_STATS_MAX_IDS must fit the one byte slot index"
+#endif
+
+typedef struct {
+  uint8_t           slot[BUS_STATS_ID_COUNT];     //0: not seen, else entry index + 1
+  bus_stats_entry_t entry[BUS_STATS_MAX_IDS];
+  volatile uint16_t used;
+  volatile uint32_t overflow;
+  volatile uint32_t extended;
+} bus_stats_channel_t;
+
+static bus_stats_channel_t bus_stats[CAN_CHANNEL_COUNT];
+static uint32_t bus_stats_cycles_per_us = 1;
+
+//——————————————————————————————————————————————————————————————————————————————
+// Initialization
+//——————————————————————————————————————————————————————————————————————————————
+void BUSSTAT_Init(void){
+  memset(bus_stats, 0, sizeof(bus_stats));
+  bus_stats_cycles_per_us = ESP.getCpuFreqMHz();
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Account one received frame (bridge task)
+//——————————————————————————————————————————————————————————————————————————————
+void BUSSTAT_Update(uint8_t can_bus, const can_frame_t &frame){
+  bus_stats_channel_t * ch;
+  bus_stats_entry_t * entry;
+  uint16_t id = (uint16_t)(frame.can_id & CAN_SFF_MASK);
+  uint32_t stamp = (0U != frame.rx_cycles) ? frame.rx_cycles : CAN_RxStamp();
+  uint32_t now_ms = millis();
+  uint8_t slot;
+
+  if(can_bus >= CAN_CHANNEL_COUNT){
+    return;
+  }
+  ch = &bus_stats[can_bus];
+  if(0U != (frame.can_id & CAN_EFF_FLAG)){
+    ch->extended = ch->extended + 1U;
+    return;
+  }
+  slot = ch->slot[id];
+
+  if(0U == slot){
+    //First frame of this ID: take the next free entry
+    if(ch->used >= BUS_STATS_MAX_IDS){
+      ch->overflow = ch->overflow + 1U;
+      return;
+    }
+    entry = &ch->entry[ch->used];
+    memset(entry, 0, sizeof(*entry));
+    entry->can_id        = id;
+    entry->period_min_us = BUS_STATS_NO_PERIOD;
+    ch->used = ch->used + 1U;
+    ch->slot[id] = (uint8_t)ch->used;
+  }else{
+    entry = &ch->entry[slot - 1U];
+  }
+
+  if((entry->count > 0U) && ((now_ms - entry->last_ms) < BUS_STATS_RESTART_MS)){
+    uint32_t period_us = (stamp - entry->last_cycles) / bus_stats_cycles_per_us;
+    uint32_t deviation;
+
+    if(BUS_STATS_NO_PERIOD == entry->period_min_us){
+      entry->period_avg_us = period_us;
+      entry->period_min_us = period_us;
+    }else{
+      entry->period_avg_us = entry->period_avg_us + (((int32_t)(period_us - entry->period_avg_us)) >> 4);
+      if(period_us < entry->period_min_us){
+        entry->period_min_us = period_us;
+      }
+    }
+    if(period_us > entry->period_max_us){
+      entry->period_max_us = period_us;
+    }
+    deviation = (period_us > entry->period_avg_us) ? (period_us - entry->period_avg_us) : (entry->period_avg_us - period_us);
+    entry->jitter_us = entry->jitter_us + (((int32_t)(deviation - entry->jitter_us)) >> 4);
+  }
+
+  entry->last_cycles = stamp;
+  entry->last_ms     = now_ms;
+  entry->count       = entry->count + 1U;
+  entry->can_dlc     = frame.can_dlc;
+  memcpy(entry->data, frame.data, CAN_MAX_DLEN);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Snapshot access (any context)
+//——————————————————————————————————————————————————————————————————————————————
+uint16_t BUSSTAT_Count(uint8_t can_bus){
+  if(can_bus >= CAN_CHANNEL_COUNT){
+    return 0;
+  }
+  return bus_stats[can_bus].used;
+}
+
+bool BUSSTAT_Get(uint8_t can_bus, uint16_t index, bus_stats_record_t * record){
+  const bus_stats_entry_t * entry;
+  bool periodic;
+
+  if(index >= BUSSTAT_Count(can_bus)){
+    return false;
+  }
+  entry = &bus_stats[can_bus].entry[index];
+  periodic = (BUS_STATS_NO_PERIOD != entry->period_min_us);
+
+  record->can_id        = entry->can_id;
+  record->can_dlc       = (entry->can_dlc <= CAN_MAX_DLEN) ? entry->can_dlc : CAN_MAX_DLEN;
+  record->reserved      = 0;
+  record->count         = entry->count;
+  record->age_ms        = millis() - entry->last_ms;
+  record->period_avg_us = periodic ? entry->period_avg_us : 0U;
+  record->period_min_us = periodic ? entry->period_min_us : 0U;
+  record->period_max_us = entry->period_max_us;
+  record->jitter_us     = entry->jitter_us;
+  memcpy(record->data, entry->data, CAN_MAX_DLEN);
+
+  return true;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// JSON snapshot, one line per ID
+//——————————————————————————————————————————————————————————————————————————————
+size_t BUSSTAT_WriteJson(Print &out){
+  bus_stats_record_t record;
+  char line[224];
+  size_t written = 0;
+  uint16_t count;
+  uint16_t i;
+  uint8_t can_bus;
+  uint8_t j;
+  int n;
+
+  written += out.print("{\"now_ms\":");
+  written += out.print((unsigned long)millis());
+  written += out.print(",\"channels\":[");
+  for(can_bus = 0; can_bus < CAN_CHANNEL_COUNT; can_bus++){
+    count = BUSSTAT_Count(can_bus);
+    n = snprintf(line, sizeof(line), "%s{\"ch\":%u,\"overflow\":%lu,\"extended\":%lu,\"ids\":[", (can_bus == 0) ? "" : ",",
+                 can_bus, (unsigned long)bus_stats[can_bus].overflow, (unsigned long)bus_stats[can_bus].extended);
+    written += out.print(line);
+
+    for(i = 0; i < count; i++){
+      if(!BUSSTAT_Get(can_bus, i, &record)){
+        break;
+      }
+      n = snprintf(line, sizeof(line),
+                   "%s\n{\"id\":\"%03X\",\"count\":%lu,\"age_ms\":%lu,\"rate_hz\":%lu,\"avg_us\":%lu,\"min_us\":%lu,\"max_us\":%lu,\"jitter_us\":%lu,\"data\":\"",
+                   (i == 0) ? "" : ",", record.can_id, (unsigned long)record.count, (unsigned long)record.age_ms,
+                   (unsigned long)((record.period_avg_us > 0U) ? (1000000UL / record.period_avg_us) : 0UL),
+                   (unsigned long)record.period_avg_us, (unsigned long)record.period_min_us,
+                   (unsigned long)record.period_max_us, (unsigned long)record.jitter_us);
+      for(j = 0; (j < record.can_dlc) && (n > 0) && ((size_t)n < (sizeof(line) - 3)); j++){
+        n += snprintf(line + n, sizeof(line) - n, "%02X", record.data[j]);
+      }
+      written += out.print(line);
+      written += out.print("\"}");
+    }
+    written += out.print("]}");
+  }
+  written += out.print("]}");
+
+  return written;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Binary snapshot, see bus_stats_header_t / bus_stats_record_t
+//——————————————————————————————————————————————————————————————————————————————
+size_t BUSSTAT_WriteBinary(Print &out){
+  bus_stats_header_t header;
+  bus_stats_record_t record;
+  size_t written = 0;
+  uint16_t count;
+  uint16_t i;
+  uint8_t can_bus;
+
+  for(can_bus = 0; can_bus < CAN_CHANNEL_COUNT; can_bus++){
+    count = BUSSTAT_Count(can_bus);
+
+    header.magic[0]    = BUS_STATS_MAGIC0;
+    header.magic[1]    = BUS_STATS_MAGIC1;
+    header.version     = BUS_STATS_VERSION;
+    header.can_bus     = can_bus;
+    header.ids         = count;
+    header.record_size = sizeof(bus_stats_record_t);
+    header.now_ms      = millis();
+    header.overflow    = bus_stats[can_bus].overflow;
+    header.extended    = bus_stats[can_bus].extended;
+    written += out.write((const uint8_t *)&header, sizeof(header));
+
+    for(i = 0; i < count; i++){
+      if(!BUSSTAT_Get(can_bus, i, &record)){
+        memset(&record, 0, sizeof(record));
+      }
+      written += out.write((const uint8_t *)&record, sizeof(record));
+    }
+  }
+
+  return written;
+}
@@ -0,0 +1,72 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Per-ID bus statistics of the received traffic (served on /busstats)
+// 10.16.2026: Frame count, inter-arrival period and jitter, last payload and last-seen time
+// 10.17.2026: 29-bit frames counted apart instead of folded into the 11-bit table
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef BUS_STATS_H
+#define BUS_STATS_H
+
+#include <Arduino.h>
+#include "canframe.h"
+#include "config.h"
+
+#define BUS_STATS_ID_COUNT      2048      //11-bit identifiers, direct index
+#define BUS_STATS_RESTART_MS    10000U    //longer gaps restart the period measurement (cycle counter wraps after ~17s)
+#define BUS_STATS_NO_PERIOD     0xFFFFFFFFUL
+
+#define BUS_STATS_MAGIC0        'B'
+#define BUS_STATS_MAGIC1        'S'
+#define BUS_STATS_VERSION       2
+
+//One tracked ID. Single writer (the bridge task); readers in other contexts may see a
+//partially updated entry.
+typedef struct {
+  uint32_t count;
+  uint32_t last_cycles;     //ingress timestamp of the last frame (can_frame_t.rx_cycles)
+  uint32_t last_ms;         //millis() of the last frame
+  uint32_t period_avg_us;   //moving average, 1/16 weight per sample
+  uint32_t period_min_us;   //BUS_STATS_NO_PERIOD until two frames were seen
+  uint32_t period_max_us;
+  uint32_t jitter_us;       //moving average of |period - period_avg|, 1/16 weight per sample
+  uint16_t can_id;
+  uint8_t  can_dlc;
+  uint8_t  data[CAN_MAX_DLEN];
+} bus_stats_entry_t;
+
+//Binary snapshot (little endian): per channel one header followed by header.ids records
+typedef struct __attribute__((packed)) {
+  uint8_t  magic[2];        //"BS"
+  uint8_t  version;         //BUS_STATS_VERSION
+  uint8_t  can_bus;
+  uint16_t ids;             //records following this header
+  uint16_t record_size;     //sizeof(bus_stats_record_t)
+  uint32_t now_ms;
+  uint32_t overflow;        //frames of IDs that found the table full
+  uint32_t extended;        //29-bit frames, not in the per-ID table
+} bus_stats_header_t;
+
+typedef struct __attribute__((packed)) {
+  uint16_t can_id;
+  uint8_t  can_dlc;
+  uint8_t  reserved;
+  uint32_t count;
+  uint32_t age_ms;          //time since the last frame
+  uint32_t period_avg_us;   //0 until two frames were seen
+  uint32_t period_min_us;
+  uint32_t period_max_us;
+  uint32_t jitter_us;
+  uint8_t  data[CAN_MAX_DLEN];
+} bus_stats_record_t;
+
+void BUSSTAT_Init(void);
+void BUSSTAT_Update(uint8_t can_bus, const can_frame_t &frame);
+
+uint16_t BUSSTAT_Count(uint8_t can_bus);
+bool BUSSTAT_Get(uint8_t can_bus, uint16_t index, bus_stats_record_t * record);
+
+//Snapshot of all channels, returns the number of bytes written
+size_t BUSSTAT_WriteJson(Print &out);
+size_t BUSSTAT_WriteBinary(Print &out);
+
+#endif //BUS_STATS_H
@@ -16,6 +16,14 @@
 // 12.04.2022: Merging of Inverter Upgrade based on https://github.com/dalathegreat/Nissan-LEAF-Inverter-Upgrade/blob/main/can-bridge-inverter.c
 // 12.06.2022: Updated Charge Current logic - 1) Start conditions are charging state and fan speed; 2) Display kW for 15sec and revert to SOC
 // 12.31.2022: Fix charge current functions Fix regen power and motor power Fix Glide and drive add code 
+// 10.16.2026: Transmit buffers are lock-free SPSC rings with drop/high-water counters
+// 10.16.2026: Transmit buffers are drained in batches until the controller is full (TX_DRAIN_BUDGET_PER_TICK)
+// 10.16.2026: Transmit buffers send in CAN ID priority order, queue wait time histogram per ID class
+// 10.16.2026: Frames passed by reference and copied once, straight into the ring slot
+// 10.16.2026: Per-frame Serial prints replaced by the binary event log
+// 10.16.2026: RX->TX latency histograms per channel and per ID class, from the ingress timestamp
+// 10.16.2026: Per-ID bus statistics initialized with the CAN hardware
+// 10.16.2026: Inbound CRC/counter validation initialized with the CAN hardware
 //——————————————————————————————————————————————————————————————————————————————
 
 #include <Arduino.h>
@@ -23,58 +31,217 @@
 #include "can_driver.h"
 #include "helper_functions.h"
 #include "config.h"
+#include "spsc_ring.h"
+#include "latency_histogram.h"
+#include "event_log.h"
+#include "bus_stats.h"
+#include "checksum.h"
 
 //——————————————————————————————————————————————————————————————————————————————
 // Transmit Buffer Structure
 //——————————————————————————————————————————————————————————————————————————————
 //Because the MCP25625 transmit buffers seem to be able to corrupt messages (see errata), we're implementing
-//our own buffering. This is an array of frames-to-be-sent, FIFO. Messages are appended to buffer_end++ as they
-//come in and handled according to buffer_pos until buffer_pos == buffer_end, at which point both pointers reset
-//the buffer size should be well in excess of what this device will ever see
-static can_frame_t tx0_buffer[TXBUFFER_SIZE];
-static uint8_t		tx0_buffer_pos		= 0;
-static uint8_t		tx0_buffer_end		= 0;
+//our own buffering. Each channel has two stages:
+//1. A lock-free single-producer/single-consumer ring (see spsc_ring.h). Frames are pushed by the handler of
+//   the opposite bus, all from task context since CAN2 reception is deferred out of its ISR. When the ring is full the new frame is
+//   refused and counted in its drop counter instead of overwriting a queued frame.
+//2. A binary min-heap owned by the consumer (BridgeTask, Schedule_Buffer_Check_CAN). Every tick the ring is
+//   emptied into the heap, which hands frames to the controller in CAN arbitration order (lowest ID first,
+//   FIFO within the same ID), so a 0x1D4 torque frame never waits behind a burst of 0x5xx housekeeping frames.
+typedef struct {
+  can_frame_t frame;
+  uint32_t    enqueue_us;   //micros() when the frame was pushed, for the queue wait statistics
+} tx_entry_t;
 
-static can_frame_t tx1_buffer[TXBUFFER_SIZE];
-static uint8_t		tx1_buffer_pos		= 0;
-static uint8_t		tx1_buffer_end		= 0;
+typedef struct {
+  tx_entry_t  entry;
+  uint32_t    seq;          //arrival order, keeps FIFO order between frames with the same ID
+} tx_heap_entry_t;
 
-static can_frame_t tx2_buffer[TXBUFFER_SIZE];
-static uint8_t   tx2_buffer_pos    = 0;
-static uint8_t   tx2_buffer_end    = 0;
+typedef struct {
+  spsc_ring<tx_entry_t, TXBUFFER_SIZE> ring;
+  tx_heap_entry_t heap[TXBUFFER_SIZE];
+  volatile uint16_t heap_len;
+  volatile uint16_t queued_high_water;  //ring + heap, the ring high water alone misses the frames in the heap
+  uint32_t        seq;
+} tx_channel_t;
+
+static tx_channel_t tx0_buffer;
+static tx_channel_t tx1_buffer;
+static tx_channel_t tx2_buffer;
+
+//Time between push and hand-over to the controller, per CAN ID class (all channels)
+static latency_hist_t tx_wait_hist[CAN_ID_CLASS_COUNT];
+
+//Time between receive interrupt (can_frame_t.rx_cycles) and hand-over to the controller of the
+//forwarded frame, by transmitting channel and by CAN ID class. Frames generated by the bridge
+//(rx_cycles 0) are not counted. Neither driver reports transmit completion per frame, so the
+//hand-over is the end point; the time on the wire is bounded by the frame length.
+static latency_hist_t rx_tx_channel_hist[CAN_CHANNEL_COUNT];
+static latency_hist_t rx_tx_class_hist[CAN_ID_CLASS_COUNT];
+static uint32_t cycles_per_us = 1;
+
+//——————————————————————————————————————————————————————————————————————————————
+// CAN ID classification
+//——————————————————————————————————————————————————————————————————————————————
+uint8_t CAN_ID_Class(uint32_t can_id){
+  uint8_t id_class;
+
+  if((can_id == 0x1D4) || (can_id == 0x1DA)){
+    id_class = CAN_ID_CLASS_TORQUE;
+  }
+  else if(can_id < 0x300){
+    id_class = CAN_ID_CLASS_CONTROL;
+  }
+  else if(can_id < 0x500){
+    id_class = CAN_ID_CLASS_STATUS;
+  }
+  else{
+    id_class = CAN_ID_CLASS_HOUSEKEEPING;
+  }
+
+  return id_class;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Transmit priority heap (consumer side only)
+//——————————————————————————————————————————————————————————————————————————————
+static bool tx_heap_before(const tx_heap_entry_t * a, const tx_heap_entry_t * b){
+  if(a->entry.frame.can_id != b->entry.frame.can_id){
+    return (a->entry.frame.can_id < b->entry.frame.can_id);
+  }
+  return ((int32_t)(a->seq - b->seq) < 0);
+}
+
+static void tx_heap_insert(tx_channel_t * ch, const tx_entry_t * entry){
+  uint16_t idx = ch->heap_len;
+  tx_heap_entry_t item;
+
+  item.entry = *entry;
+  item.seq   = ch->seq++;
+
+  //Sift up
+  while(idx > 0){
+    uint16_t parent = (idx - 1) / 2;
+    if(!tx_heap_before(&item, &ch->heap[parent])){
+      break;
+    }
+    ch->heap[idx] = ch->heap[parent];
+    idx = parent;
+  }
+  ch->heap[idx] = item;
+  ch->heap_len = ch->heap_len + 1;
+}
+
+static void tx_heap_remove_top(tx_channel_t * ch){
+  uint16_t len = ch->heap_len - 1;
+  uint16_t idx = 0;
+  tx_heap_entry_t item = ch->heap[len];
+
+  //Sift the last element down from the root
+  while(true){
+    uint16_t child = (2 * idx) + 1;
+    if(child >= len){
+      break;
+    }
+    if(((child + 1) < len) && tx_heap_before(&ch->heap[child + 1], &ch->heap[child])){
+      child++;
+    }
+    if(!tx_heap_before(&ch->heap[child], &item)){
+      break;
+    }
+    ch->heap[idx] = ch->heap[child];
+    idx = child;
+  }
+  ch->heap[idx] = item;
+  ch->heap_len = len;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Push a frame into a channel (producer side)
+//——————————————————————————————————————————————————————————————————————————————
+static bool tx_push(tx_channel_t * ch, const can_frame_t &frame){
+  tx_entry_t * entry = ch->ring.back();
+
+  if(NULL == entry){
+    return false;
+  }
+  //Single copy of the frame, straight into its ring slot
+  entry->frame      = frame;
+  entry->enqueue_us = micros();
+  ch->ring.publish();
+
+  return true;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Drain a channel into its controller (consumer side)
+//——————————————————————————————————————————————————————————————————————————————
+static void tx_drain(tx_channel_t * ch, uint8_t can_bus, bool (*send)(const can_frame_t &)){
+  uint16_t budget = TX_DRAIN_BUDGET_PER_TICK;
+  uint16_t queued = (uint16_t)(ch->ring.count() + ch->heap_len);
+  tx_entry_t * entry;
+  uint8_t id_class;
+
+  if(queued > ch->queued_high_water){
+    ch->queued_high_water = queued;
+  }
+
+  //Move everything pushed since the last tick into priority order
+  while((ch->heap_len < TXBUFFER_SIZE) && (NULL != (entry = ch->ring.front()))){
+    tx_heap_insert(ch, entry);
+    ch->ring.pop();
+  }
+
+  // Keep handing frames to the controller until the buffer is empty, the controller
+  // reports that it is full or the frame budget of this tick is used up
+  while((budget > 0U) && (ch->heap_len > 0)){
+    tx_entry_t * top = &ch->heap[0].entry;
+
+    if(!send(top->frame)){
+      //CAN Tx Buffer is not ready
+      EVENT_LOG(EVT_TX_NOT_READY, can_bus, top->frame);
+      break;
+    }
+    EVENT_LOG(EVT_TX_SENT, can_bus, top->frame);
+
+    id_class = CAN_ID_Class(top->frame.can_id);
+    HIST_Record(&tx_wait_hist[id_class], micros() - top->enqueue_us);
+    if(0U != top->frame.rx_cycles){
+      uint32_t latency_us = (CAN_RxStamp() - top->frame.rx_cycles) / cycles_per_us;
+      HIST_Record(&rx_tx_channel_hist[can_bus], latency_us);
+      HIST_Record(&rx_tx_class_hist[id_class], latency_us);
+    }
+    tx_heap_remove_top(ch);
+    budget--;
+  }
+}
 
 //——————————————————————————————————————————————————————————————————————————————
 // Hardware initialization
 //——————————————————————————————————————————————————————————————————————————————
 void hw_init(void){
+  cycles_per_us = ESP.getCpuFreqMHz();
+  BUSSTAT_Init();
+  CSUM_Init();
   CAN_Init();
 }
 
 //——————————————————————————————————————————————————————————————————————————————
 // Application CAN 0 Transmit Buffer
 //——————————————————————————————————————————————————————————————————————————————
-void buffer_send_can0(can_frame_t frame){	
-	
-	// Push to the buffer
-	memcpy(&tx0_buffer[tx0_buffer_end], &frame, sizeof(frame));
-	
-	// Update buffer end counter
-	tx0_buffer_end++;
-	
-	// Checks if end counter does not overflow
-	// silently handle buffer overflows
-	if(tx0_buffer_end >= TXBUFFER_SIZE){
-		tx0_buffer_end = TXBUFFER_SIZE - 1;
-		
-		#ifdef SERIAL_DEBUG_MONITOR
-		Serial.println("Application CAN0 Tx Buffer has overflowed!");
-		#endif //#ifdef SERIAL_DEBUG_MONITOR
-	}
-	
-	// Try to empty the buffer
-  #ifdef CAN_CH0_ENABLED
-	buffer_check_can0();
-  #endif //CAN_CH0_ENABLED
+void buffer_send_can0(const can_frame_t &frame){
+  
+  // Push to the buffer, a full buffer refuses the frame and counts it as dropped
+  if(tx_push(&tx0_buffer, frame)){
+    EVENT_LOG(EVT_TX_QUEUED, CAN_CHANNEL_0, frame);
+  }else{
+    //Application CAN0 Tx Buffer has overflowed
+    EVENT_LOG(EVT_TX_OVERFLOW, CAN_CHANNEL_0, frame);
+  }
+  
+  // Do not try to empty the buffer here: the buffer has a single consumer,
+  // BridgeTask (see Schedule_Buffer_Check_CAN)
 }
 
 //——————————————————————————————————————————————————————————————————————————————
@@ -82,59 +249,24 @@ void buffer_send_can0(can_frame_t frame){
 //——————————————————————————————————————————————————————————————————————————————
 #ifdef CAN_CH0_ENABLED
 void buffer_check_can0(void){
-	
-	// Checks if buffer is not empty
-	if(tx0_buffer_end != tx0_buffer_pos){		
-
-    //noInterrupts(); //disable interrupts
-		
-		// Check if CAN buffer is empty/ready and send 1 frame
-		bool ok = direct_send_can0 (tx0_buffer[tx0_buffer_pos]);
-		
-		if(ok){
-			//Update position if transmitted successfully
-			tx0_buffer_pos++;
-			//end of buffer, reset
-			if(tx0_buffer_pos == tx0_buffer_end){ 
-				tx0_buffer_end = 0;
-				tx0_buffer_pos = 0;
-			}
-		}
-		else{
-			#ifdef SERIAL_DEBUG_MONITOR
-			Serial.println("CAN0 Tx Buffer is not ready!");
-			#endif //#ifdef SERIAL_DEBUG_MONITOR
-		}
-	
-	  //interrupts(); //re-enable enterrupts
-	}
+  tx_drain(&tx0_buffer, CAN_CHANNEL_0, direct_send_can0);
 }
 #endif //CAN_CH0_ENABLED
 //——————————————————————————————————————————————————————————————————————————————
 // Application CAN 1 Transmit Buffer
 //——————————————————————————————————————————————————————————————————————————————
-void buffer_send_can1(can_frame_t frame){	
-	
-	// Push to the buffer
-	memcpy(&tx1_buffer[tx1_buffer_end], &frame, sizeof(frame));
-	
-	// Update buffer end counter
-	tx1_buffer_end++;
-	
-	// Checks if end counter does not overflow
-	// silently handle buffer overflows
-	if(tx1_buffer_end >= TXBUFFER_SIZE){
-		tx1_buffer_end = TXBUFFER_SIZE - 1;
-		
-		#ifdef SERIAL_DEBUG_MONITOR
-		Serial.println("Application CAN1 Tx Buffer has overflowed!");
-		#endif //#ifdef SERIAL_DEBUG_MONITOR
-	}
-	
-	// Try to empty the buffer
-  #ifdef CAN_CH1_ENABLED
-	//buffer_check_can1();
-  #endif //CAN_CH1_ENABLED
+void buffer_send_can1(const can_frame_t &frame){
+  
+  // Push to the buffer, a full buffer refuses the frame and counts it as dropped
+  if(tx_push(&tx1_buffer, frame)){
+    EVENT_LOG(EVT_TX_QUEUED, CAN_CHANNEL_1, frame);
+  }else{
+    //Application CAN1 Tx Buffer has overflowed
+    EVENT_LOG(EVT_TX_OVERFLOW, CAN_CHANNEL_1, frame);
+  }
+  
+  // Do not try to empty the buffer here: the buffer has a single consumer,
+  // BridgeTask (see Schedule_Buffer_Check_CAN)
 }
 
 //——————————————————————————————————————————————————————————————————————————————
@@ -142,59 +274,24 @@ void buffer_send_can1(can_frame_t frame){
 //——————————————————————————————————————————————————————————————————————————————
 #ifdef CAN_CH1_ENABLED
 void buffer_check_can1(void){
-	
-	// Checks if buffer is not empty
-	if(tx1_buffer_end != tx1_buffer_pos){		
-
-    //noInterrupts(); //disable interrupts
-		
-		// Check if CAN buffer is empty/ready and send 1 frame
-		bool ok = direct_send_can1(tx1_buffer[tx1_buffer_pos]);
-   
-		if(ok){
-			//Update position if transmitted successfully
-			tx1_buffer_pos++;
-			//end of buffer, reset
-			if(tx1_buffer_pos == tx1_buffer_end){ 
-				tx1_buffer_end = 0;
-				tx1_buffer_pos = 0;
-			}
-		}
-		else{
-			#ifdef SERIAL_DEBUG_MONITOR
-			Serial.println("CAN1 Tx Buffer is not ready!");
-			#endif //#ifdef SERIAL_DEBUG_MONITOR
-		}
-
-    //interrupts(); //re-enable enterrupts
-	}
+  tx_drain(&tx1_buffer, CAN_CHANNEL_1, direct_send_can1);
 }
 #endif //CAN_CH1_ENABLED
 //——————————————————————————————————————————————————————————————————————————————
 // Application CAN 2 Transmit Buffer
 //——————————————————————————————————————————————————————————————————————————————
-void buffer_send_can2(can_frame_t frame){  
-  
-  // Push to the buffer
-  memcpy(&tx2_buffer[tx2_buffer_end], &frame, sizeof(frame));
-  
-  // Update buffer end counter
-  tx2_buffer_end++;
+void buffer_send_can2(const can_frame_t &frame){
   
-  // Checks if end counter does not overflow
-  // silently handle buffer overflows
-  if(tx2_buffer_end >= TXBUFFER_SIZE){
-    tx2_buffer_end = TXBUFFER_SIZE - 1;
-    
-    #ifdef SERIAL_DEBUG_MONITOR
-    Serial.println("Application CAN2 Tx Buffer has overflowed!");
-    #endif //#ifdef SERIAL_DEBUG_MONITOR
+  // Push to the buffer, a full buffer refuses the frame and counts it as dropped
+  if(tx_push(&tx2_buffer, frame)){
+    EVENT_LOG(EVT_TX_QUEUED, CAN_CHANNEL_2, frame);
+  }else{
+    //Application CAN2 Tx Buffer has overflowed
+    EVENT_LOG(EVT_TX_OVERFLOW, CAN_CHANNEL_2, frame);
   }
   
-  // Try to empty the buffer
-  #ifdef CAN_CH2_ENABLED
-  //buffer_check_can2();
-  #endif //CAN_CH2_ENABLED
+  // Do not try to empty the buffer here: the buffer has a single consumer,
+  // BridgeTask (see Schedule_Buffer_Check_CAN)
 }
 
 //——————————————————————————————————————————————————————————————————————————————
@@ -202,32 +299,7 @@ void buffer_send_can2(can_frame_t frame){
 //——————————————————————————————————————————————————————————————————————————————
 #ifdef CAN_CH2_ENABLED
 void buffer_check_can2(void){
-  
-  // Checks if buffer is not empty
-  if(tx2_buffer_end != tx2_buffer_pos){   
-
-    //noInterrupts(); //disable interrupts
-    
-    // Check if CAN buffer is empty/ready and send 1 frame
-    bool ok = direct_send_can2(tx2_buffer[tx2_buffer_pos]);
-    
-    if(ok){
-      //Update position if transmitted successfully
-      tx2_buffer_pos++;
-      //end of buffer, reset
-      if(tx2_buffer_pos == tx2_buffer_end){ 
-        tx2_buffer_end = 0;
-        tx2_buffer_pos = 0;
-      }
-    }
-    else{
-      #ifdef SERIAL_DEBUG_MONITOR
-      Serial.println("CAN2 Tx Buffer is not ready!");
-      #endif //#ifdef SERIAL_DEBUG_MONITOR
-    }
-  
-    //interrupts(); //re-enable enterrupts
-  }
+  tx_drain(&tx2_buffer, CAN_CHANNEL_2, direct_send_can2);
 }
 #endif //CAN_CH2_ENABLED
 //——————————————————————————————————————————————————————————————————————————————
@@ -248,25 +320,127 @@ void Schedule_Buffer_Check_CAN(void) {
   #endif //CAN_CH2_ENABLED
 }
 
+//——————————————————————————————————————————————————————————————————————————————
+// Application Transmit Buffer statistics
+//——————————————————————————————————————————————————————————————————————————————
+bool buffer_get_stats(uint8_t can_bus, tx_buffer_stats_t * stats){
+  bool ok = true;
+
+  switch(can_bus){
+    case CAN_CHANNEL_0:
+      stats->count             = tx0_buffer.ring.count() + tx0_buffer.heap_len;
+      stats->ring_high_water   = tx0_buffer.ring.high_water;
+      stats->queued_high_water = tx0_buffer.queued_high_water;
+      stats->pushed            = tx0_buffer.ring.pushed;
+      stats->dropped           = tx0_buffer.ring.dropped;
+    break;
+    case CAN_CHANNEL_1:
+      stats->count             = tx1_buffer.ring.count() + tx1_buffer.heap_len;
+      stats->ring_high_water   = tx1_buffer.ring.high_water;
+      stats->queued_high_water = tx1_buffer.queued_high_water;
+      stats->pushed            = tx1_buffer.ring.pushed;
+      stats->dropped           = tx1_buffer.ring.dropped;
+    break;
+    case CAN_CHANNEL_2:
+      stats->count             = tx2_buffer.ring.count() + tx2_buffer.heap_len;
+      stats->ring_high_water   = tx2_buffer.ring.high_water;
+      stats->queued_high_water = tx2_buffer.queued_high_water;
+      stats->pushed            = tx2_buffer.ring.pushed;
+      stats->dropped           = tx2_buffer.ring.dropped;
+    break;
+    default:
+      ok = false;
+    break;
+  }
+
+  return ok;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Transmit queue wait time per CAN ID class
+//——————————————————————————————————————————————————————————————————————————————
+const latency_hist_t * buffer_get_wait_hist(uint8_t id_class){
+  if(id_class >= CAN_ID_CLASS_COUNT){
+    return NULL;
+  }
+  return &tx_wait_hist[id_class];
+}
+
+void buffer_reset_wait_hist(void){
+  uint8_t i;
+  for(i = 0; i < CAN_ID_CLASS_COUNT; i++){
+    HIST_Reset(&tx_wait_hist[i]);
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Receive interrupt to controller hand-over latency, per transmitting channel and per CAN ID class
+//——————————————————————————————————————————————————————————————————————————————
+const latency_hist_t * buffer_get_latency_hist(uint8_t can_bus){
+  if(can_bus >= CAN_CHANNEL_COUNT){
+    return NULL;
+  }
+  return &rx_tx_channel_hist[can_bus];
+}
+
+const latency_hist_t * buffer_get_class_latency_hist(uint8_t id_class){
+  if(id_class >= CAN_ID_CLASS_COUNT){
+    return NULL;
+  }
+  return &rx_tx_class_hist[id_class];
+}
+
+void buffer_reset_latency_hist(void){
+  uint8_t i;
+  for(i = 0; i < CAN_CHANNEL_COUNT; i++){
+    HIST_Reset(&rx_tx_channel_hist[i]);
+  }
+  for(i = 0; i < CAN_ID_CLASS_COUNT; i++){
+    HIST_Reset(&rx_tx_class_hist[i]);
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// MCP2515 transmit buffer selection: TXB0 has the highest TXP priority (see CAN_Init),
+// so the controller itself also sends torque frames ahead of anything pending in TXB1/TXB2
+//——————————————————————————————————————————————————————————————————————————————
+#if defined(CAN_CH0_ENABLED) || defined(CAN_CH1_ENABLED)
+static uint8_t mcp2515_txb_for_id(uint32_t can_id){
+  uint8_t txb;
+
+  switch(CAN_ID_Class(can_id)){
+    case CAN_ID_CLASS_TORQUE:
+      txb = 0;
+    break;
+    case CAN_ID_CLASS_CONTROL:
+      txb = 1;
+    break;
+    default:
+      txb = 2;
+    break;
+  }
+
+  return txb;
+}
+#endif
+
 //——————————————————————————————————————————————————————————————————————————————
 // Driver CAN Channel 0 transmission
 //——————————————————————————————————————————————————————————————————————————————
 #ifdef CAN_CH0_ENABLED
-bool direct_send_can0(can_frame_t frame){
+bool direct_send_can0(const can_frame_t &frame){
   CANMessage txdata;
-  uint16_t i;
 
   //noInterrupts(); //disable interrupts
   
   //Assemble tx data according to CANMessage format
-  txdata.ext  = false; // Standard ID
-  txdata.id   = frame.can_id;
-  txdata.len  = frame.can_dlc;
-  for(i=0; i<frame.can_dlc; i++) {
-    txdata.data[i] = frame.data[i];
-  }
+  txdata.ext  = (0U != (frame.can_id & CAN_EFF_FLAG));
+  txdata.idx  = mcp2515_txb_for_id(frame.can_id);
+  txdata.id   = frame.can_id & (txdata.ext ? CAN_EFF_MASK : CAN_SFF_MASK);
+  txdata.len  = (frame.can_dlc > CAN_MAX_DLEN) ? CAN_MAX_DLEN : frame.can_dlc;
+  memcpy(txdata.data, frame.data, CAN_MAX_DLEN);
 
-  //Pass data to CAN0 transmit 
+  //Pass data to CAN0 transmit (by reference, this is the only copy on the way to the ACAN2515 queue)
   bool ok = CAN0_Transmit(txdata);  
 
   //interrupts(); //re-enable enterrupts
@@ -279,21 +453,19 @@ bool direct_send_can0(can_frame_t frame){
 // Driver CAN Channel 1 transmission
 //——————————————————————————————————————————————————————————————————————————————
 #ifdef CAN_CH1_ENABLED
-bool direct_send_can1(can_frame_t frame){
+bool direct_send_can1(const can_frame_t &frame){
   CANMessage txdata;
-  uint16_t i;
 
   //noInterrupts(); //disable interrupts
 
   //Assemble tx data according to CANMessage format
-  txdata.ext  = false; // Standard ID
-  txdata.id   = frame.can_id;
-  txdata.len  = frame.can_dlc;
-  for(i=0; i<frame.can_dlc; i++) {
-    txdata.data[i] = frame.data[i];
-  }
+  txdata.ext  = (0U != (frame.can_id & CAN_EFF_FLAG));
+  txdata.idx  = mcp2515_txb_for_id(frame.can_id);
+  txdata.id   = frame.can_id & (txdata.ext ? CAN_EFF_MASK : CAN_SFF_MASK);
+  txdata.len  = (frame.can_dlc > CAN_MAX_DLEN) ? CAN_MAX_DLEN : frame.can_dlc;
+  memcpy(txdata.data, frame.data, CAN_MAX_DLEN);
 
-  //Pass data to CAN1 transmit 
+  //Pass data to CAN1 transmit (by reference, this is the only copy on the way to the ACAN2515 queue)
   bool ok = CAN1_Transmit(txdata);
 
   //interrupts(); //re-enable enterrupts
@@ -306,7 +478,7 @@ bool direct_send_can1(can_frame_t frame){
 // Driver CAN Channel 2 transmission
 //——————————————————————————————————————————————————————————————————————————————
 #ifdef CAN_CH2_ENABLED
-bool direct_send_can2(can_frame_t frame){  
+bool direct_send_can2(const can_frame_t &frame){  
 
   //noInterrupts(); //disable interrupts
   
@@ -22,31 +22,55 @@
 
 #include "canframe.h"
 #include "config.h"
+#include "latency_histogram.h"
+
+//CAN ID classes, used for transmit buffer selection and latency statistics
+#define CAN_ID_CLASS_TORQUE       (0U)  //0x1D4 torque request, 0x1DA torque response
+#define CAN_ID_CLASS_CONTROL      (1U)  //other IDs below 0x300 (10ms/20ms control frames)
+#define CAN_ID_CLASS_STATUS       (2U)  //0x300-0x4FF
+#define CAN_ID_CLASS_HOUSEKEEPING (3U)  //0x500 and above (100ms-1s frames, diagnostics)
+#define CAN_ID_CLASS_COUNT        (4U)
+
+//Transmit buffer statistics
+typedef struct {
+  uint32_t count;              //frames waiting to be sent (ring + priority heap)
+  uint32_t ring_high_water;    //highest ring fill level since boot, the ring alone refuses frames (dropped)
+  uint32_t queued_high_water;  //highest ring + heap level since boot, seen at the start of each drain
+  uint32_t pushed;     //frames accepted
+  uint32_t dropped;    //frames refused because the buffer was full
+} tx_buffer_stats_t;
 
 //function prototypes
 void hw_init(void);
 
 void SID_to_str(char * str, uint32_t num);
-void canframe_to_str(char * str, can_frame_t frame);
+void canframe_to_str(char * str, const can_frame_t &frame);
 
-void buffer_send_can0(can_frame_t frame);
+void buffer_send_can0(const can_frame_t &frame);
 #ifdef CAN_CH0_ENABLED
 void buffer_check_can0(void);
-bool direct_send_can0(can_frame_t frame);
+bool direct_send_can0(const can_frame_t &frame);
 #endif //CAN_CH0_ENABLED
 
-void buffer_send_can1(can_frame_t frame);
+void buffer_send_can1(const can_frame_t &frame);
 #ifdef CAN_CH1_ENABLED
 void buffer_check_can1(void);
-bool direct_send_can1(can_frame_t frame);
+bool direct_send_can1(const can_frame_t &frame);
 #endif //CAN_CH1_ENABLED
 
-void buffer_send_can2(can_frame_t frame);
+void buffer_send_can2(const can_frame_t &frame);
 #ifdef CAN_CH2_ENABLED
 void buffer_check_can2(void);
-bool direct_send_can2(can_frame_t frame);
+bool direct_send_can2(const can_frame_t &frame);
 #endif //#ifdef CAN_CH2_ENABLED
 
 void Schedule_Buffer_Check_CAN(void);
+bool buffer_get_stats(uint8_t can_bus, tx_buffer_stats_t * stats);
+const latency_hist_t * buffer_get_wait_hist(uint8_t id_class);
+void buffer_reset_wait_hist(void);
+const latency_hist_t * buffer_get_latency_hist(uint8_t can_bus);
+const latency_hist_t * buffer_get_class_latency_hist(uint8_t id_class);
+void buffer_reset_latency_hist(void);
+uint8_t CAN_ID_Class(uint32_t can_id);
 
 #endif //CAN_BRIDGE_MANAGER_COMMON_H
@@ -18,6 +18,18 @@
 // 12.04.2022: Merging of Inverter Upgrade based on https://github.com/dalathegreat/Nissan-LEAF-Inverter-Upgrade/blob/main/can-bridge-inverter.c
 // 12.06.2022: Updated Charge Current logic - 1) Start conditions are charging state and fan speed; 2) Display kW for 15sec and revert to SOC
 // 12.31.2022: Fix charge current functions Fix regen power and motor power Fix Glide and drive add code 
+// 10.16.2026: Per-ID dispatch table built at startup replaces the switch in LEAF_CAN_Handler
+// 10.16.2026: Debug output through the binary event log, no string formatting per frame
+// 10.16.2026: Synthesized inverter messages sent by the timer driven frame scheduler (LEAF_SYNTH_MODE)
+// 10.16.2026: MCP2515 frames keep their interrupt ingress timestamp for the latency histograms
+// 10.16.2026: Every received frame accounted in the per-ID bus statistics before translation
+// 10.16.2026: Inbound CRC/counter validation; modified bytes patch the CRC (CSUM_SetByte) instead of calc_crc8
+// 10.16.2026: Torque/regen multipliers in Q16 fixed point (torque_scale.h), saturated instead of wrapping
+// 10.16.2026: Torque/regen maps over demand and vehicle speed (torque_map.h) replace the multipliers when loaded
+// 10.16.2026: Signals decoded and inserted through the descriptors of leaf_signals.h instead of hand-written shifts
+// 10.16.2026: Inverter upgrade selection taken from one live_config.h snapshot per frame
+// 10.16.2026: Telemetry values (telemetry.h) stored from the received frames before translation
+// 10.16.2026: Received frames offered to the websocket sniffer (can_sniffer.h) before translation
 //——————————————————————————————————————————————————————————————————————————————
 
 #include <Arduino.h>
@@ -26,6 +38,15 @@
 #include "can_bridge_manager_leaf_inverter_upgrade.h"
 #include "can_driver.h"
 #include "helper_functions.h"
+#include "event_log.h"
+#include "frame_scheduler.h"
+#include "bus_stats.h"
+#include "checksum.h"
+#include "torque_scale.h"
+#include "torque_map.h"
+#include "leaf_signals.h"
+#include "telemetry.h"
+#include "can_sniffer.h"
 #include "config.h"
 
 #if defined(CAN_BRIDGE_FOR_LEAF)
@@ -40,6 +61,7 @@ volatile  uint16_t  battery_soc    = 0;
 volatile  uint8_t   shift_state     = 0;
 volatile  uint8_t   charging_state      = 0;
 volatile  uint8_t   eco_screen        = 0;
+volatile  uint16_t  vehicle_speed     = 0; //km/h * 16, from 0x284
 
 
 #define REGEN_TUNING_ENABLED
@@ -51,6 +73,8 @@ volatile  uint8_t   eco_screen        = 0;
 
 /* Do not make any changes to the rows below unless you are sure what you are doing */
 
+#define RESPONSE_MULTIPLIER 0.5       //0x1DA response (NM * 2) from the 0x1D4 demand (NM * 4)
+
 #define SHIFT_DRIVE   4
 #define SHIFT_ECO     5
 #define SHIFT_REVERSE 2
@@ -96,7 +120,7 @@ volatile  uint8_t   content_4B9     = 0x40;
   static    uint8_t   lookuptable_crc_108[16] = {0x00,0x85,0x8F,0x0A,0x9B,0x1e,0x14,0x91,0xb3,0x36,0x3c,0xb9,0x28,0xad,0xa7,0x22};
 
   //volatile  can_frame_t inv_1CB_message = {.can_id = 0x1cb, .can_dlc = 7, .data = {0x00,0x00,0x00,0x02,0x60,0x00,0x62}}; //Actual content
-volatile  can_frame_t inv_1CB_message = {.can_id = 0x1cb, .can_dlc = 7, .data = {0x00,0x09,0xFF,0xCE,0x10,0x8b,0xe7}}; //Startup sequence
+  static  can_frame_t inv_1CB_message = {.can_id = 0x1cb, .can_dlc = 7, .data = {0x00,0x09,0xFF,0xCE,0x10,0x8b,0xe7}}; //Startup sequence
 
 //  This message is not needed if you have a 62kWh pack (1ED), but probably good to send it towards the 160kW inverter
   static  can_frame_t inv_1ED_message = {.can_id = 0x1ED, .can_dlc = 3, .data = {0xFF,0xe0,0x68}};
@@ -120,452 +144,666 @@ volatile  can_frame_t inv_1CB_message = {.can_id = 0x1cb, .can_dlc = 7, .data =
   static    can_frame_t inv_5C5_message = {.can_id = 0x5C5, .can_dlc = 8, .data = {0x40,0x01,0x2F,0x5E,0x00,0x00,0x00,0x00}};
   static    can_frame_t inv_5EB_message = {.can_id = 0x5EB, .can_dlc = 8, .data = {0xE0,0x0F,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF}};
 
-void LEAF_CAN_Bridge_Manager_Init(void)
-{
-  
-}
-
 //——————————————————————————————————————————————————————————————————————————————
-// [LEAF] CAN Bridge Main Handler
+// [LEAF] Per-ID dispatch table
+//——————————————————————————————————————————————————————————————————————————————
+// leaf_dispatch_index maps every 11-bit ID to the first entry of its handler chain in
+// leaf_dispatch_chain (LEAF_DISPATCH_NONE for plain passthrough IDs), so LEAF_CAN_Handler()
+// needs a single indexed lookup per frame. The table is built once by LEAF_CAN_Bridge_Manager_Init()
+// from the MESSAGE_0x... selection in config.h. Settings that can change at runtime over the web
+// (inverter upgrade, shifter, charging state) stay inside the handlers, so no rebuild is needed
+// while the bridge task is running.
 //——————————————————————————————————————————————————————————————————————————————
 #ifdef CAN_BRIDGE_FOR_LEAF
-void LEAF_CAN_Bridge_Manager(void){
+#define LEAF_DISPATCH_ID_COUNT    2048  //11-bit standard IDs
+#define LEAF_DISPATCH_CHAIN_SIZE  16    //total handlers over all IDs, entry 0 is not used
+#define LEAF_DISPATCH_NONE        0
 
-  //--- Monitor CAN0 & CAN1 receptions
-  #ifdef CAN_CH0_ENABLED
-  if(true == CAN0_NewFrameIsAvailable()) {
-    #ifdef SERIAL_DEBUG_MONITOR
-    Serial.println("CAN0 Message is received");
-    #endif //#ifdef SERIAL_DEBUG_MONITOR
-    
-    CANMessage ch0_rxdata;
-    can_frame_t ch0_frame;
-    uint16_t ch0_i;
-    CAN0_ReadNewFrame(ch0_rxdata);
-    ch0_frame.can_id = ch0_rxdata.id;
-    ch0_frame.can_dlc = ch0_rxdata.len;
-    for(ch0_i=0; ch0_i<ch0_frame.can_dlc; ch0_i++) {
-      ch0_frame.data[ch0_i] = ch0_rxdata.data[ch0_i];
-    }
-    
-    //Call CAN0 event handler
-    //if( INVERTER_UPGRADE_ENABLED() )
-  //  {
-      LEAF_CAN_Handler(CAN_CHANNEL_0, ch0_frame);
-   // }
-    //else
-   // {
-      //Not supported for now
-   // }
-  }
-  #endif //CAN_CH0_ENABLED
+typedef void (*leaf_id_handler_t)(uint8_t can_bus, can_frame_t &frame);
 
+typedef struct {
+  leaf_id_handler_t handler;
+  uint8_t           next;     //next handler for the same ID, LEAF_DISPATCH_NONE at the end of the chain
+} leaf_dispatch_entry_t;
 
-  #ifdef CAN_CH1_ENABLED
-  if(true == CAN1_NewFrameIsAvailable()) {
+static uint8_t leaf_dispatch_index[LEAF_DISPATCH_ID_COUNT];
+static leaf_dispatch_entry_t leaf_dispatch_chain[LEAF_DISPATCH_CHAIN_SIZE];
+static uint8_t leaf_dispatch_chain_len = 1;
+
+//Append a handler to the chain of can_id, handlers of one ID run in registration order
+static bool leaf_dispatch_register(uint16_t can_id, leaf_id_handler_t handler){
+  uint8_t entry;
+  uint8_t link;
+
+  if((can_id >= LEAF_DISPATCH_ID_COUNT) || (leaf_dispatch_chain_len >= LEAF_DISPATCH_CHAIN_SIZE)){
     #ifdef SERIAL_DEBUG_MONITOR
-    Serial.println("CAN1 Message is received");
+    Serial.println("LEAF dispatch table is full!");
     #endif //#ifdef SERIAL_DEBUG_MONITOR
+    return false;
+  }
+
+  entry = leaf_dispatch_chain_len++;
+  leaf_dispatch_chain[entry].handler = handler;
+  leaf_dispatch_chain[entry].next    = LEAF_DISPATCH_NONE;
 
-    CANMessage ch1_rxdata;
-    can_frame_t ch1_frame;
-    uint16_t ch1_i;
-    CAN1_ReadNewFrame(ch1_rxdata);
-    ch1_frame.can_id = ch1_rxdata.id;
-    ch1_frame.can_dlc = ch1_rxdata.len;
-    for(ch1_i=0; ch1_i<ch1_frame.can_dlc; ch1_i++) {
-      ch1_frame.data[ch1_i] = ch1_rxdata.data[ch1_i];
+  link = leaf_dispatch_index[can_id];
+  if(LEAF_DISPATCH_NONE == link){
+    leaf_dispatch_index[can_id] = entry;
+  }else{
+    while(LEAF_DISPATCH_NONE != leaf_dispatch_chain[link].next){
+      link = leaf_dispatch_chain[link].next;
     }
-    
-    //Call CAN1 event handler
-   // if( INVERTER_UPGRADE_ENABLED() )
-   // {
-      LEAF_CAN_Handler(CAN_CHANNEL_1, ch1_frame );  
-  //  }
-   // else
-    //{
-      //Not supported for now
-  //  }
+    leaf_dispatch_chain[link].next = entry;
   }
-  #endif //CAN_CH1_ENABLED  
-
+  return true;
 }
 #endif //#ifdef CAN_BRIDGE_FOR_LEAF
 
 //——————————————————————————————————————————————————————————————————————————————
-// [LEAF] CAN handler - evaluates received data, tranlate and transmits to the other CAN bus
+// [LEAF] Synthesized inverter messages - rolling content
 //——————————————————————————————————————————————————————————————————————————————
+// Shared by the VCM triggered handlers and the frame scheduler, called right before the frame is sent.
 #ifdef CAN_BRIDGE_FOR_LEAF
-void LEAF_CAN_Handler(uint8_t can_bus, can_frame_t new_rx_frame){  
-  
-	can_frame_t frame;
-  //int16_t temp = 0;
 
-	memcpy(&frame, &new_rx_frame, sizeof(new_rx_frame));
+#ifdef MESSAGE_0x50C
+static void leaf_next_4B9(void){
+  content_4B9++;
+  if(content_4B9 > 79)
+  {
+    content_4B9 = 64;
+  }
+  inv_4B9_message.data[0] = content_4B9; //64 - 79 (0x40 - 0x4F)
+}
 
-	//Debugging format
-	//if CAN_CHANNEL 0 -> "0|   |..."
-	//if CAN_CHANNEL 1 -> "1|   |..."
-	//if CAN_CHANNEL 2 -> "2|   |..."
-	char strbuf[] = "0|   |                \n"; 
-	if(CAN_CHANNEL_1 == can_bus){ strbuf[0] = '1'; }
-	if(CAN_CHANNEL_2 == can_bus){ strbuf[0] = '2'; }
+static void leaf_next_3B8(void){
+  content_3B8++;
+  if(content_3B8 > 14)
+  {
+    content_3B8 = 0;
+  }
+  inv_3B8_message.data[2] = content_3B8; //0 - 14 (0x00 - 0x0E)
+    
+  if(flip_3B8)
+  {
+    flip_3B8 = 0;
+    inv_3B8_message.data[1] = 0xC8;
+  }
+  else
+  {
+    flip_3B8 = 1;
+    inv_3B8_message.data[1] = 0xE8;
+  }
+}
 
-	//Evaluate according to received ID
-	#ifdef LEAF_TRANSLATION_ENABLED    
-	switch(frame.can_id){
+static void leaf_next_5CD(void){
+  inv_5CD_message.data[1] = content_5CD;
+  content_5CD = (content_5CD + 4);
+  if(content_5CD > 238)
+  {
+    content_5CD = 2;
+  }
+}
+#endif //#ifdef MESSAGE_0x50C
 
-    case 0x5A9:
+#ifdef MESSAGE_0x1F2
+static void leaf_next_1F2_group(void){
+  PRUN10MS++;
+  if (PRUN10MS > 3){
+    PRUN10MS = 0;
+  }
+  
+  if (PRUN10MS == 0)
+  {
+    inv_1CB_message.data[5] = 0x88;
+    inv_1CB_message.data[6] = 0xED;
+    inv_1ED_message.data[1] = 0xE0;
+    inv_1ED_message.data[2] = 0x68;
+  }
+  else if(PRUN10MS == 1)
+  {
+    inv_1CB_message.data[5] = 0x89;
+    inv_1CB_message.data[6] = 0x68;
+    inv_1ED_message.data[1] = 0xE1;
+    inv_1ED_message.data[2] = 0xED;
+  }
+  else if(PRUN10MS == 2)
+  {
+    inv_1CB_message.data[5] = 0x8A;
+    inv_1CB_message.data[6] = 0x62;
+    inv_1ED_message.data[1] = 0xE2;
+    inv_1ED_message.data[2] = 0xE7;
+  }
+  else if(PRUN10MS == 3)
+  {
+    inv_1CB_message.data[5] = 0x8B;
+    inv_1CB_message.data[6] = 0xE7;
+    inv_1ED_message.data[1] = 0xE3;
+    inv_1ED_message.data[2] = 0x62;
+  }      
         
-        //eco_screen = (frame.data[0] & 0x03);
-        //eco_screen = (frame.data[0] & 0x01);
-       // eco_screen = (frame.data[0] & 0x02 >> 1);
-    
-    break;
+  content_1C2++;
+  if(content_1C2 > 95)
+  {
+    content_1C2 = 80;
+  }
+  
+  inv_1C2_message.data[0] = content_1C2; //80 - 95 (0x50 - 0x5F)
+  
+  content_108_1++;
+  if(content_108_1 > 0x0F)
+  {
+    content_108_1 = 0;
+  }
+  
+  content_108_2 = lookuptable_crc_108[content_108_1];
+  
+  inv_108_message.data[1] = content_108_1;
+  inv_108_message.data[2] = content_108_2;
+}
+#endif //#ifdef MESSAGE_0x1F2
 
-    
-    #ifdef MESSAGE_0x11A
-    case 0x11A: //store shifter status
-      switch(frame.data[0] & 0xF0){
-        case 0x20:
-          shift_state = SHIFT_REVERSE;
-        break;
-        case 0x30:
-          shift_state = SHIFT_NEUTRAL;
-        break;
-        case 0x40:         
-        shift_state = SHIFT_DRIVE;
-        break;
-        case 0x00:
-          shift_state = SHIFT_PARK;
-        break;        
-        default:
-          shift_state = SHIFT_PARK;
-        break;
-      }
+#if (LEAF_SYNTH_MODE != SCHED_MODE_VCM_TRIGGERED)
+//Abort all message modifications while AC charging, otherwise we interrupt AC charging on 62kWh LEAFs
+static bool leaf_synth_allowed(void){
+  return (charging_state != CHARGING_SLOW);
+}
+
+//Channels of the VCM frame for each destination, as the triggered handlers route: a VCM frame
+//from CAN1 is answered on CAN2, from any other channel on CAN1
+#define LEAF_SYNC_TO_CAN1   ((1U << CAN_CHANNEL_0) | (1U << CAN_CHANNEL_2))
+#define LEAF_SYNC_TO_CAN2   (1U << CAN_CHANNEL_1)
+
+//Timer driven message, locked to the VCM frame sync_id received on one of sync_channels
+static void leaf_synth_add(can_frame_t * frame, void (*send)(const can_frame_t &frame), uint8_t sync_channels,
+                           uint16_t period_ms, uint16_t sync_id, uint16_t sync_period_ms,
+                           sched_gate_t gate, sched_prepare_t prepare){
+  sched_msg_config_t config;
+
+  config.frame          = frame;
+  config.send           = send;
+  config.period_ms      = period_ms;
+  config.phase_ms       = 1;  //right after the VCM frame, as the triggered version
+  config.mode           = LEAF_SYNTH_MODE;
+  config.sync_id        = sync_id;
+  config.sync_period_ms = sync_period_ms;
+  config.sync_channels  = sync_channels;
+  config.gate           = gate;
+  config.prepare        = prepare;
+  if(!SCHED_Add(&config)){
+    #ifdef SERIAL_DEBUG_MONITOR
+    Serial.println("LEAF frame scheduler is full!");
+    #endif //#ifdef SERIAL_DEBUG_MONITOR
+  }
+}
+#endif //#if (LEAF_SYNTH_MODE != SCHED_MODE_VCM_TRIGGERED)
+
+#endif //#ifdef CAN_BRIDGE_FOR_LEAF
+
+//——————————————————————————————————————————————————————————————————————————————
+// [LEAF] Per-ID handlers
+//——————————————————————————————————————————————————————————————————————————————
+#if defined(CAN_BRIDGE_FOR_LEAF) && defined(LEAF_TRANSLATION_ENABLED)
+
+#ifdef MESSAGE_0x11A
+static void LEAF_Handle_0x11A(uint8_t can_bus, can_frame_t &frame){ //store shifter status
+  switch(SIG_Raw<LEAF_11A_SHIFTER>(frame.data)){
+    case 2:
+      shift_state = SHIFT_REVERSE;
     break;
-    #endif //#ifdef MESSAGE_0x11A
-      
+    case 3:
+      shift_state = SHIFT_NEUTRAL;
+    break;
+    case 4:         
+    shift_state = SHIFT_DRIVE;
+    break;
+    case 0:
+      shift_state = SHIFT_PARK;
+    break;        
+    default:
+      shift_state = SHIFT_PARK;
+    break;
+  }
+}
+#endif //#ifdef MESSAGE_0x11A
 
-                  
 // ------ debug for eco shift switch
- 
-      //case 0x1DB:                
-      //frame.data[4] = (shift_state+50) ; //SOC% will show the RAW can value for the shifter                       
-      //calc_crc8(&frame);
-      //break;
-      case 0x1DB:                
-      if(eco_screen == ECO_ON){ 
-          frame.data[4] = 99; //99% soc displayed
-      } 
-      if(eco_screen == ECO_OFF){ 
-          frame.data[4] = 11; //11% soc displayed
-      }                                                   
-      calc_crc8(&frame);
-      break;
+static void LEAF_Handle_0x1DB(uint8_t can_bus, can_frame_t &frame){
+  //frame.data[4] = (shift_state+50) ; //SOC% will show the RAW can value for the shifter                       
+  //calc_crc8(&frame);
+  if(eco_screen == ECO_ON){ 
+      SIG_Patch<LEAF_1DB_SOC>(frame, 99); //99% soc displayed
+  } 
+  if(eco_screen == ECO_OFF){ 
+      SIG_Patch<LEAF_1DB_SOC>(frame, 11); //11% soc displayed
+  }                                                   
+}
 //---------------------End of debug       
+
+#ifdef MESSAGE_0x1D4
+//Slap the torque back into data[2] and the high nibble of data[3]; the low nibble of data[3] is
+//cleared, the rewritten demand has always been sent as (torque << 4) & 0xFFF0
+static inline void leaf_patch_1D4(can_frame_t &frame, int16_t torque){
+  SIG_Patch<LEAF_1D4_TORQUE>(frame, torque);
+  CSUM_SetByte(frame, 3, (uint8_t)(frame.data[3] & 0xF0));
+}
+
+static void LEAF_Handle_0x1D4(uint8_t can_bus, can_frame_t &frame){ //VCM request signal     
+  int16_t demand = TSCALE_Get1D4(frame); //Requested torque is 12-bit long signed.
+  //VCMtorqueDemand = torqueDemand; //Store the original VCM demand value
+  VCMtorqueDemand = (uint16_t)SIG_Raw<LEAF_1D4_TORQUE>(frame.data); //Store the original VCM demand value (ignoring sign, just the raw NM demand)
+                
+    //if (shift_state != SHIFT_DRIVE || (torqueDemand < 2048 && eco_screen == ECO_ON)) return; //Stop modifying message if: Not in drive OR requesting power in ECO mode
+      if (shift_state != SHIFT_DRIVE || eco_screen == ECO_ON) return; //Stop modifying message if: Not in drive OR ECO mode is ON
       
-    #ifdef MESSAGE_0x1D4
-    case 0x1D4: //VCM request signal     
-      torqueDemand = ((frame.data[2] << 8) | frame.data[3]); //Requested torque is 12-bit long signed.
-      //torqueDemand = (torqueDemand & 0xFFF0) >> 4; //take out only 12 bits (remove 4)
-      //VCMtorqueDemand = torqueDemand; //Store the original VCM demand value
-      VCMtorqueDemand = (torqueDemand >> 4); //Store the original VCM demand value (ignoring sign, just the raw NM demand)
-                    
-        //if (shift_state != SHIFT_DRIVE || (torqueDemand < 2048 && eco_screen == ECO_ON)) break; //Stop modifying message if: Not in drive OR requesting power in ECO mode
-          if (shift_state != SHIFT_DRIVE || eco_screen == ECO_ON) break; //Stop modifying message if: Not in drive OR ECO mode is ON
-          
-        if((frame.data[2] & 0x80)){ //Message is signed, we are requesting regen
-            #ifndef REGEN_TUNING_ENABLED
-          break; //We are demanding regen and regen tuning is not on, abort modification!
-          #endif
-          torqueDemand = ~torqueDemand; //2S complement
-          torqueDemand = (torqueDemand >> 4);
-          torqueDemand = (torqueDemand * REGEN_MULTIPLIER);
-          torqueDemand = (torqueDemand << 4);
-          torqueDemand = ~torqueDemand; //2S complement
-                  
-          frame.data[2] = torqueDemand >> 8; //Slap it back into whole 2nd frame
-          frame.data[3] = (torqueDemand & 0x00F0);
-        }
-      else{
-        torqueDemand = (torqueDemand >> 4);
-        if( INVERTER_UPGRADE_EM57_MOTOR_WITH_110KW() )                   
-        {
-            torqueDemand = (torqueDemand * TORQUE_MULTIPLIER_110);
-        }              
-        if( INVERTER_UPGRADE_EM57_MOTOR_WITH_160KW() )
-        {
-          torqueDemand = (torqueDemand * TORQUE_MULTIPLIER_160);
-        }   
-        torqueDemand = (torqueDemand << 4); //Shift back the 4 removed bits 
-        frame.data[2] = torqueDemand >> 8; //Slap it back into whole 2nd frame
-        frame.data[3] = (torqueDemand & 0x00F0);       
-      }
-      calc_crc8(&frame); 
-    break;
-    #endif //#ifdef MESSAGE_0x1D4
-
-    #ifdef MESSAGE_0x1DA
-    case 0x1DA: //motor response also needs to be modified      
-      //torqueResponse = (int16_t) (((frame.data[2] & 0x07) << 8) | frame.data[3]);
-      //torqueResponse = (torqueResponse & 0b0000011111111111); //only take out 11bits, no need to shift
-        torqueResponse = (((frame.data[2] & 0x07) << 8) | frame.data[3]);
-        torqueResponse = (torqueResponse & 0x7FF); //only take out 11bits, no need to shift
-        
-        if (shift_state != SHIFT_DRIVE || eco_screen == ECO_ON) break; //Stop modifying message if: Not in drive OR ECO mode is ON
-
-        if (frame.data[2] & 0x04){ //We are Regen braking
-          #ifndef REGEN_TUNING_ENABLED
-          break; //We are demanding regen and regen tuning is not on, abort modification!
-          #endif
-          torqueResponse = (VCMtorqueDemand*0.5); //Fool VCM that response is exactly the same as demand
-          frame.data[2] = ((frame.data[2] & 0xF8) | (torqueResponse >> 8));
-          frame.data[3] = (torqueResponse & 0xFF);
-        }
-        else //We are requesting power in D (ECO OFF)
-        {
-          torqueResponse = (VCMtorqueDemand*0.5); //Fool VCM that response is exactly the same as demand        
-          frame.data[2] = ((frame.data[2] & 0xF8) | (torqueResponse >> 8));
-          frame.data[3] = (torqueResponse & 0xFF);
-        }
-
-        calc_crc8(&frame);
-        break;   
-        #endif //#ifdef MESSAGE_0x1DA
-
-    #ifdef MESSAGE_0x284
-    case 0x284: //Hacky way of generating missing inverter message 
-      //Upon reading VCM originating 0x284 every 20ms, send the missing message(s) to the inverter
-          if(charging_state == CHARGING_SLOW){
-              break; //abort all message modifications, otherwise we interrupt AC charging on 62kWh LEAFs
-        }
-  { //Start of function 0x284
-      ticker40ms++;
-      if(ticker40ms > 1)
-      {
-        ticker40ms = 0;
-          
-        if(can_bus == 1)
-        {
-         // buffer_send_can2(inv_355_message); //40ms
-        }
-        else
-        {
-          buffer_send_can1(inv_355_message); //40ms
-        }
-      }
-  }
-    break;
-    #endif //#ifdef MESSAGE_0x284
-
-    #ifdef MESSAGE_0x50C
-    case 0x50C: //Hacky way of generating missing inverter message 
-      //Upon reading VCM originating 0x50C every 100ms, send the missing message(s) to the inverter
-      //Eliminate the CheckEV light first
-        content_4B9++;
-        if(content_4B9 > 79)
-        {
-          content_4B9 = 64;
-        }
-        inv_4B9_message.data[0] = content_4B9; //64 - 79 (0x40 - 0x4F)
-
-        if(can_bus == 1)
-        {
-         // buffer_send_can2(inv_4B9_message); //100ms
-        }
-        else
-        {
-          buffer_send_can1(inv_4B9_message); //100ms
-        }
-        
-        if(charging_state == CHARGING_SLOW){
-          break; //abort all further message modifications, otherwise we interrupt AC charging on 62kWh LEAFs
-        }
-         
-      if(can_bus == 1)
-      {
-     //  buffer_send_can2(inv_4B9_message); //100ms
-      //  buffer_send_can2(inv_625_message); //100ms
-     //   buffer_send_can2(inv_5C5_message); //100ms
-      //  buffer_send_can2(inv_3B8_message); //100ms
-      } 
-      else 
-      {
-        buffer_send_can1(inv_4B9_message); //100ms
-        buffer_send_can1(inv_625_message); //100ms
-        buffer_send_can1(inv_5C5_message); //100ms
-        buffer_send_can1(inv_3B8_message); //100ms
-      }
-        
-      content_3B8++;
-      if(content_3B8 > 14)
-      {
-        content_3B8 = 0;
-      }
-      inv_3B8_message.data[2] = content_3B8; //0 - 14 (0x00 - 0x0E)
-        
-      if(flip_3B8)
-      {
-        flip_3B8 = 0;
-        inv_3B8_message.data[1] = 0xC8;
-      }
-      else
-      {
-        flip_3B8 = 1;
-        inv_3B8_message.data[1] = 0xE8;
+    if(demand < 0){ //Message is signed, we are requesting regen
+        #ifndef REGEN_TUNING_ENABLED
+      return; //We are demanding regen and regen tuning is not on, abort modification!
+      #endif
+      int16_t regen;
+      if(!TMAP_Apply(TMAP_REGEN, demand, vehicle_speed, &regen)){
+        regen = TSCALE_Torque12(demand, TSCALE_Get(TSCALE_REGEN));
       }
+      torqueDemand = TSCALE_Raw1D4(regen); //Signed 12-bit, saturated
               
-      ticker100ms++; //500ms messages go here
-      if(ticker100ms > 4)
+      leaf_patch_1D4(frame, regen);
+    }
+  else{
+    const live_config_t * cfg = LCFG_Get(); //one snapshot for the whole frame
+    bool upgraded = INVERTER_UPGRADE_EM57_MOTOR_WITH_110KW_IN(cfg) || INVERTER_UPGRADE_EM57_MOTOR_WITH_160KW_IN(cfg);
+    int16_t power;
+    //The power map tunes an upgraded inverter, the stock one always gets the VCM demand
+    if(!upgraded || !TMAP_Apply(TMAP_POWER, demand, vehicle_speed, &power)){
+      uint32_t multiplier = TSCALE_Q16_ONE;
+      if( INVERTER_UPGRADE_EM57_MOTOR_WITH_110KW_IN(cfg) )                   
       {
-        ticker100ms = 0;
-        if(can_bus == 1)
-        {
-        //  buffer_send_can2(inv_5EC_message); //500ms
-         // buffer_send_can2(inv_5EB_message); //500ms
-        }
-        else
-        {
-          buffer_send_can1(inv_5EC_message); //500ms
-          buffer_send_can1(inv_5EB_message); //500ms
-        }
-          
-          
-        if(flipFlop == 0)
-        {
-          flipFlop = 1;
-          inv_5CD_message.data[1] = content_5CD;
-          if(can_bus == 1)//1000ms messages alternating times
-          {
-            buffer_send_can2(inv_5CD_message); //1000ms
-          }
-          else
-          {
-            buffer_send_can1(inv_5CD_message); //1000ms
-          }
-          content_5CD = (content_5CD + 4);
-          if(content_5CD > 238)
-          {
-            content_5CD = 2;
-          }
-        }
-        else
-        {
-          flipFlop = 0;
-        }
-      }
-    break;
-    #endif //#ifdef MESSAGE_0x50C
+          multiplier = TSCALE_Get(TSCALE_POWER_110);
+      }              
+      if( INVERTER_UPGRADE_EM57_MOTOR_WITH_160KW_IN(cfg) )
+      {
+        multiplier = TSCALE_Get(TSCALE_POWER_160);
+      }   
+      power = TSCALE_Torque12(demand, multiplier);
+    }
+    torqueDemand = TSCALE_Raw1D4(power); //Shift back the 4 removed bits 
+    leaf_patch_1D4(frame, power);
+  }
+}
+#endif //#ifdef MESSAGE_0x1D4
 
-    #ifdef MESSAGE_0x1F2  
-    case 0x1F2: //Hacky way of generating missing inverter message
-      //Upon reading VCM originating 0x1F2 every 10ms, send the missing message(s) to the inverter
-        //charging_state = frame.data[2];
-        
-         //if(charging_state == CHARGING_SLOW){
-         // break; //abort all message modifications, otherwise we interrupt AC charging on 62kWh LEAFs
-         //} 
+#ifdef MESSAGE_0x1DA
+static void LEAF_Handle_0x1DA(uint8_t can_bus, can_frame_t &frame){ //motor response also needs to be modified      
+  //torqueResponse = (int16_t) (((frame.data[2] & 0x07) << 8) | frame.data[3]);
+  //torqueResponse = (torqueResponse & 0b0000011111111111); //only take out 11bits, no need to shift
+    torqueResponse = (uint16_t)SIG_Raw<LEAF_1DA_TORQUE>(frame.data); //only take out 11bits, no need to shift
+    
+    if (shift_state != SHIFT_DRIVE || eco_screen == ECO_ON) return; //Stop modifying message if: Not in drive OR ECO mode is ON
+
+    if (SIG_Get<LEAF_1DA_TORQUE>(frame.data) < 0){ //We are Regen braking
+      #ifndef REGEN_TUNING_ENABLED
+      return; //We are demanding regen and regen tuning is not on, abort modification!
+      #endif
+      torqueResponse = TSCALE_Raw<TSCALE_Q16(RESPONSE_MULTIPLIER)>(VCMtorqueDemand); //Fool VCM that response is exactly the same as demand
+      SIG_Patch<LEAF_1DA_TORQUE>(frame, torqueResponse);
+    }
+    else //We are requesting power in D (ECO OFF)
+    {
+      torqueResponse = TSCALE_Raw<TSCALE_Q16(RESPONSE_MULTIPLIER)>(VCMtorqueDemand); //Fool VCM that response is exactly the same as demand        
+      SIG_Patch<LEAF_1DA_TORQUE>(frame, torqueResponse);
+    }
+}
+#endif //#ifdef MESSAGE_0x1DA
+
+#ifdef MESSAGE_0x284
+static void LEAF_Handle_0x284(uint8_t can_bus, can_frame_t &frame){ //Hacky way of generating missing inverter message 
+  //Upon reading VCM originating 0x284 every 20ms, send the missing message(s) to the inverter
+  vehicle_speed = (uint16_t)((SIG_Raw<LEAF_284_SPEED>(frame.data) * 16U) / LEAF_284_SPEED::scale_den); //for the torque maps
+  #if (LEAF_SYNTH_MODE != SCHED_MODE_VCM_TRIGGERED)
+  SCHED_Sync(0x284, can_bus); //sent by the frame scheduler, only keep it in phase
+  return;
+  #endif
+      if(charging_state == CHARGING_SLOW){
+          return; //abort all message modifications, otherwise we interrupt AC charging on 62kWh LEAFs
+    }
+  ticker40ms++;
+  if(ticker40ms > 1)
+  {
+    ticker40ms = 0;
       
-      if(can_bus == 1)
-      {
-        buffer_send_can2(inv_1C2_message);
-        buffer_send_can2(inv_108_message);
-        buffer_send_can2(inv_1CB_message);
-        buffer_send_can2(inv_1ED_message);
-      }
-      else
-      {
-        buffer_send_can1(inv_1C2_message);
-        buffer_send_can1(inv_108_message);
-        buffer_send_can1(inv_1CB_message);
-        buffer_send_can1(inv_1ED_message);
-      }
+    if(can_bus == 1)
+    {
+     // buffer_send_can2(inv_355_message); //40ms
+    }
+    else
+    {
+      buffer_send_can1(inv_355_message); //40ms
+    }
+  }
+}
+#endif //#ifdef MESSAGE_0x284
+
+#ifdef MESSAGE_0x50C
+static void LEAF_Handle_0x50C(uint8_t can_bus, can_frame_t &frame){ //Hacky way of generating missing inverter message 
+  //Upon reading VCM originating 0x50C every 100ms, send the missing message(s) to the inverter
+  #if (LEAF_SYNTH_MODE != SCHED_MODE_VCM_TRIGGERED)
+  SCHED_Sync(0x50C, can_bus); //sent by the frame scheduler, only keep it in phase
+  return;
+  #endif
+  //Eliminate the CheckEV light first
+    leaf_next_4B9();
+
+    if(can_bus == 1)
+    {
+     // buffer_send_can2(inv_4B9_message); //100ms
+    }
+    else
+    {
+      buffer_send_can1(inv_4B9_message); //100ms
+    }
+    
+    if(charging_state == CHARGING_SLOW){
+      return; //abort all further message modifications, otherwise we interrupt AC charging on 62kWh LEAFs
+    }
+     
+  if(can_bus == 1)
+  {
+ //  buffer_send_can2(inv_4B9_message); //100ms
+  //  buffer_send_can2(inv_625_message); //100ms
+ //   buffer_send_can2(inv_5C5_message); //100ms
+  //  buffer_send_can2(inv_3B8_message); //100ms
+  } 
+  else 
+  {
+    buffer_send_can1(inv_4B9_message); //100ms
+    buffer_send_can1(inv_625_message); //100ms
+    buffer_send_can1(inv_5C5_message); //100ms
+    buffer_send_can1(inv_3B8_message); //100ms
+  }
+    
+  leaf_next_3B8();
+          
+  ticker100ms++; //500ms messages go here
+  if(ticker100ms > 4)
+  {
+    ticker100ms = 0;
+    if(can_bus == 1)
+    {
+    //  buffer_send_can2(inv_5EC_message); //500ms
+     // buffer_send_can2(inv_5EB_message); //500ms
+    }
+    else
+    {
+      buffer_send_can1(inv_5EC_message); //500ms
+      buffer_send_can1(inv_5EB_message); //500ms
+    }
       
-      PRUN10MS++;
-      if (PRUN10MS > 3){
-        PRUN10MS = 0;
-      }
       
-      if (PRUN10MS == 0)
-      {
-        inv_1CB_message.data[5] = 0x88;
-        inv_1CB_message.data[6] = 0xED;
-        inv_1ED_message.data[1] = 0xE0;
-        inv_1ED_message.data[2] = 0x68;
-      }
-      else if(PRUN10MS == 1)
+    if(flipFlop == 0)
+    {
+      flipFlop = 1;
+      leaf_next_5CD();
+      if(can_bus == 1)//1000ms messages alternating times
       {
-        inv_1CB_message.data[5] = 0x89;
-        inv_1CB_message.data[6] = 0x68;
-        inv_1ED_message.data[1] = 0xE1;
-        inv_1ED_message.data[2] = 0xED;
+        buffer_send_can2(inv_5CD_message); //1000ms
       }
-      else if(PRUN10MS == 2)
-      {
-        inv_1CB_message.data[5] = 0x8A;
-        inv_1CB_message.data[6] = 0x62;
-        inv_1ED_message.data[1] = 0xE2;
-        inv_1ED_message.data[2] = 0xE7;
-      }
-      else if(PRUN10MS == 3)
-      {
-        inv_1CB_message.data[5] = 0x8B;
-        inv_1CB_message.data[6] = 0xE7;
-        inv_1ED_message.data[1] = 0xE3;
-        inv_1ED_message.data[2] = 0x62;
-      }      
-            
-      content_1C2++;
-      if(content_1C2 > 95)
-      {
-        content_1C2 = 80;
-      }
-      
-      inv_1C2_message.data[0] = content_1C2; //80 - 95 (0x50 - 0x5F)
-      
-      content_108_1++;
-      if(content_108_1 > 0x0F)
+      else
       {
-        content_108_1 = 0;
+        buffer_send_can1(inv_5CD_message); //1000ms
       }
+    }
+    else
+    {
+      flipFlop = 0;
+    }
+  }
+}
+#endif //#ifdef MESSAGE_0x50C
+
+#ifdef MESSAGE_0x1F2  
+static void LEAF_Handle_0x1F2(uint8_t can_bus, can_frame_t &frame){ //Hacky way of generating missing inverter message
+  //Upon reading VCM originating 0x1F2 every 10ms, send the missing message(s) to the inverter
+  #if (LEAF_SYNTH_MODE != SCHED_MODE_VCM_TRIGGERED)
+  SCHED_Sync(0x1F2, can_bus); //sent by the frame scheduler, only keep it in phase
+  return;
+  #endif
+    //charging_state = frame.data[2];
+    
+     //if(charging_state == CHARGING_SLOW){
+     // return; //abort all message modifications, otherwise we interrupt AC charging on 62kWh LEAFs
+     //} 
+  
+  if(can_bus == 1)
+  {
+    buffer_send_can2(inv_1C2_message);
+    buffer_send_can2(inv_108_message);
+    buffer_send_can2(inv_1CB_message);
+    buffer_send_can2(inv_1ED_message);
+  }
+  else
+  {
+    buffer_send_can1(inv_1C2_message);
+    buffer_send_can1(inv_108_message);
+    buffer_send_can1(inv_1CB_message);
+    buffer_send_can1(inv_1ED_message);
+  }
+  
+  leaf_next_1F2_group();
+}
+#endif //#ifdef MESSAGE_0x1F2
+
+#ifdef MESSAGE_0x55B
+static void LEAF_Handle_0x55B(uint8_t can_bus, can_frame_t &frame){
+    //Collect SOC%
+    main_battery_soc = SIG_Raw<LEAF_55B_LB_SOC>(frame.data); 
+    main_battery_soc /= 10; //Remove decimals, 0-100 instead of 0-100.0
+}
+#endif //#ifdef MESSAGE_0x55B
+
+#ifdef MESSAGE_0x603  
+static void LEAF_Handle_0x603(uint8_t can_bus, can_frame_t &frame){
+  //Send new ZE1 wakeup messages, why not
+  if(can_bus == 1)
+  {
+   // buffer_send_can2(inv_605_message);
+   // buffer_send_can2(inv_607_message);
+  }
+  else
+  {
+    buffer_send_can1(inv_605_message);
+    buffer_send_can1(inv_607_message);
+  }
+}
+#endif //#ifdef MESSAGE_0x603
+
+#endif //#if defined(CAN_BRIDGE_FOR_LEAF) && defined(LEAF_TRANSLATION_ENABLED)
+
+//——————————————————————————————————————————————————————————————————————————————
+// [LEAF] CAN Bridge Initialization - builds the per-ID dispatch table
+//——————————————————————————————————————————————————————————————————————————————
+void LEAF_CAN_Bridge_Manager_Init(void)
+{
+  #ifdef CAN_BRIDGE_FOR_LEAF
+  memset(leaf_dispatch_index, LEAF_DISPATCH_NONE, sizeof(leaf_dispatch_index));
+  leaf_dispatch_chain_len = 1;
+
+  TSCALE_Set(TSCALE_POWER_110, TSCALE_Q16(TORQUE_MULTIPLIER_110));
+  TSCALE_Set(TSCALE_POWER_160, TSCALE_Q16(TORQUE_MULTIPLIER_160));
+  TSCALE_Set(TSCALE_REGEN, TSCALE_Q16(REGEN_MULTIPLIER));
+
+  #ifdef LEAF_TRANSLATION_ENABLED
+  #ifdef MESSAGE_0x11A
+  leaf_dispatch_register(0x11A, LEAF_Handle_0x11A);
+  #endif //#ifdef MESSAGE_0x11A
+  leaf_dispatch_register(0x1DB, LEAF_Handle_0x1DB);
+  #ifdef MESSAGE_0x1D4
+  leaf_dispatch_register(0x1D4, LEAF_Handle_0x1D4);
+  #endif //#ifdef MESSAGE_0x1D4
+  #ifdef MESSAGE_0x1DA
+  leaf_dispatch_register(0x1DA, LEAF_Handle_0x1DA);
+  #endif //#ifdef MESSAGE_0x1DA
+  #ifdef MESSAGE_0x284
+  leaf_dispatch_register(0x284, LEAF_Handle_0x284);
+  #endif //#ifdef MESSAGE_0x284
+  #ifdef MESSAGE_0x50C
+  leaf_dispatch_register(0x50C, LEAF_Handle_0x50C);
+  #endif //#ifdef MESSAGE_0x50C
+  #ifdef MESSAGE_0x1F2
+  leaf_dispatch_register(0x1F2, LEAF_Handle_0x1F2);
+  #endif //#ifdef MESSAGE_0x1F2
+  #ifdef MESSAGE_0x55B
+  leaf_dispatch_register(0x55B, LEAF_Handle_0x55B);
+  #endif //#ifdef MESSAGE_0x55B
+  #ifdef MESSAGE_0x603
+  leaf_dispatch_register(0x603, LEAF_Handle_0x603);
+  #endif //#ifdef MESSAGE_0x603
+  #endif //#ifdef LEAF_TRANSLATION_ENABLED
+
+  //--- Synthesized inverter messages on the timer, locked to the VCM frames that used to trigger them
+  //Free running has no VCM frame to route by: only the messages towards the inverter (CAN1)
+  #if defined(LEAF_TRANSLATION_ENABLED) && (LEAF_SYNTH_MODE != SCHED_MODE_VCM_TRIGGERED)
+  SCHED_Clear();
+  #ifdef MESSAGE_0x284
+  leaf_synth_add(&inv_355_message, buffer_send_can1, LEAF_SYNC_TO_CAN1,   40, 0x284,  20, leaf_synth_allowed, NULL);
+  #endif //#ifdef MESSAGE_0x284
+  #ifdef MESSAGE_0x50C
+  leaf_synth_add(&inv_4B9_message, buffer_send_can1, LEAF_SYNC_TO_CAN1,  100, 0x50C, 100, NULL,               leaf_next_4B9);
+  //The triggered handler sends 4B9 twice per 0x50C: ungated first, then again with the gated group
+  leaf_synth_add(&inv_4B9_message, buffer_send_can1, LEAF_SYNC_TO_CAN1,  100, 0x50C, 100, leaf_synth_allowed, NULL);
+  leaf_synth_add(&inv_625_message, buffer_send_can1, LEAF_SYNC_TO_CAN1,  100, 0x50C, 100, leaf_synth_allowed, NULL);
+  leaf_synth_add(&inv_5C5_message, buffer_send_can1, LEAF_SYNC_TO_CAN1,  100, 0x50C, 100, leaf_synth_allowed, NULL);
+  leaf_synth_add(&inv_3B8_message, buffer_send_can1, LEAF_SYNC_TO_CAN1,  100, 0x50C, 100, leaf_synth_allowed, leaf_next_3B8);
+  leaf_synth_add(&inv_5EC_message, buffer_send_can1, LEAF_SYNC_TO_CAN1,  500, 0x50C, 100, leaf_synth_allowed, NULL);
+  leaf_synth_add(&inv_5EB_message, buffer_send_can1, LEAF_SYNC_TO_CAN1,  500, 0x50C, 100, leaf_synth_allowed, NULL);
+  leaf_synth_add(&inv_5CD_message, buffer_send_can1, LEAF_SYNC_TO_CAN1, 1000, 0x50C, 100, leaf_synth_allowed, leaf_next_5CD);
+  #if (LEAF_SYNTH_MODE == SCHED_MODE_PHASE_LOCKED)
+  leaf_synth_add(&inv_5CD_message, buffer_send_can2, LEAF_SYNC_TO_CAN2, 1000, 0x50C, 100, leaf_synth_allowed, leaf_next_5CD);
+  #endif
+  #endif //#ifdef MESSAGE_0x50C
+  #ifdef MESSAGE_0x1F2
+  leaf_synth_add(&inv_1C2_message, buffer_send_can1, LEAF_SYNC_TO_CAN1,   10, 0x1F2,  10, NULL,               leaf_next_1F2_group);
+  leaf_synth_add(&inv_108_message, buffer_send_can1, LEAF_SYNC_TO_CAN1,   10, 0x1F2,  10, NULL,               NULL);
+  leaf_synth_add(&inv_1CB_message, buffer_send_can1, LEAF_SYNC_TO_CAN1,   10, 0x1F2,  10, NULL,               NULL);
+  leaf_synth_add(&inv_1ED_message, buffer_send_can1, LEAF_SYNC_TO_CAN1,   10, 0x1F2,  10, NULL,               NULL);
+  #if (LEAF_SYNTH_MODE == SCHED_MODE_PHASE_LOCKED)
+  leaf_synth_add(&inv_1C2_message, buffer_send_can2, LEAF_SYNC_TO_CAN2,   10, 0x1F2,  10, NULL,               leaf_next_1F2_group);
+  leaf_synth_add(&inv_108_message, buffer_send_can2, LEAF_SYNC_TO_CAN2,   10, 0x1F2,  10, NULL,               NULL);
+  leaf_synth_add(&inv_1CB_message, buffer_send_can2, LEAF_SYNC_TO_CAN2,   10, 0x1F2,  10, NULL,               NULL);
+  leaf_synth_add(&inv_1ED_message, buffer_send_can2, LEAF_SYNC_TO_CAN2,   10, 0x1F2,  10, NULL,               NULL);
+  #endif
+  #endif //#ifdef MESSAGE_0x1F2
+  #endif //LEAF_TRANSLATION_ENABLED && LEAF_SYNTH_MODE
+  #endif //#ifdef CAN_BRIDGE_FOR_LEAF
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// [LEAF] CAN Bridge Main Handler
+//——————————————————————————————————————————————————————————————————————————————
+#ifdef CAN_BRIDGE_FOR_LEAF
+void LEAF_CAN_Bridge_Manager(void){
+
+  //--- Monitor CAN0 & CAN1 receptions
+  #ifdef CAN_CH0_ENABLED
+  {
+    uint16_t ch0_budget = CAN_RX_DRAIN_BUDGET;
+
+    //Drain everything the driver has queued, bounded by the per-pass budget
+    while((ch0_budget > 0U) && (true == CAN0_NewFrameIsAvailable())) {
+      can_frame_t ch0_frame;
+      CAN0_ReadNewFrame(ch0_frame);
       
-      content_108_2 = lookuptable_crc_108[content_108_1];
+      BUSSTAT_Update(CAN_CHANNEL_0, ch0_frame);
+      #ifdef CRC_VALIDATION_ENABLED
+      CSUM_Validate(ch0_frame);
+      #endif //#ifdef CRC_VALIDATION_ENABLED
+
+      //Call CAN0 event handler
+      LEAF_CAN_Handler(CAN_CHANNEL_0, ch0_frame);
+      ch0_budget--;
+    }
+
+    if((ch0_budget == 0U) && (true == CAN0_NewFrameIsAvailable())) {
+      CAN_RxBudgetExhausted(CAN_CHANNEL_0);
+    }
+  }
+  #endif //CAN_CH0_ENABLED
+
+
+  #ifdef CAN_CH1_ENABLED
+  {
+    uint16_t ch1_budget = CAN_RX_DRAIN_BUDGET;
+
+    //Drain everything the driver has queued, bounded by the per-pass budget
+    while((ch1_budget > 0U) && (true == CAN1_NewFrameIsAvailable())) {
+      can_frame_t ch1_frame;
+      CAN1_ReadNewFrame(ch1_frame);
       
-      inv_108_message.data[1] = content_108_1;
-      inv_108_message.data[2] = content_108_2;
-     
-    break;
-    #endif //#ifdef MESSAGE_0x1F2
+      BUSSTAT_Update(CAN_CHANNEL_1, ch1_frame);
+      #ifdef CRC_VALIDATION_ENABLED
+      CSUM_Validate(ch1_frame);
+      #endif //#ifdef CRC_VALIDATION_ENABLED
+
+      //Call CAN1 event handler
+      LEAF_CAN_Handler(CAN_CHANNEL_1, ch1_frame);
+      ch1_budget--;
+    }
 
-    #ifdef MESSAGE_0x55B
-    case 0x55B:
-        //Collect SOC%
-        main_battery_soc = (frame.data[0] << 2) | ((frame.data[1] & 0xC0) >> 6); 
-        main_battery_soc /= 10; //Remove decimals, 0-100 instead of 0-100.0
-      break;
-      #endif //#ifdef MESSAGE_0x55B
-    
-    #ifdef MESSAGE_0x603  
-    case 0x603:
-      //Send new ZE1 wakeup messages, why not
-      if(can_bus == 1)
-      {
-       // buffer_send_can2(inv_605_message);
-       // buffer_send_can2(inv_607_message);
-      }
-      else
-      {
-        buffer_send_can1(inv_605_message);
-        buffer_send_can1(inv_607_message);
-      }
-    break;
-    #endif //#ifdef MESSAGE_0x603
-    
-    default:
-      break;
+    if((ch1_budget == 0U) && (true == CAN1_NewFrameIsAvailable())) {
+      CAN_RxBudgetExhausted(CAN_CHANNEL_1);
+    }
   }
+  #endif //CAN_CH1_ENABLED  
+
+  #ifdef CAN_CH2_ENABLED
+  {
+    uint16_t ch2_budget = CAN_RX_DRAIN_BUDGET;
+
+    //Frames queued by the CAN2 ISR, handled here in task context
+    //The handler works directly on the ring slot, which is released afterwards
+    can_frame_t * ch2_frame;
+    while((ch2_budget > 0U) && (NULL != (ch2_frame = CAN2_PeekFrame(NULL)))) {
+      BUSSTAT_Update(CAN_CHANNEL_2, *ch2_frame);
+      #ifdef CRC_VALIDATION_ENABLED
+      CSUM_Validate(*ch2_frame);
+      #endif //#ifdef CRC_VALIDATION_ENABLED
+
+      //Call CAN2 event handler
+      LEAF_CAN_Handler(CAN_CHANNEL_2, *ch2_frame);
+      CAN2_ReleaseFrame();
+      ch2_budget--;
+    }
+  }
+  #endif //CAN_CH2_ENABLED
+
+}
+#endif //#ifdef CAN_BRIDGE_FOR_LEAF
+
+//——————————————————————————————————————————————————————————————————————————————
+// [LEAF] CAN handler - evaluates received data, tranlate and transmits to the other CAN bus
+//——————————————————————————————————————————————————————————————————————————————
+#ifdef CAN_BRIDGE_FOR_LEAF
+void LEAF_CAN_Handler(uint8_t can_bus, can_frame_t &frame){  
   
+  //int16_t temp = 0;
+
+	//frame is translated in place, it is the caller's receive slot (no local copy)
+
+	//Debugging: binary record only, formatted later by the housekeeping task (see event_log.h)
+	EVENT_LOG(EVT_RX, can_bus, frame);
+
+	//Live values for the websocket telemetry, as sent by the ECUs (stored only, sent by the housekeeping task)
+	TELEM_Frame(frame);
+
+	//Raw copy for a sniffing websocket client, filtered here (one flag test while nobody sniffs)
+	SNIFF_Frame(can_bus, frame);
+
+	//Evaluate according to received ID: one indexed lookup, passthrough IDs have no handler chain
+	#ifdef LEAF_TRANSLATION_ENABLED    
+	if(frame.can_id < LEAF_DISPATCH_ID_COUNT){
+	  uint8_t link = leaf_dispatch_index[frame.can_id];
+	  while(LEAF_DISPATCH_NONE != link){
+	    leaf_dispatch_chain[link].handler(can_bus, frame);
+	    link = leaf_dispatch_chain[link].next;
+	  }
+	}
   #endif //#ifdef LEAF_TRANSLATION_ENABLED
 
   
@@ -608,9 +846,8 @@ void LEAF_CAN_Handler(uint8_t can_bus, can_frame_t new_rx_frame){
         buffer_send_can0(frame);
       }
       else{
-        #ifdef SERIAL_DEBUG_MONITOR
-        Serial.println("CAN Channel 1 is not used for gatewaying");
-        #endif //#ifdef SERIAL_DEBUG_MONITOR
+        //CAN Channel 1 is not used for gatewaying
+        EVENT_LOG(EVT_NO_ROUTE, can_bus, frame);
       }
     #elif defined (CAN_CH1_ENABLED) //Priority 2: Channel 1 with Channel 2
       if(CAN_CHANNEL_1 == can_bus){
@@ -619,9 +856,8 @@ void LEAF_CAN_Handler(uint8_t can_bus, can_frame_t new_rx_frame){
         buffer_send_can1(frame);
       }
       else{
-        #ifdef SERIAL_DEBUG_MONITOR
-        Serial.println("CAN Channel 0 is not used for gatewaying");
-        #endif //#ifdef SERIAL_DEBUG_MONITOR
+        //CAN Channel 0 is not used for gatewaying
+        EVENT_LOG(EVT_NO_ROUTE, can_bus, frame);
       }
     #else
       #error "CAN 0 or CAN 1 must be paired with CAN 2 for Gatewaying."
@@ -629,13 +865,6 @@ void LEAF_CAN_Handler(uint8_t can_bus, can_frame_t new_rx_frame){
     }
   }
   //--- End of Messages Gateway
-      
-  //Post processing for debugging
-  SID_to_str(strbuf + 2, frame.can_id);
-  canframe_to_str(strbuf + 6, frame);
-  #ifdef SERIAL_DEBUG_MONITOR
-  Serial.println(strbuf);
-  #endif //#ifdef SERIAL_DEBUG_MONITOR
 
 }
 #endif// CAN_BRIDGE_FOR_LEAF
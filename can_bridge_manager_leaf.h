@@ -27,7 +27,7 @@
 #if defined(CAN_BRIDGE_FOR_LEAF)
   void LEAF_CAN_Bridge_Manager_Init(void);
   void LEAF_CAN_Bridge_Manager(void);
-  void LEAF_CAN_Handler(uint8_t can_bus, can_frame_t new_rx_frame);
+  void LEAF_CAN_Handler(uint8_t can_bus, can_frame_t &frame);
 #endif
 
 #endif //CAN_BRIDGE_MANAGER_LEAF_H
@@ -13,6 +13,15 @@
 // 12.04.2022: Merging of Inverter Upgrade based on https://github.com/dalathegreat/Nissan-LEAF-Inverter-Upgrade/blob/main/can-bridge-inverter.c
 // 12.06.2022: Updated Charge Current logic - 1) Start conditions are charging state and fan speed; 2) Display kW for 15sec and revert to SOC
 // 12.31.2022: Fix charge current functions Fix regen power and motor power Fix Glide and drive add code 
+// 10.16.2026: Non-blocking CAN2 transmit so the application buffer can be drained in batches
+// 10.16.2026: MCP2515 TXB priorities follow the CAN ID class of the frame
+// 10.16.2026: MCP2515 reception statistics (driver queue full, RXnOVR, drain budget)
+// 10.16.2026: CAN2 ISR only queues the frame, handling is deferred to task context
+// 10.16.2026: CAN2 ISR wakes the bridge task
+// 10.16.2026: Frames passed by reference, CAN2 frames handled in place in the receive ring
+// 10.16.2026: Per-frame Serial prints removed (see event_log.h)
+// 10.16.2026: Received frames carry their interrupt ingress timestamp (can_frame_t.rx_cycles)
+// 10.17.2026: MCP2515 reads fill the can_frame_t of the caller, transmit takes the CANMessage by reference
 //——————————————————————————————————————————————————————————————————————————————
 
 //——————————————————————————————————————————————————————————————————————————————
@@ -35,6 +44,7 @@
 #include "can_bridge_manager_leaf.h"
 #include "can_bridge_manager_env200.h"
 #include "helper_functions.h"
+#include "spsc_ring.h"
 
 //——————————————————————————————————————————————————————————————————————————————
 // CAN communication using ESP32 and MCP2515 hardware and ACAN2515 Arduino library.
@@ -84,6 +94,16 @@ static const byte MCP2515_INT_CAN1  = 22; // INT output of MCP2515
 //——————————————————————————————————————————————————————————————————————————————
 static const uint32_t QUARTZ_FREQUENCY = 8UL * 1000UL * 1000UL ; // 8 MHz
 
+//——————————————————————————————————————————————————————————————————————————————
+// MCP2515 transmit buffers
+// TXB0 carries torque frames, TXB1 other control frames, TXB2 everything else (see direct_send_canX).
+// TXP priority bits: bits 1-0 TXB0, bits 3-2 TXB1, bits 5-4 TXB2 (3 = highest).
+// The driver queues in front of each TXB are kept short so that the ordering is decided by the
+// application priority buffer and not by a long FIFO inside the driver.
+//——————————————————————————————————————————————————————————————————————————————
+static const uint8_t  MCP2515_TXB_PRIORITY          = (1U << 4) | (2U << 2) | 3U ;
+static const uint16_t MCP2515_TX_DRIVER_QUEUE_SIZE  = 2 ;
+
 //——————————————————————————————————————————————————————————————————————————————
 //  MCP2515 Driver object
 //——————————————————————————————————————————————————————————————————————————————
@@ -98,9 +118,91 @@ SPIClass spi1;
 ACAN2515 can1 (MCP2515_CS_CAN1, spi1, MCP2515_INT_CAN1);
 #endif //CAN_CH1_ENABLED
 
+//——————————————————————————————————————————————————————————————————————————————
+//  MCP2515 Reception statistics (written by BridgeTask only)
+//——————————————————————————————————————————————————————————————————————————————
+#define MCP2515_EFLG_RX0OVR   0x40
+#define MCP2515_EFLG_RX1OVR   0x80
+
+//RX0OVR/RX1OVR stay set until cleared by the MCU, which ACAN2515 does not do
+#define MCP2515_SPI_BIT_MODIFY  0x05
+#define MCP2515_REG_EFLG        0x2D
+#define MCP2515_SPI_CLOCK       (10UL * 1000UL * 1000UL)  //as ACAN2515
+
+#ifdef CAN_CH0_ENABLED
+static can_rx_stats_t can0_rx_stats;
+#endif //CAN_CH0_ENABLED
+
+#ifdef CAN_CH1_ENABLED
+static can_rx_stats_t can1_rx_stats;
+#endif //CAN_CH1_ENABLED
+
+//——————————————————————————————————————————————————————————————————————————————
+//  MCP2515 ingress timestamps
+//——————————————————————————————————————————————————————————————————————————————
+// ACAN2515 moves frames from the controller into its receive queue in its own task, so the only
+// point where a frame can be timestamped is the INT edge. Each channel keeps the cycle counter of
+// the first interrupt not yet used by a frame; the next frame read takes it and clears it, so a
+// frame left in the queue by the drain budget never inherits the stamp of an earlier frame. Frames
+// that arrived on the same edge, or read without a pending stamp, are stamped on reading.
+// Transmit-complete interrupts share the INT line: their stamp is dropped when the queue is found
+// empty, unless a new interrupt has replaced it meanwhile.
+#ifdef CAN_CH0_ENABLED
+static std::atomic<uint32_t> can0_isr_cycles(0);
+#endif //CAN_CH0_ENABLED
+
+#ifdef CAN_CH1_ENABLED
+static std::atomic<uint32_t> can1_isr_cycles(0);
+#endif //CAN_CH1_ENABLED
+
+#if defined(CAN_CH0_ENABLED) || defined(CAN_CH1_ENABLED)
+//ISR: keep the oldest pending stamp
+static inline void mcp2515_stamp_ingress(std::atomic<uint32_t> &isr_cycles) {
+  uint32_t none = 0U;
+  (void)isr_cycles.compare_exchange_strong(none, CAN_RxStamp());
+}
+
+//Task: the stamp of the frame just read, consumed
+static inline uint32_t mcp2515_take_ingress(std::atomic<uint32_t> &isr_cycles) {
+  uint32_t stamp = isr_cycles.exchange(0U);
+  return (0U != stamp) ? stamp : CAN_RxStamp();
+}
+
+//Task: queue found empty, drop a stamp left by a transmit-complete interrupt. pending is the stamp
+//read before available(), an interrupt after that (a frame arriving) keeps its own stamp.
+static inline void mcp2515_drop_ingress(std::atomic<uint32_t> &isr_cycles, uint32_t pending) {
+  if(0U != pending) {
+    (void)isr_cycles.compare_exchange_strong(pending, 0U);
+  }
+}
+
+//ACAN2515 hands out CANMessage only: the one conversion of a received frame, straight into the caller's frame
+static inline void mcp2515_to_frame(const CANMessage &message, can_frame_t &frame) {
+  frame.can_id  = message.ext ? (message.id | CAN_EFF_FLAG) : message.id;
+  frame.can_dlc = (message.len > CAN_MAX_DLEN) ? CAN_MAX_DLEN : message.len;
+  memcpy(frame.data, message.data, CAN_MAX_DLEN);
+}
+#endif //CAN_CH0_ENABLED || CAN_CH1_ENABLED
+
 //——————————————————————————————————————————————————————————————————————————————
 //  CAN2 Variables
 //——————————————————————————————————————————————————————————————————————————————
+#ifdef CAN_CH2_ENABLED
+//Producer: CAN2_onReceive (ISR), consumer: LEAF_CAN_Bridge_Manager (task)
+//Each frame carries the cycle counter at ISR entry in rx_cycles
+static spsc_ring<can_frame_t, CAN2_RXBUFFER_SIZE> can2_rx_buffer;
+
+//ISR duration in CPU cycles, written by the ISR only
+static struct {
+  volatile uint32_t count;
+  volatile uint32_t last_cycles;
+  volatile uint32_t avg_cycles;   //moving average, 1/16 weight per sample
+  volatile uint32_t max_cycles;
+} can2_isr_stats;
+
+//Task woken by the ISR when a frame has been queued (the bridge task), NULL when nobody waits
+static TaskHandle_t can2_rx_notify_task = NULL;
+#endif //CAN_CH2_ENABLED
 
 //——————————————————————————————————————————————————————————————————————————————
 //  CAN Initialization
@@ -119,19 +221,33 @@ void CAN_Init(void) {
   //--- Configure CAN0 and CAN1 settings
   #ifdef CAN_CH0_ENABLED
   ACAN2515Settings can0_settings (QUARTZ_FREQUENCY, 500UL * 1000UL) ; // CAN bit rate 500 kb/s
+  can0_settings.mTXBPriority         = MCP2515_TXB_PRIORITY ;
+  can0_settings.mTransmitBuffer0Size = MCP2515_TX_DRIVER_QUEUE_SIZE ;
+  can0_settings.mTransmitBuffer1Size = MCP2515_TX_DRIVER_QUEUE_SIZE ;
+  can0_settings.mTransmitBuffer2Size = MCP2515_TX_DRIVER_QUEUE_SIZE ;
   #endif //CAN_CH0_ENABLED
 
   #ifdef CAN_CH1_ENABLED
   ACAN2515Settings can1_settings (QUARTZ_FREQUENCY, 500UL * 1000UL) ; // CAN bit rate 500 kb/s
+  can1_settings.mTXBPriority         = MCP2515_TXB_PRIORITY ;
+  can1_settings.mTransmitBuffer0Size = MCP2515_TX_DRIVER_QUEUE_SIZE ;
+  can1_settings.mTransmitBuffer1Size = MCP2515_TX_DRIVER_QUEUE_SIZE ;
+  can1_settings.mTransmitBuffer2Size = MCP2515_TX_DRIVER_QUEUE_SIZE ;
   #endif //CAN_CH0_ENABLED
   
   //--- Start CAN channels and report CAN parameters if successful
   #ifdef CAN_CH0_ENABLED
-  uint16_t errorCode0 = can0.begin (can0_settings, [] { can0.isr () ; }) ;
+  uint16_t errorCode0 = can0.begin (can0_settings, [] {
+    mcp2515_stamp_ingress(can0_isr_cycles);
+    can0.isr () ;
+  }) ;
   #endif //CAN_CH0_ENABLED
 
   #ifdef CAN_CH1_ENABLED
-  uint16_t errorCode1 = can1.begin (can1_settings, [] { can1.isr () ; }) ;
+  uint16_t errorCode1 = can1.begin (can1_settings, [] {
+    mcp2515_stamp_ingress(can1_isr_cycles);
+    can1.isr () ;
+  }) ;
   #endif //CAN_CH1_ENABLED
 
   #ifdef CAN_CH0_ENABLED
@@ -212,17 +328,9 @@ void CAN_Init(void) {
 //  CAN0 Transmission Routine
 //——————————————————————————————————————————————————————————————————————————————
 #ifdef CAN_CH0_ENABLED
-bool CAN0_Transmit(CANMessage frame) {
+bool CAN0_Transmit(const CANMessage &frame) {
+  //Success and controller-full are reported by the caller through the event log
   bool ok = can0.tryToSend (frame);    
-  if(ok) {
-    #ifdef SERIAL_DEBUG_MONITOR
-    Serial.print("CAN0 Transmission Succeeded");
-    #endif //#ifdef SERIAL_DEBUG_MONITOR
-  }else {
-    #ifdef SERIAL_DEBUG_MONITOR
-    Serial.println("CAN0 Transmission Failed");
-    #endif //#ifdef SERIAL_DEBUG_MONITOR 
-  }
 
   return ok;
 }
@@ -232,17 +340,9 @@ bool CAN0_Transmit(CANMessage frame) {
 //  CAN1 Transmission Routine
 //——————————————————————————————————————————————————————————————————————————————
 #ifdef CAN_CH1_ENABLED
-bool CAN1_Transmit(CANMessage frame) {
+bool CAN1_Transmit(const CANMessage &frame) {
+  //Success and controller-full are reported by the caller through the event log
   bool ok = can1.tryToSend (frame);    
-  if(ok) {
-    #ifdef SERIAL_DEBUG_MONITOR
-    Serial.print("CAN1 Transmission Succeeded");
-    #endif //#ifdef SERIAL_DEBUG_MONITOR
-  }else {
-    #ifdef SERIAL_DEBUG_MONITOR
-    Serial.println("CAN1 Transmission Failed");
-    #endif //#ifdef SERIAL_DEBUG_MONITOR
-  }
 
   return ok;
 }
@@ -253,13 +353,28 @@ bool CAN1_Transmit(CANMessage frame) {
 //——————————————————————————————————————————————————————————————————————————————
 #ifdef CAN_CH0_ENABLED
 bool CAN0_NewFrameIsAvailable(void) {
-  return (can0.available());
+  uint32_t pending = can0_isr_cycles.load();
+  bool available = can0.available();
+  if(!available) {
+    //Queue empty: the next interrupt starts a new ingress stamp
+    mcp2515_drop_ingress(can0_isr_cycles, pending);
+  }
+  return available;
 }
 #endif //CAN_CH0_ENABLED
 
 #ifdef CAN_CH0_ENABLED
-void CAN0_ReadNewFrame(CANMessage &frame){
-  (void)can0.receive(frame); 
+void CAN0_ReadNewFrame(can_frame_t &frame){
+  CANMessage message;
+
+  //A full driver queue means the ACAN2515 ISR had no room for the frames arriving meanwhile
+  if(can0.receiveBufferCount() >= can0.receiveBufferSize()) {
+    can0_rx_stats.queue_full++;
+  }
+  (void)can0.receive(message); 
+  can0_rx_stats.frames++;
+  mcp2515_to_frame(message, frame);
+  frame.rx_cycles = mcp2515_take_ingress(can0_isr_cycles);
 }
 #endif//CAN_CH0_ENABLED
 
@@ -268,16 +383,87 @@ void CAN0_ReadNewFrame(CANMessage &frame){
 //——————————————————————————————————————————————————————————————————————————————
 #ifdef CAN_CH1_ENABLED
 bool CAN1_NewFrameIsAvailable(void) {
-  return (can1.available());
+  uint32_t pending = can1_isr_cycles.load();
+  bool available = can1.available();
+  if(!available) {
+    //Queue empty: the next interrupt starts a new ingress stamp
+    mcp2515_drop_ingress(can1_isr_cycles, pending);
+  }
+  return available;
 }
 #endif //CAN_CH1_ENABLED
 
 #ifdef CAN_CH1_ENABLED
-void CAN1_ReadNewFrame(CANMessage &frame){
-  (void)can1.receive(frame); 
+void CAN1_ReadNewFrame(can_frame_t &frame){
+  CANMessage message;
+
+  //A full driver queue means the ACAN2515 ISR had no room for the frames arriving meanwhile
+  if(can1.receiveBufferCount() >= can1.receiveBufferSize()) {
+    can1_rx_stats.queue_full++;
+  }
+  (void)can1.receive(message); 
+  can1_rx_stats.frames++;
+  mcp2515_to_frame(message, frame);
+  frame.rx_cycles = mcp2515_take_ingress(can1_isr_cycles);
 }
 #endif //CAN_CH1_ENABLED
   
+//——————————————————————————————————————————————————————————————————————————————
+//  MCP2515 Reception Monitor (call periodically, reads EFLG over SPI)
+//——————————————————————————————————————————————————————————————————————————————
+// Clears the overflow flags after counting them, so that each count is an overflow since the
+// previous sample. The SPI transaction holds the bus lock, the ACAN2515 interrupt task waits.
+static void mcp2515_clear_rx_overflow(SPIClass &spi, uint8_t cs) {
+  spi.beginTransaction(SPISettings(MCP2515_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+  digitalWrite(cs, LOW);
+  spi.transfer(MCP2515_SPI_BIT_MODIFY);
+  spi.transfer(MCP2515_REG_EFLG);
+  spi.transfer(MCP2515_EFLG_RX0OVR | MCP2515_EFLG_RX1OVR);  //mask
+  spi.transfer(0x00);
+  digitalWrite(cs, HIGH);
+  spi.endTransaction();
+}
+
+void CAN_Rx_Monitor(void) {
+  #ifdef CAN_CH0_ENABLED
+  if(can0.errorFlagRegister() & (MCP2515_EFLG_RX0OVR | MCP2515_EFLG_RX1OVR)) {
+    can0_rx_stats.hw_overflow++;
+    mcp2515_clear_rx_overflow(spi0, MCP2515_CS_CAN0);
+  }
+  can0_rx_stats.queue_size = can0.receiveBufferSize();
+  can0_rx_stats.queue_peak = can0.receiveBufferPeakCount();
+  #endif //CAN_CH0_ENABLED
+
+  #ifdef CAN_CH1_ENABLED
+  if(can1.errorFlagRegister() & (MCP2515_EFLG_RX0OVR | MCP2515_EFLG_RX1OVR)) {
+    can1_rx_stats.hw_overflow++;
+    mcp2515_clear_rx_overflow(spi1, MCP2515_CS_CAN1);
+  }
+  can1_rx_stats.queue_size = can1.receiveBufferSize();
+  can1_rx_stats.queue_peak = can1.receiveBufferPeakCount();
+  #endif //CAN_CH1_ENABLED
+}
+
+void CAN_RxBudgetExhausted(uint8_t can_bus) {
+  #ifdef CAN_CH0_ENABLED
+  if(CAN_CHANNEL_0 == can_bus) { can0_rx_stats.budget_exhausted++; }
+  #endif //CAN_CH0_ENABLED
+  #ifdef CAN_CH1_ENABLED
+  if(CAN_CHANNEL_1 == can_bus) { can1_rx_stats.budget_exhausted++; }
+  #endif //CAN_CH1_ENABLED
+}
+
+bool CAN_GetRxStats(uint8_t can_bus, can_rx_stats_t * stats) {
+  bool ok = false;
+  #ifdef CAN_CH0_ENABLED
+  if(CAN_CHANNEL_0 == can_bus) { *stats = can0_rx_stats; ok = true; }
+  #endif //CAN_CH0_ENABLED
+  #ifdef CAN_CH1_ENABLED
+  if(CAN_CHANNEL_1 == can_bus) { *stats = can1_rx_stats; ok = true; }
+  #endif //CAN_CH1_ENABLED
+  return ok;
+}
+
 //——————————————————————————————————————————————————————————————————————————————
 //  Using ESP32 (SJA1000) Internal Bus Controller - Initialization 
 //——————————————————————————————————————————————————————————————————————————————
@@ -304,16 +490,21 @@ void CAN2_Init(void) {
 //——————————————————————————————————————————————————————————————————————————————
 //  Using ESP32 (SJA1000) Internal Bus Controller - Interrupt Service Routine
 //——————————————————————————————————————————————————————————————————————————————
+// The ISR only copies the frame and a cycle counter timestamp into can2_rx_buffer.
+// LEAF_CAN_Handler() runs later in task context (LEAF_CAN_Bridge_Manager), so the CRC/float
+// work and the transmit buffer pushes no longer block the timer and MCP2515 interrupts.
+//——————————————————————————————————————————————————————————————————————————————
 #ifdef CAN_CH2_ENABLED
 void CAN2_onReceive(int packetSize) {
+  uint32_t isr_start = ESP.getCycleCount();
+  uint32_t isr_cycles;
   unsigned int i = 0;
   can_frame_t rx_frame;
 
-  noInterrupts(); //disable interrupts
-  
   //Organize Received Message  
-  rx_frame.can_id  = CAN.packetId();
-  rx_frame.can_dlc = CAN.packetDlc();  
+  rx_frame.can_id    = CAN.packetExtended() ? (CAN.packetId() | CAN_EFF_FLAG) : CAN.packetId();
+  rx_frame.can_dlc   = CAN.packetDlc();  
+  rx_frame.rx_cycles = isr_start | 1U;  //see CAN_RxStamp()
     
   //Copy CAN buffer data to driver variable
   //Guard innfinite loop by checking counter i reaching to a not logical value
@@ -322,45 +513,132 @@ void CAN2_onReceive(int packetSize) {
     rx_frame.data[i++] = CAN.read();
   }
 
-  //Validate number of recection interrupts
-  if(i > 8){
-    #ifdef SERIAL_DEBUG_MONITOR
-    Serial.println("CAN2 Reception interruption is > 8");
-    #endif //#SERIAL_DEBUG_MONITOR
+  //Hand over to the task, a full buffer counts the frame as dropped
+  (void)can2_rx_buffer.push(rx_frame);
+  if(NULL != can2_rx_notify_task) {
+    BaseType_t task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(can2_rx_notify_task, &task_woken);
+    if(pdFALSE != task_woken) {
+      portYIELD_FROM_ISR();
+    }
+  }
+
+  //ISR duration statistics (single writer: this ISR)
+  isr_cycles = ESP.getCycleCount() - isr_start;
+  can2_isr_stats.count = can2_isr_stats.count + 1U;
+  can2_isr_stats.last_cycles = isr_cycles;
+  can2_isr_stats.avg_cycles = can2_isr_stats.avg_cycles + (((int32_t)(isr_cycles - can2_isr_stats.avg_cycles)) >> 4);
+  if(isr_cycles > can2_isr_stats.max_cycles) {
+    can2_isr_stats.max_cycles = isr_cycles;
   }
-  else {
-    //Push to CAN0/CAN1 Tx buffer
-    LEAF_CAN_Handler(CAN_CHANNEL_2, rx_frame);
+}
+#endif //CAN_CH2_ENABLED
+
+//——————————————————————————————————————————————————————————————————————————————
+//  CAN2 Reception Monitor (task context, single consumer of can2_rx_buffer)
+//——————————————————————————————————————————————————————————————————————————————
+#ifdef CAN_CH2_ENABLED
+void CAN2_SetRxNotifyTask(TaskHandle_t task) {
+  can2_rx_notify_task = task;
+}
+
+bool CAN2_NewFrameIsAvailable(void) {
+  return (!can2_rx_buffer.empty());
+}
+
+//Oldest queued frame, handled in place in its ring slot (NULL when empty).
+//The slot belongs to the caller until CAN2_ReleaseFrame().
+can_frame_t * CAN2_PeekFrame(uint32_t * timestamp) {
+  can_frame_t * rx_frame = can2_rx_buffer.front();
+  if(NULL == rx_frame) {
+    return NULL;
   }
-     
-  #ifdef SERIAL_DEBUG_MONITOR   
-   Serial.print("CAN2 Received:");
-   Serial.print(rx_frame.can_id, HEX);
-   Serial.print(" | ");
-   Serial.print(rx_frame.can_dlc, HEX);
-   Serial.print(" | "); 
-   
-   for(i = 0; i<rx_frame.can_dlc; i++) {
-    Serial.print(rx_frame.data[i], HEX);
-   }
-   Serial.println();
-  #endif // SERIAL_DEBUG_MONITOR 
-
-  interrupts(); //re-enable enterrupts
+  if(NULL != timestamp) {
+    *timestamp = rx_frame->rx_cycles;
+  }
+
+  return rx_frame;
+}
 
+void CAN2_ReleaseFrame(void) {
+  can2_rx_buffer.pop();
+}
+
+void CAN2_GetRxStats(can2_rx_stats_t * stats) {
+  stats->isr_count      = can2_isr_stats.count;
+  stats->isr_last_cycles = can2_isr_stats.last_cycles;
+  stats->isr_avg_cycles = can2_isr_stats.avg_cycles;
+  stats->isr_max_cycles = can2_isr_stats.max_cycles;
+  stats->queue_count    = can2_rx_buffer.count();
+  stats->queue_size     = can2_rx_buffer.capacity();
+  stats->queue_peak     = can2_rx_buffer.high_water;
+  stats->dropped        = can2_rx_buffer.dropped;
 }
 #endif //CAN_CH2_ENABLED
 //——————————————————————————————————————————————————————————————————————————————
 //  Using ESP32 (SJA1000) Internal Bus Controller - CAN Transmit Routine
 //——————————————————————————————————————————————————————————————————————————————
+// CAN.endPacket() busy-waits until the frame is on the bus (~250us at 500kbps), which allowed
+// only one frame per polling tick. The frame is therefore written straight into the SJA1000
+// transmit buffer and the call returns immediately; when the previous frame is still pending
+// the controller is reported as full and the frame stays in the application buffer.
+// Register map as used by arduino-CAN (ESP32SJA1000.cpp).
+//——————————————————————————————————————————————————————————————————————————————
 #ifdef CAN_CH2_ENABLED
-bool CAN2_Transmit(can_frame tx_frame){
-  bool ok = true;
-  CAN.beginPacket(tx_frame.can_id);
-  CAN.write(tx_frame.data, tx_frame.can_dlc);
-  CAN.endPacket();
+#define CAN2_REG_BASE     0x3ff6b000
+#define CAN2_REG_CMR      0x01
+#define CAN2_REG_SR       0x02
+#define CAN2_REG_ECC      0x0c
+#define CAN2_REG_SFF      0x10
+#define CAN2_REG_EFF      0x10
+#define CAN2_REG(addr)    (*(volatile uint32_t *)(CAN2_REG_BASE + ((addr) * 4)))
 
-  return ok;
+#define CAN2_CMR_TX_REQUEST   0x01
+#define CAN2_CMR_ABORT_TX     0x02
+#define CAN2_SR_TX_BUF_FREE   0x04
+#define CAN2_ECC_TX_ACK_ERROR 0xd9 //bit error in ACK slot while transmitting (nobody acknowledges)
+
+bool CAN2_Transmit(const can_frame_t &tx_frame){
+  uint8_t dlc = (tx_frame.can_dlc > CAN_MAX_DLEN) ? CAN_MAX_DLEN : tx_frame.can_dlc;
+  uint32_t id;
+  uint8_t i;
+
+  //Previous frame still pending: report full
+  if((CAN2_REG(CAN2_REG_SR) & CAN2_SR_TX_BUF_FREE) != CAN2_SR_TX_BUF_FREE){
+    //Same recovery as CAN.endPacket(): abort a frame that nobody acknowledges
+    if(CAN2_REG(CAN2_REG_ECC) == CAN2_ECC_TX_ACK_ERROR){
+      CAN2_REG(CAN2_REG_CMR) = CAN2_CMR_ABORT_TX;
+    }
+    return false;
+  }
+
+  if(0U != (tx_frame.can_id & CAN_EFF_FLAG)){
+    //Extended frame format: FF bit + DLC, ID28..21, ID20..13, ID12..5, ID4..0, data
+    id = tx_frame.can_id & CAN_EFF_MASK;
+    CAN2_REG(CAN2_REG_EFF)     = 0x80 | dlc;
+    CAN2_REG(CAN2_REG_EFF + 1) = (uint8_t)(id >> 21);
+    CAN2_REG(CAN2_REG_EFF + 2) = (uint8_t)(id >> 13);
+    CAN2_REG(CAN2_REG_EFF + 3) = (uint8_t)(id >> 5);
+    CAN2_REG(CAN2_REG_EFF + 4) = (uint8_t)(id << 3);
+    for(i = 0; i < dlc; i++) {
+      CAN2_REG(CAN2_REG_EFF + 5 + i) = tx_frame.data[i];
+    }
+  }
+  else{
+    //Standard frame format: DLC, ID10..3, ID2..0, data
+    id = tx_frame.can_id & CAN_SFF_MASK;
+    CAN2_REG(CAN2_REG_SFF)     = dlc;
+    CAN2_REG(CAN2_REG_SFF + 1) = (uint8_t)(id >> 3);
+    CAN2_REG(CAN2_REG_SFF + 2) = (uint8_t)(id << 5);
+    for(i = 0; i < dlc; i++) {
+      CAN2_REG(CAN2_REG_SFF + 3 + i) = tx_frame.data[i];
+    }
+  }
+
+  //Request transmission and return without waiting for completion
+  CAN2_REG(CAN2_REG_CMR) = CAN2_CMR_TX_REQUEST;
+
+  return true;
   
 }
 #endif //CAN_CH2_ENABLED
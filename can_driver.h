@@ -13,6 +13,7 @@
 // 12.04.2022: Merging of Inverter Upgrade based on https://github.com/dalathegreat/Nissan-LEAF-Inverter-Upgrade/blob/main/can-bridge-inverter.c
 // 12.06.2022: Updated Charge Current logic - 1) Start conditions are charging state and fan speed; 2) Display kW for 15sec and revert to SOC
 // 12.31.2022: Fix charge current functions Fix regen power and motor power Fix Glide and drive add code 
+// 10.16.2026: Received frames are stamped with the CPU cycle counter at interrupt ingress
 //——————————————————————————————————————————————————————————————————————————————
 
 //——————————————————————————————————————————————————————————————————————————————
@@ -30,24 +31,61 @@
 #include "canframe.h"
 #include "config.h"
 
+//Reception statistics of the MCP2515 channels
+typedef struct {
+  uint32_t frames;            //frames read from the driver
+  uint32_t budget_exhausted;  //drain passes stopped by CAN_RX_DRAIN_BUDGET with frames still pending
+  uint32_t queue_full;        //reads that found the driver receive queue full (newer frames may be lost)
+  uint32_t hw_overflow;       //monitor samples that found MCP2515 RX0OVR/RX1OVR set (cleared after each)
+  uint16_t queue_size;        //ACAN2515 receive queue size
+  uint16_t queue_peak;        //ACAN2515 receive queue peak fill level
+} can_rx_stats_t;
+
+//Reception statistics of the internal CAN2 controller
+typedef struct {
+  uint32_t isr_count;         //receive interrupts handled
+  uint32_t isr_last_cycles;   //duration of the last ISR in CPU cycles
+  uint32_t isr_avg_cycles;    //moving average ISR duration in CPU cycles
+  uint32_t isr_max_cycles;    //longest ISR in CPU cycles
+  uint32_t queue_count;       //frames waiting for the task
+  uint32_t queue_size;        //CAN2_RXBUFFER_SIZE
+  uint32_t queue_peak;        //highest fill level
+  uint32_t dropped;           //frames lost because the queue was full
+} can2_rx_stats_t;
+
+//Ingress timestamp for can_frame_t.rx_cycles. Never 0, which marks frames generated by the bridge.
+//The cycle counter is per core: the receive interrupts are attached from setup() and the transmit
+//side runs in BridgeTask, both on core 1. It wraps after ~17s at 240MHz, far above any bridge latency.
+static inline uint32_t CAN_RxStamp(void) {
+  return (ESP.getCycleCount() | 1U);
+}
+
 void CAN_Init(void);
+void CAN_Rx_Monitor(void);
+void CAN_RxBudgetExhausted(uint8_t can_bus);
+bool CAN_GetRxStats(uint8_t can_bus, can_rx_stats_t * stats);
 
 #ifdef CAN_CH0_ENABLED
-bool CAN0_Transmit(CANMessage frame);
+bool CAN0_Transmit(const CANMessage &frame);
 bool CAN0_NewFrameIsAvailable(void);
-void CAN0_ReadNewFrame(CANMessage &frame);
+void CAN0_ReadNewFrame(can_frame_t &frame);   //sets frame.rx_cycles
 #endif //CAN_CH0_ENABLED
 
 #ifdef CAN_CH1_ENABLED
-bool CAN1_Transmit(CANMessage frame);
+bool CAN1_Transmit(const CANMessage &frame);
 bool CAN1_NewFrameIsAvailable(void);
-void CAN1_ReadNewFrame(CANMessage &frame);
+void CAN1_ReadNewFrame(can_frame_t &frame);   //sets frame.rx_cycles
 #endif //CAN_CH1_ENABLED
 
 #ifdef CAN_CH2_ENABLED
 void CAN2_Init(void);
 void CAN2_onReceive(int packetSize);
-bool CAN2_Transmit(can_frame tx_frame);
+bool CAN2_Transmit(const can_frame_t &tx_frame);
+void CAN2_SetRxNotifyTask(TaskHandle_t task);
+bool CAN2_NewFrameIsAvailable(void);
+can_frame_t * CAN2_PeekFrame(uint32_t * timestamp);
+void CAN2_ReleaseFrame(void);
+void CAN2_GetRxStats(can2_rx_stats_t * stats);
 #endif //CAN_CH2_ENABLED
 
 #endif //CAN_DRIVER_H
@@ -0,0 +1,199 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: CAN signal codec, compile time signal descriptors with inlined extract/insert
+// 10.16.2026: Replaces the int bitfield structs of canframe.h (layout depended on the compiler)
+//——————————————————————————————————————————————————————————————————————————————
+// A signal is described as in a DBC file:
+//   start   Motorola (big endian): bit number of the MSB; Intel (little endian): of the LSB.
+//           Bit n is bit (n % 8) of data[n / 8], bit 0 being the least significant.
+//   length  1..32 bits
+//   sign    SIG_UNSIGNED or SIG_SIGNED (two's complement)
+//   scale   physical = raw * SCALE_NUM / SCALE_DEN + OFFSET (integers, the bridge works on raw)
+//
+// The descriptor is a type (sig_def<...>), so every function below sees it as constants: the
+// byte span, shifts and masks fold at compile time and an extract is the same handful of loads,
+// shifts and ands as the hand-written version. SIG_Extract/SIG_Insert take the same parameters
+// at runtime (host tests, tools).
+//
+// SIG_Patch() inserts into a CRC protected LEAF frame and patches data[7] per changed byte
+// (CSUM_SetByte) instead of recomputing the CRC.
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef CAN_SIGNAL_H
+#define CAN_SIGNAL_H
+
+#include <Arduino.h>
+#include "canframe.h"
+#include "checksum.h"
+
+#define SIG_MOTOROLA    0   //big endian, DBC @0
+#define SIG_INTEL       1   //little endian, DBC @1
+#define SIG_UNSIGNED    0
+#define SIG_SIGNED      1
+
+//——————————————————————————————————————————————————————————————————————————————
+// Layout: first/last payload byte of a signal and the position of its LSB in the last byte
+// (Motorola) or the first byte (Intel)
+//——————————————————————————————————————————————————————————————————————————————
+//Motorola: bit position counted from the MSB of data[0] (0..63)
+constexpr uint8_t SIG_MsbPos(uint8_t start){
+  return (uint8_t)(((start / 8U) * 8U) + (7U - (start % 8U)));
+}
+
+constexpr uint8_t SIG_FirstByte(uint8_t start, uint8_t length, uint8_t order){
+  return (uint8_t)(start / 8U);
+}
+
+constexpr uint8_t SIG_LastByte(uint8_t start, uint8_t length, uint8_t order){
+  return (SIG_MOTOROLA == order) ? (uint8_t)((SIG_MsbPos(start) + length - 1U) / 8U)
+                                 : (uint8_t)((start + length - 1U) / 8U);
+}
+
+constexpr uint8_t SIG_Shift(uint8_t start, uint8_t length, uint8_t order){
+  return (SIG_MOTOROLA == order) ? (uint8_t)(7U - ((SIG_MsbPos(start) + length - 1U) % 8U))
+                                 : (uint8_t)(start % 8U);
+}
+
+constexpr uint32_t SIG_Mask(uint8_t length){
+  return (length >= 32U) ? 0xFFFFFFFFUL : ((1UL << length) - 1UL);
+}
+
+constexpr bool SIG_Fits(uint8_t start, uint8_t length, uint8_t order){
+  return (start < 64U) && (length >= 1U) && (length <= 32U) && (SIG_LastByte(start, length, order) < CAN_MAX_DLEN);
+}
+
+//Bit position of bit 0 of data[index] inside the signal word (LSB of the signal = shift)
+static inline uint8_t sig_byte_pos(uint8_t index, uint8_t first, uint8_t last, uint8_t order){
+  return (uint8_t)(8U * ((SIG_MOTOROLA == order) ? (last - index) : (index - first)));
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Runtime codec (constant arguments fold after inlining)
+//——————————————————————————————————————————————————————————————————————————————
+static inline uint32_t SIG_Extract(const uint8_t * data, uint8_t start, uint8_t length, uint8_t order){
+  const uint8_t first = SIG_FirstByte(start, length, order);
+  const uint8_t last = SIG_LastByte(start, length, order);
+  const uint8_t shift = SIG_Shift(start, length, order);
+  uint32_t raw = 0;
+  uint8_t index;
+
+  for(index = first; index <= last; index++) {
+    uint8_t pos = sig_byte_pos(index, first, last, order);
+    raw |= (pos >= shift) ? ((uint32_t)data[index] << (pos - shift)) : ((uint32_t)data[index] >> shift);
+  }
+  return raw & SIG_Mask(length);
+}
+
+//Signed: the signal is assembled with its MSB at bit 31 and shifted down arithmetically, no
+//mask and separate sign extension. Every byte holds a bit of the signal, so no shift exceeds 31.
+static inline int32_t SIG_ExtractSigned(const uint8_t * data, uint8_t start, uint8_t length, uint8_t order){
+  const uint8_t first = SIG_FirstByte(start, length, order);
+  const uint8_t last = SIG_LastByte(start, length, order);
+  const uint8_t shift = SIG_Shift(start, length, order);
+  const uint8_t align = (uint8_t)(32U - length);
+  uint32_t word = 0;
+  uint8_t index;
+
+  for(index = first; index <= last; index++) {
+    uint8_t pos = (uint8_t)(sig_byte_pos(index, first, last, order) + align);
+    word |= (pos >= shift) ? ((uint32_t)data[index] << (pos - shift)) : ((uint32_t)data[index] >> (shift - pos));
+  }
+  return (int32_t)word >> align;
+}
+
+//data[index] with the bits of the signal replaced by raw (other bits kept)
+static inline uint8_t SIG_MergeByte(uint8_t old, uint8_t index, uint32_t raw, uint8_t start, uint8_t length, uint8_t order){
+  const uint8_t first = SIG_FirstByte(start, length, order);
+  const uint8_t last = SIG_LastByte(start, length, order);
+  const uint8_t shift = SIG_Shift(start, length, order);
+  const uint8_t pos = sig_byte_pos(index, first, last, order);
+  const uint32_t mask = SIG_Mask(length);
+  uint8_t bits;
+  uint8_t field;
+
+  raw &= mask;
+  if(pos >= shift) {
+    bits = (uint8_t)(mask >> (pos - shift));
+    field = (uint8_t)(raw >> (pos - shift));
+  } else {
+    bits = (uint8_t)(mask << shift);
+    field = (uint8_t)(raw << shift);
+  }
+  return (uint8_t)((old & (uint8_t)~bits) | field);
+}
+
+static inline void SIG_Insert(uint8_t * data, uint8_t start, uint8_t length, uint8_t order, uint32_t raw){
+  const uint8_t first = SIG_FirstByte(start, length, order);
+  const uint8_t last = SIG_LastByte(start, length, order);
+  uint8_t index;
+
+  for(index = first; index <= last; index++) {
+    data[index] = SIG_MergeByte(data[index], index, raw, start, length, order);
+  }
+}
+
+static inline int32_t SIG_SignExtend(uint32_t raw, uint8_t length){
+  return (int32_t)(raw << (32U - length)) >> (32U - length);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Descriptors
+//——————————————————————————————————————————————————————————————————————————————
+template <uint8_t START, uint8_t LENGTH, uint8_t ORDER = SIG_MOTOROLA, uint8_t SIGN = SIG_UNSIGNED,
+          int32_t SCALE_NUM = 1, int32_t SCALE_DEN = 1, int32_t OFFSET = 0>
+struct sig_def {
+  static_assert(SIG_Fits(START, LENGTH, ORDER), "signal does not fit into the 8 byte payload");
+  static_assert(SCALE_DEN != 0, "signal scale denominator is 0");
+
+  static constexpr uint8_t start = START;
+  static constexpr uint8_t length = LENGTH;
+  static constexpr uint8_t order = ORDER;
+  static constexpr uint8_t sign = SIGN;
+  static constexpr uint8_t first = SIG_FirstByte(START, LENGTH, ORDER);
+  static constexpr uint8_t last = SIG_LastByte(START, LENGTH, ORDER);
+  static constexpr int32_t scale_num = SCALE_NUM;
+  static constexpr int32_t scale_den = SCALE_DEN;
+  static constexpr int32_t offset = OFFSET;
+};
+
+//Unsigned raw bits
+template <class S>
+static inline uint32_t SIG_Raw(const uint8_t * data){
+  return SIG_Extract(data, S::start, S::length, S::order);
+}
+
+//Raw value, sign extended for signed signals
+template <class S>
+static inline int32_t SIG_Get(const uint8_t * data){
+  return (SIG_SIGNED == S::sign) ? SIG_ExtractSigned(data, S::start, S::length, S::order) : (int32_t)SIG_Raw<S>(data);
+}
+
+//Raw value (truncated to the signal length, no range check), other bits kept
+template <class S>
+static inline void SIG_Set(uint8_t * data, int32_t value){
+  SIG_Insert(data, S::start, S::length, S::order, (uint32_t)value);
+}
+
+//SIG_Set on a CRC protected frame (data[0..6]), data[7] patched for every byte rewritten
+template <class S>
+static inline void SIG_Patch(can_frame_t &frame, int32_t value){
+  static_assert(S::last < CSUM_CRC_BYTES, "signal overlaps the CRC byte");
+  uint8_t index;
+
+  for(index = S::first; index <= S::last; index++) {
+    CSUM_SetByte(frame, index, SIG_MergeByte(frame.data[index], index, (uint32_t)value, S::start, S::length, S::order));
+  }
+}
+
+//Raw to physical and back (web pages, logs; not for the per-frame path)
+template <class S>
+constexpr float SIG_ToPhys(int32_t raw){
+  return (((float)raw * (float)S::scale_num) / (float)S::scale_den) + (float)S::offset;
+}
+
+template <class S>
+constexpr int32_t SIG_FromPhys(float phys){
+  return (int32_t)((((phys - (float)S::offset) * (float)S::scale_den) / (float)S::scale_num) +
+                   ((phys >= (float)S::offset) ? 0.5f : -0.5f));
+}
+
+#endif //CAN_SIGNAL_H
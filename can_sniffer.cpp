@@ -0,0 +1,378 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Remote CAN sniffer, raw frames of all channels streamed in batches on the websocket
+// 10.16.2026: Replaces SERIAL_DEBUG_MONITOR at 115200 baud for looking at the traffic of a running bridge
+//——————————————————————————————————————————————————————————————————————————————
+
+#include "can_sniffer.h"
+#include "spsc_ring.h"
+
+typedef struct {
+  uint32_t pass[SNIFF_ID_COUNT / 32];   //bit per standard ID
+  uint8_t  channels;                    //bit per CAN channel
+  uint8_t  every;                       //keep one frame in 'every' per ID
+  bool     extended;                    //29-bit IDs pass (ids=all)
+} sniff_filter_t;
+
+std::atomic<bool> sniff_active(false);
+
+//Bridge task
+static sniff_filter_t sniff_filter;                 //written by SNIFF_Command() while sniff_active is false
+static uint8_t sniff_skip[SNIFF_ID_COUNT];          //frames left out since the last one kept, per ID
+static uint8_t sniff_skip_extended;
+static spsc_ring<sniff_record_t, SNIFF_RING_SIZE> sniff_ring;
+
+static portMUX_TYPE sniff_mux = portMUX_INITIALIZER_UNLOCKED;   //sniff_client, sniff_session, sniff_filter
+static uint32_t sniff_client = 0;
+static uint32_t sniff_session = 0;                  //bumped by every command, restarts the stream
+
+//Housekeeping task
+static uint8_t  sniff_message[SNIFF_MESSAGE_SIZE];
+static uint8_t  sniff_count = 0;                    //records in sniff_message
+static uint32_t sniff_batch_ms = 0;                 //first record of the batch taken from the ring
+static uint32_t sniff_sequence = 0;
+static uint32_t sniff_session_seen = 0;
+static uint32_t sniff_dropped_base = 0;             //sniff_ring.dropped at the command
+
+//——————————————————————————————————————————————————————————————————————————————
+// Bridge task
+//——————————————————————————————————————————————————————————————————————————————
+void SNIFF_Capture(uint8_t can_bus, const can_frame_t &frame){
+  sniff_record_t * record;
+  uint8_t * skip;
+  uint8_t count;
+
+  if((can_bus >= CAN_CHANNEL_COUNT) || (0U == (sniff_filter.channels & (1U << can_bus)))){
+    return;
+  }
+  if(frame.can_id < SNIFF_ID_COUNT){
+    if(0U == (sniff_filter.pass[frame.can_id >> 5] & (1UL << (frame.can_id & 31U)))){
+      return;
+    }
+    skip = &sniff_skip[frame.can_id];
+  }
+  else{
+    if(!sniff_filter.extended){
+      return;
+    }
+    skip = &sniff_skip_extended;
+  }
+
+  //Decimation per ID: the first frame of every run of 'every' is kept
+  count = *skip;
+  *skip = (((uint32_t)count + 1U) >= sniff_filter.every) ? 0U : (uint8_t)(count + 1U);
+  if(0U != count){
+    return;
+  }
+
+  record = sniff_ring.back();
+  if(NULL == record){
+    return;   //counted in sniff_ring.dropped, reported with the next message
+  }
+  record->time_us = micros();
+  record->can_id  = frame.can_id;
+  record->can_bus = can_bus;
+  record->can_dlc = frame.can_dlc;
+  memcpy(record->data, frame.data, CAN_MAX_DLEN);
+  sniff_ring.publish();
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Commands
+//——————————————————————————————————————————————————————————————————————————————
+static bool sniff_number(const char * text, size_t len, uint8_t base, uint32_t limit, uint32_t * value){
+  uint32_t digit;
+  size_t i;
+
+  *value = 0;
+  if((0U == len) || (len > 4U)){
+    return false;
+  }
+  for(i = 0; i < len; i++){
+    if(isDigit(text[i])){
+      digit = (uint32_t)(text[i] - '0');
+    }
+    else if((16U == base) && isHexadecimalDigit(text[i])){
+      digit = (uint32_t)((text[i] | 0x20) - 'a' + 10);
+    }
+    else{
+      return false;
+    }
+    *value = (*value * base) + digit;
+  }
+  return (*value <= limit);
+}
+
+static bool sniff_is(const char * text, size_t len, const char * word){
+  return (strlen(word) == len) && (0 == memcmp(text, word, len));
+}
+
+//"1D4,1DA,500-5FF"
+static bool sniff_parse_ids(const char * text, size_t len, sniff_filter_t * filter){
+  uint32_t first;
+  uint32_t last;
+  size_t pos = 0;
+  size_t end;
+  size_t dash;
+
+  memset(filter->pass, 0, sizeof(filter->pass));
+  filter->extended = false;
+  do {
+    end = pos;
+    while((end < len) && (text[end] != ',')){
+      end++;
+    }
+    dash = pos;
+    while((dash < end) && (text[dash] != '-')){
+      dash++;
+    }
+    if(!sniff_number(&text[pos], dash - pos, 16, SNIFF_ID_COUNT - 1U, &first)){
+      return false;
+    }
+    last = first;
+    if((dash < end) && !sniff_number(&text[dash + 1U], end - dash - 1U, 16, SNIFF_ID_COUNT - 1U, &last)){
+      return false;
+    }
+    if(last < first){
+      return false;
+    }
+    for(; first <= last; first++){
+      filter->pass[first >> 5] |= (1UL << (first & 31U));
+    }
+    pos = end + 1U;
+  } while(end < len);
+
+  return true;
+}
+
+//"0,2"
+static bool sniff_parse_bus(const char * text, size_t len, sniff_filter_t * filter){
+  uint32_t can_bus;
+  size_t pos = 0;
+  size_t end;
+
+  filter->channels = 0;
+  do {
+    end = pos;
+    while((end < len) && (text[end] != ',')){
+      end++;
+    }
+    if(!sniff_number(&text[pos], end - pos, 10, CAN_CHANNEL_COUNT - 1U, &can_bus)){
+      return false;
+    }
+    filter->channels |= (uint8_t)(1U << can_bus);
+    pos = end + 1U;
+  } while(end < len);
+
+  return true;
+}
+
+//"ids=...;bus=...;every=..." with every key optional
+static bool sniff_parse(const char * args, size_t len, sniff_filter_t * filter, char * reply, size_t reply_size){
+  const char * key;
+  const char * value;
+  size_t key_len;
+  size_t value_len;
+  size_t pos = 0;
+  size_t end;
+  uint32_t every;
+  bool ok;
+
+  memset(filter->pass, 0xFF, sizeof(filter->pass));
+  filter->channels = (uint8_t)((1U << CAN_CHANNEL_COUNT) - 1U);
+  filter->every = 1;
+  filter->extended = true;
+
+  while(pos < len){
+    end = pos;
+    while((end < len) && (args[end] != ';')){
+      end++;
+    }
+    key = &args[pos];
+    key_len = 0;
+    while(((pos + key_len) < end) && (key[key_len] != '=')){
+      key_len++;
+    }
+    value = &key[key_len + 1U];
+    value_len = ((pos + key_len) < end) ? (end - pos - key_len - 1U) : 0U;
+
+    if(0U == key_len){
+      ok = true;    //empty field, "ids=1D4;"
+    }
+    else if(sniff_is(key, key_len, "ids")){
+      if(sniff_is(value, value_len, "all")){
+        memset(filter->pass, 0xFF, sizeof(filter->pass));
+        filter->extended = true;
+        ok = true;
+      }
+      else{
+        ok = sniff_parse_ids(value, value_len, filter);
+      }
+    }
+    else if(sniff_is(key, key_len, "bus")){
+      ok = sniff_parse_bus(value, value_len, filter);
+    }
+    else if(sniff_is(key, key_len, "every")){
+      ok = sniff_number(value, value_len, 10, SNIFF_MAX_EVERY, &every) && (0U != every);
+      filter->every = (uint8_t)every;
+    }
+    else{
+      snprintf(reply, reply_size, "Fail: unknown key %.*s", (int)key_len, key);
+      return false;
+    }
+    if(!ok){
+      snprintf(reply, reply_size, "Fail: invalid %.*s", (int)key_len, key);
+      return false;
+    }
+    pos = end + 1U;
+  }
+  return true;
+}
+
+bool SNIFF_Command(uint32_t client_id, const char * args, size_t len, char * reply, size_t reply_size){
+  sniff_filter_t filter;
+  bool off = sniff_is(args, len, "off");
+  bool ok = true;
+
+  if(!off && !sniff_parse(args, len, &filter, reply, reply_size)){
+    return false;
+  }
+
+  portENTER_CRITICAL(&sniff_mux);
+  if((0U != sniff_client) && (sniff_client != client_id)){
+    ok = false;
+  }
+  else if(off){
+    if(sniff_client == client_id){
+      sniff_active.store(false, std::memory_order_relaxed);
+      sniff_client = 0;
+      sniff_session++;
+    }
+  }
+  else{
+    //A frame the bridge task is filtering right now may still see the previous filter
+    sniff_active.store(false, std::memory_order_relaxed);
+    sniff_filter = filter;
+    sniff_client = client_id;
+    sniff_session++;
+    sniff_active.store(true, std::memory_order_release);
+  }
+  portEXIT_CRITICAL(&sniff_mux);
+
+  snprintf(reply, reply_size, ok ? "OK" : "Fail: sniffer used by another client");
+  return ok;
+}
+
+void SNIFF_Stop(uint32_t client_id){
+  portENTER_CRITICAL(&sniff_mux);
+  if((0U != client_id) && (sniff_client == client_id)){
+    sniff_active.store(false, std::memory_order_relaxed);
+    sniff_client = 0;
+    sniff_session++;
+  }
+  portEXIT_CRITICAL(&sniff_mux);
+}
+
+uint32_t SNIFF_Client(void){
+  uint32_t client_id;
+
+  portENTER_CRITICAL(&sniff_mux);
+  client_id = sniff_client;
+  portEXIT_CRITICAL(&sniff_mux);
+  return client_id;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Housekeeping task
+//——————————————————————————————————————————————————————————————————————————————
+static telem_send_result_t sniff_flush(uint32_t client_id, telem_send_t send){
+  sniff_header_t * header = (sniff_header_t *)sniff_message;
+  telem_send_result_t result;
+
+  header->magic[0] = SNIFF_MAGIC0;
+  header->magic[1] = SNIFF_MAGIC1;
+  header->version  = SNIFF_VERSION;
+  header->count    = sniff_count;
+  header->sequence = sniff_sequence;
+  header->dropped  = sniff_ring.dropped - sniff_dropped_base;
+
+  //Not under sniff_mux: the transport may take its own locks
+  result = send(client_id, sniff_message, sizeof(sniff_header_t) + (sniff_count * sizeof(sniff_record_t)));
+  if(TELEM_SENT == result){
+    sniff_sequence++;
+    sniff_count = 0;
+  }
+  return result;
+}
+
+uint16_t SNIFF_Poll(uint32_t now_ms, telem_send_t send){
+  telem_send_result_t result = TELEM_SENT;
+  const sniff_record_t * record;
+  uint32_t client_id;
+  uint32_t session;
+  uint16_t sent = 0;
+  uint8_t count;
+
+  portENTER_CRITICAL(&sniff_mux);
+  client_id = sniff_client;
+  session = sniff_session;
+  portEXIT_CRITICAL(&sniff_mux);
+
+  //New command or stop: frames of the previous filter and the unsent batch are discarded
+  if(session != sniff_session_seen){
+    while(NULL != sniff_ring.front()){
+      sniff_ring.pop();
+    }
+    sniff_session_seen = session;
+    sniff_count = 0;
+    sniff_sequence = 0;
+    sniff_dropped_base = sniff_ring.dropped;
+  }
+  if(0U == client_id){
+    return 0;
+  }
+
+  //Full batches as long as the websocket takes them; a kept batch stops the draining
+  for(;;){
+    if(SNIFF_BATCH_RECORDS == sniff_count){
+      result = sniff_flush(client_id, send);
+      if(TELEM_SENT != result){
+        break;
+      }
+      sent += SNIFF_BATCH_RECORDS;
+    }
+    record = sniff_ring.front();
+    if(NULL == record){
+      break;
+    }
+    if(0U == sniff_count){
+      sniff_batch_ms = now_ms;
+    }
+    memcpy(&sniff_message[sizeof(sniff_header_t) + (sniff_count * sizeof(sniff_record_t))], record, sizeof(sniff_record_t));
+    sniff_ring.pop();
+    sniff_count++;
+  }
+
+  //Partial batch that waited long enough. A drop needs a full ring, whose frames carry the count.
+  if((TELEM_SENT == result) && (0U != sniff_count) && ((uint32_t)(now_ms - sniff_batch_ms) >= SNIFF_BATCH_MS)){
+    count = sniff_count;
+    result = sniff_flush(client_id, send);
+    if(TELEM_SENT == result){
+      sent += count;
+    }
+  }
+
+  if(TELEM_GONE == result){
+    SNIFF_Stop(client_id);
+  }
+  return sent;
+}
+
+void SNIFF_Reset(void){
+  portENTER_CRITICAL(&sniff_mux);
+  sniff_active.store(false, std::memory_order_relaxed);
+  sniff_client = 0;
+  sniff_session++;
+  portEXIT_CRITICAL(&sniff_mux);
+  memset(sniff_skip, 0, sizeof(sniff_skip));
+  sniff_skip_extended = 0;
+}
@@ -0,0 +1,85 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Remote CAN sniffer, raw frames of all channels streamed in batches on the websocket
+// 10.16.2026: Replaces SERIAL_DEBUG_MONITOR at 115200 baud for looking at the traffic of a running bridge
+//——————————————————————————————————————————————————————————————————————————————
+// One websocket client at a time owns the sniffer. Its ID filter, channel mask and decimation are
+// applied by the bridge task before anything is copied: a frame that does not pass costs a bit
+// test, and nothing at all is done while no client is sniffing (one atomic load). Frames that
+// pass are copied as sniff_record_t into a lock-free ring (spsc_ring.h).
+//
+// The housekeeping task calls SNIFF_Poll(): it drains the ring into one binary message of up to
+// SNIFF_BATCH_RECORDS records and sends it when full, or SNIFF_BATCH_MS after its first record.
+// When the websocket queue is full the batch is kept and the ring stops being drained; frames the
+// bridge task cannot store are counted, and sniff_header_t.dropped reports them with the next
+// message. A slow WiFi link thus loses frames, never delays the bridge.
+//
+// Websocket: "sniff" streams everything, "sniff ids=1D4,1DA,500-5FF;bus=0,2;every=4" streams the
+// listed IDs (hex, ranges) of channels 0 and 2, one frame in 4 per ID. Keys are optional (ids=all,
+// bus=all, every=1); ids=all also passes 29-bit IDs. "sniff off" stops. Each command restarts the
+// stream (sequence 0). Messages are binary, little endian: sniff_header_t, then count records.
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef CAN_SNIFFER_H
+#define CAN_SNIFFER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "canframe.h"
+#include "config.h"
+#include "telemetry.h"
+
+#define SNIFF_RING_SIZE       256   //frames between two housekeeping passes, power of two
+#define SNIFF_BATCH_RECORDS   64    //records per websocket message
+#define SNIFF_BATCH_MS        50    //a partial batch waits at most this long
+#define SNIFF_MAX_EVERY       255
+#define SNIFF_ID_COUNT        2048  //standard 11-bit IDs, one filter bit each
+#define SNIFF_REPLY_SIZE      48
+
+#define SNIFF_MAGIC0          'S'
+#define SNIFF_MAGIC1          'N'
+#define SNIFF_VERSION         1
+
+typedef struct __attribute__((packed)) {
+  uint8_t  magic[2];                      //"SN"
+  uint8_t  version;                       //SNIFF_VERSION
+  uint8_t  count;                         //records following the header
+  uint32_t sequence;                      //messages sent since the command
+  uint32_t dropped;                       //frames lost since the command (ring full)
+} sniff_header_t;
+
+typedef struct __attribute__((packed)) {
+  uint32_t time_us;                       //micros() when the bridge task received the frame
+  uint32_t can_id;                        //as can_frame_t, flags included
+  uint8_t  can_bus;                       //CAN_CHANNEL_x
+  uint8_t  can_dlc;
+  uint8_t  data[CAN_MAX_DLEN];
+} sniff_record_t;
+
+static_assert(sizeof(sniff_header_t) == 12, "sniff_header_t is sent as is");
+static_assert(sizeof(sniff_record_t) == 18, "sniff_record_t is sent as is");
+
+#define SNIFF_MESSAGE_SIZE    (sizeof(sniff_header_t) + (SNIFF_BATCH_RECORDS * sizeof(sniff_record_t)))
+
+extern std::atomic<bool> sniff_active;
+
+//Bridge task: filter and copy one received frame; use SNIFF_Frame()
+void SNIFF_Capture(uint8_t can_bus, const can_frame_t &frame);
+
+static inline void SNIFF_Frame(uint8_t can_bus, const can_frame_t &frame){
+  if(sniff_active.load(std::memory_order_acquire)){
+    SNIFF_Capture(can_bus, frame);
+  }
+}
+
+//Any task: "sniff" command arguments of a client; reply gets "OK" or "Fail: <reason>"
+bool SNIFF_Command(uint32_t client_id, const char * args, size_t len, char * reply, size_t reply_size);
+void SNIFF_Stop(uint32_t client_id);
+uint32_t SNIFF_Client(void);                //0: nobody sniffing
+
+//Housekeeping task: send the batches that are due, returns the records sent
+uint16_t SNIFF_Poll(uint32_t now_ms, telem_send_t send);
+
+//Stop and clear (host programs)
+void SNIFF_Reset(void);
+
+#endif //CAN_SNIFFER_H
@@ -0,0 +1,51 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: LEAF frame CRC-8 (poly 0x85) and inbound CRC/rolling counter validation
+// 10.16.2026: Table per byte position (full recompute without a dependency chain, byte delta update)
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <Arduino.h>
+#include "canframe.h"
+#include "config.h"
+
+#define CSUM_CRC_BYTES  7   //data[0..6] protected, CRC in data[7]
+
+//CRC-8 of a byte at data[position] with zero bytes everywhere else. The CRC (init 0, no final
+//xor) is linear, so the CRC of a frame is the xor of the entries of its 7 bytes and changing
+//one byte changes the CRC by the entry of (old ^ new). Row 6 is the classic byte-wise table.
+extern const uint8_t crc8_position_table[CSUM_CRC_BYTES][256];
+
+//Per-ID inbound validation counters
+typedef struct {
+  uint16_t can_id;
+  uint32_t frames;          //frames checked
+  uint32_t crc_errors;      //data[7] did not match the CRC of data[0..6]
+  uint32_t counter_skips;   //rolling counter values missing between two frames
+  uint32_t counter_repeats; //rolling counter did not advance
+} csum_stats_t;
+
+//CRC-8 of data[0..6]
+static inline uint8_t CSUM_Crc8(const uint8_t * data){
+  return crc8_position_table[0][data[0]] ^ crc8_position_table[1][data[1]] ^
+         crc8_position_table[2][data[2]] ^ crc8_position_table[3][data[3]] ^
+         crc8_position_table[4][data[4]] ^ crc8_position_table[5][data[5]] ^
+         crc8_position_table[6][data[6]];
+}
+
+//Rewrite one protected byte and patch the CRC in data[7] instead of recomputing it.
+//A frame that arrived with a bad CRC keeps a bad CRC, so the receiver still rejects it.
+static inline void CSUM_SetByte(can_frame_t &frame, uint8_t position, uint8_t value){
+  frame.data[7] ^= crc8_position_table[position][frame.data[position] ^ value];
+  frame.data[position] = value;
+}
+
+//Inbound validation (bridge task), see CSUM_CHECKED_IDS in checksum.cpp
+void CSUM_Init(void);
+void CSUM_Validate(const can_frame_t &frame);
+uint8_t CSUM_Count(void);
+bool CSUM_GetStats(uint8_t index, csum_stats_t * stats);
+void CSUM_ResetStats(void);
+
+#endif //CHECKSUM_H
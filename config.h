@@ -15,12 +15,15 @@
 // 12.04.2022: Merging of Inverter Upgrade based on https://github.com/dalathegreat/Nissan-LEAF-Inverter-Upgrade/blob/main/can-bridge-inverter.c
 // 12.06.2022: Updated Charge Current logic - 1) Start conditions are charging state and fan speed; 2) Display kW for 15sec and revert to SOC
 // 12.31.2022: Fix charge current functions Fix regen power and motor power Fix Glide and drive add code 
+// 10.16.2026: OTA setters take the code parsed by settings_parser.cpp, WebRequestProcessing() on a char buffer
+// 10.16.2026: OTA selections read from the live_config.h snapshot, _IN(cfg) forms for the bridge task
 //——————————————————————————————————————————————————————————————————————————————
 
 #ifndef CONFIG_H
 #define CONFIG_H
 
 #include <Arduino.h>
+#include "live_config.h"
 
 // Comment this out when module is used without Serial Port connected to avoid infinite loop during Serial initialization
 //#define SERIAL_DEBUG_MONITOR
@@ -28,6 +31,20 @@
 //#define DEBUG_WEB_PROCESSING
 //#define DEBUG_WEB_SOCKET
 
+// Binary event log of the bridge hot path (see event_log.h). The bridge task only stores fixed size
+// records, the housekeeping task formats them and prints them on the Serial debug monitor.
+// When commented out every EVENT_LOG() compiles to nothing.
+//#define EVENT_LOG_ENABLED
+#define EVENT_LOG_SIZE  256 //records, must be a power of two
+
+// Per-ID statistics of the received traffic (see bus_stats.h, served on /busstats).
+// Distinct CAN IDs tracked per channel, at most 255; a LEAF EV-CAN carries well under 100.
+#define BUS_STATS_MAX_IDS  128
+
+// Check the CRC-8 and rolling counter of the received CRC protected frames (see checksum.h, reported
+// on /diag). Frames are only counted, never dropped. Comment out to skip the check on the bridge task.
+#define CRC_VALIDATION_ENABLED
+
 //——————————————————————————————————————————————————————————————————————————————
 // Vehicle selection 
 // Requirement: Uncomment the target vehicle; Comment the unused vehicle.
@@ -46,6 +63,21 @@
 #define T_POLLING_VALUE_10MS    (10000) //10 millisecond
 
 #define T_POLLING               (T_POLLING_VALUE_100US)
+#define INTERVAL_1SEC           (1000000 / T_POLLING) //T_POLLING ticks per second
+
+//——————————————————————————————————————————————————————————————————————————————
+// Task Layout
+//——————————————————————————————————————————————————————————————————————————————
+//The bridge pipeline (reception -> handler -> transmit) runs in its own task on core 1, woken
+//by the T_POLLING timer and by the CAN2 ISR. WiFi and AsyncTCP live on core 0, together with
+//the housekeeping task (OTA, websocket cleanup, load report).
+#define BRIDGE_TASK_CORE              1
+#define BRIDGE_TASK_PRIORITY          20   //above every core 1 task except the ACAN2515 interrupt task
+#define BRIDGE_TASK_STACK_SIZE        4096
+#define HOUSEKEEPING_TASK_CORE        0
+#define HOUSEKEEPING_TASK_PRIORITY    1
+#define HOUSEKEEPING_TASK_STACK_SIZE  4096
+#define HOUSEKEEPING_TASK_PERIOD_MS   10
 
 //——————————————————————————————————————————————————————————————————————————————
 // LEAF Testing Conditions  
@@ -63,7 +95,38 @@
 //——————————————————————————————————————————————————————————————————————————————
 // Transmit Buffer Size
 //——————————————————————————————————————————————————————————————————————————————
-#define TXBUFFER_SIZE	32
+#define TXBUFFER_SIZE	32 //Must be a power of two (lock-free ring buffer)
+
+//Maximum number of frames handed to one controller per polling tick (T_POLLING).
+//The drain stops earlier when the controller reports that its transmit queue is full.
+//Set to 1 for the legacy behaviour of one frame per channel per tick (host/queue_bench compares both).
+#ifndef TX_DRAIN_BUDGET_PER_TICK
+#define TX_DRAIN_BUDGET_PER_TICK  8
+#endif
+
+//——————————————————————————————————————————————————————————————————————————————
+// Receive Drain Budget
+//——————————————————————————————————————————————————————————————————————————————
+//Maximum number of frames read from each MCP2515 channel per BridgeTask pass. A burst is drained
+//in one pass instead of one frame per pass; the bound keeps a flooded bus from starving the
+//synthesized frames and the transmit buffer drain of the same pass.
+#define CAN_RX_DRAIN_BUDGET       16
+
+//Frames queued by the CAN2 (SJA1000) ISR for the bridge task. Must be a power of two.
+#define CAN2_RXBUFFER_SIZE        32
+
+//——————————————————————————————————————————————————————————————————————————————
+// Synthesized Inverter Messages
+//——————————————————————————————————————————————————————————————————————————————
+//SCHED_MODE_VCM_TRIGGERED: default, sent from the handlers of 0x284/0x50C/0x1F2 when those VCM frames arrive
+//SCHED_MODE_FREE_RUNNING:  opt-in, sent by the timer (frame_scheduler.cpp) with a fixed period, VCM or not
+//SCHED_MODE_PHASE_LOCKED:  opt-in, sent by the timer, phase follows the VCM frames; gaps and jitter of the VCM
+//                          no longer reach the inverter, sending stops SCHED_SYNC_TIMEOUT_MS after the last VCM frame
+//host/synth_test runs the same scenario in all three modes (-DLEAF_SYNTH_MODE=...)
+#ifndef LEAF_SYNTH_MODE
+#define LEAF_SYNTH_MODE         SCHED_MODE_VCM_TRIGGERED
+#endif
+#define SCHED_SYNC_TIMEOUT_MS   500
 
 //——————————————————————————————————————————————————————————————————————————————
 // CAN Channel Assignments
@@ -71,6 +134,7 @@
 #define CAN_CHANNEL_0  (0U)
 #define CAN_CHANNEL_1  (1U)
 #define CAN_CHANNEL_2  (2U)
+#define CAN_CHANNEL_COUNT  (3U)
 
 //Port Enabling/Disabling
 //#define CAN_CH0_ENABLED
@@ -96,13 +160,23 @@
 //#define LEAF_2018				//Nissan Leaf 2017- (new exterior style, 40 or 60kWh battery)
 
 //---NEW--Choose from OTA configurable Vehicle Selections
-#define NISSAN_LEAF_2010_to_2019()    (Vehicle_Selection == Vehicle_Selection_Nissan_LEAF_2010_2019) //None will be removed
-#define NISSAN_ENV200()               (Vehicle_Selection == Vehicle_Selection_Nissan_ENV200) //Equals to #define E_NV_200     
-#define NISSAN_ZE0_2011_2012()        (Vehicle_Selection == Vehicle_Selection_ZE0_2011_2012) //Equals to #define LEAF_2011
-#define NISSAN_AZE0_2013_2017()       (Vehicle_Selection == Vehicle_Selection_AZE0_2013_2017) //Equals to #define LEAF_2014
-#define NISSAN_ZE1_2018_2022()        (Vehicle_Selection == Vehicle_Selection_ZE1_2018_2022) //Equals to #define LEAF_2018 
+//The _IN(cfg) forms test a snapshot the caller loaded once (LCFG_Get(), bridge task: once per frame);
+//the plain forms load the active snapshot themselves, for the web task and setup()
+#define NISSAN_LEAF_2010_to_2019_IN(cfg)  ((cfg)->vehicle == Vehicle_Selection_Nissan_LEAF_2010_2019)
+#define NISSAN_ENV200_IN(cfg)             ((cfg)->vehicle == Vehicle_Selection_Nissan_ENV200)
+#define NISSAN_ZE0_2011_2012_IN(cfg)      ((cfg)->vehicle == Vehicle_Selection_ZE0_2011_2012)
+#define NISSAN_AZE0_2013_2017_IN(cfg)     ((cfg)->vehicle == Vehicle_Selection_AZE0_2013_2017)
+#define NISSAN_ZE1_2018_2022_IN(cfg)      ((cfg)->vehicle == Vehicle_Selection_ZE1_2018_2022)
 
-#define NISSAN_LEAF_CONFIG()         ( NISSAN_LEAF_2010_to_2019() || NISSAN_ZE0_2011_2012() || NISSAN_AZE0_2013_2017() || NISSAN_ZE1_2018_2022() ) 
+#define NISSAN_LEAF_CONFIG_IN(cfg)        ( NISSAN_LEAF_2010_to_2019_IN(cfg) || NISSAN_ZE0_2011_2012_IN(cfg) || NISSAN_AZE0_2013_2017_IN(cfg) || NISSAN_ZE1_2018_2022_IN(cfg) )
+
+#define NISSAN_LEAF_2010_to_2019()    NISSAN_LEAF_2010_to_2019_IN(LCFG_Get()) //None will be removed
+#define NISSAN_ENV200()               NISSAN_ENV200_IN(LCFG_Get()) //Equals to #define E_NV_200     
+#define NISSAN_ZE0_2011_2012()        NISSAN_ZE0_2011_2012_IN(LCFG_Get()) //Equals to #define LEAF_2011
+#define NISSAN_AZE0_2013_2017()       NISSAN_AZE0_2013_2017_IN(LCFG_Get()) //Equals to #define LEAF_2014
+#define NISSAN_ZE1_2018_2022()        NISSAN_ZE1_2018_2022_IN(LCFG_Get()) //Equals to #define LEAF_2018 
+
+#define NISSAN_LEAF_CONFIG()         NISSAN_LEAF_CONFIG_IN(LCFG_Get())
 
 /* Choose the modification */
 
@@ -150,9 +224,13 @@
 //--------------------------------------
 // Inverter Upgrade 110Kw/160Kw
 //--------------------------------------
-#define INVERTER_UPGRADE_EM57_MOTOR_WITH_110KW()    (Inverter_Upgrade_110Kw_160Kw == Inverter_Upgrade_EM57_Motor_with_110Kw_inverter)
-#define INVERTER_UPGRADE_EM57_MOTOR_WITH_160KW()    (Inverter_Upgrade_110Kw_160Kw == Inverter_Upgrade_EM57_Motor_with_160Kw_Inverter)
-#define INVERTER_UPGRADE_DISABLED()                 (Inverter_Upgrade_110Kw_160Kw == Inverter_Upgrade_Disabled)
+#define INVERTER_UPGRADE_EM57_MOTOR_WITH_110KW_IN(cfg)  ((cfg)->inverter == Inverter_Upgrade_EM57_Motor_with_110Kw_inverter)
+#define INVERTER_UPGRADE_EM57_MOTOR_WITH_160KW_IN(cfg)  ((cfg)->inverter == Inverter_Upgrade_EM57_Motor_with_160Kw_Inverter)
+#define INVERTER_UPGRADE_DISABLED_IN(cfg)               ((cfg)->inverter == Inverter_Upgrade_Disabled)
+
+#define INVERTER_UPGRADE_EM57_MOTOR_WITH_110KW()    INVERTER_UPGRADE_EM57_MOTOR_WITH_110KW_IN(LCFG_Get())
+#define INVERTER_UPGRADE_EM57_MOTOR_WITH_160KW()    INVERTER_UPGRADE_EM57_MOTOR_WITH_160KW_IN(LCFG_Get())
+#define INVERTER_UPGRADE_DISABLED()                 INVERTER_UPGRADE_DISABLED_IN(LCFG_Get())
 
 #define INVERTER_UPGRADE_ENABLED()                  (INVERTER_UPGRADE_EM57_MOTOR_WITH_110KW() || INVERTER_UPGRADE_EM57_MOTOR_WITH_160KW())
 
@@ -188,26 +266,16 @@
 //--------------------------------------
 //  OTA API Defines and externs
 //--------------------------------------
-void Set_Vehicle_Selection(String setValue);
-extern uint8_t Vehicle_Selection;
-
-void Set_Inverter_Upgrade_110Kw_160Kw(String setValue);
-extern uint8_t Inverter_Upgrade_110Kw_160Kw;
-
-//void Set_Battery_Selection(String setValue);
-//extern uint8_t Battery_Selection;
-
-//void Set_Battery_Saver(String setValue);
-//extern uint8_t Battery_Saver;
-
-//void Set_Glide_In_Drive(String setValue);
-//extern uint8_t Glide_In_Drive;
-
-//void Set_Current_Control(String setValue);
-//extern uint8_t Current_Control;
-
-//Web Request Manager
-void WebRequestProcessing(const String data);
+//Setters change the config being built (cfg), WebRequestProcessing() publishes it once complete
+void Set_Vehicle_Selection(live_config_t * cfg, uint8_t setValue);
+void Set_Inverter_Upgrade_110Kw_160Kw(live_config_t * cfg, uint8_t setValue);
+//void Set_Battery_Selection(live_config_t * cfg, uint8_t setValue);
+//void Set_Battery_Saver(live_config_t * cfg, uint8_t setValue);
+//void Set_Glide_In_Drive(live_config_t * cfg, uint8_t setValue);
+//void Set_Current_Control(live_config_t * cfg, uint8_t setValue);
+
+//Web Request Manager: settings text (/settings body, websocket "set"), reply "OK" or "Fail: <first error>"
+bool WebRequestProcessing(const char * data, size_t len, char * reply, size_t reply_len);
 
 //--------------------------------------
 // Vehicle Selection
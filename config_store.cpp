@@ -0,0 +1,89 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Bridge settings stored as one versioned, CRC protected NVS blob with deferred writes
+// 10.16.2026: Replaces the per-setting Preferences keys (one NVS commit per key and form submit)
+//——————————————————————————————————————————————————————————————————————————————
+
+#include "config_store.h"
+
+static portMUX_TYPE cfg_mux = portMUX_INITIALIZER_UNLOCKED;
+static bool cfg_dirty = false;
+static uint32_t cfg_changed_ms = 0;
+
+//——————————————————————————————————————————————————————————————————————————————
+// CRC-32 (IEEE 802.3, reflected), bit by bit: a few hundred bytes at boot and per save
+//——————————————————————————————————————————————————————————————————————————————
+uint32_t CFG_Crc32(const void * data, size_t len){
+  const uint8_t * bytes = (const uint8_t *)data;
+  uint32_t crc = 0xFFFFFFFFUL;
+  uint8_t bit;
+
+  while(len--){
+    crc ^= *bytes++;
+    for(bit = 0; bit < 8; bit++){
+      crc = (crc >> 1) ^ ((crc & 1UL) ? 0xEDB88320UL : 0UL);
+    }
+  }
+  return ~crc;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Blob
+//——————————————————————————————————————————————————————————————————————————————
+void CFG_Defaults(cfg_blob_t * cfg){
+  //0 is the factory value of every selection (the former getUInt() defaults), no torque maps
+  memset(cfg, 0, sizeof(*cfg));
+}
+
+bool CFG_Load(const void * data, size_t len, cfg_blob_t * cfg){
+  uint8_t blob[CFG_BLOB_MAX];
+  cfg_header_t header;
+
+  CFG_Defaults(cfg);
+  if((len < sizeof(cfg_header_t)) || (len > sizeof(blob))){
+    return false;
+  }
+  memcpy(blob, data, len);
+  memcpy(&header, blob, sizeof(header));
+  if((0 == header.version) || (header.size != len)){
+    return false;
+  }
+  memset(&((cfg_header_t *)blob)->crc, 0, sizeof(header.crc));
+  if(CFG_Crc32(blob, len) != header.crc){
+    return false;
+  }
+
+  //Older: the fields it has over the defaults; newer: the fields this version knows
+  memcpy(cfg, blob, (len < sizeof(*cfg)) ? len : sizeof(*cfg));
+  cfg->header = header;
+  return true;
+}
+
+void CFG_Seal(cfg_blob_t * cfg){
+  cfg->header.version = CFG_VERSION;
+  cfg->header.reserved = 0;
+  cfg->header.size = (uint16_t)sizeof(*cfg);
+  cfg->header.crc = 0;
+  cfg->header.crc = CFG_Crc32(cfg, sizeof(*cfg));
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Deferred write
+//——————————————————————————————————————————————————————————————————————————————
+void CFG_MarkDirty(uint32_t now_ms){
+  portENTER_CRITICAL(&cfg_mux);
+  cfg_dirty = true;
+  cfg_changed_ms = now_ms;
+  portEXIT_CRITICAL(&cfg_mux);
+}
+
+bool CFG_SaveDue(uint32_t now_ms){
+  bool due;
+
+  portENTER_CRITICAL(&cfg_mux);
+  due = cfg_dirty && ((uint32_t)(now_ms - cfg_changed_ms) >= CFG_SAVE_DELAY_MS);
+  if(due){
+    cfg_dirty = false;
+  }
+  portEXIT_CRITICAL(&cfg_mux);
+  return due;
+}
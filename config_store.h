@@ -0,0 +1,69 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Bridge settings stored as one versioned, CRC protected NVS blob with deferred writes
+// 10.16.2026: Replaces the per-setting Preferences keys (one NVS commit per key and form submit)
+//——————————————————————————————————————————————————————————————————————————————
+// The blob holds every setting the bridge keeps across a reset: the OTA selections of config.h
+// and the torque/regen maps of torque_map.h. Boot reads it with a single getBytes().
+//
+// Schema: fields are only ever appended and CFG_VERSION is raised with every change. A blob of
+// an older version is copied over the defaults, so the fields it does not have yet take their
+// default; a newer blob (firmware downgrade) is read as far as this version knows it and left
+// in NVS as it is until a setting changes. The header records the size the writer used, the CRC-32 covers header and payload.
+// Version 0 is the former layout, one Preferences key per setting; the sketch converts it once
+// (PREF_Init) and removes the old keys.
+//
+// Writes: a setter changes the RAM copy and calls CFG_MarkDirty(). The housekeeping task asks
+// CFG_SaveDue() and commits the whole blob once CFG_SAVE_DELAY_MS after the last change, so a
+// form submit or a burst of websocket commands costs one NVS commit, never on the bridge core.
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <Arduino.h>
+#include "torque_map.h"
+
+#define CFG_VERSION           1
+#define CFG_SAVE_DELAY_MS     2000U     //quiet time after the last change before the commit
+#define CFG_PREF_KEY          "Config"
+#define CFG_BLOB_MAX          512U      //read buffer, newer versions up to this size are accepted
+
+typedef struct {
+  uint8_t  version;           //CFG_VERSION of the writer
+  uint8_t  reserved;
+  uint16_t size;              //sizeof(cfg_blob_t) of the writer
+  uint32_t crc;               //CRC-32 of the blob (size bytes) with crc = 0
+} cfg_header_t;
+
+//Version 1
+typedef struct {
+  cfg_header_t header;
+  uint8_t      vehicle;                   //Vehicle_Selection
+  uint8_t      inverter;                  //Inverter_Upgrade_110Kw_160Kw
+  uint8_t      battery;                   //Battery_Selection
+  uint8_t      battery_saver;             //Battery_Saver
+  uint8_t      glide;                     //Glide_In_Drive
+  uint8_t      current_control;           //Current_Control
+  uint8_t      reserved[2];
+  tmap_def_t   maps[TMAP_COUNT];          //nx = 0: no map, fixed multipliers
+} cfg_blob_t;
+
+static_assert(sizeof(cfg_blob_t) == (8 + 8 + (TMAP_COUNT * sizeof(tmap_def_t))), "cfg_blob_t is stored as is");
+static_assert(sizeof(cfg_blob_t) <= CFG_BLOB_MAX, "CFG_BLOB_MAX too small");
+
+uint32_t CFG_Crc32(const void * data, size_t len);
+
+//Factory settings (version, size and crc are set by CFG_Seal)
+void CFG_Defaults(cfg_blob_t * cfg);
+
+//Stored bytes to settings: false (cfg = defaults) when too short, corrupted or of version 0
+bool CFG_Load(const void * data, size_t len, cfg_blob_t * cfg);
+
+//Version, size and CRC before a write
+void CFG_Seal(cfg_blob_t * cfg);
+
+//Deferred write (any task); CFG_SaveDue() returns true once per quiet period, the caller commits
+void CFG_MarkDirty(uint32_t now_ms);
+bool CFG_SaveDue(uint32_t now_ms);
+
+#endif //CONFIG_STORE_H
@@ -0,0 +1,226 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Bridge diagnostics report (served on /diag)
+// 10.16.2026: Transmit buffer counters and queue wait time per CAN ID class
+// 10.16.2026: MCP2515 reception counters
+// 10.16.2026: CAN2 ISR duration and deferred queue counters
+// 10.16.2026: Per-task load and stack headroom
+// 10.16.2026: Event log counters
+// 10.16.2026: Synthesized message schedule and jitter
+// 10.16.2026: RX->TX latency per channel and per CAN ID class
+// 10.16.2026: Inbound CRC errors and rolling counter skips per CAN ID
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include "diagnostics.h"
+#include "can_bridge_manager_common.h"
+#include "can_driver.h"
+#include "latency_histogram.h"
+#include "task_monitor.h"
+#include "event_log.h"
+#include "frame_scheduler.h"
+#include "checksum.h"
+#include "config.h"
+
+static const char * const id_class_names[CAN_ID_CLASS_COUNT] = {"torque", "control", "status", "housekeeping"};
+
+//——————————————————————————————————————————————————————————————————————————————
+// Bounded append, output is truncated (never overflowed) when buf is too small
+//——————————————————————————————————————————————————————————————————————————————
+static void diag_append(char * buf, size_t len, size_t * pos, const char * fmt, ...){
+  va_list args;
+  int n;
+
+  if(*pos >= len){
+    return;
+  }
+  va_start(args, fmt);
+  n = vsnprintf(buf + *pos, len - *pos, fmt, args);
+  va_end(args);
+  if(n > 0){
+    *pos += (size_t)n;
+    if(*pos >= len){
+      *pos = len - 1;
+    }
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// One histogram: summary, with the log2 buckets when requested (see latency_histogram.h)
+//——————————————————————————————————————————————————————————————————————————————
+static void diag_append_hist(char * buf, size_t len, size_t * pos, const latency_hist_t * hist, bool buckets){
+  uint8_t i;
+  uint8_t last = 0;
+
+  diag_append(buf, len, pos, "\"count\":%lu,\"p50\":%lu,\"p99\":%lu,\"max\":%lu",
+              (unsigned long)hist->count, (unsigned long)HIST_Percentile(hist, 50),
+              (unsigned long)HIST_Percentile(hist, 99), (unsigned long)hist->max);
+  if(!buckets){
+    return;
+  }
+  //Trailing empty buckets are left out
+  for(i = 0; i < LATENCY_HIST_BUCKETS; i++){
+    if(hist->bucket[i] != 0U){
+      last = i + 1;
+    }
+  }
+  diag_append(buf, len, pos, ",\"buckets\":[");
+  for(i = 0; i < last; i++){
+    diag_append(buf, len, pos, "%s%lu", (i == 0) ? "" : ",", (unsigned long)hist->bucket[i]);
+  }
+  diag_append(buf, len, pos, "]");
+}
+
+static void diag_append_latency(char * buf, size_t len, size_t * pos, bool buckets){
+  uint8_t i;
+
+  diag_append(buf, len, pos, "\"rx_tx_us\":{\"channel\":[");
+  for(i = 0; i < CAN_CHANNEL_COUNT; i++){
+    diag_append(buf, len, pos, "%s{\"ch\":%u,", (i == 0) ? "" : ",", i);
+    diag_append_hist(buf, len, pos, buffer_get_latency_hist(i), buckets);
+    diag_append(buf, len, pos, "}");
+  }
+  diag_append(buf, len, pos, "],\"class\":[");
+  for(i = 0; i < CAN_ID_CLASS_COUNT; i++){
+    diag_append(buf, len, pos, "%s{\"class\":\"%s\",", (i == 0) ? "" : ",", id_class_names[i]);
+    diag_append_hist(buf, len, pos, buffer_get_class_latency_hist(i), buckets);
+    diag_append(buf, len, pos, "}");
+  }
+  diag_append(buf, len, pos, "]}");
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Build the JSON report, returns its length
+//——————————————————————————————————————————————————————————————————————————————
+size_t DIAG_BuildJson(char * buf, size_t len){
+  size_t pos = 0;
+  uint8_t i;
+  bool first;
+  tx_buffer_stats_t tx;
+  can_rx_stats_t rx;
+  task_stats_t task;
+  sched_stats_t sched;
+  csum_stats_t csum;
+  #ifdef EVENT_LOG_ENABLED
+  event_log_stats_t evlog;
+  #endif //EVENT_LOG_ENABLED
+  #ifdef CAN_CH2_ENABLED
+  can2_rx_stats_t rx2;
+  uint32_t cpu_mhz = ESP.getCpuFreqMHz();
+  #endif //CAN_CH2_ENABLED
+
+  if(len == 0){
+    return 0;
+  }
+  buf[0] = '\0';
+
+  diag_append(buf, len, &pos, "{\"tx_buffer\":[");
+  for(i = CAN_CHANNEL_0; i <= CAN_CHANNEL_2; i++){
+    if(buffer_get_stats(i, &tx)){
+      diag_append(buf, len, &pos, "%s{\"ch\":%u,\"count\":%lu,\"ring_high_water\":%lu,\"queued_high_water\":%lu,\"pushed\":%lu,\"dropped\":%lu}",
+                  (i == CAN_CHANNEL_0) ? "" : ",", i, (unsigned long)tx.count, (unsigned long)tx.ring_high_water,
+                  (unsigned long)tx.queued_high_water, (unsigned long)tx.pushed, (unsigned long)tx.dropped);
+    }
+  }
+
+  diag_append(buf, len, &pos, "],\"rx_driver\":[");
+  first = true;
+  for(i = CAN_CHANNEL_0; i <= CAN_CHANNEL_1; i++){
+    if(CAN_GetRxStats(i, &rx)){
+      diag_append(buf, len, &pos, "%s{\"ch\":%u,\"frames\":%lu,\"budget_exhausted\":%lu,\"queue_full\":%lu,\"hw_overflow\":%lu,\"queue_size\":%u,\"queue_peak\":%u}",
+                  first ? "" : ",", i,
+                  (unsigned long)rx.frames, (unsigned long)rx.budget_exhausted, (unsigned long)rx.queue_full, (unsigned long)rx.hw_overflow,
+                  rx.queue_size, rx.queue_peak);
+      first = false;
+    }
+  }
+
+  diag_append(buf, len, &pos, "]");
+
+  #ifdef CAN_CH2_ENABLED
+  //ISR durations are kept in CPU cycles, reported in microseconds
+  CAN2_GetRxStats(&rx2);
+  diag_append(buf, len, &pos, ",\"can2_isr\":{\"count\":%lu,\"last_us\":%lu,\"avg_us\":%lu,\"max_us\":%lu,\"queue_count\":%lu,\"queue_size\":%lu,\"queue_peak\":%lu,\"dropped\":%lu}",
+              (unsigned long)rx2.isr_count, (unsigned long)(rx2.isr_last_cycles / cpu_mhz),
+              (unsigned long)(rx2.isr_avg_cycles / cpu_mhz), (unsigned long)(rx2.isr_max_cycles / cpu_mhz),
+              (unsigned long)rx2.queue_count, (unsigned long)rx2.queue_size, (unsigned long)rx2.queue_peak, (unsigned long)rx2.dropped);
+  #endif //CAN_CH2_ENABLED
+
+  #ifdef EVENT_LOG_ENABLED
+  EVLOG_GetStats(&evlog);
+  diag_append(buf, len, &pos, ",\"event_log\":{\"written\":%lu,\"dropped\":%lu,\"count\":%lu}",
+              (unsigned long)evlog.written, (unsigned long)evlog.dropped, (unsigned long)evlog.count);
+  #endif //EVENT_LOG_ENABLED
+
+  diag_append(buf, len, &pos, ",\"tx_wait_us\":[");
+  for(i = 0; i < CAN_ID_CLASS_COUNT; i++){
+    const latency_hist_t * hist = buffer_get_wait_hist(i);
+    diag_append(buf, len, &pos, "%s{\"class\":\"%s\",\"count\":%lu,\"p50\":%lu,\"p99\":%lu,\"max\":%lu}",
+                (i == 0) ? "" : ",", id_class_names[i], (unsigned long)hist->count,
+                (unsigned long)HIST_Percentile(hist, 50), (unsigned long)HIST_Percentile(hist, 99), (unsigned long)hist->max);
+  }
+  diag_append(buf, len, &pos, "],");
+  diag_append_latency(buf, len, &pos, false);
+  diag_append(buf, len, &pos, ",\"tasks\":[");
+  first = true;
+  for(i = 0; i < TASK_ID_COUNT; i++){
+    if(TASKMON_Get(i, &task)){
+      diag_append(buf, len, &pos, "%s{\"name\":\"%s\",\"core\":%u,\"priority\":%u,\"runs\":%lu,\"load_permille\":%lu,\"max_pass_us\":%lu,\"stack_free\":%lu}",
+                  first ? "" : ",", task.name, task.core, task.priority, (unsigned long)task.runs,
+                  (unsigned long)task.load_permille, (unsigned long)task.max_pass_us, (unsigned long)task.stack_free);
+      first = false;
+    }
+  }
+  diag_append(buf, len, &pos, "],\"synth\":[");
+  for(i = 0; i < SCHED_Count(); i++){
+    if(SCHED_GetStats(i, &sched)){
+      diag_append(buf, len, &pos, "%s{\"id\":\"%03lX\",\"mode\":%u,\"period_ms\":%u,\"sent\":%lu,\"skipped\":%lu,\"avg_jitter_us\":%lu,\"max_jitter_us\":%lu}",
+                  (i == 0) ? "" : ",", (unsigned long)sched.can_id, sched.mode, sched.period_ms, (unsigned long)sched.sent,
+                  (unsigned long)sched.skipped, (unsigned long)sched.avg_jitter_us, (unsigned long)sched.max_jitter_us);
+    }
+  }
+  diag_append(buf, len, &pos, "],\"crc_check\":[");
+  for(i = 0; i < CSUM_Count(); i++){
+    if(CSUM_GetStats(i, &csum)){
+      diag_append(buf, len, &pos, "%s{\"id\":\"%03X\",\"frames\":%lu,\"crc_errors\":%lu,\"counter_skips\":%lu,\"counter_repeats\":%lu}",
+                  (i == 0) ? "" : ",", csum.can_id, (unsigned long)csum.frames, (unsigned long)csum.crc_errors,
+                  (unsigned long)csum.counter_skips, (unsigned long)csum.counter_repeats);
+    }
+  }
+  diag_append(buf, len, &pos, "]}");
+
+  return pos;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Restart the statistics that can be reset (histograms, maxima, synthesized frame counters)
+//——————————————————————————————————————————————————————————————————————————————
+void DIAG_Reset(void){
+  buffer_reset_wait_hist();
+  buffer_reset_latency_hist();
+  TASKMON_Reset();
+  SCHED_ResetStats();
+  CSUM_ResetStats();
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Latency report with the histogram buckets, returns its length
+//——————————————————————————————————————————————————————————————————————————————
+size_t DIAG_BuildLatencyJson(char * buf, size_t len){
+  size_t pos = 0;
+
+  if(len == 0){
+    return 0;
+  }
+  buf[0] = '\0';
+
+  diag_append(buf, len, &pos, "{");
+  diag_append_latency(buf, len, &pos, true);
+  diag_append(buf, len, &pos, "}");
+
+  return pos;
+}
+
+void DIAG_ResetLatency(void){
+  buffer_reset_latency_hist();
+}
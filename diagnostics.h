@@ -0,0 +1,23 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Bridge diagnostics report (served on /diag)
+// 10.16.2026: Transmit buffer counters and queue wait time per CAN ID class
+// 10.16.2026: MCP2515 reception counters
+// 10.16.2026: Synthesized message jitter, report size 4096
+// 10.16.2026: RX->TX latency histograms, also as a separate report (/latency, websocket "latency")
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <Arduino.h>
+
+#define DIAG_JSON_SIZE          4096
+#define DIAG_LATENCY_JSON_SIZE  2048
+
+size_t DIAG_BuildJson(char * buf, size_t len);
+void DIAG_Reset(void);
+
+size_t DIAG_BuildLatencyJson(char * buf, size_t len);
+void DIAG_ResetLatency(void);
+
+#endif //DIAGNOSTICS_H
@@ -0,0 +1,90 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Binary event log of the bridge hot path
+// 10.16.2026: Replaces per-frame string formatting and Serial prints in the CAN path
+// 10.17.2026: Whole can_id with CAN_EFF_FLAG, 29-bit identifiers printed with 8 digits
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include "event_log.h"
+#include "can_bridge_manager_common.h"
+#include "helper_functions.h"
+#include "spsc_ring.h"
+
+#ifdef EVENT_LOG_ENABLED
+
+//Producer: bridge task (EVENT_LOG), consumer: housekeeping task (EVLOG_Drain)
+static spsc_ring<event_record_t, EVENT_LOG_SIZE> event_log;
+
+static const char * const event_names[] = {"?", "RX", "TXQ", "OVF", "TX", "BUSY", "NORT"};
+
+//——————————————————————————————————————————————————————————————————————————————
+// Store one record (hot path: no formatting, a full log drops the new record)
+//——————————————————————————————————————————————————————————————————————————————
+void EVLOG_Write(uint8_t event, uint8_t can_bus, const can_frame_t &frame){
+  event_record_t * record = event_log.back();
+
+  if(NULL == record){
+    return;
+  }
+  record->timestamp_us = micros();
+  record->can_id       = frame.can_id;
+  record->can_bus      = can_bus;
+  record->event        = event;
+  record->can_dlc      = frame.can_dlc;
+  memcpy(record->data, frame.data, CAN_MAX_DLEN);
+  event_log.publish();
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Format and print up to max_records records, returns the number printed
+// Line format: "<timestamp us> <event> <can_bus>|<ID>|<data>", same fields as the former strbuf output;
+// the ID has 3 hex digits, 8 for an extended (29-bit) frame
+//——————————————————————————————————————————————————————————————————————————————
+uint16_t EVLOG_Drain(Print &out, uint16_t max_records){
+  uint16_t printed = 0;
+  event_record_t * record;
+  can_frame_t frame;
+
+  while((printed < max_records) && (NULL != (record = event_log.front()))){
+    char strbuf[] = "0|        |                ";
+    uint8_t dlc = (record->can_dlc <= CAN_MAX_DLEN) ? record->can_dlc : CAN_MAX_DLEN;
+    uint8_t data_pos;
+
+    frame.can_id  = record->can_id;
+    frame.can_dlc = dlc;
+    memcpy(frame.data, record->data, CAN_MAX_DLEN);
+
+    strbuf[0] = '0' + record->can_bus;
+    if(frame.can_id & CAN_EFF_FLAG){
+      uint32_to_str(strbuf + 2, frame.can_id);
+      data_pos = 11;
+    }else{
+      SID_to_str(strbuf + 2, frame.can_id);
+      data_pos = 6;
+    }
+    strbuf[data_pos - 1] = '|';
+    canframe_to_str(strbuf + data_pos, frame);
+    strbuf[data_pos + (2 * dlc)] = '\0';
+
+    out.print(record->timestamp_us);
+    out.print(' ');
+    out.print((record->event < (sizeof(event_names) / sizeof(event_names[0]))) ? event_names[record->event] : event_names[0]);
+    out.print(' ');
+    out.println(strbuf);
+
+    event_log.pop();
+    printed++;
+  }
+  return printed;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Counters for the diagnostics report
+//——————————————————————————————————————————————————————————————————————————————
+void EVLOG_GetStats(event_log_stats_t * stats){
+  stats->written = event_log.pushed;
+  stats->dropped = event_log.dropped;
+  stats->count   = event_log.count();
+}
+
+#endif //EVENT_LOG_ENABLED
@@ -0,0 +1,51 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Binary event log of the bridge hot path
+// 10.16.2026: Replaces per-frame string formatting and Serial prints in the CAN path
+// 10.17.2026: Whole can_id with CAN_EFF_FLAG, 29-bit identifiers printed with 8 digits
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <Arduino.h>
+#include "canframe.h"
+#include "config.h"
+
+//Event codes
+#define EVT_RX              (1U)  //frame received, before translation
+#define EVT_TX_QUEUED       (2U)  //frame pushed to the application transmit buffer of can_bus
+#define EVT_TX_OVERFLOW     (3U)  //application transmit buffer full, frame dropped
+#define EVT_TX_SENT         (4U)  //frame handed to the controller
+#define EVT_TX_NOT_READY    (5U)  //controller full, frame stays queued
+#define EVT_NO_ROUTE        (6U)  //received on a channel that is not gatewayed
+
+//Fixed size record, formatting is left to the consumer
+typedef struct {
+  uint32_t timestamp_us;
+  uint32_t can_id;     //as in can_frame_t, CAN_EFF_FLAG kept
+  uint8_t  can_bus;
+  uint8_t  event;
+  uint8_t  can_dlc;
+  uint8_t  data[CAN_MAX_DLEN];
+} event_record_t;
+
+typedef struct {
+  uint32_t written;
+  uint32_t dropped;   //records lost because the log was full
+  uint32_t count;     //records waiting for the consumer
+} event_log_stats_t;
+
+//Producer: the bridge task only. When EVENT_LOG_ENABLED is not defined the arguments are not evaluated.
+#ifdef EVENT_LOG_ENABLED
+  #define EVENT_LOG(event, can_bus, frame)  EVLOG_Write((event), (can_bus), (frame))
+#else
+  #define EVENT_LOG(event, can_bus, frame)  do {} while(0)
+#endif //EVENT_LOG_ENABLED
+
+#ifdef EVENT_LOG_ENABLED
+void EVLOG_Write(uint8_t event, uint8_t can_bus, const can_frame_t &frame);
+uint16_t EVLOG_Drain(Print &out, uint16_t max_records);
+void EVLOG_GetStats(event_log_stats_t * stats);
+#endif //EVENT_LOG_ENABLED
+
+#endif //EVENT_LOG_H
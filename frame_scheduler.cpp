@@ -0,0 +1,260 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Timer driven scheduler for periodic (synthesized) CAN frames
+// 10.16.2026: Timing wheel with per-message period/phase, VCM phase lock and jitter statistics
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include "frame_scheduler.h"
+
+//——————————————————————————————————————————————————————————————————————————————
+// Hashed timing wheel with 1ms slots. A message due at sched_now_ms == due_ms sits in slot
+// (due_ms & (SCHED_WHEEL_SLOTS - 1)); each slot is visited once per wheel turn and only fires
+// the entries that are due, so periods longer than one turn simply wait for later turns.
+// All calls come from the bridge task (SCHED_Tick on the T_POLLING tick, SCHED_Sync from the
+// frame handlers); the statistics are read by the web server on the other core.
+//——————————————————————————————————————————————————————————————————————————————
+#define SCHED_NONE  (0xFFU)
+
+typedef struct {
+  sched_msg_config_t config;
+  uint32_t           due_ms;
+  uint8_t            next;            //next entry in the same wheel slot
+  bool               synced;          //phase locked: VCM frame seen at least once
+  uint32_t           last_sync_ms;
+  uint32_t           last_sent_us;
+  volatile uint32_t  sent;
+  volatile uint32_t  skipped;
+  volatile uint32_t  avg_jitter_us;
+  volatile uint32_t  max_jitter_us;
+} sched_entry_t;
+
+static sched_entry_t sched_entry[SCHED_MAX_MESSAGES];
+static uint8_t  sched_count = 0;
+static uint8_t  sched_wheel[SCHED_WHEEL_SLOTS];
+static uint32_t sched_now_ms = 0;
+static uint32_t sched_last_us = 0;
+static bool     sched_started = false;
+
+//——————————————————————————————————————————————————————————————————————————————
+// Wheel slot lists
+//——————————————————————————————————————————————————————————————————————————————
+//Appended at the tail: entries due in the same slot keep their registration order from turn to turn,
+//a group whose first entry prepares the content of the others (0x1F2 group) is always sent consistent
+static void sched_link(uint8_t index){
+  uint8_t slot = sched_entry[index].due_ms & (SCHED_WHEEL_SLOTS - 1U);
+  uint8_t * link = &sched_wheel[slot];
+
+  while(SCHED_NONE != *link){
+    link = &sched_entry[*link].next;
+  }
+  sched_entry[index].next = SCHED_NONE;
+  *link = index;
+}
+
+static void sched_unlink(uint8_t index){
+  uint8_t slot = sched_entry[index].due_ms & (SCHED_WHEEL_SLOTS - 1U);
+  uint8_t * link = &sched_wheel[slot];
+
+  while(SCHED_NONE != *link){
+    if(*link == index){
+      *link = sched_entry[index].next;
+      return;
+    }
+    link = &sched_entry[*link].next;
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Send one entry and record how far the interval was from the period; a skipped period
+// restarts the measurement, the next interval would otherwise count the gap as jitter
+//——————————————————————————————————————————————————————————————————————————————
+static void sched_fire(sched_entry_t * e, uint32_t now_us){
+  if((NULL != e->config.gate) && !e->config.gate()){
+    e->skipped = e->skipped + 1U;
+    e->last_sent_us = 0U;
+    return;
+  }
+  if(SCHED_MODE_PHASE_LOCKED == e->config.mode){
+    //Stop once the VCM is silent: the car is going to sleep, do not keep the inverter awake
+    if(!e->synced || ((sched_now_ms - e->last_sync_ms) > SCHED_SYNC_TIMEOUT_MS)){
+      e->skipped = e->skipped + 1U;
+      e->last_sent_us = 0U;
+      return;
+    }
+  }
+
+  if(NULL != e->config.prepare){
+    e->config.prepare();
+  }
+  e->config.send(*e->config.frame);
+  e->sent = e->sent + 1U;
+
+  if(0U != e->last_sent_us){
+    uint32_t interval = now_us - e->last_sent_us;
+    uint32_t period_us = (uint32_t)e->config.period_ms * 1000U;
+    uint32_t jitter = (interval > period_us) ? (interval - period_us) : (period_us - interval);
+    e->avg_jitter_us = e->avg_jitter_us + (((int32_t)(jitter - e->avg_jitter_us)) >> 4);
+    if(jitter > e->max_jitter_us){
+      e->max_jitter_us = jitter;
+    }
+  }
+  e->last_sent_us = now_us;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Process the slot of sched_now_ms, slot_us is the time of that millisecond
+//——————————————————————————————————————————————————————————————————————————————
+static void sched_run_slot(uint32_t slot_us){
+  uint8_t slot = sched_now_ms & (SCHED_WHEEL_SLOTS - 1U);
+  uint8_t index = sched_wheel[slot];
+
+  //Detach the list first, every entry is linked again (same or new slot) below
+  sched_wheel[slot] = SCHED_NONE;
+  while(SCHED_NONE != index){
+    sched_entry_t * e = &sched_entry[index];
+    uint8_t next = e->next;
+
+    if((int32_t)(sched_now_ms - e->due_ms) >= 0){
+      sched_fire(e, slot_us);
+      e->due_ms += e->config.period_ms;
+      //Far behind (e.g. the task was blocked): drop the missed periods instead of bursting
+      if((int32_t)(sched_now_ms - e->due_ms) >= 0){
+        e->due_ms = sched_now_ms + e->config.period_ms;
+        e->last_sent_us = 0U;
+      }
+    }
+    sched_link(index);
+    index = next;
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Registration (setup, before the bridge task runs)
+//——————————————————————————————————————————————————————————————————————————————
+void SCHED_Clear(void){
+  memset(sched_wheel, SCHED_NONE, sizeof(sched_wheel));
+  sched_count = 0;
+}
+
+bool SCHED_Add(const sched_msg_config_t * config){
+  sched_entry_t * e;
+
+  if((sched_count >= SCHED_MAX_MESSAGES) || (NULL == config->frame) || (NULL == config->send) ||
+     (0U == config->period_ms) || (SCHED_MODE_VCM_TRIGGERED == config->mode)){
+    return false;
+  }
+  if(0U == sched_count){
+    memset(sched_wheel, SCHED_NONE, sizeof(sched_wheel));
+  }
+
+  e = &sched_entry[sched_count];
+  memset(e, 0, sizeof(*e));
+  e->config = *config;
+  e->due_ms = sched_now_ms + config->phase_ms + 1U;
+  sched_link(sched_count);
+  sched_count++;
+  return true;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Advance the wheel to now_us (bridge task, every T_POLLING tick)
+//——————————————————————————————————————————————————————————————————————————————
+void SCHED_Tick(uint32_t now_us){
+  uint16_t steps = 0;
+
+  if(0U == sched_count){
+    return;
+  }
+  if(!sched_started){
+    sched_started = true;
+    sched_last_us = now_us;
+    return;
+  }
+  while(((now_us - sched_last_us) >= 1000U) && (steps < SCHED_WHEEL_SLOTS)){
+    sched_last_us += 1000U;
+    sched_now_ms++;
+    sched_run_slot(sched_last_us);    //catch-up slots keep their own time
+    steps++;
+  }
+  //More than one wheel turn behind: resynchronize the time base, late entries fire on their next visit
+  if((now_us - sched_last_us) >= 1000U){
+    sched_last_us = now_us;
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// VCM frame sync_id was received on can_bus: pull the phase locked entries towards its cadence
+//——————————————————————————————————————————————————————————————————————————————
+void SCHED_Sync(uint16_t sync_id, uint8_t can_bus){
+  uint8_t i;
+
+  for(i = 0; i < sched_count; i++){
+    sched_entry_t * e = &sched_entry[i];
+    int32_t grid;
+    int32_t error;
+    int32_t step;
+
+    if((SCHED_MODE_PHASE_LOCKED != e->config.mode) || (e->config.sync_id != sync_id) || (0U == e->config.sync_period_ms) ||
+       (0U == (e->config.sync_channels & (1U << can_bus)))){
+      continue;
+    }
+
+    //Distance to the nearest point phase_ms after a VCM frame, within +/- half a VCM period
+    grid  = e->config.sync_period_ms;
+    error = ((int32_t)(e->due_ms - (sched_now_ms + e->config.phase_ms))) % grid;
+    if(error >= (grid / 2)){
+      error -= grid;
+    }else if(error < -(grid / 2)){
+      error += grid;
+    }
+
+    //Snap on the first frame, then correct half of the error per VCM frame (filters VCM jitter)
+    step = e->synced ? (error / 2) : error;
+    if((0 == step) && (0 != error)){
+      step = error;
+    }
+    e->synced = true;
+    e->last_sync_ms = sched_now_ms;
+
+    if(0 != step){
+      sched_unlink(i);
+      e->due_ms -= step;
+      if((int32_t)(e->due_ms - sched_now_ms) < 1){
+        e->due_ms = sched_now_ms + 1U;
+      }
+      sched_link(i);
+    }
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Statistics
+//——————————————————————————————————————————————————————————————————————————————
+uint8_t SCHED_Count(void){
+  return sched_count;
+}
+
+bool SCHED_GetStats(uint8_t index, sched_stats_t * stats){
+  if(index >= sched_count){
+    return false;
+  }
+  stats->can_id        = sched_entry[index].config.frame->can_id;
+  stats->mode          = sched_entry[index].config.mode;
+  stats->period_ms     = sched_entry[index].config.period_ms;
+  stats->sent          = sched_entry[index].sent;
+  stats->skipped       = sched_entry[index].skipped;
+  stats->avg_jitter_us = sched_entry[index].avg_jitter_us;
+  stats->max_jitter_us = sched_entry[index].max_jitter_us;
+  return true;
+}
+
+//Restart every per-entry counter; called from the web server, a frame sent meanwhile may land before or after
+void SCHED_ResetStats(void){
+  uint8_t i;
+  for(i = 0; i < sched_count; i++){
+    sched_entry[i].sent          = 0U;
+    sched_entry[i].skipped       = 0U;
+    sched_entry[i].avg_jitter_us = 0U;
+    sched_entry[i].max_jitter_us = 0U;
+  }
+}
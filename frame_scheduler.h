@@ -0,0 +1,55 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Timer driven scheduler for periodic (synthesized) CAN frames
+// 10.16.2026: Timing wheel with per-message period/phase, VCM phase lock and jitter statistics
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <Arduino.h>
+#include "canframe.h"
+#include "config.h"
+
+//Scheduling modes
+#define SCHED_MODE_VCM_TRIGGERED  (0U)  //legacy: sent by the handler of the VCM frame, not scheduled here
+#define SCHED_MODE_FREE_RUNNING   (1U)  //sent on the timer only, period and phase from boot
+#define SCHED_MODE_PHASE_LOCKED   (2U)  //sent on the timer, phase follows the VCM frame cadence, stops when the VCM is silent
+
+#define SCHED_MAX_MESSAGES  24
+#define SCHED_WHEEL_SLOTS   64  //1ms per slot, must be a power of two
+
+typedef bool (*sched_gate_t)(void);         //false: skip this period (e.g. while AC charging)
+typedef void (*sched_prepare_t)(void);      //update rolling counters of the frame before it is sent
+
+typedef struct {
+  can_frame_t *   frame;
+  void            (*send)(const can_frame_t &frame);
+  uint16_t        period_ms;
+  uint16_t        phase_ms;         //offset from boot (free running) or from the VCM frame (phase locked)
+  uint8_t         mode;
+  uint16_t        sync_id;          //VCM frame the message is locked to
+  uint16_t        sync_period_ms;   //nominal period of that VCM frame
+  uint8_t         sync_channels;    //channels that VCM frame counts from, bit (1 << CAN_CHANNEL_x) each
+  sched_gate_t    gate;             //optional
+  sched_prepare_t prepare;          //optional
+} sched_msg_config_t;
+
+typedef struct {
+  uint32_t can_id;
+  uint8_t  mode;
+  uint16_t period_ms;
+  uint32_t sent;
+  uint32_t skipped;         //periods not sent (gate closed or VCM silent)
+  uint32_t avg_jitter_us;   //moving average of |interval - period|
+  uint32_t max_jitter_us;
+} sched_stats_t;
+
+bool SCHED_Add(const sched_msg_config_t * config);
+void SCHED_Clear(void);
+void SCHED_Tick(uint32_t now_us);
+void SCHED_Sync(uint16_t sync_id, uint8_t can_bus);
+uint8_t SCHED_Count(void);
+bool SCHED_GetStats(uint8_t index, sched_stats_t * stats);
+void SCHED_ResetStats(void);
+
+#endif //FRAME_SCHEDULER_H
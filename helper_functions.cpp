@@ -13,15 +13,17 @@
 // 12.04.2022: Merging of Inverter Upgrade based on https://github.com/dalathegreat/Nissan-LEAF-Inverter-Upgrade/blob/main/can-bridge-inverter.c
 // 12.06.2022: Updated Charge Current logic - 1) Start conditions are charging state and fan speed; 2) Display kW for 15sec and revert to SOC
 // 12.31.2022: Fix charge current functions Fix regen power and motor power Fix Glide and drive add code 
+// 10.16.2026: CRC-8 through the const position tables of checksum.cpp, no mutable crctable in RAM
+// 10.16.2026: 0x5BC/0x5C0 conversions through the signal descriptors of leaf_signals.h
+// 10.16.2026: ...now the LEAF_Encode/Decode functions generated from dbc/leaf.dbc
 //——————————————————————————————————————————————————————————————————————————————
 
 //——————————————————————————————————————————————————————————————————————————————
 #include <Arduino.h>
 #include "helper_functions.h"
 #include "canframe.h"
-
-//——————————————————————————————————————————————————————————————————————————————
-uint8_t	crctable[256] = {0,133,143,10,155,30,20,145,179,54,60,185,40,173,167,34,227,102,108,233,120,253,247,114,80,213,223,90,203,78,68,193,67,198,204,73,216,93,87,210,240,117,127,250,107,238,228,97,160,37,47,170,59,190,180,49,19,150,156,25,136,13,7,130,134,3,9,140,29,152,146,23,53,176,186,63,174,43,33,164,101,224,234,111,254,123,113,244,214,83,89,220,77,200,194,71,197,64,74,207,94,219,209,84,118,243,249,124,237,104,98,231,38,163,169,44,189,56,50,183,149,16,26,159,14,139,129,4,137,12,6,131,18,151,157,24,58,191,181,48,161,36,46,171,106,239,229,96,241,116,126,251,217,92,86,211,66,199,205,72,202,79,69,192,81,212,222,91,121,252,246,115,226,103,109,232,41,172,166,35,178,55,61,184,154,31,21,144,1,132,142,11,15,138,128,5,148,17,27,158,188,57,51,182,39,162,168,45,236,105,99,230,119,242,248,125,95,218,208,85,196,65,75,206,76,201,195,70,215,82,88,221,255,122,112,245,100,225,235,110,175,42,32,165,52,177,187,62,28,153,147,22,135,2,8,141};
+#include "checksum.h"
+#include "leaf_signals.h"
 
 //——————————————————————————————————————————————————————————————————————————————
 //print standard ID (11-bit) to string
@@ -57,7 +59,7 @@ void uint32_to_str(char * str, uint32_t num){
 //——————————————————————————————————————————————————————————————————————————————
 //CAN frame to string translation
 //——————————————————————————————————————————————————————————————————————————————
-void canframe_to_str(char * str, can_frame_t frame){
+void canframe_to_str(char * str, const can_frame_t &frame){
 	uint8_t tmp;
 	for(uint8_t i = 0; i < frame.can_dlc; i++){
 		tmp = (frame.data[i] & 0xF0) >> 4;
@@ -82,11 +84,7 @@ void int_to_hex(char * str, int num){
 //recalculates the CRC-8 with 0x85 poly
 //——————————————————————————————————————————————————————————————————————————————
 void calc_crc8(can_frame_t *frame){
-	uint8_t crc = 0;
-	for(uint8_t i = 0; i < 7; i++){
-		crc = crctable[(crc ^ ((int) (*frame).data[i])) % 256];
-	}
-	(*frame).data[7] = crc;
+	(*frame).data[7] = CSUM_Crc8((*frame).data);
 }
 
 //——————————————————————————————————————————————————————————————————————————————
@@ -185,29 +183,23 @@ void NVM_GetGUID(uint8_t * b) {
 	b[10]=ReadCalibrationByte(COORDY1);
 }
 
-void convert_5bc_to_array(volatile Leaf_2011_5BC_message * src, uint8_t * dest){
-  dest[0] = (uint8_t) (src->LB_CAPR >> 2);
-  dest[1] = (uint8_t) (((src->LB_CAPR << 6) & 0xC0) | ((src->LB_FULLCAP >> 4) & 0x1F));
-  dest[2] = (uint8_t) (((src->LB_FULLCAP << 4) & 0xF0) | ((src->LB_CAPSEG) & 0x0F));
-  dest[3] = (uint8_t) (src->LB_AVET);
-  dest[4] = (uint8_t) (((src->LB_SOH << 1) & 0xFE) | ((src->LB_CAPSW) & 1));
-  dest[5] = (uint8_t) (((src->LB_RLIMIT << 5) & 0xE0) | ((src->LB_CAPBALCOMP << 2) & 4) | ((src->LB_RCHGTCON >> 3) & 3));
-  dest[6] = (uint8_t) (((src->LB_RCHGTCON << 5) & 0xE0) | ((src->LB_RCHGTIM >> 8) & 0x1F));
-  dest[7] = (uint8_t) (src->LB_RCHGTIM);
+//——————————————————————————————————————————————————————————————————————————————
+//0x5BC / 0x5C0 payload <-> decoded message, spacer bits 0
+//Unlike the former shifts, the 0x5BC encoder keeps LB_FULLCAP bit 9 and the decoder fills every
+//field (it only set LB_CAPR, from the wrong bits of data[1]); host/signal_test compares both.
+//——————————————————————————————————————————————————————————————————————————————
+void convert_5bc_to_array(const leaf_5bc_t * src, uint8_t * dest){
+  memset(dest, 0, CAN_MAX_DLEN);
+  LEAF_Encode_5BC(src, dest);
 }
 
-void convert_array_to_5bc(volatile Leaf_2011_5BC_message * dest, uint8_t * src){
-  dest->LB_CAPR = (src[0] << 2) | (src[1] & 0xC0 >> 6);
+void convert_array_to_5bc(leaf_5bc_t * dest, const uint8_t * src){
+  LEAF_Decode_5BC(src, dest);
 }
 
-void convert_5c0_to_array(volatile Leaf_2011_5C0_message * src, uint8_t * dest){
-  dest[0] = (src->LB_HIS_DATA_SW << 6) | src->LB_HIS_HLVOL_TIMS;
-  dest[1] = src->LB_HIS_TEMP_WUP << 1;
-  dest[2] = src->LB_HIS_TEMP << 1;
-  dest[3] = src->LB_HIS_INTG_CUR;
-  dest[4] = src->LB_HIS_DEG_REGI << 1;
-  dest[5] = src->LB_HIS_CELL_VOL << 2;
-  dest[7] = src->LB_DTC;
+void convert_5c0_to_array(const leaf_5c0_t * src, uint8_t * dest){
+  memset(dest, 0, CAN_MAX_DLEN);
+  LEAF_Encode_5C0(src, dest);
 }
 
 //——————————————————————————————————————————————————————————————————————————————
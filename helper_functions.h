@@ -13,12 +13,15 @@
 // 12.04.2022: Merging of Inverter Upgrade based on https://github.com/dalathegreat/Nissan-LEAF-Inverter-Upgrade/blob/main/can-bridge-inverter.c
 // 12.06.2022: Updated Charge Current logic - 1) Start conditions are charging state and fan speed; 2) Display kW for 15sec and revert to SOC
 // 12.31.2022: Fix charge current functions Fix regen power and motor power Fix Glide and drive add code 
+// 10.16.2026: 0x5BC/0x5C0 conversions on the plain structs of leaf_signals.h
+// 10.16.2026: Structs renamed leaf_5bc_t/leaf_5c0_t (generated from dbc/leaf.dbc)
 //——————————————————————————————————————————————————————————————————————————————
 #ifndef HELPER_FUNCTIONS_H
 #define HELPER_FUNCTIONS_H
 
 #include <Arduino.h>
 #include "canframe.h"
+#include "leaf_signals.h"
 
 void uint32_to_str(char * str, uint32_t num);
 uint8_t ReadCalibrationByte( uint8_t index );
@@ -29,9 +32,9 @@ void int_to_4digit_nodec(int num, char * buffer);
 void int_to_hex(char * str, int num);
 void calc_crc8(can_frame_t *frame);
 void calc_sum4(can_frame_t *frame);
-void convert_5bc_to_array(volatile Leaf_2011_5BC_message * src, uint8_t * dest);
-void convert_array_to_5bc(volatile Leaf_2011_5BC_message * dest, uint8_t * src);
-void convert_5c0_to_array(volatile Leaf_2011_5C0_message * src, uint8_t * dest);
+void convert_5bc_to_array(const leaf_5bc_t * src, uint8_t * dest);
+void convert_array_to_5bc(leaf_5bc_t * dest, const uint8_t * src);
+void convert_5c0_to_array(const leaf_5c0_t * src, uint8_t * dest);
 
 void TIMER_Start(void);
 bool TIMER_Expired(uint32_t durationInSec);
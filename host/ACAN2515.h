@@ -0,0 +1,29 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Host stand-in for the ACAN2515 library, only the CANMessage frame type
+// 10.16.2026: Host build of the bridge engine, see host/Makefile
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef HOST_ACAN2515_H
+#define HOST_ACAN2515_H
+
+#include <Arduino.h>
+
+//Same layout and defaults as ACAN2515's CANMessage
+class CANMessage {
+public:
+  uint32_t id;
+  bool     ext;
+  bool     rtr;
+  uint8_t  idx;
+  uint8_t  len;
+  union {
+    uint64_t data64;
+    uint32_t data32[2];
+    uint16_t data16[4];
+    uint8_t  data[8];
+  };
+
+  CANMessage() : id(0), ext(false), rtr(false), idx(0), len(0), data64(0) {}
+};
+
+#endif //HOST_ACAN2515_H
@@ -0,0 +1,150 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Host (Linux) stand-in for the parts of the Arduino/ESP32 core used by the bridge engine
+// 10.16.2026: Host build of the bridge engine, see host/Makefile
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <string>
+
+#define IRAM_ATTR
+
+#define DEC 10
+#define HEX 16
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+//Time comes from the simulated clock (sim_clock.h), never from the host
+uint32_t micros(void);
+uint32_t millis(void);
+inline void delay(uint32_t ms) { (void)ms; }
+inline void yield(void) {}
+
+inline void noInterrupts(void) {}
+inline void interrupts(void) {}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Print / Serial
+//——————————————————————————————————————————————————————————————————————————————
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t * buffer, size_t size) {
+    size_t n = 0;
+    while(size--) {
+      n += write(*buffer++);
+    }
+    return n;
+  }
+
+  size_t print(const char * str) { return write((const uint8_t *)str, strlen(str)); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned long num, int base = DEC) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), (base == HEX) ? "%lX" : "%lu", num);
+    return print(buf);
+  }
+  size_t print(long num, int base = DEC) {
+    if(base != DEC) {
+      return print((unsigned long)num, base);
+    }
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%ld", num);
+    return print(buf);
+  }
+  size_t print(unsigned int num, int base = DEC) { return print((unsigned long)num, base); }
+  size_t print(int num, int base = DEC) { return print((long)num, base); }
+  size_t print(unsigned char num, int base = DEC) { return print((unsigned long)num, base); }
+  size_t print(double num, int digits = 2) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", digits, num);
+    return print(buf);
+  }
+  size_t print(const std::string &str) { return print(str.c_str()); }
+
+  size_t println(void) { return print("\r\n"); }
+  template <typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+  template <typename T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+};
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  operator bool() const { return true; }
+  size_t write(uint8_t c) { return (EOF == fputc(c, stdout)) ? 0U : 1U; }
+  size_t write(const uint8_t * buffer, size_t size) { return fwrite(buffer, 1, size, stdout); }
+  using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+//——————————————————————————————————————————————————————————————————————————————
+// String (only what config.h and the helpers need)
+//——————————————————————————————————————————————————————————————————————————————
+class String : public std::string {
+public:
+  String() {}
+  String(const char * str) : std::string(str ? str : "") {}
+  String(const std::string &str) : std::string(str) {}
+  String(int value) : std::string(std::to_string(value)) {}
+  String(unsigned int value) : std::string(std::to_string(value)) {}
+  unsigned int length(void) const { return (unsigned int)size(); }
+  char charAt(unsigned int index) const { return (index < size()) ? (*this)[index] : 0; }
+  long toInt(void) const { return strtol(c_str(), NULL, 10); }
+};
+
+//WCharacter.h
+inline boolean isAlphaNumeric(int c) { return isalnum(c) != 0; }
+inline boolean isDigit(int c) { return isdigit(c) != 0; }
+inline boolean isHexadecimalDigit(int c) { return isxdigit(c) != 0; }
+inline boolean isWhitespace(int c) { return isblank(c) != 0; }
+
+//——————————————————————————————————————————————————————————————————————————————
+// ESP32 core
+//——————————————————————————————————————————————————————————————————————————————
+#define HOST_CPU_FREQ_MHZ  240U   //same as the ESP32 target, so cycle based statistics scale alike
+
+class EspClass {
+public:
+  uint32_t getCycleCount(void) { return micros() * HOST_CPU_FREQ_MHZ; }
+  uint32_t getCpuFreqMHz(void) { return HOST_CPU_FREQ_MHZ; }
+  uint32_t getFreeHeap(void) { return 0U; }
+};
+
+extern EspClass ESP;
+
+//——————————————————————————————————————————————————————————————————————————————
+// FreeRTOS (single threaded on the host: critical sections and notifications are no-ops)
+//——————————————————————————————————————————————————————————————————————————————
+typedef int       portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED  0
+#define portENTER_CRITICAL(mux)       (void)(mux)
+#define portEXIT_CRITICAL(mux)        (void)(mux)
+#define portENTER_CRITICAL_ISR(mux)   (void)(mux)
+#define portEXIT_CRITICAL_ISR(mux)    (void)(mux)
+
+typedef void *    TaskHandle_t;
+typedef int       BaseType_t;
+typedef uint32_t  UBaseType_t;
+typedef uint32_t  TickType_t;
+
+#define pdFALSE               0
+#define pdTRUE                1
+#define pdPASS                1
+#define portMAX_DELAY         0xFFFFFFFFU
+#define pdMS_TO_TICKS(ms)     (ms)
+#define portYIELD_FROM_ISR()  do{}while(0)
+
+inline void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t * woken) { (void)task; (void)woken; }
+inline UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) { (void)task; return 0U; }
+
+#endif //HOST_ARDUINO_H
@@ -0,0 +1,452 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Per-frame microbenchmarks of the LEAF handlers on the host build
+// 10.16.2026: ns/frame and instructions/frame per rewritten CAN ID, baseline comparison
+// 10.16.2026: CRC-8 cases against the original byte-wise calc_crc8, with a self-check
+//——————————————————————————————————————————————————————————————————————————————
+// Every case feeds LEAF_CAN_Handler() with a cycle of recorded-like payloads of one ID and
+// times batches of TX_DRAIN_BUDGET_PER_TICK frames. Between batches the transmit buffers are
+// emptied into the virtual bus outside the timed section, so each frame is measured as the
+// bridge task sees it: copy into the receive slot, dispatch, translation and forward push.
+// synth_tick_1ms times one 1 ms step of the frame scheduler with the 0x284/0x50C groups locked
+// (only when LEAF_SYNTH_MODE puts the synthesized messages on the timer).
+// bus_stats_update times the per-ID statistics update done for every received frame.
+// The *_bytewise CRC cases are the loop calc_crc8() ran before checksum.cpp, kept here as the
+// reference: before anything is timed the position table and delta versions are checked
+// against it on random frames (exit code 1 on a mismatch). sum4 is calc_sum4() as is.
+//
+// Usage: bridge_bench [-n frames] [-b baseline] [-u] [-t threshold_pct]
+//   -b  compare with the baseline file and flag cases slower by more than the threshold
+//       (the file is created when it does not exist)
+//   -u  rewrite the baseline with this run
+// Exit code 1 when a regression was flagged.
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include <unistd.h>
+#include "config.h"
+#include "can_driver.h"
+#include "can_bridge_manager_common.h"
+#include "can_bridge_manager_leaf.h"
+#include "helper_functions.h"
+#include "frame_scheduler.h"
+#include "bus_stats.h"
+#include "checksum.h"
+#include "sim_clock.h"
+#include "virtual_can.h"
+#include "bench_util.h"
+
+#define BENCH_PAYLOADS  16                        //payload cycle per case
+#define BENCH_BATCH     TX_DRAIN_BUDGET_PER_TICK  //frames per timed batch
+#define BENCH_CSUM_BATCH  256U                    //checksums per timed batch (a few ns each)
+#define BENCH_CSUM_CHECKS 100000U                 //random frames of the self-check
+
+typedef struct {
+  const char * name;
+  uint8_t      can_bus;
+  uint16_t     can_id;
+  uint8_t      can_dlc;
+  uint8_t      inverter;    //live_config_t.inverter during the case
+  void         (*payload)(uint32_t index, uint8_t * data);
+} bench_case_t;
+
+//——————————————————————————————————————————————————————————————————————————————
+// Payload generators, byte layouts as seen on the car
+//——————————————————————————————————————————————————————————————————————————————
+static void bench_payload_5BC(uint32_t index, uint8_t * data){
+  static const uint8_t capacity[8] = {0x3D, 0x80, 0xF0, 0x1E, 0xC4, 0x00, 0x00, 0x00};
+  memcpy(data, capacity, 8);
+  data[3] = (uint8_t)(0x14 + index);   //average temperature
+}
+
+static void bench_payload_11A(uint32_t index, uint8_t * data){
+  memset(data, 0, 8);
+  data[0] = 0x4E;                       //D
+  data[1] = 0x40;
+  data[6] = (uint8_t)(index & 0x03);
+}
+
+static void bench_payload_1D4_power(uint32_t index, uint8_t * data){
+  uint16_t torque = (uint16_t)((40U + (index * 37U)) & 0x7FF);  //positive 12-bit request
+  data[0] = 0x6E;
+  data[1] = 0x6E;
+  data[2] = (uint8_t)(torque >> 4);
+  data[3] = (uint8_t)(torque << 4);
+  data[4] = 0x07;
+  data[5] = 0x44;
+  data[6] = (uint8_t)(0x30 + (index & 0x03));
+}
+
+static void bench_payload_1D4_regen(uint32_t index, uint8_t * data){
+  uint16_t torque = (uint16_t)(0x1000 - (20U + (index * 29U)));  //negative 12-bit request
+  bench_payload_1D4_power(index, data);
+  data[2] = (uint8_t)(torque >> 4);
+  data[3] = (uint8_t)(torque << 4);
+}
+
+static void bench_payload_1DA(uint32_t index, uint8_t * data){
+  uint16_t torque = (uint16_t)((index * 53U) & 0x3FF);
+  data[0] = 0x55;
+  data[1] = 0x00;
+  data[2] = (uint8_t)(0x30 | ((index & 1U) ? 0x04 : 0x00) | (torque >> 8));
+  data[3] = (uint8_t)torque;
+  data[4] = 0x00;
+  data[5] = 0x00;
+  data[6] = (uint8_t)(index & 0x03);
+}
+
+static void bench_payload_1DB(uint32_t index, uint8_t * data){
+  data[0] = 0xFF;
+  data[1] = 0xE0;
+  data[2] = 0xC8;
+  data[3] = (uint8_t)(0x50 + index);
+  data[4] = 0x55;
+  data[5] = 0x00;
+  data[6] = (uint8_t)(index & 0x03);
+}
+
+static void bench_payload_50C(uint32_t index, uint8_t * data){
+  memset(data, 0, 8);
+  data[3] = (uint8_t)(index & 0x03);
+  data[4] = 0xA7;
+}
+
+static const bench_case_t bench_cases[] = {
+  { "passthrough_5BC",  CAN_CHANNEL_2, 0x5BC, 8, Inverter_Upgrade_Disabled,                       bench_payload_5BC },
+  { "shifter_11A",      CAN_CHANNEL_2, 0x11A, 8, Inverter_Upgrade_Disabled,                       bench_payload_11A },
+  { "torque_1D4_stock", CAN_CHANNEL_2, 0x1D4, 8, Inverter_Upgrade_Disabled,                       bench_payload_1D4_power },
+  { "torque_1D4_110kw", CAN_CHANNEL_2, 0x1D4, 8, Inverter_Upgrade_EM57_Motor_with_110Kw_inverter, bench_payload_1D4_power },
+  { "torque_1D4_160kw", CAN_CHANNEL_2, 0x1D4, 8, Inverter_Upgrade_EM57_Motor_with_160Kw_Inverter, bench_payload_1D4_power },
+  { "torque_1D4_regen", CAN_CHANNEL_2, 0x1D4, 8, Inverter_Upgrade_EM57_Motor_with_110Kw_inverter, bench_payload_1D4_regen },
+  { "response_1DA",     CAN_CHANNEL_1, 0x1DA, 8, Inverter_Upgrade_EM57_Motor_with_110Kw_inverter, bench_payload_1DA },
+  { "soc_1DB",          CAN_CHANNEL_2, 0x1DB, 8, Inverter_Upgrade_Disabled,                       bench_payload_1DB },
+  { "sync_50C",         CAN_CHANNEL_2, 0x50C, 6, Inverter_Upgrade_Disabled,                       bench_payload_50C },
+};
+#define BENCH_CASE_COUNT (sizeof(bench_cases) / sizeof(bench_cases[0]))
+
+//——————————————————————————————————————————————————————————————————————————————
+// Untimed helpers
+//——————————————————————————————————————————————————————————————————————————————
+//Empty the transmit buffers into the virtual bus and put everything on the wire
+static void bench_drain(void){
+  tx_buffer_stats_t stats;
+  uint8_t i;
+  bool pending;
+
+  do {
+    Schedule_Buffer_Check_CAN();
+    VCAN_Advance(SIM_Clock_Now() + 1000000ULL);
+    pending = false;
+    for(i = CAN_CHANNEL_0; i <= CAN_CHANNEL_2; i++) {
+      if(buffer_get_stats(i, &stats) && (stats.count > 0U)) {
+        pending = true;
+      }
+    }
+    SIM_Clock_Advance(1000U);
+  } while(pending);
+}
+
+static void bench_build(uint16_t can_id, uint8_t can_dlc, void (*payload)(uint32_t, uint8_t *),
+                        uint32_t index, can_frame_t &frame){
+  frame.can_id = can_id;
+  frame.can_dlc = can_dlc;
+  memset(frame.data, 0, sizeof(frame.data));
+  payload(index, frame.data);
+  if(8U == can_dlc) {
+    calc_crc8(&frame);
+  }
+}
+
+//Bridge state of a car in D: shifter seen once
+static void bench_prime(void){
+  can_frame_t frame;
+  bench_build(0x11A, 8, bench_payload_11A, 0, frame);
+  LEAF_CAN_Handler(CAN_CHANNEL_2, frame);
+  bench_drain();
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Cases
+//——————————————————————————————————————————————————————————————————————————————
+static void bench_run_case(const bench_case_t * c, uint32_t frames){
+  can_frame_t templates[BENCH_PAYLOADS];
+  can_frame_t rx_slot;
+  live_config_t cfg;
+  bench_timer_t timer;
+  uint32_t done;
+  uint32_t i;
+  uint8_t repeat;
+
+  for(i = 0; i < BENCH_PAYLOADS; i++) {
+    bench_build(c->can_id, c->can_dlc, c->payload, i, templates[i]);
+  }
+  LCFG_Snapshot(&cfg);
+  cfg.inverter = c->inverter;
+  LCFG_Init(&cfg);    //between cases, no frame in flight
+
+  for(repeat = 0; repeat < BENCH_REPEAT; repeat++) {
+    BENCH_Clear(&timer);
+    for(done = 0; done < frames; done += BENCH_BATCH) {
+      BENCH_Start(&timer);
+      for(i = 0; i < BENCH_BATCH; i++) {
+        //The handler translates in place, as on the receive slot of the target
+        rx_slot = templates[(done + i) & (BENCH_PAYLOADS - 1U)];
+        LEAF_CAN_Handler(c->can_bus, rx_slot);
+      }
+      BENCH_Stop(&timer, BENCH_BATCH);
+      bench_drain();
+    }
+    BENCH_Record(c->name, &timer);
+  }
+  BENCH_Report(c->name);
+}
+
+static void bench_run_synth_tick(uint32_t ticks){
+  bench_timer_t timer;
+  uint32_t done;
+  uint8_t repeat;
+
+  if(0U == SCHED_Count()) {
+    printf("  %-24s skipped, LEAF_SYNTH_MODE is SCHED_MODE_VCM_TRIGGERED\n", "synth_tick_1ms");
+    return;
+  }
+  for(repeat = 0; repeat < BENCH_REPEAT; repeat++) {
+    BENCH_Clear(&timer);
+    for(done = 0; done < ticks; done++) {
+      //VCM frames keep the phase locked messages alive, as on a running car
+      if(0U == (done % 20U)) {
+        SCHED_Sync(0x284, CAN_CHANNEL_2);
+      }
+      if(0U == (done % 100U)) {
+        SCHED_Sync(0x50C, CAN_CHANNEL_2);
+      }
+      SIM_Clock_Advance(1000U);
+      BENCH_Start(&timer);
+      SCHED_Tick(micros());
+      BENCH_Stop(&timer, 1U);
+      bench_drain();
+    }
+    BENCH_Record("synth_tick_1ms", &timer);
+  }
+  BENCH_Report("synth_tick_1ms");
+}
+
+static void bench_run_bus_stats(uint32_t frames){
+  can_frame_t templates[BENCH_PAYLOADS];
+  bench_timer_t timer;
+  uint32_t done;
+  uint32_t i;
+  uint8_t repeat;
+
+  //A spread of IDs as on the VCM side, each arriving every BENCH_PAYLOADS frames
+  for(i = 0; i < BENCH_PAYLOADS; i++) {
+    bench_build((uint16_t)(0x100U + (i * 0x51U)), 8, bench_payload_1DB, i, templates[i]);
+  }
+
+  for(repeat = 0; repeat < BENCH_REPEAT; repeat++) {
+    BENCH_Clear(&timer);
+    for(done = 0; done < frames; done += BENCH_BATCH) {
+      SIM_Clock_Advance(1000U);
+      for(i = 0; i < BENCH_BATCH; i++) {
+        templates[(done + i) & (BENCH_PAYLOADS - 1U)].rx_cycles = CAN_RxStamp();
+      }
+      BENCH_Start(&timer);
+      for(i = 0; i < BENCH_BATCH; i++) {
+        BUSSTAT_Update(CAN_CHANNEL_2, templates[(done + i) & (BENCH_PAYLOADS - 1U)]);
+      }
+      BENCH_Stop(&timer, BENCH_BATCH);
+    }
+    BENCH_Record("bus_stats_update", &timer);
+  }
+  BENCH_Report("bus_stats_update");
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Checksums: reference implementations (as in helper_functions.cpp before checksum.cpp)
+//——————————————————————————————————————————————————————————————————————————————
+static uint8_t bench_crctable[256];
+
+static void bench_crctable_init(void){
+  uint16_t i;
+  uint8_t bit;
+  uint8_t crc;
+
+  for(i = 0; i < 256U; i++) {
+    crc = (uint8_t)i;
+    for(bit = 0; bit < 8U; bit++) {
+      crc = (crc & 0x80U) ? (uint8_t)((crc << 1) ^ 0x85U) : (uint8_t)(crc << 1);
+    }
+    bench_crctable[i] = crc;
+  }
+}
+
+static void bench_crc8_bytewise(can_frame_t &frame){
+  uint8_t crc = 0;
+  for(uint8_t i = 0; i < 7; i++) {
+    crc = bench_crctable[(crc ^ ((int)frame.data[i])) % 256];
+  }
+  frame.data[7] = crc;
+}
+
+//The 0x1D4 rewrite: two torque bytes replaced, then the whole CRC recomputed / patched
+static void bench_rewrite_bytewise(can_frame_t &frame){
+  frame.data[2] = (uint8_t)(frame.data[2] ^ 0x15U);
+  frame.data[3] = (uint8_t)(frame.data[3] ^ 0xA0U);
+  bench_crc8_bytewise(frame);
+}
+
+static void bench_rewrite_delta(can_frame_t &frame){
+  CSUM_SetByte(frame, 2, (uint8_t)(frame.data[2] ^ 0x15U));
+  CSUM_SetByte(frame, 3, (uint8_t)(frame.data[3] ^ 0xA0U));
+}
+
+static void bench_crc8_position(can_frame_t &frame){
+  frame.data[7] = CSUM_Crc8(frame.data);
+}
+
+static void bench_sum4(can_frame_t &frame){
+  calc_sum4(&frame);
+}
+
+static void bench_csum_validate(can_frame_t &frame){
+  CSUM_Validate(frame);
+}
+
+//xorshift32, fixed seed so a failing frame number is reproducible
+static uint32_t bench_rand(void){
+  static uint32_t state = 0x1D4C0DE5UL;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static void bench_random_frame(can_frame_t &frame){
+  uint8_t i;
+  frame.can_id = 0x1D4;
+  frame.can_dlc = 8;
+  frame.rx_cycles = 0;
+  for(i = 0; i < 8U; i++) {
+    frame.data[i] = (uint8_t)bench_rand();
+  }
+}
+
+//Table and delta versions must match the byte-wise reference bit for bit
+static bool bench_csum_selfcheck(void){
+  can_frame_t ref;
+  can_frame_t test;
+  uint32_t n;
+  uint8_t position;
+  uint8_t value;
+
+  bench_crctable_init();
+  if((0 != memcmp(bench_crctable, crc8_position_table[CSUM_CRC_BYTES - 1], sizeof(bench_crctable)))) {
+    printf("FAIL: crc8_position_table[6] differs from the CRC-8/0x85 table\n");
+    return false;
+  }
+  for(n = 0; n < BENCH_CSUM_CHECKS; n++) {
+    bench_random_frame(ref);
+    test = ref;
+    bench_crc8_bytewise(ref);
+    bench_crc8_position(test);
+    if(0 != memcmp(ref.data, test.data, 8)) {
+      printf("FAIL: CSUM_Crc8 differs from calc_crc8 on frame %u\n", (unsigned)n);
+      return false;
+    }
+
+    //Byte rewrite of a frame with a valid CRC: patched CRC equals the recomputed one
+    position = (uint8_t)(bench_rand() % CSUM_CRC_BYTES);
+    value = (uint8_t)bench_rand();
+    CSUM_SetByte(test, position, value);
+    ref.data[position] = value;
+    bench_crc8_bytewise(ref);
+    if(0 != memcmp(ref.data, test.data, 8)) {
+      printf("FAIL: CSUM_SetByte(%u) differs from calc_crc8 on frame %u\n", (unsigned)position, (unsigned)n);
+      return false;
+    }
+  }
+  return true;
+}
+
+template <void (*CHECKSUM)(can_frame_t &)>
+static void bench_run_checksum(const char * name, uint32_t frames){
+  can_frame_t templates[BENCH_PAYLOADS];
+  can_frame_t work;
+  bench_timer_t timer;
+  uint32_t done;
+  uint32_t i;
+  uint8_t repeat;
+
+  //Valid 0x1D4 frames with a running counter, so the validation case takes its full path
+  for(i = 0; i < BENCH_PAYLOADS; i++) {
+    bench_build(0x1D4, 8, bench_payload_1D4_power, i, templates[i]);
+  }
+
+  for(repeat = 0; repeat < BENCH_REPEAT; repeat++) {
+    BENCH_Clear(&timer);
+    for(done = 0; done < frames; done += BENCH_CSUM_BATCH) {
+      BENCH_Start(&timer);
+      for(i = 0; i < BENCH_CSUM_BATCH; i++) {
+        work = templates[i & (BENCH_PAYLOADS - 1U)];
+        CHECKSUM(work);
+        BENCH_Use(work);
+      }
+      BENCH_Stop(&timer, BENCH_CSUM_BATCH);
+    }
+    BENCH_Record(name, &timer);
+  }
+  BENCH_Report(name);
+}
+
+int main(int argc, char ** argv){
+  uint32_t frames = 1000000U;
+  uint32_t threshold_pct = 10U;
+  const char * baseline = NULL;
+  bool update = false;
+  uint32_t regressions;
+  uint32_t i;
+  int opt;
+
+  while(-1 != (opt = getopt(argc, argv, "n:b:ut:"))) {
+    switch(opt) {
+      case 'n': frames = (uint32_t)strtoul(optarg, NULL, 10); break;
+      case 'b': baseline = optarg; break;
+      case 'u': update = true; break;
+      case 't': threshold_pct = (uint32_t)strtoul(optarg, NULL, 10); break;
+      default:
+        fprintf(stderr, "usage: %s [-n frames] [-b baseline] [-u] [-t threshold_pct]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  if(!bench_csum_selfcheck()) {
+    return 1;
+  }
+
+  BENCH_Init();
+  SIM_Clock_Set(0U);
+  hw_init();
+  LEAF_CAN_Bridge_Manager_Init();
+  SCHED_Tick(micros());
+  bench_prime();
+
+  printf("LEAF_CAN_Handler, %u frames per case, best of %u%s:\n", (unsigned)frames, (unsigned)BENCH_REPEAT,
+         BENCH_InstructionsAvailable() ? "" : " (instruction counter not available)");
+  for(i = 0; i < BENCH_CASE_COUNT; i++) {
+    bench_run_case(&bench_cases[i], frames);
+  }
+  bench_run_synth_tick(frames / 100U);
+  bench_run_bus_stats(frames);
+  bench_run_checksum<bench_crc8_bytewise>("crc8_bytewise", frames);
+  bench_run_checksum<bench_crc8_position>("crc8_position", frames);
+  bench_run_checksum<bench_rewrite_bytewise>("rewrite_2byte_bytewise", frames);
+  bench_run_checksum<bench_rewrite_delta>("rewrite_2byte_delta", frames);
+  bench_run_checksum<bench_sum4>("sum4", frames);
+  bench_run_checksum<bench_csum_validate>("crc_validate_1D4", frames);
+
+  regressions = BENCH_Finish(baseline, update, threshold_pct);
+  if(regressions > 0U) {
+    printf("%u regression(s) above %u%%\n", (unsigned)regressions, (unsigned)threshold_pct);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,187 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Host microbenchmark support: wall clock and instruction counting, baseline files
+// 10.16.2026: Per-frame benchmarks of the bridge engine, see host/Makefile
+//——————————————————————————————————————————————————————————————————————————————
+// Instructions are counted with the Linux perf_event interface (user space only). Where that is
+// not permitted (containers, perf_event_paranoid) only the time is reported.
+//
+// Baseline file format, one case per line: "<name> <ns/op> <instructions/op>"
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "bench_util.h"
+
+static int bench_perf_fd = -1;
+static bench_result_t bench_results[BENCH_MAX_RESULTS];
+static uint32_t bench_result_count = 0;
+
+//——————————————————————————————————————————————————————————————————————————————
+// Counters
+//——————————————————————————————————————————————————————————————————————————————
+void BENCH_Init(void){
+  struct perf_event_attr attr;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  bench_perf_fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+  if(bench_perf_fd >= 0) {
+    ioctl(bench_perf_fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(bench_perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+bool BENCH_InstructionsAvailable(void){
+  return (bench_perf_fd >= 0);
+}
+
+static uint64_t bench_now_ns(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t bench_instructions(void){
+  uint64_t count = 0;
+  if((bench_perf_fd < 0) || (sizeof(count) != read(bench_perf_fd, &count, sizeof(count)))) {
+    return 0;
+  }
+  return count;
+}
+
+void BENCH_Clear(bench_timer_t * timer){
+  memset(timer, 0, sizeof(*timer));
+}
+
+void BENCH_Start(bench_timer_t * timer){
+  timer->start_instructions = bench_instructions();
+  timer->start_ns = bench_now_ns();
+}
+
+void BENCH_Stop(bench_timer_t * timer, uint32_t ops){
+  uint64_t now_ns = bench_now_ns();
+  uint64_t now_instructions = bench_instructions();
+
+  timer->ns += now_ns - timer->start_ns;
+  timer->instructions += now_instructions - timer->start_instructions;
+  timer->ops += ops;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Results
+//——————————————————————————————————————————————————————————————————————————————
+static bench_result_t * bench_find(bench_result_t * table, uint32_t count, const char * name){
+  uint32_t i;
+  for(i = 0; i < count; i++) {
+    if(0 == strcmp(table[i].name, name)) {
+      return &table[i];
+    }
+  }
+  return NULL;
+}
+
+void BENCH_Record(const char * name, const bench_timer_t * timer){
+  bench_result_t * result = bench_find(bench_results, bench_result_count, name);
+  double ns_per_op;
+  double instr_per_op;
+
+  if(0U == timer->ops) {
+    return;
+  }
+  ns_per_op = (double)timer->ns / (double)timer->ops;
+  instr_per_op = BENCH_InstructionsAvailable() ? ((double)timer->instructions / (double)timer->ops) : -1.0;
+
+  if(NULL == result) {
+    if(bench_result_count >= BENCH_MAX_RESULTS) {
+      return;
+    }
+    result = &bench_results[bench_result_count++];
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    result->ns_per_op = ns_per_op;
+    result->instr_per_op = instr_per_op;
+  } else if(ns_per_op < result->ns_per_op) {
+    result->ns_per_op = ns_per_op;
+    result->instr_per_op = instr_per_op;
+  }
+}
+
+void BENCH_Report(const char * name){
+  bench_result_t * result = bench_find(bench_results, bench_result_count, name);
+
+  if(NULL == result) {
+    return;
+  }
+  if(result->instr_per_op >= 0.0) {
+    printf("  %-24s %9.1f ns/op %9.1f instr/op\n", result->name, result->ns_per_op, result->instr_per_op);
+  } else {
+    printf("  %-24s %9.1f ns/op %9s instr/op\n", result->name, result->ns_per_op, "-");
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Baseline comparison
+//——————————————————————————————————————————————————————————————————————————————
+uint32_t BENCH_Finish(const char * baseline_path, bool update, uint32_t threshold_pct){
+  bench_result_t baseline[BENCH_MAX_RESULTS];
+  uint32_t baseline_count = 0;
+  uint32_t regressions = 0;
+  uint32_t i;
+  FILE * file;
+
+  if(NULL == baseline_path) {
+    return 0;
+  }
+
+  file = fopen(baseline_path, "r");
+  if(NULL != file) {
+    while((baseline_count < BENCH_MAX_RESULTS) &&
+          (3 == fscanf(file, "%31s %lf %lf", baseline[baseline_count].name,
+                       &baseline[baseline_count].ns_per_op, &baseline[baseline_count].instr_per_op))) {
+      baseline_count++;
+    }
+    fclose(file);
+
+    printf("Against baseline %s (threshold %u%%):\n", baseline_path, (unsigned)threshold_pct);
+    for(i = 0; i < bench_result_count; i++) {
+      const bench_result_t * now = &bench_results[i];
+      const bench_result_t * base = bench_find(baseline, baseline_count, now->name);
+      double change;
+
+      if((NULL == base) || (base->ns_per_op <= 0.0)) {
+        printf("  %-24s new\n", now->name);
+        continue;
+      }
+      change = ((now->ns_per_op - base->ns_per_op) * 100.0) / base->ns_per_op;
+      if(change > (double)threshold_pct) {
+        regressions++;
+      }
+      printf("  %-24s %+7.1f%%%s\n", now->name, change, (change > (double)threshold_pct) ? "  REGRESSION" : "");
+    }
+  } else {
+    update = true;
+  }
+
+  if(update) {
+    file = fopen(baseline_path, "w");
+    if(NULL == file) {
+      fprintf(stderr, "cannot write baseline %s\n", baseline_path);
+      return regressions;
+    }
+    for(i = 0; i < bench_result_count; i++) {
+      fprintf(file, "%s %.2f %.2f\n", bench_results[i].name, bench_results[i].ns_per_op, bench_results[i].instr_per_op);
+    }
+    fclose(file);
+    printf("Baseline written to %s\n", baseline_path);
+  }
+
+  return regressions;
+}
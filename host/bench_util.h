@@ -0,0 +1,49 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Host microbenchmark support: wall clock and instruction counting, baseline files
+// 10.16.2026: Per-frame benchmarks of the bridge engine, see host/Makefile
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <stdint.h>
+
+#define BENCH_MAX_RESULTS   64
+#define BENCH_NAME_LEN      32
+#define BENCH_REPEAT        5       //measurements per case, the fastest one is reported
+
+//Accumulates only the time between BENCH_Start() and BENCH_Stop(), so the harness can do
+//untimed work (draining buffers, rebuilding inputs) between timed batches.
+typedef struct {
+  uint64_t ns;
+  uint64_t instructions;
+  uint64_t ops;
+  uint64_t start_ns;
+  uint64_t start_instructions;
+} bench_timer_t;
+
+typedef struct {
+  char   name[BENCH_NAME_LEN];
+  double ns_per_op;
+  double instr_per_op;    //negative when the instruction counter is not available
+} bench_result_t;
+
+void BENCH_Init(void);
+bool BENCH_InstructionsAvailable(void);
+
+void BENCH_Clear(bench_timer_t * timer);
+void BENCH_Start(bench_timer_t * timer);
+void BENCH_Stop(bench_timer_t * timer, uint32_t ops);
+
+//Keep the best of the BENCH_REPEAT measurements of one case and print it
+void BENCH_Record(const char * name, const bench_timer_t * timer);
+void BENCH_Report(const char * name);
+
+//Compare with the baseline file (if present) and optionally rewrite it with the current results.
+//Returns the number of cases slower than the baseline by more than threshold_pct.
+uint32_t BENCH_Finish(const char * baseline_path, bool update, uint32_t threshold_pct);
+
+//Keep the compiler from optimizing benchmarked results away
+template <typename T> inline void BENCH_Use(const T &value) { __asm__ volatile("" : : "g"(&value) : "memory"); }
+
+#endif //BENCH_UTIL_H
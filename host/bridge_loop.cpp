@@ -0,0 +1,42 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Bridge task loop of the host build (BridgeTask in ACAN2515_ESP32_INVERTER.ino on the target)
+// 10.16.2026: Shared by the simulation and the trace replay
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include "config.h"
+#include "can_driver.h"
+#include "can_bridge_manager_common.h"
+#include "can_bridge_manager_leaf.h"
+#include "helper_functions.h"
+#include "frame_scheduler.h"
+#include "bridge_loop.h"
+
+static uint32_t counter_1sec = 0;
+
+void HOST_BridgeInit(void){
+  counter_1sec = 0;
+  HOST_ConfigInit();
+  hw_init();
+  LEAF_CAN_Bridge_Manager_Init();
+  TIMER_Start();
+}
+
+void HOST_BridgePass(void){
+  LCFG_Quiescent();
+
+  if( NISSAN_LEAF_CONFIG_IN(LCFG_Get()) )
+  {
+    LEAF_CAN_Bridge_Manager();
+  }
+
+  SCHED_Tick(micros());
+  Schedule_Buffer_Check_CAN();
+
+  counter_1sec++;
+  if(counter_1sec > INTERVAL_1SEC) {
+    counter_1sec = 0;
+    TIMER_Count();
+    CAN_Rx_Monitor();
+  }
+}
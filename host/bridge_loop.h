@@ -0,0 +1,20 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Bridge task loop of the host build (BridgeTask in ACAN2515_ESP32_INVERTER.ino on the target)
+// 10.16.2026: Shared by the simulation and the trace replay
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef BRIDGE_LOOP_H
+#define BRIDGE_LOOP_H
+
+#include <Arduino.h>
+
+//OTA selections of the host build (host_config.cpp), active at once: no bridge pass may be running
+void HOST_ConfigInit(void);
+
+//Boot as setup() does: controllers, dispatch table, frame scheduler, 1 s timer
+void HOST_BridgeInit(void);
+
+//One T_POLLING pass at the current simulated time, same order as BridgeTask
+void HOST_BridgePass(void);
+
+#endif //BRIDGE_LOOP_H
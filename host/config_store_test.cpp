@@ -0,0 +1,131 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Settings blob (config_store.h): CRC, validation, older/newer layouts, deferred write
+// 10.16.2026: Checks of the stored format the sketch reads once at boot and writes from housekeeping
+//——————————————————————————————————————————————————————————————————————————————
+// Usage: config_store_test   exit code 1 when a check fails
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include "config_store.h"
+
+static uint32_t test_failures = 0;
+
+static void test_check(const char * name, bool ok){
+  printf("  %-40s %s\n", name, ok ? "ok" : "FAIL");
+  if(!ok){
+    test_failures++;
+  }
+}
+
+static void test_settings(cfg_blob_t * cfg){
+  CFG_Defaults(cfg);
+  cfg->vehicle = 3;
+  cfg->inverter = 1;
+  cfg->battery = 2;
+  cfg->battery_saver = 2;
+  cfg->glide = 1;
+  cfg->current_control = 5;
+  cfg->maps[TMAP_REGEN].version = TMAP_VERSION;
+  cfg->maps[TMAP_REGEN].nx = 2;
+  cfg->maps[TMAP_REGEN].ny = 1;
+  cfg->maps[TMAP_REGEN].x[1] = TMAP_X_MAX;
+  cfg->maps[TMAP_REGEN].v[0][0] = 1000;
+  cfg->maps[TMAP_REGEN].v[0][1] = 1500;
+}
+
+static bool test_same(const cfg_blob_t * a, const cfg_blob_t * b){
+  return (0 == memcmp((const uint8_t *)a + sizeof(cfg_header_t), (const uint8_t *)b + sizeof(cfg_header_t),
+                      sizeof(cfg_blob_t) - sizeof(cfg_header_t)));
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Blob
+//——————————————————————————————————————————————————————————————————————————————
+static void test_blob(void){
+  uint8_t stored[CFG_BLOB_MAX];
+  cfg_blob_t cfg;
+  cfg_blob_t loaded;
+  cfg_blob_t defaults;
+  cfg_header_t header;
+
+  CFG_Defaults(&defaults);
+  test_check("crc32 check value", 0xCBF43926UL == CFG_Crc32("123456789", 9));
+
+  test_settings(&cfg);
+  CFG_Seal(&cfg);
+  test_check("round trip", CFG_Load(&cfg, sizeof(cfg), &loaded) && test_same(&cfg, &loaded) &&
+                           (CFG_VERSION == loaded.header.version));
+
+  memcpy(stored, &cfg, sizeof(cfg));
+  stored[sizeof(cfg_header_t) + 1] ^= 0x01;
+  test_check("corrupted byte rejected", !CFG_Load(stored, sizeof(cfg), &loaded) && test_same(&defaults, &loaded));
+
+  test_check("truncated read rejected", !CFG_Load(&cfg, sizeof(cfg) - 1, &loaded));
+  test_check("empty read rejected", !CFG_Load(&cfg, 0, &loaded) && test_same(&defaults, &loaded));
+
+  memcpy(stored, &cfg, sizeof(cfg));
+  ((cfg_header_t *)stored)->version = 0;
+  test_check("version 0 rejected", !CFG_Load(stored, sizeof(cfg), &loaded));
+
+  //Older layout: only the selections, the maps were appended later
+  memset(stored, 0, sizeof(stored));
+  memcpy(stored, &cfg, 16);
+  header.version = 1;
+  header.reserved = 0;
+  header.size = 16;
+  header.crc = 0;
+  memcpy(stored, &header, sizeof(header));
+  header.crc = CFG_Crc32(stored, 16);
+  memcpy(stored, &header, sizeof(header));
+  test_check("older layout, appended fields default", CFG_Load(stored, 16, &loaded) && (3 == loaded.vehicle) &&
+                                                      (5 == loaded.current_control) && (0 == loaded.maps[TMAP_REGEN].nx));
+
+  //Newer layout (downgrade): 32 more bytes this version does not know
+  memset(stored, 0xA5, sizeof(stored));
+  memcpy(stored, &cfg, sizeof(cfg));
+  header = cfg.header;
+  header.version = CFG_VERSION + 1;
+  header.size = (uint16_t)(sizeof(cfg) + 32U);
+  header.crc = 0;
+  memcpy(stored, &header, sizeof(header));
+  header.crc = CFG_Crc32(stored, header.size);
+  memcpy(stored, &header, sizeof(header));
+  test_check("newer layout, known fields read", CFG_Load(stored, header.size, &loaded) && test_same(&cfg, &loaded) &&
+                                                ((CFG_VERSION + 1) == loaded.header.version));
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Deferred write
+//——————————————————————————————————————————————————————————————————————————————
+static void test_deferred(void){
+  bool ok;
+
+  test_check("nothing to save", !CFG_SaveDue(0));
+
+  CFG_MarkDirty(1000);
+  ok = !CFG_SaveDue(1000 + CFG_SAVE_DELAY_MS - 1U) && CFG_SaveDue(1000 + CFG_SAVE_DELAY_MS) &&
+       !CFG_SaveDue(1000 + (3U * CFG_SAVE_DELAY_MS));
+  test_check("saved once after the quiet time", ok);
+
+  //Six setters of one form submit, then a second change burst before the quiet time ended
+  for(uint32_t t = 10000; t < 10006; t++){
+    CFG_MarkDirty(t);
+  }
+  CFG_MarkDirty(10000 + CFG_SAVE_DELAY_MS - 10U);
+  ok = !CFG_SaveDue(10005 + CFG_SAVE_DELAY_MS) && CFG_SaveDue(10000 + (2U * CFG_SAVE_DELAY_MS) - 10U) &&
+       !CFG_SaveDue(10000 + (4U * CFG_SAVE_DELAY_MS));
+  test_check("burst coalesced into one save", ok);
+
+  CFG_MarkDirty(0xFFFFFFFFUL - 100U);
+  ok = !CFG_SaveDue(50) && CFG_SaveDue(CFG_SAVE_DELAY_MS);
+  test_check("millis() wrap", ok);
+}
+
+int main(int argc, char ** argv){
+  printf("Settings blob, %u bytes, version %u:\n", (unsigned)sizeof(cfg_blob_t), (unsigned)CFG_VERSION);
+  test_blob();
+  printf("Deferred write, %u ms quiet time:\n", (unsigned)CFG_SAVE_DELAY_MS);
+  test_deferred();
+  printf("%s\n", (0U == test_failures) ? "PASS" : "FAIL");
+  return (0U == test_failures) ? 0 : 1;
+}
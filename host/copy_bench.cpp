@@ -0,0 +1,234 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Frame copies per forwarded frame, former by-value path against the by-reference path
+// 10.16.2026: Microbenchmark of the zero-copy frame path (CAN2 receive ring to MCP2515 CANMessage)
+//——————————————————————————————————————————————————————————————————————————————
+// Both paths are the stages of a frame forwarded from CAN2 to CAN1, written with the types of
+// the engine (can_frame_t, spsc_ring, CANMessage) and the signatures each version had:
+//
+//   by_value:     CAN2_ReadNewFrame() copies the ring slot out, LEAF_CAN_Handler(can_frame_t) and
+//                 its local memcpy, buffer_send_can1(can_frame_t), tx_push() building a tx entry
+//                 that ring.push() copies again, send(can_frame_t) into the CANMessage
+//   by_reference: the handler works in the ring slot (CAN2_PeekFrame), buffer_send_can1() and
+//                 direct_send_can1() take const references, tx_push() writes into ring.back()
+//
+// Each stage counts the frames it copies, so the report gives copies and bytes per frame next to
+// the time. Common to both: the ISR copy into the receive ring, the move into the priority heap
+// and the CANMessage conversion the ACAN2515 library needs.
+//
+// Usage: copy_bench [-n frames]
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include <unistd.h>
+#include <ACAN2515.h>
+#include "canframe.h"
+#include "config.h"
+#include "spsc_ring.h"
+#include "bench_util.h"
+
+#define COPY_RING_SIZE  32
+#define COPY_BATCH      8       //frames per timed batch, one drain budget
+
+typedef struct {
+  can_frame_t frame;
+  uint32_t    enqueue_us;
+} copy_tx_entry_t;
+
+static spsc_ring<can_frame_t, COPY_RING_SIZE> copy_rx_ring;
+static spsc_ring<copy_tx_entry_t, COPY_RING_SIZE> copy_tx_ring;
+static copy_tx_entry_t copy_heap[COPY_RING_SIZE];
+static uint32_t copy_heap_len = 0;
+static CANMessage copy_wire;
+static uint32_t copy_count = 0;
+
+//Stand-in for the translation: one byte patched, as most handlers do
+static inline void copy_translate(can_frame_t &frame){
+  frame.data[1] = (uint8_t)(frame.data[1] ^ 0x40);
+}
+
+//Common stages
+static void copy_isr(const can_frame_t &frame){
+  (void)copy_rx_ring.push(frame);
+  copy_count++;
+}
+
+static void copy_heap_insert(const copy_tx_entry_t * entry){
+  copy_heap[copy_heap_len++] = *entry;
+  copy_count++;
+}
+
+static bool copy_to_message(const can_frame_t &frame){
+  uint8_t i;
+
+  copy_wire.ext = false;
+  copy_wire.id = frame.can_id;
+  copy_wire.len = frame.can_dlc;
+  for(i = 0; i < frame.can_dlc; i++) {
+    copy_wire.data[i] = frame.data[i];
+  }
+  copy_count++;
+  BENCH_Use(copy_wire);
+  return true;
+}
+
+static void copy_drain(bool (*send)(const copy_tx_entry_t *)){
+  copy_tx_entry_t * entry;
+  uint32_t i;
+
+  while(NULL != (entry = copy_tx_ring.front())) {
+    copy_heap_insert(entry);
+    copy_tx_ring.pop();
+  }
+  for(i = 0; i < copy_heap_len; i++) {
+    (void)send(&copy_heap[i]);
+  }
+  copy_heap_len = 0;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Former path: frames passed by value
+//——————————————————————————————————————————————————————————————————————————————
+static __attribute__((noinline)) bool byval_direct_send_can1(can_frame_t frame){
+  copy_count++;
+  return copy_to_message(frame);
+}
+
+static bool byval_send(const copy_tx_entry_t * entry){
+  return byval_direct_send_can1(entry->frame);
+}
+
+static __attribute__((noinline)) bool byval_tx_push(const can_frame_t * frame){
+  copy_tx_entry_t entry;
+
+  entry.frame = *frame;
+  entry.enqueue_us = 0U;
+  copy_count++;
+  copy_count++;           //ring.push(entry)
+  return copy_tx_ring.push(entry);
+}
+
+static __attribute__((noinline)) void byval_buffer_send_can1(can_frame_t frame){
+  copy_count++;
+  (void)byval_tx_push(&frame);
+}
+
+static __attribute__((noinline)) void byval_handler(uint8_t can_bus, can_frame_t new_rx_frame){
+  can_frame_t frame;
+
+  copy_count++;
+  memcpy(&frame, &new_rx_frame, sizeof(new_rx_frame));
+  copy_count++;
+  copy_translate(frame);
+  byval_buffer_send_can1(frame);
+}
+
+static void byval_forward(void){
+  can_frame_t * slot;
+  can_frame_t frame;
+
+  while(NULL != (slot = copy_rx_ring.front())) {
+    frame = *slot;        //CAN2_ReadNewFrame()
+    copy_count++;
+    copy_rx_ring.pop();
+    byval_handler(CAN_CHANNEL_2, frame);
+  }
+  copy_drain(byval_send);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Current path: frames passed by reference, handled in their ring slot
+//——————————————————————————————————————————————————————————————————————————————
+static __attribute__((noinline)) bool byref_direct_send_can1(const can_frame_t &frame){
+  return copy_to_message(frame);
+}
+
+static bool byref_send(const copy_tx_entry_t * entry){
+  return byref_direct_send_can1(entry->frame);
+}
+
+static __attribute__((noinline)) bool byref_tx_push(const can_frame_t &frame){
+  copy_tx_entry_t * entry = copy_tx_ring.back();
+
+  if(NULL == entry) {
+    return false;
+  }
+  entry->frame = frame;
+  entry->enqueue_us = 0U;
+  copy_count++;
+  copy_tx_ring.publish();
+  return true;
+}
+
+static __attribute__((noinline)) void byref_buffer_send_can1(const can_frame_t &frame){
+  (void)byref_tx_push(frame);
+}
+
+static __attribute__((noinline)) void byref_handler(uint8_t can_bus, can_frame_t &frame){
+  copy_translate(frame);
+  byref_buffer_send_can1(frame);
+}
+
+static void byref_forward(void){
+  can_frame_t * slot;
+
+  while(NULL != (slot = copy_rx_ring.front())) {
+    byref_handler(CAN_CHANNEL_2, *slot);
+    copy_rx_ring.pop();
+  }
+  copy_drain(byref_send);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Cases
+//——————————————————————————————————————————————————————————————————————————————
+static void copy_run(const char * name, void (*forward)(void), uint32_t frames){
+  can_frame_t frame;
+  bench_timer_t timer;
+  uint32_t done;
+  uint32_t i;
+  uint8_t repeat;
+
+  memset(&frame, 0, sizeof(frame));
+  frame.can_id = 0x5BC;
+  frame.can_dlc = 8;
+
+  for(repeat = 0; repeat < BENCH_REPEAT; repeat++) {
+    BENCH_Clear(&timer);
+    copy_count = 0;
+    for(done = 0; done < frames; done += COPY_BATCH) {
+      BENCH_Start(&timer);
+      for(i = 0; i < COPY_BATCH; i++) {
+        frame.data[0] = (uint8_t)(done + i);
+        copy_isr(frame);
+      }
+      forward();
+      BENCH_Stop(&timer, COPY_BATCH);
+    }
+    BENCH_Record(name, &timer);
+  }
+  BENCH_Report(name);
+  printf("  %-24s %9.1f copies/op %7.0f bytes/op\n", "", (double)copy_count / (double)done,
+         ((double)copy_count * sizeof(can_frame_t)) / (double)done);
+}
+
+int main(int argc, char ** argv){
+  uint32_t frames = 1000000U;
+  int opt;
+
+  while(-1 != (opt = getopt(argc, argv, "n:"))) {
+    switch(opt) {
+      case 'n': frames = (uint32_t)strtoul(optarg, NULL, 10); break;
+      default:
+        fprintf(stderr, "usage: %s [-n frames]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  BENCH_Init();
+  printf("CAN2 -> CAN1 forward, %u frames, can_frame_t %u bytes, best of %u%s:\n", (unsigned)frames,
+         (unsigned)sizeof(can_frame_t), (unsigned)BENCH_REPEAT,
+         BENCH_InstructionsAvailable() ? "" : " (instruction counter not available)");
+  copy_run("by_value", byval_forward, frames);
+  copy_run("by_reference", byref_forward, frames);
+  return 0;
+}
@@ -0,0 +1,528 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: DBC to C++ generator for the signal codec (can_signal.h)
+// 10.16.2026: Signal descriptors, decoded message structs and decode/encode per message
+//——————————————————————————————————————————————————————————————————————————————
+// Reads the BO_ (message), SG_ (signal) and CM_ (comment) lines of a DBC file and writes a
+// header for the firmware and the host tools, per message in ID order:
+//   <PREFIX>_<ID>_ID / _DLC                    defines
+//   <PREFIX>_<ID>_<SIGNAL>                     sig_def<> descriptor of every signal
+//   <prefix>_<id>_t                            struct with one member per signal (raw values)
+//   <PREFIX>_Decode_<ID>() / _Encode_<ID>()    all signals of a payload, inlined
+// The descriptors are compile time constants, so each decode/encode compiles to the loads, shifts
+// and masks of its signals without branches or loops.
+//
+// The DBC factor becomes the integer ratio SCALE_NUM / SCALE_DEN of sig_def (denominator up to
+// 100000), the offset has to be an integer. Multiplexed signals, extended IDs, signals outside
+// the payload and overlapping signals are rejected. The output has CRLF line endings like the
+// rest of the sketch and only depends on the DBC, so it can be checked in and compared.
+//
+// Usage: dbc_gen -i input.dbc -o output.h [-p PREFIX]    exit code 1 on a DBC error
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include <unistd.h>
+#include <math.h>
+#include <stdarg.h>
+#include "can_signal.h"
+
+#define GEN_MAX_MESSAGES      64
+#define GEN_MAX_SIGNALS       32      //per message
+#define GEN_NAME_LEN          48
+#define GEN_TEXT_LEN          128
+#define GEN_LINE_LEN          512
+#define GEN_MAX_DEN           100000
+
+typedef struct {
+  char     name[GEN_NAME_LEN];
+  uint8_t  start;
+  uint8_t  length;
+  uint8_t  order;
+  uint8_t  sign;
+  int32_t  scale_num;
+  int32_t  scale_den;
+  int32_t  offset;
+  double   factor;
+  char     unit[GEN_NAME_LEN];
+  char     comment[GEN_TEXT_LEN];
+} gen_signal_t;
+
+typedef struct {
+  uint32_t     can_id;
+  char         name[GEN_NAME_LEN];
+  uint8_t      dlc;
+  char         sender[GEN_NAME_LEN];
+  char         comment[GEN_TEXT_LEN];
+  uint8_t      count;
+  gen_signal_t signals[GEN_MAX_SIGNALS];
+} gen_message_t;
+
+static gen_message_t gen_messages[GEN_MAX_MESSAGES];
+static uint8_t gen_count = 0;
+static char gen_version[GEN_TEXT_LEN];
+static const char * gen_path = "";
+static uint32_t gen_line = 0;
+
+static bool gen_error(const char * message, const char * detail){
+  fprintf(stderr, "%s:%u: %s%s%s\n", gen_path, (unsigned)gen_line, message, detail ? ": " : "", detail ? detail : "");
+  return false;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Parsing
+//——————————————————————————————————————————————————————————————————————————————
+static const char * gen_skip(const char * p){
+  while((' ' == *p) || ('\t' == *p)) {
+    p++;
+  }
+  return p;
+}
+
+//Identifier into out, returns the position after it (NULL if there is none)
+static const char * gen_ident(const char * p, char * out){
+  size_t n = 0;
+
+  p = gen_skip(p);
+  while(isalnum((unsigned char)*p) || ('_' == *p)) {
+    if(n < (GEN_NAME_LEN - 1)) {
+      out[n++] = *p;
+    }
+    p++;
+  }
+  out[n] = '\0';
+  return (n > 0) ? p : NULL;
+}
+
+//Quoted string into out (up to len - 1 characters), returns the position after the closing quote
+static const char * gen_quoted(const char * p, char * out, size_t len){
+  size_t n = 0;
+
+  p = gen_skip(p);
+  if('"' != *p) {
+    return NULL;
+  }
+  p++;
+  while(('\0' != *p) && ('"' != *p)) {
+    if(n < (len - 1)) {
+      out[n++] = *p;
+    }
+    p++;
+  }
+  out[n] = '\0';
+  return ('"' == *p) ? (p + 1) : NULL;
+}
+
+static gen_message_t * gen_find(uint32_t can_id){
+  uint8_t i;
+  for(i = 0; i < gen_count; i++) {
+    if(gen_messages[i].can_id == can_id) {
+      return &gen_messages[i];
+    }
+  }
+  return NULL;
+}
+
+//Factor as an integer ratio, offset as an integer
+static bool gen_scale(gen_signal_t * sig, double factor, double offset){
+  int32_t den;
+
+  if((0.0 == factor) || (fabs(factor) > 1000000.0)) {
+    return gen_error("unsupported factor", sig->name);
+  }
+  for(den = 1; den <= GEN_MAX_DEN; den++) {
+    double num = factor * den;
+    if(fabs(num - floor(num + 0.5)) <= (1e-9 * fabs(num))) {
+      sig->scale_num = (int32_t)floor(num + 0.5);
+      sig->scale_den = den;
+      break;
+    }
+  }
+  if(den > GEN_MAX_DEN) {
+    return gen_error("factor is not a ratio of integers", sig->name);
+  }
+  if((offset != floor(offset)) || (fabs(offset) > 2147483647.0)) {
+    return gen_error("offset is not an integer", sig->name);
+  }
+  sig->offset = (int32_t)offset;
+  sig->factor = factor;
+  return true;
+}
+
+// BO_ 468 VCM_1D4: 8 VCM
+static bool gen_parse_message(const char * p){
+  gen_message_t * msg;
+  char * end;
+  unsigned long can_id;
+
+  if(gen_count >= GEN_MAX_MESSAGES) {
+    return gen_error("too many messages", NULL);
+  }
+  msg = &gen_messages[gen_count];
+  memset(msg, 0, sizeof(*msg));
+  can_id = strtoul(p, &end, 10);
+  if(end == p) {
+    return gen_error("message without an ID", NULL);
+  }
+  if(can_id > 0x7FFUL) {
+    return gen_error("extended IDs are not supported", NULL);
+  }
+  if(NULL != gen_find((uint32_t)can_id)) {
+    return gen_error("duplicate message ID", NULL);
+  }
+  msg->can_id = (uint32_t)can_id;
+  p = gen_ident(end, msg->name);
+  if((NULL == p) || (':' != *(p = gen_skip(p)))) {
+    return gen_error("malformed BO_ line", NULL);
+  }
+  msg->dlc = (uint8_t)strtoul(p + 1, &end, 10);
+  if((end == (p + 1)) || (msg->dlc > CAN_MAX_DLEN)) {
+    return gen_error("invalid DLC", msg->name);
+  }
+  if(NULL == gen_ident(end, msg->sender)) {
+    strcpy(msg->sender, "Vector__XXX");
+  }
+  gen_count++;
+  return true;
+}
+
+//  SG_ TORQUE : 23|12@0- (0.25,0) [-512|511.75] "Nm" INV,BRIDGE
+static bool gen_parse_signal(const char * p){
+  gen_message_t * msg;
+  gen_signal_t * sig;
+  char * end;
+  unsigned long start;
+  unsigned long length;
+  double factor;
+  double offset;
+  uint8_t i;
+
+  if(0 == gen_count) {
+    return gen_error("signal outside a message", NULL);
+  }
+  msg = &gen_messages[gen_count - 1];
+  if(msg->count >= GEN_MAX_SIGNALS) {
+    return gen_error("too many signals", msg->name);
+  }
+  sig = &msg->signals[msg->count];
+  memset(sig, 0, sizeof(*sig));
+  if(NULL == (p = gen_ident(p, sig->name))) {
+    return gen_error("malformed SG_ line", NULL);
+  }
+  p = gen_skip(p);
+  if(':' != *p) {
+    return gen_error("multiplexed signals are not supported", sig->name);
+  }
+  start = strtoul(p + 1, &end, 10);
+  if('|' != *end) {
+    return gen_error("malformed start bit", sig->name);
+  }
+  length = strtoul(end + 1, &end, 10);
+  if(('@' != end[0]) || (('0' != end[1]) && ('1' != end[1])) || (('+' != end[2]) && ('-' != end[2]))) {
+    return gen_error("malformed byte order or sign", sig->name);
+  }
+  sig->order = ('0' == end[1]) ? SIG_MOTOROLA : SIG_INTEL;
+  sig->sign = ('-' == end[2]) ? SIG_SIGNED : SIG_UNSIGNED;
+  if((start > 63UL) || (length < 1UL) || (length > 32UL) || !SIG_Fits((uint8_t)start, (uint8_t)length, sig->order)) {
+    return gen_error("signal does not fit into the payload", sig->name);
+  }
+  sig->start = (uint8_t)start;
+  sig->length = (uint8_t)length;
+  if(SIG_LastByte(sig->start, sig->length, sig->order) >= msg->dlc) {
+    return gen_error("signal beyond the DLC", sig->name);
+  }
+  p = gen_skip(end + 3);
+  if(('(' != *p) || (2 != sscanf(p, "(%lf,%lf)", &factor, &offset))) {
+    return gen_error("malformed factor/offset", sig->name);
+  }
+  if(!gen_scale(sig, factor, offset)) {
+    return false;
+  }
+  p = strchr(p, ']');
+  if((NULL == p) || (NULL == gen_quoted(p + 1, sig->unit, sizeof(sig->unit)))) {
+    return gen_error("malformed range or unit", sig->name);
+  }
+  for(i = 0; i < msg->count; i++) {
+    if(0 == strcmp(msg->signals[i].name, sig->name)) {
+      return gen_error("duplicate signal", sig->name);
+    }
+  }
+  msg->count++;
+  return true;
+}
+
+// CM_ BO_ 468 "text";   CM_ SG_ 468 TORQUE "text";   (single line)
+static bool gen_parse_comment(const char * p){
+  gen_message_t * msg;
+  char kind[GEN_NAME_LEN];
+  char name[GEN_NAME_LEN];
+  char * end;
+  uint8_t i;
+
+  if((NULL == (p = gen_ident(p, kind))) || ((0 != strcmp(kind, "BO_")) && (0 != strcmp(kind, "SG_")))) {
+    return true;  //network and node comments are not used
+  }
+  msg = gen_find((uint32_t)strtoul(p, &end, 10));
+  if(NULL == msg) {
+    return gen_error("comment for an unknown message", NULL);
+  }
+  if(0 == strcmp(kind, "BO_")) {
+    return (NULL != gen_quoted(end, msg->comment, sizeof(msg->comment))) || gen_error("malformed comment", NULL);
+  }
+  if(NULL == (p = gen_ident(end, name))) {
+    return gen_error("malformed comment", NULL);
+  }
+  for(i = 0; i < msg->count; i++) {
+    if(0 == strcmp(msg->signals[i].name, name)) {
+      return (NULL != gen_quoted(p, msg->signals[i].comment, sizeof(msg->signals[i].comment))) || gen_error("malformed comment", name);
+    }
+  }
+  return gen_error("comment for an unknown signal", name);
+}
+
+//Signals of one message must not share a bit
+static bool gen_check_overlap(const gen_message_t * msg){
+  uint8_t used[CAN_MAX_DLEN] = { 0 };
+  uint8_t i;
+  uint8_t b;
+
+  for(i = 0; i < msg->count; i++) {
+    const gen_signal_t * sig = &msg->signals[i];
+    uint8_t bits[CAN_MAX_DLEN] = { 0 };
+    SIG_Insert(bits, sig->start, sig->length, sig->order, 0xFFFFFFFFUL);
+    for(b = 0; b < CAN_MAX_DLEN; b++) {
+      if(0 != (used[b] & bits[b])) {
+        gen_line = 0;
+        return gen_error("overlapping signals in message", msg->name);
+      }
+      used[b] |= bits[b];
+    }
+  }
+  return true;
+}
+
+static bool gen_parse(const char * path){
+  char line[GEN_LINE_LEN];
+  FILE * file;
+  bool ok = true;
+  uint8_t i;
+
+  gen_path = path;
+  file = fopen(path, "r");
+  if(NULL == file) {
+    fprintf(stderr, "cannot open %s\n", path);
+    return false;
+  }
+  while(ok && (NULL != fgets(line, sizeof(line), file))) {
+    const char * p = gen_skip(line);
+    gen_line++;
+    line[strcspn(line, "\r\n")] = '\0';
+    if(0 == strncmp(p, "VERSION", 7)) {
+      gen_quoted(p + 7, gen_version, sizeof(gen_version));
+    } else if(0 == strncmp(p, "BO_ ", 4)) {
+      ok = gen_parse_message(p + 4);
+    } else if(0 == strncmp(p, "SG_ ", 4)) {
+      ok = gen_parse_signal(p + 4);
+    } else if(0 == strncmp(p, "CM_ ", 4)) {
+      ok = gen_parse_comment(p + 4);
+    }
+  }
+  fclose(file);
+  for(i = 0; ok && (i < gen_count); i++) {
+    ok = gen_check_overlap(&gen_messages[i]);
+  }
+  return ok;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Output
+//——————————————————————————————————————————————————————————————————————————————
+static FILE * gen_out;
+
+//printf with CRLF line endings ('\n' in the format becomes "\r\n")
+static void gen_printf(const char * format, ...) __attribute__((format(printf, 1, 2)));
+static void gen_printf(const char * format, ...){
+  char text[GEN_LINE_LEN];
+  va_list args;
+  const char * p;
+
+  va_start(args, format);
+  vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+  for(p = text; '\0' != *p; p++) {
+    if('\n' == *p) {
+      fputc('\r', gen_out);
+    }
+    fputc(*p, gen_out);
+  }
+}
+
+static const char * gen_type(const gen_signal_t * sig){
+  if(SIG_SIGNED == sig->sign) {
+    return (sig->length <= 8) ? "int8_t" : ((sig->length <= 16) ? "int16_t" : "int32_t");
+  }
+  return (sig->length <= 8) ? "uint8_t" : ((sig->length <= 16) ? "uint16_t" : "uint32_t");
+}
+
+//sig_def<...> with the trailing default arguments left out
+static void gen_def(const gen_signal_t * sig, char * out, size_t len){
+  bool scaled = (1 != sig->scale_num) || (1 != sig->scale_den) || (0 != sig->offset);
+  int n = snprintf(out, len, "sig_def<%2u, %2u", (unsigned)sig->start, (unsigned)sig->length);
+
+  if(scaled || (SIG_MOTOROLA != sig->order) || (SIG_UNSIGNED != sig->sign)) {
+    n += snprintf(out + n, len - n, ", %s, %s", (SIG_MOTOROLA == sig->order) ? "SIG_MOTOROLA" : "SIG_INTEL",
+                  (SIG_SIGNED == sig->sign) ? "SIG_SIGNED" : "SIG_UNSIGNED");
+  }
+  if(scaled) {
+    n += snprintf(out + n, len - n, ", %ld, %ld", (long)sig->scale_num, (long)sig->scale_den);
+  }
+  if(0 != sig->offset) {
+    n += snprintf(out + n, len - n, ", %ld", (long)sig->offset);
+  }
+  snprintf(out + n, len - n, ">");
+}
+
+static void gen_lower(const char * in, char * out, size_t len){
+  size_t n;
+  for(n = 0; (n < (len - 1)) && ('\0' != in[n]); n++) {
+    out[n] = (char)tolower((unsigned char)in[n]);
+  }
+  out[n] = '\0';
+}
+
+static void gen_message(const gen_message_t * msg, const char * prefix){
+  char defs[GEN_MAX_SIGNALS][GEN_LINE_LEN];
+  char names[GEN_MAX_SIGNALS][GEN_LINE_LEN];
+  char id[8];
+  char lower[GEN_NAME_LEN];
+  size_t def_width = 0;
+  size_t name_width = 0;
+  uint8_t i;
+
+  snprintf(id, sizeof(id), "%03X", (unsigned)msg->can_id);
+  snprintf(lower, sizeof(lower), "%s_%s", prefix, id);
+  gen_lower(lower, lower, sizeof(lower));
+  for(i = 0; i < msg->count; i++) {
+    gen_def(&msg->signals[i], defs[i], sizeof(defs[i]));
+    snprintf(names[i], sizeof(names[i]), "%s_%s_%s;", prefix, id, msg->signals[i].name);
+    def_width = (strlen(defs[i]) > def_width) ? strlen(defs[i]) : def_width;
+    name_width = (strlen(names[i]) > name_width) ? strlen(names[i]) : name_width;
+  }
+
+  gen_printf("//——————————————————————————————————————————————————————————————————————————————\n");
+  gen_printf("// 0x%s %s, %u bytes from %s%s%s\n", id, msg->name, (unsigned)msg->dlc, msg->sender,
+             ('\0' != msg->comment[0]) ? ": " : "", msg->comment);
+  gen_printf("//——————————————————————————————————————————————————————————————————————————————\n");
+  gen_printf("#define %s_%s_ID    0x%s\n", prefix, id, id);
+  gen_printf("#define %s_%s_DLC   %u\n\n", prefix, id, (unsigned)msg->dlc);
+
+  for(i = 0; i < msg->count; i++) {
+    const gen_signal_t * sig = &msg->signals[i];
+    char note[GEN_TEXT_LEN + GEN_NAME_LEN + 32] = "";
+    if((1.0 != sig->factor) || ('\0' != sig->unit[0])) {
+      snprintf(note, sizeof(note), "%g%s%s", sig->factor, ('\0' != sig->unit[0]) ? " " : "", sig->unit);
+    }
+    if('\0' != sig->comment[0]) {
+      size_t n = strlen(note);
+      snprintf(note + n, sizeof(note) - n, "%s%s", (n > 0) ? ", " : "", sig->comment);
+    }
+    if('\0' != note[0]) {
+      gen_printf("typedef %-*s %-*s //%s\n", (int)def_width, defs[i], (int)name_width, names[i], note);
+    } else {
+      gen_printf("typedef %-*s %s\n", (int)def_width, defs[i], names[i]);
+    }
+  }
+
+  gen_printf("\ntypedef struct {\n");
+  for(i = 0; i < msg->count; i++) {
+    gen_printf("  %-8s %s;\n", gen_type(&msg->signals[i]), msg->signals[i].name);
+  }
+  gen_printf("} %s_t;\n\n", lower);
+
+  gen_printf("static inline void %s_Decode_%s(const uint8_t * data, %s_t * msg){\n", prefix, id, lower);
+  for(i = 0; i < msg->count; i++) {
+    const gen_signal_t * sig = &msg->signals[i];
+    gen_printf("  msg->%s = (%s)SIG_%s<%s_%s_%s>(data);\n", sig->name, gen_type(sig),
+               (SIG_SIGNED == sig->sign) ? "Get" : "Raw", prefix, id, sig->name);
+  }
+  gen_printf("}\n\n");
+
+  gen_printf("//Payload bits not covered by a signal are kept\n");
+  gen_printf("static inline void %s_Encode_%s(const %s_t * msg, uint8_t * data){\n", prefix, id, lower);
+  for(i = 0; i < msg->count; i++) {
+    gen_printf("  SIG_Set<%s_%s_%s>(data, msg->%s);\n", prefix, id, msg->signals[i].name, msg->signals[i].name);
+  }
+  gen_printf("}\n\n");
+}
+
+static int gen_compare(const void * a, const void * b){
+  return (int)((const gen_message_t *)a)->can_id - (int)((const gen_message_t *)b)->can_id;
+}
+
+static bool gen_write(const char * path, const char * source, const char * prefix){
+  char guard[GEN_NAME_LEN];
+  const char * base = strrchr(path, '/');
+  const char * dbc = strrchr(source, '/');
+  size_t n;
+  uint8_t i;
+
+  base = (NULL != base) ? (base + 1) : path;
+  dbc = (NULL != dbc) ? (dbc + 1) : source;
+  for(n = 0; (n < (sizeof(guard) - 1)) && ('\0' != base[n]); n++) {
+    guard[n] = isalnum((unsigned char)base[n]) ? (char)toupper((unsigned char)base[n]) : '_';
+  }
+  guard[n] = '\0';
+
+  gen_out = fopen(path, "wb");
+  if(NULL == gen_out) {
+    fprintf(stderr, "cannot create %s\n", path);
+    return false;
+  }
+  qsort(gen_messages, gen_count, sizeof(gen_messages[0]), gen_compare);
+
+  gen_printf("//——————————————————————————————————————————————————————————————————————————————\n");
+  gen_printf("// Description: %s signal descriptors and message decoders/encoders (can_signal.h)\n", prefix);
+  gen_printf("// Generated by host/dbc_gen from %s, do not edit: change the DBC and run make gen in host/\n", dbc);
+  gen_printf("//——————————————————————————————————————————————————————————————————————————————\n");
+  if('\0' != gen_version[0]) {
+    gen_printf("// %s\n", gen_version);
+  }
+  gen_printf("// Start bits in DBC numbering: bit n is bit (n %% 8) of data[n / 8], Motorola signals start at\n");
+  gen_printf("// their MSB. Struct members hold raw values, physical = raw * factor (noted per signal).\n");
+  gen_printf("//——————————————————————————————————————————————————————————————————————————————\n\n");
+  gen_printf("#ifndef %s\n#define %s\n\n#include \"can_signal.h\"\n\n", guard, guard);
+  for(i = 0; i < gen_count; i++) {
+    gen_message(&gen_messages[i], prefix);
+  }
+  gen_printf("#endif //%s\n", guard);
+  fclose(gen_out);
+  return true;
+}
+
+int main(int argc, char ** argv){
+  const char * in_path = NULL;
+  const char * out_path = NULL;
+  const char * prefix = "LEAF";
+  int opt;
+
+  while(-1 != (opt = getopt(argc, argv, "i:o:p:"))) {
+    switch(opt) {
+      case 'i': in_path = optarg; break;
+      case 'o': out_path = optarg; break;
+      case 'p': prefix = optarg; break;
+      default:
+        in_path = NULL;
+      break;
+    }
+  }
+  if((NULL == in_path) || (NULL == out_path)) {
+    fprintf(stderr, "usage: %s -i input.dbc -o output.h [-p PREFIX]\n", argv[0]);
+    return 2;
+  }
+  if(!gen_parse(in_path)) {
+    return 1;
+  }
+  if(!gen_write(out_path, in_path, prefix)) {
+    return 2;
+  }
+  printf("%s: %u messages -> %s\n", in_path, (unsigned)gen_count, out_path);
+  return 0;
+}
@@ -0,0 +1,269 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Generated message decoders (leaf_signals.h) against the hand-written shifts, on a trace
+// 10.16.2026: Every recorded frame decoded both ways and compared, then both timed
+//——————————————————————————————————————————————————————————————————————————————
+// The hand-written decoders are the shifts and masks the handlers and helper_functions.cpp
+// used before the signal codec (0x11A shifter, 0x1D4/0x1DA torque, 0x1DB, 0x284, 0x55B, 0x5BC).
+// Both versions return the same fields as int32_t; a frame where they differ fails the run.
+// The frames of each ID are taken from the trace as recorded (up to DBENCH_MAX_FRAMES), so a
+// drive log exercises the real value distribution.
+//
+// Usage: decode_bench -i trace(.log|.asc) [-n iterations]   exit code 1 on a mismatch
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include <unistd.h>
+#include "trace_io.h"
+#include "leaf_signals.h"
+#include "bench_util.h"
+
+#define DBENCH_MAX_FRAMES     4096U   //per ID
+#define DBENCH_MAX_FIELDS     12
+
+typedef void (*dbench_decode_t)(const uint8_t * data, int32_t * out);
+
+typedef struct {
+  const char *    name;
+  uint16_t        can_id;
+  uint8_t         fields;
+  dbench_decode_t hand;
+  dbench_decode_t generated;
+} dbench_case_t;
+
+//——————————————————————————————————————————————————————————————————————————————
+// Hand-written decoders
+//——————————————————————————————————————————————————————————————————————————————
+static void hand_11A(const uint8_t * data, int32_t * out){
+  out[0] = (data[0] & 0xF0) >> 4;
+  out[1] = (data[1] & 0x10) >> 4;
+}
+
+static void hand_1D4(const uint8_t * data, int32_t * out){
+  out[0] = (int16_t)((int16_t)((data[2] << 8) | data[3]) >> 4);
+  out[1] = data[6] & 0x03;
+  out[2] = data[7];
+}
+
+static void hand_1DA(const uint8_t * data, int32_t * out){
+  out[0] = (((data[2] & 0x07) << 8) | data[3]) & 0x7FF;
+  out[1] = (data[2] & 0x04) ? 1 : 0;
+}
+
+static void hand_1DB(const uint8_t * data, int32_t * out){
+  out[0] = (int16_t)((int16_t)((data[0] << 8) | data[1]) >> 5);
+  out[1] = (data[2] << 2) | ((data[3] & 0xC0) >> 6);
+  out[2] = data[4];
+  out[3] = data[6] & 0x03;
+  out[4] = data[7];
+}
+
+static void hand_284(const uint8_t * data, int32_t * out){
+  out[0] = (data[4] << 8) | data[5];
+}
+
+static void hand_55B(const uint8_t * data, int32_t * out){
+  out[0] = (data[0] << 2) | ((data[1] & 0xC0) >> 6);
+  out[1] = data[7];
+}
+
+static void hand_5BC(const uint8_t * data, int32_t * out){
+  out[0] = (data[0] << 2) | (data[1] >> 6);
+  out[1] = ((data[1] & 0x3F) << 4) | (data[2] >> 4);
+  out[2] = data[2] & 0x0F;
+  out[3] = data[3];
+  out[4] = data[4] >> 1;
+  out[5] = data[4] & 0x01;
+  out[6] = data[5] >> 5;
+  out[7] = (data[5] >> 2) & 0x01;
+  out[8] = ((data[5] & 0x03) << 3) | (data[6] >> 5);
+  out[9] = ((data[6] & 0x1F) << 8) | data[7];
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Generated decoders, same fields
+//——————————————————————————————————————————————————————————————————————————————
+static void gen_11A(const uint8_t * data, int32_t * out){
+  leaf_11a_t msg;
+  LEAF_Decode_11A(data, &msg);
+  out[0] = msg.SHIFTER;
+  out[1] = msg.ECO;
+}
+
+static void gen_1D4(const uint8_t * data, int32_t * out){
+  leaf_1d4_t msg;
+  LEAF_Decode_1D4(data, &msg);
+  out[0] = msg.TORQUE;
+  out[1] = msg.COUNTER;
+  out[2] = msg.CRC8;
+}
+
+static void gen_1DA(const uint8_t * data, int32_t * out){
+  leaf_1da_t msg;
+  LEAF_Decode_1DA(data, &msg);
+  out[0] = msg.TORQUE & 0x7FF;
+  out[1] = (msg.TORQUE < 0) ? 1 : 0;
+}
+
+static void gen_1DB(const uint8_t * data, int32_t * out){
+  leaf_1db_t msg;
+  LEAF_Decode_1DB(data, &msg);
+  out[0] = msg.LB_CURRENT;
+  out[1] = msg.LB_VOLTAGE;
+  out[2] = msg.SOC;
+  out[3] = msg.MPR1DB;
+  out[4] = msg.CRC8;
+}
+
+static void gen_284(const uint8_t * data, int32_t * out){
+  leaf_284_t msg;
+  LEAF_Decode_284(data, &msg);
+  out[0] = msg.SPEED;
+}
+
+static void gen_55B(const uint8_t * data, int32_t * out){
+  leaf_55b_t msg;
+  LEAF_Decode_55B(data, &msg);
+  out[0] = msg.LB_SOC;
+  out[1] = msg.CRC8;
+}
+
+static void gen_5BC(const uint8_t * data, int32_t * out){
+  leaf_5bc_t msg;
+  LEAF_Decode_5BC(data, &msg);
+  out[0] = msg.LB_CAPR;
+  out[1] = msg.LB_FULLCAP;
+  out[2] = msg.LB_CAPSEG;
+  out[3] = msg.LB_AVET;
+  out[4] = msg.LB_SOH;
+  out[5] = msg.LB_CAPSW;
+  out[6] = msg.LB_RLIMIT;
+  out[7] = msg.LB_CAPBALCOMP;
+  out[8] = msg.LB_RCHGTCON;
+  out[9] = msg.LB_RCHGTIM;
+}
+
+static const dbench_case_t dbench_cases[] = {
+  { "11A_shifter",   LEAF_11A_ID,  2, hand_11A, gen_11A },
+  { "1D4_torque",    LEAF_1D4_ID,  3, hand_1D4, gen_1D4 },
+  { "1DA_response",  LEAF_1DA_ID,  2, hand_1DA, gen_1DA },
+  { "1DB_battery",   LEAF_1DB_ID,  5, hand_1DB, gen_1DB },
+  { "284_speed",     LEAF_284_ID,  1, hand_284, gen_284 },
+  { "55B_soc",       LEAF_55B_ID,  2, hand_55B, gen_55B },
+  { "5BC_capacity",  LEAF_5BC_ID, 10, hand_5BC, gen_5BC },
+};
+#define DBENCH_CASES (sizeof(dbench_cases) / sizeof(dbench_cases[0]))
+
+static can_frame_t dbench_frames[DBENCH_CASES][DBENCH_MAX_FRAMES];
+static uint32_t dbench_count[DBENCH_CASES];
+
+//——————————————————————————————————————————————————————————————————————————————
+// Check and timing
+//——————————————————————————————————————————————————————————————————————————————
+static bool dbench_check(uint8_t c){
+  const dbench_case_t * bench = &dbench_cases[c];
+  uint32_t mismatches = 0;
+  uint32_t i;
+
+  for(i = 0; i < dbench_count[c]; i++) {
+    int32_t hand[DBENCH_MAX_FIELDS];
+    int32_t generated[DBENCH_MAX_FIELDS];
+    bench->hand(dbench_frames[c][i].data, hand);
+    bench->generated(dbench_frames[c][i].data, generated);
+    if(0 != memcmp(hand, generated, bench->fields * sizeof(int32_t))) {
+      if(0U == mismatches) {
+        uint8_t f;
+        printf("  %s: first mismatch in frame %u:", bench->name, (unsigned)i);
+        for(f = 0; f < bench->fields; f++) {
+          printf(" %ld/%ld", (long)hand[f], (long)generated[f]);
+        }
+        printf("\n");
+      }
+      mismatches++;
+    }
+  }
+  printf("  %-16s %5u frames, %u mismatches%s\n", bench->name, (unsigned)dbench_count[c], (unsigned)mismatches,
+         mismatches ? " FAIL" : "");
+  return (0U == mismatches);
+}
+
+template <bool GENERATED>
+static void dbench_time(uint8_t c, uint32_t iterations){
+  const dbench_case_t * bench = &dbench_cases[c];
+  dbench_decode_t decode = GENERATED ? bench->generated : bench->hand;
+  char name[BENCH_NAME_LEN];
+  int32_t out[DBENCH_MAX_FIELDS];
+  bench_timer_t timer;
+  uint32_t done;
+  uint32_t i;
+  uint8_t repeat;
+
+  snprintf(name, sizeof(name), "%s_%s", bench->name, GENERATED ? "generated" : "hand");
+  for(repeat = 0; repeat < BENCH_REPEAT; repeat++) {
+    BENCH_Clear(&timer);
+    for(done = 0; done < iterations; done += dbench_count[c]) {
+      BENCH_Start(&timer);
+      for(i = 0; i < dbench_count[c]; i++) {
+        decode(dbench_frames[c][i].data, out);
+        BENCH_Use(out);
+      }
+      BENCH_Stop(&timer, dbench_count[c]);
+    }
+    BENCH_Record(name, &timer);
+  }
+  BENCH_Report(name);
+}
+
+int main(int argc, char ** argv){
+  const char * in_path = NULL;
+  uint32_t iterations = 1U << 20;
+  trace_reader_t in;
+  trace_frame_t next;
+  bool pass = true;
+  uint8_t c;
+  int opt;
+
+  while(-1 != (opt = getopt(argc, argv, "i:n:"))) {
+    switch(opt) {
+      case 'i': in_path = optarg; break;
+      case 'n': iterations = (uint32_t)strtoul(optarg, NULL, 10); break;
+      default:
+        in_path = NULL;
+      break;
+    }
+  }
+  if(NULL == in_path) {
+    fprintf(stderr, "usage: %s -i trace(.log|.asc) [-n iterations]\n", argv[0]);
+    return 2;
+  }
+  if(!TRACE_Open(&in, in_path)) {
+    fprintf(stderr, "cannot open %s\n", in_path);
+    return 2;
+  }
+  while(TRACE_Read(&in, &next)) {
+    for(c = 0; c < DBENCH_CASES; c++) {
+      if((dbench_cases[c].can_id == next.frame.can_id) && (dbench_count[c] < DBENCH_MAX_FRAMES)) {
+        dbench_frames[c][dbench_count[c]++] = next.frame;
+      }
+    }
+  }
+  TRACE_Close(&in);
+
+  printf("Generated decoders against the hand-written shifts, %s:\n", in_path);
+  for(c = 0; c < DBENCH_CASES; c++) {
+    pass = dbench_check(c) && pass;
+  }
+
+  BENCH_Init();
+  printf("Per frame, best of %u%s:\n", (unsigned)BENCH_REPEAT,
+         BENCH_InstructionsAvailable() ? "" : " (instruction counter not available)");
+  for(c = 0; c < DBENCH_CASES; c++) {
+    if(0U == dbench_count[c]) {
+      continue;
+    }
+    dbench_time<false>(c, iterations);
+    dbench_time<true>(c, iterations);
+  }
+
+  printf("%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,18 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: OTA configuration of the host build (PREF_Init in ACAN2515_ESP32_INVERTER.ino on the target)
+// 10.16.2026: Shared by the host programs (simulation, benchmarks)
+// 10.16.2026: Published as the live_config.h snapshot instead of the former globals
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include "config.h"
+#include "bridge_loop.h"
+
+void HOST_ConfigInit(void){
+  live_config_t cfg;
+
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.vehicle = Vehicle_Selection_Nissan_LEAF_2010_2019;
+  cfg.inverter = Inverter_Upgrade_Disabled;
+  LCFG_Init(&cfg);
+}
@@ -0,0 +1,176 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Live configuration (live_config.h): publish, grace period, torn-read check
+// 10.16.2026: A writer thread publishes complete configs while a reader thread plays the bridge task
+// 10.17.2026: Queued requests (LCFG_Request/LCFG_PublishPending)
+//——————————————————————————————————————————————————————————————————————————————
+// Usage: live_config_test [-n publishes]   exit code 1 when a check fails
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include <unistd.h>
+#include <thread>
+#include "live_config.h"
+
+#define TEST_FRAMES_PER_PASS  16
+
+static uint32_t test_failures = 0;
+
+static void test_check(const char * name, bool ok){
+  printf("  %-40s %s\n", name, ok ? "ok" : "FAIL");
+  if(!ok){
+    test_failures++;
+  }
+}
+
+//Every field k: a reader seeing two different values saw a half-written config
+static void test_fill(live_config_t * cfg, uint8_t k){
+  memset(cfg, 0, sizeof(*cfg));
+  cfg->vehicle = k;
+  cfg->inverter = k;
+  cfg->battery = k;
+  cfg->battery_saver = k;
+  cfg->glide = k;
+  cfg->current_control = k;
+}
+
+static bool test_whole(const live_config_t * cfg){
+  uint8_t k = cfg->vehicle;
+  return (cfg->inverter == k) && (cfg->battery == k) && (cfg->battery_saver == k) && (cfg->glide == k) &&
+         (cfg->current_control == k);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Single task
+//——————————————————————————————————————————————————————————————————————————————
+static void test_publish(void){
+  live_config_t cfg;
+  live_config_t copy;
+  const live_config_t * before;
+  bool ok;
+
+  test_fill(&cfg, 1);
+  LCFG_Init(&cfg);
+  test_check("init active at once", (1 == LCFG_Get()->vehicle) && (0 == LCFG_Get()->generation));
+
+  test_fill(&cfg, 2);
+  before = LCFG_Get();
+  ok = LCFG_Publish(&cfg) && (LCFG_Get() != before) && (2 == LCFG_Get()->inverter) && (1 == LCFG_Get()->generation);
+  test_check("publish seen by the next frame", ok && (1 == before->inverter));
+
+  test_fill(&cfg, 3);
+  ok = !LCFG_Publish(&cfg) && (2 == LCFG_Get()->inverter) && (1 == before->inverter);
+  test_check("second publish waits for a pass", ok);
+
+  LCFG_Quiescent();
+  ok = LCFG_Publish(&cfg) && (LCFG_Get() == before) && (3 == LCFG_Get()->inverter) && (2 == LCFG_Get()->generation);
+  test_check("retired buffer reused after a pass", ok);
+
+  LCFG_Snapshot(&copy);
+  test_check("snapshot", (0 == memcmp(&copy, LCFG_Get(), sizeof(copy))));
+}
+
+static void test_request(void){
+  live_config_t cfg;
+  live_config_t copy;
+  bool ok;
+
+  test_fill(&cfg, 1);
+  LCFG_Init(&cfg);
+  test_fill(&cfg, 2);
+  ok = LCFG_Request(&cfg) && (2 == LCFG_Get()->inverter) && !LCFG_PublishPending();
+  test_check("request applied at once when free", ok);
+
+  test_fill(&cfg, 3);
+  ok = !LCFG_Request(&cfg) && (2 == LCFG_Get()->inverter);
+  LCFG_Snapshot(&copy);
+  test_check("request in the grace period queued", ok && (3 == copy.inverter));
+
+  test_fill(&cfg, 4);
+  ok = !LCFG_Request(&cfg) && !LCFG_PublishPending() && (2 == LCFG_Get()->inverter);
+  test_check("pending kept until a pass", ok);
+
+  LCFG_Quiescent();
+  ok = LCFG_PublishPending() && (4 == LCFG_Get()->inverter) && test_whole(LCFG_Get()) && !LCFG_PublishPending();
+  LCFG_Snapshot(&copy);
+  test_check("latest request published after a pass", ok && (0 == memcmp(&copy, LCFG_Get(), sizeof(copy))));
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Writer thread against a bridge task thread
+//——————————————————————————————————————————————————————————————————————————————
+static std::atomic<bool> test_done(false);
+
+static void test_bridge(uint32_t * frames, uint32_t * torn, uint32_t * changes){
+  const live_config_t * cfg;
+  uint16_t generation = 0;
+  uint32_t i;
+
+  while(!test_done.load(std::memory_order_acquire)){
+    LCFG_Quiescent();
+    for(i = 0; i < TEST_FRAMES_PER_PASS; i++){
+      cfg = LCFG_Get();
+      if(!test_whole(cfg)){
+        (*torn)++;
+      }
+      if(cfg->generation != generation){
+        generation = cfg->generation;
+        (*changes)++;
+      }
+      (*frames)++;
+    }
+    std::this_thread::yield();    //the bridge task waits for its next notification
+  }
+}
+
+static void test_threads(uint32_t publishes){
+  live_config_t cfg;
+  uint32_t frames = 0;
+  uint32_t torn = 0;
+  uint32_t changes = 0;
+  uint32_t retries = 0;
+  uint32_t n;
+
+  test_fill(&cfg, 0);
+  LCFG_Init(&cfg);
+  test_done.store(false);
+  std::thread bridge(test_bridge, &frames, &torn, &changes);
+
+  for(n = 1; n <= publishes; n++){
+    test_fill(&cfg, (uint8_t)n);
+    while(!LCFG_Publish(&cfg)){
+      retries++;
+      std::this_thread::yield();
+    }
+  }
+  test_done.store(true, std::memory_order_release);
+  bridge.join();
+
+  printf("  %u publishes, %u retries, %u frames, %u changes seen\n", (unsigned)publishes, (unsigned)retries,
+         (unsigned)frames, (unsigned)changes);
+  test_check("no half-written config read", 0U == torn);
+  test_check("last publish active", ((uint8_t)publishes == LCFG_Get()->vehicle) && test_whole(LCFG_Get()));
+}
+
+int main(int argc, char ** argv){
+  uint32_t publishes = 10000;
+  int opt;
+
+  while((opt = getopt(argc, argv, "n:")) != -1){
+    switch(opt){
+      case 'n':
+        publishes = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-n publishes]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  printf("Live config, %u bytes:\n", (unsigned)sizeof(live_config_t));
+  test_publish();
+  test_request();
+  printf("Writer and bridge threads:\n");
+  test_threads(publishes);
+  printf("%s\n", (0U == test_failures) ? "PASS" : "FAIL");
+  return (0U == test_failures) ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: End-to-end queue latency of the transmit drain at 500 kbit/s saturation
+// 10.16.2026: Built twice, with TX_DRAIN_BUDGET_PER_TICK of config.h and with 1 (the former drain)
+//——————————————————————————————————————————————————————————————————————————————
+// CAN2 carries back-to-back 8 byte frames of a passthrough ID (100 % bus load), which the bridge
+// forwards to CAN1. The bridge passes run every pass_us of simulated time: T_POLLING when the
+// bridge task keeps up, longer when its ticks are delayed by other work and merge. Each frame
+// carries its sequence number, so its latency is measured from the end of its reception on CAN2
+// to the end of its transmission on CAN1 (virtual bus, VCAN_BITRATE).
+//
+// This is simulated time, not host CPU time, and the budget is a compile-time constant of the
+// engine; bridge_bench (CPU time per frame, one engine build) therefore does not measure it.
+// peak ring/queued: highest fill of the ring alone and of ring + heap since the program started.
+//
+// Usage: queue_bench [-n frames] [-p pass_us]   (default: pass_us 100, 250, 500 and 1000)
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+#include "config.h"
+#include "can_driver.h"
+#include "can_bridge_manager_common.h"
+#include "sim_clock.h"
+#include "virtual_can.h"
+#include "bridge_loop.h"
+
+#define QBENCH_CAN_ID     0x260     //no handler, forwarded CAN2 -> CAN1 as is
+#define QBENCH_DRAIN_US   100000U   //quiet time at the end so every accepted frame leaves the bridge
+#define QBENCH_NO_TIME    0xFFFFFFFFFFFFFFFFULL
+
+static std::vector<uint64_t> qbench_rx_us;      //by sequence number
+static std::vector<uint32_t> qbench_latency_us;
+
+static void qbench_on_tx(uint8_t can_bus, const can_frame_t &frame, uint64_t done_us){
+  uint32_t seq;
+
+  if((CAN_CHANNEL_1 != can_bus) || (QBENCH_CAN_ID != frame.can_id)) {
+    return;   //synthesized inverter frames
+  }
+  memcpy(&seq, frame.data, sizeof(seq));
+  if((seq < qbench_rx_us.size()) && (QBENCH_NO_TIME != qbench_rx_us[seq])) {
+    qbench_latency_us.push_back((uint32_t)(done_us - qbench_rx_us[seq]));
+  }
+}
+
+static uint32_t qbench_percentile(uint32_t percent){
+  size_t index;
+
+  if(qbench_latency_us.empty()) {
+    return 0U;
+  }
+  index = ((qbench_latency_us.size() - 1U) * percent) / 100U;
+  return qbench_latency_us[index];
+}
+
+static void qbench_run(uint32_t frames, uint32_t pass_us){
+  tx_buffer_stats_t before;
+  tx_buffer_stats_t after;
+  uint32_t frame_us = VCAN_FrameTimeUs(8);
+  uint64_t next_rx_us = frame_us;     //the first frame has completely arrived
+  uint64_t next_pass_us = pass_us;
+  uint64_t now_us = 0U;
+  uint64_t end_us;
+  uint32_t sent = 0U;
+
+  qbench_rx_us.assign(frames, QBENCH_NO_TIME);
+  qbench_latency_us.clear();
+
+  SIM_Clock_Set(0U);
+  HOST_BridgeInit();
+  VCAN_SetTxCallback(qbench_on_tx);
+  buffer_get_stats(CAN_CHANNEL_1, &before);
+
+  end_us = ((uint64_t)frames * frame_us) + QBENCH_DRAIN_US;
+  while(now_us < end_us) {
+    now_us = ((sent < frames) && (next_rx_us < next_pass_us)) ? next_rx_us : next_pass_us;
+    SIM_Clock_Tick(now_us);
+    VCAN_Advance(now_us);
+
+    if((sent < frames) && (now_us == next_rx_us)) {
+      can_frame_t frame;
+      memset(&frame, 0, sizeof(frame));
+      frame.can_id = QBENCH_CAN_ID;
+      frame.can_dlc = 8;
+      memcpy(frame.data, &sent, sizeof(sent));
+      if(VCAN_Inject(CAN_CHANNEL_2, frame)) {
+        qbench_rx_us[sent] = now_us;
+      }
+      sent++;
+      next_rx_us += frame_us;
+    }
+    if(now_us == next_pass_us) {
+      HOST_BridgePass();
+      next_pass_us += pass_us;
+    }
+  }
+  VCAN_Advance(now_us);
+  buffer_get_stats(CAN_CHANNEL_1, &after);
+
+  std::sort(qbench_latency_us.begin(), qbench_latency_us.end());
+  printf("  pass %5u us  %7u frames  p50 %7u us  p99 %7u us  max %7u us  dropped %6u  peak ring %2u queued %2u\n",
+         (unsigned)pass_us, (unsigned)qbench_latency_us.size(), (unsigned)qbench_percentile(50),
+         (unsigned)qbench_percentile(99), (unsigned)(qbench_latency_us.empty() ? 0U : qbench_latency_us.back()),
+         (unsigned)(after.dropped - before.dropped), (unsigned)after.ring_high_water, (unsigned)after.queued_high_water);
+}
+
+int main(int argc, char ** argv){
+  static const uint32_t pass_default[] = { T_POLLING, 250U, 500U, 1000U };
+  uint32_t frames = 20000U;
+  uint32_t pass_us = 0U;
+  uint32_t i;
+  int opt;
+
+  while(-1 != (opt = getopt(argc, argv, "n:p:"))) {
+    switch(opt) {
+      case 'n': frames = (uint32_t)strtoul(optarg, NULL, 10); break;
+      case 'p': pass_us = (uint32_t)strtoul(optarg, NULL, 10); break;
+      default:
+        fprintf(stderr, "usage: %s [-n frames] [-p pass_us]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  printf("CAN2 -> CAN1 at %u kbit/s saturation, one frame every %u us, TX_DRAIN_BUDGET_PER_TICK %u:\n",
+         (unsigned)(VCAN_BITRATE / 1000UL), (unsigned)VCAN_FrameTimeUs(8), (unsigned)TX_DRAIN_BUDGET_PER_TICK);
+  if(0U != pass_us) {
+    qbench_run(frames, pass_us);
+  } else {
+    for(i = 0; i < (sizeof(pass_default) / sizeof(pass_default[0])); i++) {
+      qbench_run(frames, pass_default[i]);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,328 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Settings parser (settings_parser.cpp) against the former String parser: results, time, heap
+// 10.16.2026: Checks the accepted forms and error reports, then times both parsers and counts their allocations
+//——————————————————————————————————————————————————————————————————————————————
+// legacy_parse() is the parsing part of the former WebRequestProcessing() unchanged, minus the
+// debug prints; its fields are read at the fixed positions the old code used (temp2[1], [3] ...).
+// Heap use is counted by replacing the global operator new/delete. On the host String is a
+// std::string (small strings inline, geometric growth); the ESP32 core String reallocates on
+// most appends, so the firmware made more allocations than counted here, not fewer.
+//
+// Usage: settings_bench [-n iterations]   exit code 1 when a check fails
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include <unistd.h>
+#include <new>
+#include "settings_parser.h"
+#include "bench_util.h"
+
+//——————————————————————————————————————————————————————————————————————————————
+// Heap counting
+//——————————————————————————————————————————————————————————————————————————————
+#define HEAP_HEADER   16U   //keeps the size of the block, preserves the malloc alignment
+
+typedef struct {
+  bool     enabled;
+  uint64_t calls;
+  uint64_t bytes;
+  uint64_t live;
+  uint64_t peak;
+} heap_count_t;
+
+static heap_count_t heap;
+
+void * operator new(size_t size){
+  uint8_t * block = (uint8_t *)malloc(size + HEAP_HEADER);
+  if(NULL == block){
+    throw std::bad_alloc();
+  }
+  *(size_t *)block = size;
+  if(heap.enabled){
+    heap.calls++;
+    heap.bytes += size;
+    heap.live += size;
+    heap.peak = (heap.live > heap.peak) ? heap.live : heap.peak;
+  }
+  return block + HEAP_HEADER;
+}
+
+void operator delete(void * ptr) noexcept {
+  uint8_t * block;
+  if(NULL == ptr){
+    return;
+  }
+  block = (uint8_t *)ptr - HEAP_HEADER;
+  if(heap.enabled && (heap.live >= *(size_t *)block)){
+    heap.live -= *(size_t *)block;
+  }
+  free(block);
+}
+
+void operator delete(void * ptr, size_t size) noexcept {
+  operator delete(ptr);
+}
+
+static void heap_start(void){
+  memset(&heap, 0, sizeof(heap));
+  heap.enabled = true;
+}
+
+static void heap_stop(void){
+  heap.enabled = false;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Former parser
+//——————————————————————————————————————————————————————————————————————————————
+#define LEGACY_FIELDS   14
+
+static void legacy_parse(const String data, String temp2[LEGACY_FIELDS]){
+  int len1 = data.length();
+  int len2;
+  int y;
+  char ch;
+  String temp1;
+  boolean prevAlphaNum = false;
+
+  //First formatting
+  //Read all alphanumeric, colon(:), hyphen (-) from the web request
+  for(int x=0; x < len1; x++)
+  {
+    //Check each character
+    ch = data.charAt(x);
+    if(isAlphaNumeric(ch) || isDigit(ch) || ch == '-'  || ch == ':' || isWhitespace(ch))
+    {
+      //store is not space; replace space with ',' and store to temp1 buffer
+      if(!isWhitespace(ch))
+      {
+        temp1 += ch;
+      }
+      else
+      {
+        temp1 += ',';
+      }
+    }
+  }
+
+  //Second formatting
+  //From temp1 buffer, read the names and values and store to temp2 buffer in an array organization
+  len2 = temp1.length();
+  y = 0; //this is used to jump to next array
+  for(int x=0; x < len2; x++)
+  {
+    ch = temp1.charAt(x);
+    if(isAlphaNumeric(ch) || isDigit(ch) || ch == '-' || ch == ':' || ch == ',')
+    {
+      if(isAlphaNumeric(ch) || isDigit(ch) || ch == '-')
+      {
+        temp2[y] += ch;
+        prevAlphaNum = true;
+      }
+      else if(ch == ':' || ch == ',')
+      {
+        if(prevAlphaNum == true)
+        {
+          prevAlphaNum = false;
+          y++;
+        }
+      }
+      else
+      {;}
+    }
+  }
+}
+
+//Field positions read by the former WebRequestProcessing(), -1: not read
+static const int8_t legacy_position[SETP_KEY_COUNT] = { 1, 3, 5, 7, 9, -1, 13 };
+
+//——————————————————————————————————————————————————————————————————————————————
+// Inputs
+//——————————————————————————————————————————————————————————————————————————————
+//As index.html posts it: JSON.stringify(Object.fromEntries(new FormData(form)), null, 2)
+static const char bench_form[] =
+  "{\n  \"Vehicle\": \"AZE0\",\n  \"Inverter\": \"160\",\n  \"Battery\": \"40\",\n  \"BatterySaver\": \"80\",\n"
+  "  \"Glide\": \"0\",\n  \"Capacity\": \"1\",\n  \"CurrentControl\": \"-1\"\n}";
+
+static const char bench_reordered[] =
+  "{\n  \"Inverter\": \"160\",\n  \"Vehicle\": \"AZE0\",\n  \"Glide\": \"0\",\n  \"CurrentControl\": \"-1\",\n"
+  "  \"Capacity\": \"1\",\n  \"BatterySaver\": \"80\",\n  \"Battery\": \"40\"\n}";
+
+static const char bench_ws[] = "Vehicle=AZE0;Inverter=160";
+
+//Codes of bench_form
+static const uint8_t bench_form_codes[SETP_KEY_COUNT] = { 3, 1, 2, 2, 1, 0, 5 };
+#define SETP_ALL_KEYS   ((uint8_t)((1U << SETP_KEY_COUNT) - 1U))
+
+typedef struct {
+  const char * name;
+  const char * text;
+  uint8_t      present;       //expected keys
+  uint8_t      errors;        //expected error count
+  const char * error;         //expected first error
+} settings_check_t;
+
+static const settings_check_t settings_checks[] = {
+  { "form",            bench_form,                                     SETP_ALL_KEYS, 0, "" },
+  { "reordered",       bench_reordered,                                SETP_ALL_KEYS, 0, "" },
+  { "ws_set",          bench_ws,                                       0x03,          0, "" },
+  { "query",           "Vehicle=AZE0&Inverter=160",                    0x03,          0, "" },
+  { "empty",           "",                                             0x00,          0, "" },
+  { "empty_object",    "{ }",                                          0x00,          0, "" },
+  { "unknown_key",     "{\"Vehicle\": \"AZE0\", \"Colour\": \"red\"}", 0x01,          1, "unknown key 'Colour'" },
+  { "invalid_value",   "Vehicle=AZE1;Inverter=160",                    0x02,          1, "invalid value for 'Vehicle'" },
+  { "empty_value",     "Inverter=;Vehicle=AZE0",                       0x01,          1, "invalid value for 'Inverter'" },
+  { "two_errors",      "Glide=2;Speed=1;Inverter=160",                 0x02,          2, "invalid value for 'Glide'" },
+  { "no_value",        "Inverter=160;Vehicle",                         0x02,          1, "no value for 'Vehicle'" },
+  { "unexpected",      "Inverter=160;[Vehicle=AZE0]",                  0x02,          1, "unexpected '['" },
+};
+
+//——————————————————————————————————————————————————————————————————————————————
+// Checks
+//——————————————————————————————————————————————————————————————————————————————
+static bool check_parse(const settings_check_t * check){
+  setp_result_t result;
+  bool ok;
+  uint8_t key;
+
+  SETP_Parse(check->text, strlen(check->text), &result);
+  ok = (result.present == check->present) && (result.errors == check->errors) && (0 == strcmp(result.error, check->error));
+  for(key = 0; (key < SETP_KEY_COUNT) && ok; key++){
+    if(result.present & (1U << key)){
+      ok = (result.value[key] == bench_form_codes[key]);  //every check uses the values of bench_form
+    }
+  }
+  printf("  %-16s present 0x%02X, %u errors%s%s%s\n", check->name, result.present, result.errors,
+         result.errors ? " (" : "", result.error, result.errors ? ")" : "");
+  if(!ok){
+    printf("  %-16s FAIL, expected present 0x%02X, %u errors (%s)\n", check->name, check->present, check->errors, check->error);
+  }
+  return ok;
+}
+
+//SETP_Format() output parses back to the same settings
+static bool check_format(void){
+  setp_result_t in;
+  setp_result_t out;
+  char text[SETP_TEXT_SIZE];
+  bool ok;
+
+  SETP_Parse(bench_form, strlen(bench_form), &in);
+  SETP_Format(&in, text, sizeof(text));
+  ok = SETP_Parse(text, strlen(text), &out) && (out.present == in.present) && (0 == memcmp(out.value, in.value, sizeof(in.value)));
+  printf("  %-16s %s%s\n", "format", text, ok ? "" : " FAIL");
+  return ok;
+}
+
+//The new parser reads what the former one read from the page layout; the former one is also
+//shown on the reordered body (informational, it has no way to detect it)
+static bool check_legacy(const char * name, const char * text, bool must_match){
+  String temp2[LEGACY_FIELDS];
+  setp_result_t result;
+  uint8_t mismatches = 0;
+  uint8_t key;
+
+  legacy_parse(text, temp2);
+  SETP_Parse(text, strlen(text), &result);
+  printf("  %-16s former parser reads", name);
+  for(key = 0; key < SETP_KEY_COUNT; key++){
+    if(legacy_position[key] < 0){
+      continue;
+    }
+    printf(" %s=%s", SETP_KeyName(key), temp2[legacy_position[key]].c_str());
+    if(temp2[legacy_position[key]] != SETP_ValueName(key, result.value[key])){
+      mismatches++;
+    }
+  }
+  printf(", %u differ from the new parser%s\n", mismatches, (must_match && (mismatches > 0U)) ? " FAIL" : "");
+  return !must_match || (0U == mismatches);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Timing and heap
+//——————————————————————————————————————————————————————————————————————————————
+template <bool LEGACY>
+static void time_parse(const char * name, const char * text, uint32_t iterations){
+  char label[BENCH_NAME_LEN];
+  bench_timer_t timer;
+  size_t len = strlen(text);
+  uint32_t i;
+  uint8_t repeat;
+
+  snprintf(label, sizeof(label), "%s_%s", name, LEGACY ? "former" : "new");
+  for(repeat = 0; repeat < BENCH_REPEAT; repeat++){
+    BENCH_Clear(&timer);
+    BENCH_Start(&timer);
+    for(i = 0; i < iterations; i++){
+      if(LEGACY){
+        String temp2[LEGACY_FIELDS];
+        legacy_parse(text, temp2);
+        BENCH_Use(temp2);
+      }else{
+        setp_result_t result;
+        SETP_Parse(text, len, &result);
+        BENCH_Use(result);
+      }
+    }
+    BENCH_Stop(&timer, iterations);
+    BENCH_Record(label, &timer);
+  }
+  BENCH_Report(label);
+}
+
+template <bool LEGACY>
+static void count_heap(const char * name, const char * text){
+  setp_result_t result;
+
+  heap_start();
+  if(LEGACY){
+    String temp2[LEGACY_FIELDS];
+    legacy_parse(text, temp2);
+    BENCH_Use(temp2);
+  }else{
+    SETP_Parse(text, strlen(text), &result);
+    BENCH_Use(result);
+  }
+  heap_stop();
+  printf("  %-24s %4llu allocations %6llu bytes, peak %5llu bytes\n", name, (unsigned long long)heap.calls,
+         (unsigned long long)heap.bytes, (unsigned long long)heap.peak);
+}
+
+int main(int argc, char ** argv){
+  uint32_t iterations = 1U << 16;
+  bool pass = true;
+  uint8_t i;
+  int opt;
+
+  while(-1 != (opt = getopt(argc, argv, "n:"))){
+    switch(opt){
+      case 'n': iterations = (uint32_t)strtoul(optarg, NULL, 10); break;
+      default:
+        fprintf(stderr, "usage: %s [-n iterations]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  printf("Settings parser checks:\n");
+  for(i = 0; i < (sizeof(settings_checks) / sizeof(settings_checks[0])); i++){
+    pass = check_parse(&settings_checks[i]) && pass;
+  }
+  pass = check_format() && pass;
+  pass = check_legacy("form", bench_form, true) && pass;
+  check_legacy("reordered", bench_reordered, false);
+
+  printf("Heap per parse (form body, %u bytes):\n", (unsigned)strlen(bench_form));
+  count_heap<true>("form_former", bench_form);
+  count_heap<false>("form_new", bench_form);
+  count_heap<false>("ws_set_new", bench_ws);
+
+  BENCH_Init();
+  printf("Per parse, best of %u%s:\n", (unsigned)BENCH_REPEAT,
+         BENCH_InstructionsAvailable() ? "" : " (instruction counter not available)");
+  time_parse<true>("form", bench_form, iterations);
+  time_parse<false>("form", bench_form, iterations);
+  time_parse<false>("ws_set", bench_ws, iterations);
+
+  printf("%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
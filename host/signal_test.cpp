@@ -0,0 +1,651 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: CAN signal codec (can_signal.h, leaf_signals.h) against bit by bit references
+// 10.16.2026: Every placement of every length in both byte orders, the LEAF descriptors against
+//             the hand-written shifts they replace, timing of both
+//——————————————————————————————————————————————————————————————————————————————
+// - codec: for each byte order, start bit and length (1..32) that fits the payload, extract and
+//   insert of edge and random values on random payloads match a one-bit-at-a-time reference,
+//   and insert leaves every bit outside the signal unchanged
+// - LEAF descriptors: over every value of the bytes involved, the same result as the shifts
+//   the handlers used before (the 0x1D4 insert keeps the low nibble of data[3], the old code
+//   cleared it); SIG_Patch leaves a valid CRC valid; the signals of one message do not overlap
+// - 0x1D4 handler: LEAF_CAN_Handler in drive with the stock inverter against the former handler
+//   (12-bit rewrite, data[3] low nibble cleared, CRC recomputed), every value of data[2..3].
+//   Power demand is byte-identical; regen torque may differ by 1 (the former code scaled the
+//   one's complement, see torque_scale_test) and saturates where the former result wrapped to
+//   positive torque; every other bit is identical.
+// - 0x5BC/0x5C0: convert_* against the field order of the former bitfield structs, and against
+//   the former functions byte for byte. They differ only where the former ones were wrong, which
+//   is counted, not failed: convert_5bc_to_array masked LB_FULLCAP >> 4 with 0x1F and lost bit 9;
+//   convert_array_to_5bc decoded LB_CAPR alone, its low bits from (src[1] & (0xC0 >> 6)), i.e.
+//   src[1] & 0x03. convert_5c0_to_array is identical (the former left the spacer byte data[6]
+//   as it was, compared on a zeroed buffer). None of them is on the bridge path.
+//
+// Usage: signal_test [-n iterations]   exit code 1 on a mismatch
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include <unistd.h>
+#include "can_signal.h"
+#include "leaf_signals.h"
+#include "helper_functions.h"
+#include "can_bridge_manager_leaf.h"
+#include "torque_scale.h"
+#include "bridge_loop.h"
+#include "bench_util.h"
+
+#define TEST_VALUES       48U       //random values per placement
+#define TEST_FRAMES       4096U     //payloads per timed batch
+
+static uint32_t test_seed = 0x5EED1D4UL;
+
+static uint32_t test_rand(void){
+  test_seed ^= test_seed << 13;
+  test_seed ^= test_seed >> 17;
+  test_seed ^= test_seed << 5;
+  return test_seed;
+}
+
+static void test_random_payload(uint8_t * data){
+  uint8_t i;
+  for(i = 0; i < CAN_MAX_DLEN; i++) {
+    data[i] = (uint8_t)test_rand();
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Reference: one bit at a time, straight from the DBC definition
+//——————————————————————————————————————————————————————————————————————————————
+static bool ref_fits(uint8_t start, uint8_t length, uint8_t order){
+  if(SIG_MOTOROLA == order) {
+    return ((((start / 8) * 8) + (7 - (start % 8))) + length) <= 64;
+  }
+  return (start + length) <= 64;
+}
+
+//Bit number (DBC numbering) of bit i of the signal, i = 0 being the LSB
+static uint8_t ref_bit(uint8_t start, uint8_t length, uint8_t order, uint8_t i){
+  if(SIG_MOTOROLA == order) {
+    uint8_t linear = (uint8_t)(((start / 8) * 8) + (7 - (start % 8)) + (length - 1 - i));  //from the MSB of data[0]
+    return (uint8_t)(((linear / 8) * 8) + (7 - (linear % 8)));
+  }
+  return (uint8_t)(start + i);
+}
+
+static uint32_t ref_get(const uint8_t * data, uint8_t start, uint8_t length, uint8_t order){
+  uint32_t raw = 0;
+  uint8_t i;
+
+  for(i = 0; i < length; i++) {
+    uint8_t bit = ref_bit(start, length, order, i);
+    raw |= (uint32_t)((data[bit / 8] >> (bit % 8)) & 1U) << i;
+  }
+  return raw;
+}
+
+static void ref_set(uint8_t * data, uint8_t start, uint8_t length, uint8_t order, uint32_t raw){
+  uint8_t i;
+
+  for(i = 0; i < length; i++) {
+    uint8_t bit = ref_bit(start, length, order, i);
+    data[bit / 8] = (uint8_t)((data[bit / 8] & ~(1U << (bit % 8))) | (((raw >> i) & 1U) << (bit % 8)));
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Codec, every placement
+//——————————————————————————————————————————————————————————————————————————————
+static bool test_codec(void){
+  uint32_t placements = 0;
+  uint32_t checks = 0;
+  uint32_t failures = 0;
+  uint8_t order;
+  uint8_t start;
+  uint8_t length;
+  uint32_t n;
+
+  for(order = SIG_MOTOROLA; order <= SIG_INTEL; order++) {
+    for(start = 0; start < 64; start++) {
+      for(length = 1; length <= 32; length++) {
+        if(SIG_Fits(start, length, order) != ref_fits(start, length, order)) {
+          printf("  %s start %u length %u: SIG_Fits disagrees\n", order ? "intel" : "motorola", start, length);
+          failures++;
+        }
+        if(!ref_fits(start, length, order)) {
+          continue;
+        }
+        placements++;
+        for(n = 0; n < (TEST_VALUES + 4U); n++) {
+          uint8_t data[CAN_MAX_DLEN];
+          uint8_t expected[CAN_MAX_DLEN];
+          uint32_t mask = SIG_Mask(length);
+          uint32_t value;
+          int32_t sign_ref;
+
+          switch(n) {
+            case 0:  value = 0; break;
+            case 1:  value = mask; break;
+            case 2:  value = 0x55555555UL & mask; break;
+            case 3:  value = 1UL << (length - 1); break;
+            default: value = test_rand() & mask; break;
+          }
+          test_random_payload(data);
+          if(SIG_Extract(data, start, length, order) != ref_get(data, start, length, order)) {
+            failures++;
+          }
+          memcpy(expected, data, sizeof(expected));
+          ref_set(expected, start, length, order, value);
+          SIG_Insert(data, start, length, order, value | ~mask);   //bits above the length are ignored
+          if(0 != memcmp(data, expected, sizeof(expected))) {
+            failures++;
+          }
+          sign_ref = (int32_t)value - ((value & (1UL << (length - 1))) ? (int32_t)(((int64_t)1 << length)) : 0);
+          if((SIG_SignExtend(value, length) != sign_ref) ||
+             (SIG_ExtractSigned(data, start, length, order) != sign_ref)) {
+            failures++;
+          }
+          checks++;
+        }
+      }
+    }
+  }
+  printf("  %-20s %u placements, %u values, %u mismatches%s\n", "codec", (unsigned)placements, (unsigned)checks,
+         (unsigned)failures, failures ? " FAIL" : "");
+  return (0U == failures);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// LEAF descriptors against the hand-written shifts, every value of the two bytes involved
+//——————————————————————————————————————————————————————————————————————————————
+static bool test_report(const char * name, uint32_t total, uint32_t failures){
+  printf("  %-20s %6u/%u identical%s\n", name, (unsigned)(total - failures), (unsigned)total, failures ? " FAIL" : "");
+  return (0U == failures);
+}
+
+static void test_crc_frame(can_frame_t &frame, uint8_t hi_index, uint8_t hi, uint8_t lo){
+  test_random_payload(frame.data);
+  frame.data[hi_index] = hi;
+  frame.data[hi_index + 1] = lo;
+  frame.data[7] = CSUM_Crc8(frame.data);
+}
+
+static bool test_leaf(void){
+  uint32_t total = 0;
+  uint32_t failures = 0;
+  uint32_t hi;
+  uint32_t lo;
+  bool pass = true;
+
+  //0x1D4 torque demand: 12-bit signed in data[2], high nibble of data[3]
+  for(hi = 0; hi < 256U; hi++) {
+    for(lo = 0; lo < 256U; lo++) {
+      can_frame_t frame;
+      can_frame_t legacy;
+      test_crc_frame(frame, 2, (uint8_t)hi, (uint8_t)lo);
+      int16_t torque = (int16_t)((int16_t)(((uint16_t)hi << 8) | lo) >> 4);
+      failures += (SIG_Get<LEAF_1D4_TORQUE>(frame.data) != torque);
+      failures += (SIG_Raw<LEAF_1D4_TORQUE>(frame.data) != ((((uint16_t)hi << 8) | lo) >> 4));
+      //Rewrite: old code cleared the low nibble of data[3], compare on payloads where it is 0
+      frame.data[3] &= 0xF0;
+      frame.data[7] = CSUM_Crc8(frame.data);
+      legacy = frame;
+      int16_t scaled = (int16_t)((int16_t)(hi * 7U + lo) % 2048);
+      uint16_t raw = (uint16_t)((uint16_t)scaled << 4);
+      CSUM_SetByte(legacy, 2, raw >> 8);
+      CSUM_SetByte(legacy, 3, raw & 0x00F0);
+      SIG_Patch<LEAF_1D4_TORQUE>(frame, scaled);
+      failures += (0 != memcmp(frame.data, legacy.data, CAN_MAX_DLEN));
+      total++;
+    }
+  }
+  pass = test_report("1D4_torque", total, failures) && pass;
+
+  //0x1DA torque response: 11 bits, bit 10 (data[2] & 0x04) set while regen braking
+  total = 0;
+  failures = 0;
+  for(hi = 0; hi < 256U; hi++) {
+    for(lo = 0; lo < 256U; lo++) {
+      can_frame_t frame;
+      can_frame_t legacy;
+      test_crc_frame(frame, 2, (uint8_t)hi, (uint8_t)lo);
+      uint16_t response = (uint16_t)((((hi & 0x07) << 8) | lo) & 0x7FF);
+      failures += (SIG_Raw<LEAF_1DA_TORQUE>(frame.data) != response);
+      failures += ((SIG_Get<LEAF_1DA_TORQUE>(frame.data) < 0) != (0 != (hi & 0x04)));
+      legacy = frame;
+      uint16_t replaced = (uint16_t)((hi * 13U + lo) & 0x7FF);
+      CSUM_SetByte(legacy, 2, ((legacy.data[2] & 0xF8) | (replaced >> 8)));
+      CSUM_SetByte(legacy, 3, (replaced & 0xFF));
+      SIG_Patch<LEAF_1DA_TORQUE>(frame, replaced);
+      failures += (0 != memcmp(frame.data, legacy.data, CAN_MAX_DLEN));
+      total++;
+    }
+  }
+  pass = test_report("1DA_response", total, failures) && pass;
+
+  //0x284 speed, 0x55B SOC, 0x11A shifter, 0x1DB displayed SOC
+  total = 0;
+  failures = 0;
+  for(hi = 0; hi < 256U; hi++) {
+    for(lo = 0; lo < 256U; lo++) {
+      uint8_t data[CAN_MAX_DLEN];
+      can_frame_t frame;
+      can_frame_t legacy;
+      test_random_payload(data);
+      data[0] = (uint8_t)hi;
+      data[1] = (uint8_t)lo;
+      data[4] = (uint8_t)hi;
+      data[5] = (uint8_t)lo;
+      failures += (SIG_Raw<LEAF_284_SPEED>(data) != (((uint32_t)data[4] << 8) | data[5]));
+      failures += (SIG_Raw<LEAF_55B_LB_SOC>(data) != (uint32_t)((data[0] << 2) | ((data[1] & 0xC0) >> 6)));
+      failures += ((SIG_Raw<LEAF_11A_SHIFTER>(data) << 4) != (uint32_t)(data[0] & 0xF0));
+      test_crc_frame(frame, 4, (uint8_t)hi, (uint8_t)lo);
+      legacy = frame;
+      CSUM_SetByte(legacy, 4, (uint8_t)(hi ^ lo));
+      SIG_Patch<LEAF_1DB_SOC>(frame, (uint8_t)(hi ^ lo));
+      failures += (0 != memcmp(frame.data, legacy.data, CAN_MAX_DLEN));
+      failures += (CSUM_Crc8(frame.data) != frame.data[7]);
+      total++;
+    }
+  }
+  pass = test_report("284_55B_11A_1DB", total, failures) && pass;
+
+  //Scale: raw <-> physical
+  failures = 0;
+  failures += (SIG_ToPhys<LEAF_1D4_TORQUE>(-8) != -2.0f);
+  failures += (SIG_FromPhys<LEAF_1D4_TORQUE>(-2.0f) != -8);
+  failures += (SIG_FromPhys<LEAF_1DA_TORQUE>(100.2f) != 200);
+  failures += (SIG_FromPhys<LEAF_55B_LB_SOC>(55.55f) != 556);
+  failures += (SIG_ToPhys<LEAF_284_SPEED>(9800) != 100.0f);
+  pass = test_report("scale", 5U, failures) && pass;
+  return pass;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Signals of one message must not overlap
+//——————————————————————————————————————————————————————————————————————————————
+static uint64_t test_mask_word(const uint8_t * data){
+  uint64_t word = 0;
+  uint8_t i;
+  for(i = 0; i < CAN_MAX_DLEN; i++) {
+    word = (word << 8) | data[i];
+  }
+  return word;
+}
+
+template <class S>
+static void test_claim(uint64_t * used, uint32_t * failures){
+  uint8_t data[CAN_MAX_DLEN] = { 0 };
+  SIG_Set<S>(data, -1);
+  uint64_t bits = test_mask_word(data);
+  *failures += (0 != (*used & bits));
+  *failures += (S::length != __builtin_popcountll(bits));
+  *used |= bits;
+}
+
+static bool test_layout(void){
+  uint32_t failures = 0;
+  uint64_t used;
+
+  used = 0;
+  test_claim<LEAF_5BC_LB_CAPR>(&used, &failures);
+  test_claim<LEAF_5BC_LB_FULLCAP>(&used, &failures);
+  test_claim<LEAF_5BC_LB_CAPSEG>(&used, &failures);
+  test_claim<LEAF_5BC_LB_AVET>(&used, &failures);
+  test_claim<LEAF_5BC_LB_SOH>(&used, &failures);
+  test_claim<LEAF_5BC_LB_CAPSW>(&used, &failures);
+  test_claim<LEAF_5BC_LB_RLIMIT>(&used, &failures);
+  test_claim<LEAF_5BC_LB_CAPBALCOMP>(&used, &failures);
+  test_claim<LEAF_5BC_LB_RCHGTCON>(&used, &failures);
+  test_claim<LEAF_5BC_LB_RCHGTIM>(&used, &failures);
+  failures += (used != 0xFFFFFFFFFFE7FFFFULL);   //everything but the 2 spacer bits of data[5]
+
+  used = 0;
+  test_claim<LEAF_5C0_LB_HIS_DATA_SW>(&used, &failures);
+  test_claim<LEAF_5C0_LB_HIS_HLVOL_TIMS>(&used, &failures);
+  test_claim<LEAF_5C0_LB_HIS_TEMP_WUP>(&used, &failures);
+  test_claim<LEAF_5C0_LB_HIS_TEMP>(&used, &failures);
+  test_claim<LEAF_5C0_LB_HIS_INTG_CUR>(&used, &failures);
+  test_claim<LEAF_5C0_LB_HIS_DEG_REGI>(&used, &failures);
+  test_claim<LEAF_5C0_LB_HIS_CELL_VOL>(&used, &failures);
+  test_claim<LEAF_5C0_LB_DTC>(&used, &failures);
+
+  used = 0;
+  test_claim<LEAF_1DC_LB_POUT>(&used, &failures);
+  test_claim<LEAF_1DC_LB_PIN>(&used, &failures);
+  test_claim<LEAF_1DC_LB_BPCMAX>(&used, &failures);
+  test_claim<LEAF_1DC_LB_PIN_STATUS>(&used, &failures);
+  test_claim<LEAF_1DC_LB_BPCUPRATE>(&used, &failures);
+  test_claim<LEAF_1DC_LB_CODECON>(&used, &failures);
+  test_claim<LEAF_1DC_LB_CODE1>(&used, &failures);
+  test_claim<LEAF_1DC_LB_CODE2>(&used, &failures);
+  test_claim<LEAF_1DC_MPR1DC>(&used, &failures);
+  test_claim<LEAF_1DC_CRC8>(&used, &failures);
+  failures += (used != 0xFFFFFFFFFFFFFFFFULL);
+
+  used = 0;
+  test_claim<LEAF_1F2_TCSOC>(&used, &failures);
+  test_claim<LEAF_1F2_CHG_STA_RQ>(&used, &failures);
+  test_claim<LEAF_1F2_MPRUN>(&used, &failures);
+  test_claim<LEAF_1F2_CRC8>(&used, &failures);
+
+  used = 0;
+  test_claim<LEAF_1DB_LB_CURRENT>(&used, &failures);
+  test_claim<LEAF_1DB_LB_VOLTAGE>(&used, &failures);
+  test_claim<LEAF_1DB_SOC>(&used, &failures);
+  test_claim<LEAF_1DB_MPR1DB>(&used, &failures);
+  test_claim<LEAF_1DB_CRC8>(&used, &failures);
+
+  printf("  %-20s %s\n", "layout", failures ? "FAIL" : "ok");
+  return (0U == failures);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// 0x1D4 handler against the former one
+//——————————————————————————————————————————————————————————————————————————————
+//Baseline handler, stock inverter (no multiplier), REGEN_TUNING_ENABLED with REGEN_MULTIPLIER 1.10
+static void legacy_handle_1D4(can_frame_t &frame){
+  uint16_t torqueDemand = (uint16_t)((frame.data[2] << 8) | frame.data[3]);
+
+  if(frame.data[2] & 0x80){
+    torqueDemand = ~torqueDemand;
+    torqueDemand = (torqueDemand >> 4);
+    torqueDemand = (uint16_t)(torqueDemand * 1.10);
+    torqueDemand = (torqueDemand << 4);
+    torqueDemand = ~torqueDemand;
+  }
+  else{
+    torqueDemand = (torqueDemand >> 4);
+    torqueDemand = (torqueDemand << 4);
+  }
+  frame.data[2] = torqueDemand >> 8;
+  frame.data[3] = (torqueDemand & 0x00F0);
+  frame.data[7] = CSUM_Crc8(frame.data);
+}
+
+static bool test_handler_1D4(void){
+  can_frame_t shifter;
+  uint32_t total = 0;
+  uint32_t failures = 0;
+  uint32_t regen_total = 0;
+  uint32_t regen_failures = 0;
+  uint32_t regen_off_by_one = 0;
+  uint32_t regen_wrapped = 0;
+  uint32_t hi;
+  uint32_t lo;
+  bool pass;
+
+  HOST_BridgeInit();              //Nissan LEAF, stock inverter
+  memset(&shifter, 0, sizeof(shifter));
+  shifter.can_id = 0x11A;
+  shifter.can_dlc = 8;
+  SIG_Set<LEAF_11A_SHIFTER>(shifter.data, 4);   //drive, the rewrite is skipped otherwise
+  shifter.data[7] = CSUM_Crc8(shifter.data);
+  LEAF_CAN_Handler(CAN_CHANNEL_2, shifter);
+
+  for(hi = 0; hi < 256U; hi++) {
+    for(lo = 0; lo < 256U; lo++) {
+      can_frame_t frame;
+      can_frame_t legacy;
+      frame.can_id = 0x1D4;
+      frame.can_dlc = 8;
+      frame.rx_cycles = 1U;
+      test_crc_frame(frame, 2, (uint8_t)hi, (uint8_t)lo);
+      legacy = frame;
+      legacy_handle_1D4(legacy);
+      LEAF_CAN_Handler(CAN_CHANNEL_2, frame);
+      if(hi & 0x80) {
+        int32_t delta = SIG_Get<LEAF_1D4_TORQUE>(frame.data) - SIG_Get<LEAF_1D4_TORQUE>(legacy.data);
+        if(SIG_Get<LEAF_1D4_TORQUE>(legacy.data) >= 0) {
+          delta = SIG_Get<LEAF_1D4_TORQUE>(frame.data) - TSCALE_TORQUE_MIN;   //wrapped
+          regen_wrapped++;
+        }
+        legacy.data[2] = frame.data[2];
+        legacy.data[3] = frame.data[3];
+        legacy.data[7] = CSUM_Crc8(legacy.data);
+        regen_failures += (delta < -1) || (delta > 1) || (0 != memcmp(frame.data, legacy.data, CAN_MAX_DLEN));
+        regen_off_by_one += (0 != delta);
+        regen_total++;
+      } else {
+        failures += (0 != memcmp(frame.data, legacy.data, CAN_MAX_DLEN));
+        total++;
+      }
+      //Both paths clear the low nibble of data[3]
+      failures += (0 != (frame.data[3] & 0x0F));
+    }
+  }
+  pass = test_report("1D4_handler_power", total, failures);
+  printf("  %-20s %6u/%u within 1, %u differ by 1, former wrapped %u%s\n", "1D4_handler_regen",
+         (unsigned)(regen_total - regen_failures), (unsigned)regen_total, (unsigned)regen_off_by_one,
+         (unsigned)regen_wrapped, regen_failures ? " FAIL" : "");
+  return (0U == regen_failures) && pass;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// 0x5BC / 0x5C0 conversions
+//——————————————————————————————————————————————————————————————————————————————
+//Fields in the declaration order of the former bitfield structs, MSB of data[0] first
+static void ref_pack(uint8_t * data, const uint32_t * values, const uint8_t * lengths, uint8_t count){
+  uint64_t word = 0;
+  uint8_t used = 0;
+  uint8_t i;
+
+  for(i = 0; i < count; i++) {
+    word = (word << lengths[i]) | (values[i] & SIG_Mask(lengths[i]));
+    used += lengths[i];
+  }
+  word <<= (64 - used);
+  for(i = 0; i < CAN_MAX_DLEN; i++) {
+    data[i] = (uint8_t)(word >> (56 - (8 * i)));
+  }
+}
+
+static void legacy_5bc_to_array(const leaf_5bc_t * src, uint8_t * dest){
+  dest[0] = (uint8_t) (src->LB_CAPR >> 2);
+  dest[1] = (uint8_t) (((src->LB_CAPR << 6) & 0xC0) | ((src->LB_FULLCAP >> 4) & 0x1F));
+  dest[2] = (uint8_t) (((src->LB_FULLCAP << 4) & 0xF0) | ((src->LB_CAPSEG) & 0x0F));
+  dest[3] = (uint8_t) (src->LB_AVET);
+  dest[4] = (uint8_t) (((src->LB_SOH << 1) & 0xFE) | ((src->LB_CAPSW) & 1));
+  dest[5] = (uint8_t) (((src->LB_RLIMIT << 5) & 0xE0) | ((src->LB_CAPBALCOMP << 2) & 4) | ((src->LB_RCHGTCON >> 3) & 3));
+  dest[6] = (uint8_t) (((src->LB_RCHGTCON << 5) & 0xE0) | ((src->LB_RCHGTIM >> 8) & 0x1F));
+  dest[7] = (uint8_t) (src->LB_RCHGTIM);
+}
+
+static void legacy_array_to_5bc(leaf_5bc_t * dest, const uint8_t * src){
+  dest->LB_CAPR = (src[0] << 2) | (src[1] & 0xC0 >> 6);
+}
+
+static void legacy_5c0_to_array(const leaf_5c0_t * src, uint8_t * dest){
+  dest[0] = (src->LB_HIS_DATA_SW << 6) | src->LB_HIS_HLVOL_TIMS;
+  dest[1] = src->LB_HIS_TEMP_WUP << 1;
+  dest[2] = src->LB_HIS_TEMP << 1;
+  dest[3] = src->LB_HIS_INTG_CUR;
+  dest[4] = src->LB_HIS_DEG_REGI << 1;
+  dest[5] = src->LB_HIS_CELL_VOL << 2;
+  dest[7] = src->LB_DTC;
+}
+
+static void test_random_5bc(leaf_5bc_t * msg){
+  msg->LB_CAPR = (uint16_t)(test_rand() & 0x3FF);
+  msg->LB_FULLCAP = (uint16_t)(test_rand() & 0x3FF);
+  msg->LB_CAPSEG = (uint8_t)(test_rand() & 0x0F);
+  msg->LB_AVET = (uint8_t)test_rand();
+  msg->LB_SOH = (uint8_t)(test_rand() & 0x7F);
+  msg->LB_CAPSW = (uint8_t)(test_rand() & 0x01);
+  msg->LB_RLIMIT = (uint8_t)(test_rand() & 0x07);
+  msg->LB_CAPBALCOMP = (uint8_t)(test_rand() & 0x01);
+  msg->LB_RCHGTCON = (uint8_t)(test_rand() & 0x1F);
+  msg->LB_RCHGTIM = (uint16_t)(test_rand() & 0x1FFF);
+}
+
+static bool test_convert(uint32_t count){
+  static const uint8_t lengths_5bc[] = { 10, 10, 4, 8, 7, 1, 3, 2, 1, 5, 13 };
+  static const uint8_t lengths_5c0[] = { 2, 2, 4, 7, 1, 7, 1, 8, 7, 1, 6, 10, 8 };
+  uint32_t failures = 0;
+  uint32_t legacy_differs = 0;
+  uint32_t legacy_bit9 = 0;
+  uint32_t legacy_decode_differs = 0;
+  uint32_t legacy_capr_bits = 0;
+  uint32_t n;
+
+  for(n = 0; n < count; n++) {
+    leaf_5bc_t msg;
+    leaf_5bc_t back;
+    uint8_t data[CAN_MAX_DLEN];
+    uint8_t expected[CAN_MAX_DLEN];
+    uint8_t legacy[CAN_MAX_DLEN];
+
+    memset(&msg, 0, sizeof(msg));   //padding, compared with memcmp
+    test_random_5bc(&msg);
+    uint32_t values[] = { msg.LB_CAPR, msg.LB_FULLCAP, msg.LB_CAPSEG, msg.LB_AVET, msg.LB_SOH, msg.LB_CAPSW,
+                          msg.LB_RLIMIT, 0, msg.LB_CAPBALCOMP, msg.LB_RCHGTCON, msg.LB_RCHGTIM };
+    ref_pack(expected, values, lengths_5bc, sizeof(lengths_5bc));
+    convert_5bc_to_array(&msg, data);
+    failures += (0 != memcmp(data, expected, sizeof(expected)));
+    memset(&back, 0, sizeof(back));
+    convert_array_to_5bc(&back, data);
+    failures += (0 != memcmp(&back, &msg, sizeof(msg)));
+    legacy_5bc_to_array(&msg, legacy);
+    if(0 != memcmp(legacy, data, sizeof(legacy))) {
+      legacy_differs++;
+      legacy_bit9 += (0 != (msg.LB_FULLCAP & 0x200));
+    }
+    //The former decoder, on a copy already holding every other field
+    back = msg;
+    legacy_array_to_5bc(&back, data);
+    if(0 != memcmp(&back, &msg, sizeof(msg))) {
+      legacy_decode_differs++;
+      legacy_capr_bits += ((data[1] & 0x03) != (data[1] >> 6));
+    }
+
+    leaf_5c0_t his;
+    his.LB_HIS_DATA_SW = (uint8_t)(test_rand() & 0x03);
+    his.LB_HIS_HLVOL_TIMS = (uint8_t)(test_rand() & 0x0F);
+    his.LB_HIS_TEMP_WUP = (uint8_t)(test_rand() & 0x7F);
+    his.LB_HIS_TEMP = (uint8_t)(test_rand() & 0x7F);
+    his.LB_HIS_INTG_CUR = (uint8_t)test_rand();
+    his.LB_HIS_DEG_REGI = (uint8_t)(test_rand() & 0x7F);
+    his.LB_HIS_CELL_VOL = (uint8_t)(test_rand() & 0x3F);
+    his.LB_DTC = (uint8_t)test_rand();
+    uint32_t values_5c0[] = { his.LB_HIS_DATA_SW, 0, his.LB_HIS_HLVOL_TIMS, his.LB_HIS_TEMP_WUP, 0, his.LB_HIS_TEMP, 0,
+                              his.LB_HIS_INTG_CUR, his.LB_HIS_DEG_REGI, 0, his.LB_HIS_CELL_VOL, 0, his.LB_DTC };
+    ref_pack(expected, values_5c0, lengths_5c0, sizeof(lengths_5c0));
+    convert_5c0_to_array(&his, data);
+    failures += (0 != memcmp(data, expected, sizeof(expected)));
+    memset(legacy, 0, sizeof(legacy));
+    legacy_5c0_to_array(&his, legacy);
+    failures += (0 != memcmp(data, legacy, sizeof(legacy)));
+  }
+  //The legacy 0x5BC encoder must differ exactly where LB_FULLCAP bit 9 is set, the decoder exactly
+  //where the two LB_CAPR bits it read from src[1] are not the right ones
+  failures += (legacy_differs != legacy_bit9);
+  failures += (legacy_decode_differs != legacy_capr_bits);
+  printf("  %-20s %6u/%u identical, legacy 0x5BC lost LB_FULLCAP bit 9 in %u%s\n", "convert_5BC_5C0",
+         (unsigned)(count - failures), (unsigned)count, (unsigned)legacy_bit9, failures ? " FAIL" : "");
+  printf("  %-20s legacy 0x5BC decoder read the wrong LB_CAPR bits in %u\n", "", (unsigned)legacy_capr_bits);
+  return (0U == failures);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Timing
+//——————————————————————————————————————————————————————————————————————————————
+static can_frame_t time_frames[TEST_FRAMES];
+
+template <uint32_t (*CASE)(can_frame_t &)>
+static void test_time(const char * name, uint32_t iterations){
+  bench_timer_t timer;
+  uint32_t done;
+  uint32_t i;
+  uint32_t out;
+  uint8_t repeat;
+
+  for(repeat = 0; repeat < BENCH_REPEAT; repeat++) {
+    BENCH_Clear(&timer);
+    for(done = 0; done < iterations; done += TEST_FRAMES) {
+      BENCH_Start(&timer);
+      for(i = 0; i < TEST_FRAMES; i++) {
+        out = CASE(time_frames[i]);
+        BENCH_Use(out);
+      }
+      BENCH_Stop(&timer, TEST_FRAMES);
+    }
+    BENCH_Record(name, &timer);
+  }
+  BENCH_Report(name);
+}
+
+static uint32_t time_get_1D4_shift(can_frame_t &frame){
+  return (uint32_t)(int16_t)((int16_t)(((uint16_t)frame.data[2] << 8) | frame.data[3]) >> 4);
+}
+static uint32_t time_get_1D4_sig(can_frame_t &frame){
+  return (uint32_t)SIG_Get<LEAF_1D4_TORQUE>(frame.data);
+}
+static uint32_t time_set_1DA_shift(can_frame_t &frame){
+  uint16_t response = (uint16_t)(frame.data[0] << 3);
+  CSUM_SetByte(frame, 2, ((frame.data[2] & 0xF8) | (response >> 8)));
+  CSUM_SetByte(frame, 3, (response & 0xFF));
+  return frame.data[7];
+}
+static uint32_t time_set_1DA_sig(can_frame_t &frame){
+  SIG_Patch<LEAF_1DA_TORQUE>(frame, (uint16_t)(frame.data[0] << 3));
+  return frame.data[7];
+}
+static uint32_t time_get_55B_shift(can_frame_t &frame){
+  return (uint32_t)((frame.data[0] << 2) | ((frame.data[1] & 0xC0) >> 6));
+}
+static uint32_t time_get_55B_sig(can_frame_t &frame){
+  return SIG_Raw<LEAF_55B_LB_SOC>(frame.data);
+}
+static uint32_t time_5BC_shift(can_frame_t &frame){
+  leaf_5bc_t msg;
+  convert_array_to_5bc(&msg, frame.data);
+  legacy_5bc_to_array(&msg, frame.data);
+  return frame.data[1];
+}
+static uint32_t time_5BC_sig(can_frame_t &frame){
+  leaf_5bc_t msg;
+  convert_array_to_5bc(&msg, frame.data);
+  convert_5bc_to_array(&msg, frame.data);
+  return frame.data[1];
+}
+
+int main(int argc, char ** argv){
+  uint32_t iterations = TEST_FRAMES * 256U;
+  bool pass = true;
+  uint32_t i;
+  int opt;
+
+  while(-1 != (opt = getopt(argc, argv, "n:"))) {
+    switch(opt) {
+      case 'n': iterations = (uint32_t)strtoul(optarg, NULL, 10); break;
+      default:
+        fprintf(stderr, "usage: %s [-n iterations]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  printf("CAN signal codec against the bit by bit reference:\n");
+  pass = test_codec() && pass;
+  pass = test_leaf() && pass;
+  pass = test_handler_1D4() && pass;
+  pass = test_layout() && pass;
+  pass = test_convert(65536U) && pass;
+
+  BENCH_Init();
+  for(i = 0; i < TEST_FRAMES; i++) {
+    test_random_payload(time_frames[i].data);
+    time_frames[i].data[7] = CSUM_Crc8(time_frames[i].data);
+  }
+  printf("Per frame, best of %u%s:\n", (unsigned)BENCH_REPEAT,
+         BENCH_InstructionsAvailable() ? "" : " (instruction counter not available)");
+  test_time<time_get_1D4_shift>("get_1D4_shift", iterations);
+  test_time<time_get_1D4_sig>("get_1D4_signal", iterations);
+  test_time<time_set_1DA_shift>("patch_1DA_shift", iterations);
+  test_time<time_set_1DA_sig>("patch_1DA_signal", iterations);
+  test_time<time_get_55B_shift>("get_55B_shift", iterations);
+  test_time<time_get_55B_sig>("get_55B_signal", iterations);
+  test_time<time_5BC_shift>("encode_5BC_shift", iterations);
+  test_time<time_5BC_sig>("encode_5BC_signal", iterations);
+
+  printf("%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
@@ -0,0 +1,39 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Simulated clock for the host build, backs micros()/millis()/ESP.getCycleCount()
+// 10.16.2026: Host build of the bridge engine, see host/Makefile
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include "sim_clock.h"
+
+static uint64_t sim_now_us = 0U;
+
+HardwareSerial Serial;
+EspClass ESP;
+
+void SIM_Clock_Set(uint64_t now_us){
+  sim_now_us = now_us;
+}
+
+void SIM_Clock_Advance(uint32_t delta_us){
+  sim_now_us += delta_us;
+}
+
+void SIM_Clock_Tick(uint64_t now_us){
+  if(now_us > sim_now_us) {
+    sim_now_us = now_us;
+  }
+}
+
+uint64_t SIM_Clock_Now(void){
+  return sim_now_us;
+}
+
+//Same 32-bit wrap-around as the ESP32 core
+uint32_t micros(void){
+  return (uint32_t)sim_now_us;
+}
+
+uint32_t millis(void){
+  return (uint32_t)(sim_now_us / 1000U);
+}
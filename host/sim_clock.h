@@ -0,0 +1,19 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Simulated clock for the host build, backs micros()/millis()/ESP.getCycleCount()
+// 10.16.2026: Host build of the bridge engine, see host/Makefile
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+#include <stdint.h>
+
+//The clock only moves when the simulation moves it, so runs are reproducible and
+//independent of how fast the host executes the engine.
+void SIM_Clock_Set(uint64_t now_us);
+void SIM_Clock_Advance(uint32_t delta_us);
+//Start of a bridge pass: to now_us, unless the previous pass ran past it (VCAN_RX_PROCESS_US)
+void SIM_Clock_Tick(uint64_t now_us);
+uint64_t SIM_Clock_Now(void);
+
+#endif //SIM_CLOCK_H
@@ -0,0 +1,292 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Host simulation of the LEAF bridge engine on the virtual CAN bus
+// 10.16.2026: Host build of the bridge engine, see host/Makefile
+// 10.16.2026: The scenario must pass the inbound CRC/counter validation without errors
+//——————————————————————————————————————————————————————————————————————————————
+// Runs the unmodified engine sources (can_bridge_manager_common/leaf, frame_scheduler,
+// helper_functions, ...) against a scripted traffic scenario on a simulated clock:
+//  - VCM/LBC traffic arrives on CAN2, inverter traffic on CAN1 (as wired in the vehicle)
+//  - every T_POLLING the loop does what BridgeTask does on the target
+//  - forwarded frames are matched to their reception by ID for the wire-to-wire latency
+//  - each frame read costs VCAN_RX_PROCESS_US of simulated time, the RX->TX histograms must show it
+// Output: frames/s of host execution, latency percentiles per direction, synthesized frame
+// counts, and a pass/fail verdict for regression runs (exit code 1 on failure).
+//
+// -w records the injected traffic as a candump trace (channels can1/can2) for bridge_replay.
+//
+// Usage: bridge_sim [-d seconds] [-l max_latency_us] [-w trace.log] [-v]
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include <unistd.h>
+#include <chrono>
+#include "config.h"
+#include "can_driver.h"
+#include "can_bridge_manager_common.h"
+#include "can_bridge_manager_leaf.h"
+#include "helper_functions.h"
+#include "latency_histogram.h"
+#include "frame_scheduler.h"
+#include "sim_clock.h"
+#include "virtual_can.h"
+#include "bridge_loop.h"
+#include "trace_io.h"
+#include "checksum.h"
+
+//——————————————————————————————————————————————————————————————————————————————
+// Traffic scenario
+//——————————————————————————————————————————————————————————————————————————————
+typedef struct {
+  uint8_t  can_bus;
+  uint16_t can_id;
+  uint8_t  can_dlc;
+  uint16_t period_ms;
+  uint16_t phase_ms;
+} sim_traffic_t;
+
+static const sim_traffic_t sim_traffic[] = {
+  //VCM and LBC side (CAN2)
+  { CAN_CHANNEL_2, 0x11A, 8,   10, 0 },  //shifter
+  { CAN_CHANNEL_2, 0x1D4, 8,   10, 1 },  //torque request
+  { CAN_CHANNEL_2, 0x1DB, 8,   10, 2 },  //LBC current/voltage
+  { CAN_CHANNEL_2, 0x1DC, 8,   10, 3 },  //LBC power limits
+  { CAN_CHANNEL_2, 0x1F2, 8,   10, 4 },  //VCM charger command
+  { CAN_CHANNEL_2, 0x284, 8,   20, 5 },  //ABS wheel speeds
+  { CAN_CHANNEL_2, 0x292, 8,   40, 6 },
+  { CAN_CHANNEL_2, 0x50B, 7,  100, 7 },
+  { CAN_CHANNEL_2, 0x50C, 6,  100, 8 },
+  { CAN_CHANNEL_2, 0x55B, 8,  100, 9 },  //LBC SOC
+  { CAN_CHANNEL_2, 0x5BC, 8,  100, 3 },  //LBC capacity
+  { CAN_CHANNEL_2, 0x5C0, 8,  500, 6 },
+  //Inverter side (CAN1)
+  { CAN_CHANNEL_1, 0x1DA, 8,   10, 5 },  //torque response
+  { CAN_CHANNEL_1, 0x55A, 8,  100, 2 },
+  { CAN_CHANNEL_1, 0x59A, 8,  100, 7 },
+};
+#define SIM_TRAFFIC_COUNT (sizeof(sim_traffic) / sizeof(sim_traffic[0]))
+
+#define SIM_ID_COUNT      2048U
+#define SIM_NO_TIME       0xFFFFFFFFFFFFFFFFULL
+#define SIM_DRAIN_MS      50U     //quiet time at the end so every forwarded frame leaves the bridge
+
+static uint64_t sim_rx_time[VCAN_CHANNELS][SIM_ID_COUNT];  //last reception per channel and ID
+static uint32_t sim_rx_count[VCAN_CHANNELS];
+static uint32_t sim_forwarded[VCAN_CHANNELS];               //by receiving channel
+static uint32_t sim_synthesized[SIM_ID_COUNT];              //sent without a matching reception
+static latency_hist_t sim_latency[VCAN_CHANNELS];           //by receiving channel
+static bool sim_verbose = false;
+
+//Deterministic payload: a rolling value per message, LEAF CRC on 8 byte frames
+static void sim_build_frame(const sim_traffic_t * msg, uint32_t count, can_frame_t &frame){
+  uint8_t i;
+  frame.can_id = msg->can_id;
+  frame.can_dlc = msg->can_dlc;
+  memset(frame.data, 0, sizeof(frame.data));
+  for(i = 0; i < msg->can_dlc; i++) {
+    frame.data[i] = (uint8_t)((count + i) & 0x0F);
+  }
+  switch(msg->can_id) {
+    case 0x11A:
+      frame.data[0] = 0x40;  //drive
+    break;
+    case 0x1D4:
+      frame.data[2] = (uint8_t)((count * 3U) & 0x7F);  //positive torque ramp
+      frame.data[3] = 0x00;
+    break;
+    case 0x1F2:
+      frame.data[2] = CHARGING_IDLE;
+    break;
+    default:
+    break;
+  }
+  if(8U == msg->can_dlc) {
+    calc_crc8(&frame);
+  }
+}
+
+static uint8_t sim_peer(uint8_t can_bus){
+  return (CAN_CHANNEL_2 == can_bus) ? CAN_CHANNEL_1 : CAN_CHANNEL_2;
+}
+
+static void sim_on_tx(uint8_t can_bus, const can_frame_t &frame, uint64_t done_us){
+  uint8_t source = sim_peer(can_bus);
+  uint64_t rx_us = (frame.can_id < SIM_ID_COUNT) ? sim_rx_time[source][frame.can_id] : SIM_NO_TIME;
+
+  if(SIM_NO_TIME == rx_us) {
+    if(frame.can_id < SIM_ID_COUNT) {
+      sim_synthesized[frame.can_id]++;
+    }
+  } else {
+    sim_forwarded[source]++;
+    HIST_Record(&sim_latency[source], (uint32_t)(done_us - rx_us));
+  }
+
+  if(sim_verbose) {
+    char strbuf[32];
+    canframe_to_str(strbuf, frame);
+    printf("%10llu tx%u %s\n", (unsigned long long)done_us, can_bus, strbuf);
+  }
+}
+
+static void sim_print_latency(const char * name, const latency_hist_t * hist){
+  printf("  %-10s %8u frames  p50 %6u us  p99 %6u us  max %6u us\n", name,
+         (unsigned)hist->count, (unsigned)HIST_Percentile(hist, 50), (unsigned)HIST_Percentile(hist, 99),
+         (unsigned)hist->max);
+}
+
+int main(int argc, char ** argv){
+  uint32_t duration_s = 10U;
+  uint32_t max_latency_us = 5000U;
+  uint32_t traffic_count[SIM_TRAFFIC_COUNT];
+  const char * trace_path = NULL;
+  trace_writer_t trace;
+  uint32_t passes = 0U;
+  uint64_t end_us;
+  uint64_t now_us;
+  uint32_t i;
+  int opt;
+  bool pass = true;
+
+  while(-1 != (opt = getopt(argc, argv, "d:l:w:v"))) {
+    switch(opt) {
+      case 'd': duration_s = (uint32_t)strtoul(optarg, NULL, 10); break;
+      case 'l': max_latency_us = (uint32_t)strtoul(optarg, NULL, 10); break;
+      case 'w': trace_path = optarg; break;
+      case 'v': sim_verbose = true; break;
+      default:
+        fprintf(stderr, "usage: %s [-d seconds] [-l max_latency_us] [-w trace.log] [-v]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  memset(sim_rx_time, 0xFF, sizeof(sim_rx_time));
+  memset(traffic_count, 0, sizeof(traffic_count));
+  for(i = 0; i < VCAN_CHANNELS; i++) {
+    HIST_Reset(&sim_latency[i]);
+  }
+
+  memset(&trace, 0, sizeof(trace));
+  if((NULL != trace_path) && !TRACE_Create(&trace, trace_path)) {
+    fprintf(stderr, "cannot create %s\n", trace_path);
+    return 2;
+  }
+
+  //Boot, as setup() does
+  SIM_Clock_Set(0U);
+  HOST_BridgeInit();
+  VCAN_SetTxCallback(sim_on_tx);
+
+  end_us = (uint64_t)duration_s * 1000000ULL;
+  std::chrono::steady_clock::time_point wall_start = std::chrono::steady_clock::now();
+
+  for(now_us = 0U; now_us < end_us + (SIM_DRAIN_MS * 1000U); now_us += T_POLLING) {
+    SIM_Clock_Tick(now_us);
+
+    //Frames arrive at the start of the tick they fall into
+    if(now_us < end_us) {
+      for(i = 0; i < SIM_TRAFFIC_COUNT; i++) {
+        const sim_traffic_t * msg = &sim_traffic[i];
+        uint64_t due_us = ((uint64_t)msg->phase_ms + ((uint64_t)traffic_count[i] * msg->period_ms)) * 1000U;
+        if(due_us <= now_us) {
+          can_frame_t frame;
+          sim_build_frame(msg, traffic_count[i], frame);
+          sim_rx_time[msg->can_bus][msg->can_id] = now_us;
+          TRACE_Write(&trace, now_us, (CAN_CHANNEL_2 == msg->can_bus) ? "can2" : "can1", frame);
+          if(VCAN_Inject(msg->can_bus, frame)) {
+            sim_rx_count[msg->can_bus]++;
+          }
+          traffic_count[i]++;
+        }
+      }
+    }
+
+    HOST_BridgePass();
+    passes++;
+    VCAN_Advance(now_us + T_POLLING);
+  }
+
+  std::chrono::steady_clock::time_point wall_end = std::chrono::steady_clock::now();
+  TRACE_Finish(&trace);
+  double wall_s = std::chrono::duration<double>(wall_end - wall_start).count();
+  uint32_t rx_total = sim_rx_count[CAN_CHANNEL_1] + sim_rx_count[CAN_CHANNEL_2];
+
+  //——— Report
+  printf("Simulated %u s, %u bridge passes (T_POLLING %u us)\n", (unsigned)duration_s, (unsigned)passes, (unsigned)T_POLLING);
+  printf("Host: %.3f s, %.0f frames/s, %.0f ns/pass\n", wall_s,
+         (wall_s > 0.0) ? (rx_total / wall_s) : 0.0, (passes > 0U) ? ((wall_s * 1e9) / passes) : 0.0);
+
+  printf("Received -> forwarded (wire to wire latency):\n");
+  sim_print_latency("CAN2->CAN1", &sim_latency[CAN_CHANNEL_2]);
+  sim_print_latency("CAN1->CAN2", &sim_latency[CAN_CHANNEL_1]);
+  printf("Bridge RX->TX histograms (ingress timestamp to controller hand-over):\n");
+  sim_print_latency("tx CAN1", buffer_get_latency_hist(CAN_CHANNEL_1));
+  sim_print_latency("tx CAN2", buffer_get_latency_hist(CAN_CHANNEL_2));
+  for(i = 0; i < CAN_ID_CLASS_COUNT; i++) {
+    static const char * const class_names[CAN_ID_CLASS_COUNT] = {"torque", "control", "status", "housekeep"};
+    sim_print_latency(class_names[i], buffer_get_class_latency_hist(i));
+  }
+
+  printf("Synthesized:\n");
+  for(i = 0; i < SIM_ID_COUNT; i++) {
+    if(sim_synthesized[i] > 0U) {
+      printf("  0x%03X %8u frames\n", (unsigned)i, (unsigned)sim_synthesized[i]);
+    }
+  }
+
+  //——— Regression checks
+  for(i = 0; i < VCAN_CHANNELS; i++) {
+    vcan_stats_t vstats;
+    tx_buffer_stats_t tstats;
+    VCAN_GetStats(i, &vstats);
+    if(vstats.rx_dropped > 0U) {
+      printf("FAIL: CAN%u receive queue dropped %u frames\n", (unsigned)i, (unsigned)vstats.rx_dropped);
+      pass = false;
+    }
+    if(buffer_get_stats(i, &tstats) && (tstats.dropped > 0U)) {
+      printf("FAIL: CAN%u transmit buffer dropped %u frames\n", (unsigned)i, (unsigned)tstats.dropped);
+      pass = false;
+    }
+    //Every frame passes through the ring, the ring + heap level can only be higher
+    if(buffer_get_stats(i, &tstats) && (tstats.queued_high_water < tstats.ring_high_water)) {
+      printf("FAIL: CAN%u transmit queue peak %u below the ring peak %u\n", (unsigned)i,
+             (unsigned)tstats.queued_high_water, (unsigned)tstats.ring_high_water);
+      pass = false;
+    }
+  }
+  if(sim_forwarded[CAN_CHANNEL_2] != sim_rx_count[CAN_CHANNEL_2]) {
+    printf("FAIL: CAN2->CAN1 forwarded %u of %u frames\n", (unsigned)sim_forwarded[CAN_CHANNEL_2], (unsigned)sim_rx_count[CAN_CHANNEL_2]);
+    pass = false;
+  }
+  if(sim_forwarded[CAN_CHANNEL_1] != sim_rx_count[CAN_CHANNEL_1]) {
+    printf("FAIL: CAN1->CAN2 forwarded %u of %u frames\n", (unsigned)sim_forwarded[CAN_CHANNEL_1], (unsigned)sim_rx_count[CAN_CHANNEL_1]);
+    pass = false;
+  }
+  for(i = 0; i < CSUM_Count(); i++) {
+    csum_stats_t csum;
+    if(CSUM_GetStats(i, &csum) && ((csum.crc_errors > 0U) || (csum.counter_skips > 0U))) {
+      printf("FAIL: 0x%03X %u CRC errors, %u counter skips in %u frames\n", (unsigned)csum.can_id,
+             (unsigned)csum.crc_errors, (unsigned)csum.counter_skips, (unsigned)csum.frames);
+      pass = false;
+    }
+  }
+  //Every read frame costs VCAN_RX_PROCESS_US, so no forwarded frame can reach its controller at 0 us
+  for(i = CAN_CHANNEL_1; i <= CAN_CHANNEL_2; i++) {
+    const latency_hist_t * hist = buffer_get_latency_hist(i);
+    uint32_t p50 = HIST_Percentile(hist, 50);
+    uint32_t p99 = HIST_Percentile(hist, 99);
+    if((sim_rx_count[sim_peer(i)] > 0U) && ((0U == hist->count) || (0U == p50) || (p50 < VCAN_RX_PROCESS_US) || (p50 > p99) || (p99 > hist->max))) {
+      printf("FAIL: CAN%u RX->TX histogram %u frames, p50 %u us, p99 %u us, max %u us\n", (unsigned)i,
+             (unsigned)hist->count, (unsigned)p50, (unsigned)p99, (unsigned)hist->max);
+      pass = false;
+    }
+  }
+  for(i = 0; i < VCAN_CHANNELS; i++) {
+    if(sim_latency[i].max > max_latency_us) {
+      printf("FAIL: CAN%u max latency %u us above %u us\n", (unsigned)i, (unsigned)sim_latency[i].max, (unsigned)max_latency_us);
+      pass = false;
+    }
+  }
+
+  printf("%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
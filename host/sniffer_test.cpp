@@ -0,0 +1,264 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Websocket CAN sniffer (can_sniffer.h): commands, ID/channel filter, decimation, batching, drops
+// 10.16.2026: A fake transport stands in for AsyncWebSocket; it can report a full queue or a gone client
+//——————————————————————————————————————————————————————————————————————————————
+// Usage: sniffer_test   exit code 1 when a check fails
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include "can_sniffer.h"
+
+#define TEST_MESSAGES_MAX  32
+#define TEST_RECORDS_MAX   1024
+
+static uint32_t test_failures = 0;
+
+static void test_check(const char * name, bool ok){
+  printf("  %-44s %s\n", name, ok ? "ok" : "FAIL");
+  if(!ok){
+    test_failures++;
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Fake transport
+//——————————————————————————————————————————————————————————————————————————————
+static sniff_header_t test_headers[TEST_MESSAGES_MAX];
+static sniff_record_t test_records[TEST_RECORDS_MAX];
+static uint32_t test_message_count = 0;
+static uint32_t test_record_count = 0;
+static bool test_bad_message = false;
+static bool test_busy = false;
+static bool test_gone = false;
+
+static telem_send_result_t test_send(uint32_t client_id, const uint8_t * data, size_t len){
+  const sniff_header_t * header = (const sniff_header_t *)data;
+
+  if(test_gone){
+    return TELEM_GONE;
+  }
+  if(test_busy){
+    return TELEM_BUSY;
+  }
+  if((len < sizeof(sniff_header_t)) || (len != (sizeof(sniff_header_t) + (header->count * sizeof(sniff_record_t)))) ||
+     (SNIFF_MAGIC0 != header->magic[0]) || (SNIFF_MAGIC1 != header->magic[1]) || (SNIFF_VERSION != header->version)){
+    test_bad_message = true;
+    return TELEM_SENT;
+  }
+  if(test_message_count < TEST_MESSAGES_MAX){
+    test_headers[test_message_count++] = *header;
+  }
+  if((test_record_count + header->count) <= TEST_RECORDS_MAX){
+    memcpy(&test_records[test_record_count], data + sizeof(sniff_header_t), header->count * sizeof(sniff_record_t));
+    test_record_count += header->count;
+  }
+  return TELEM_SENT;
+}
+
+static void test_clear(void){
+  test_message_count = 0;
+  test_record_count = 0;
+  test_bad_message = false;
+  test_busy = false;
+  test_gone = false;
+}
+
+static bool test_command(uint32_t client_id, const char * args, char * reply){
+  return SNIFF_Command(client_id, args, strlen(args), reply, SNIFF_REPLY_SIZE);
+}
+
+//Frame n of an ID: data[0..1] = n
+static void test_frame(uint8_t can_bus, uint32_t can_id, uint16_t n){
+  can_frame_t frame;
+
+  memset(&frame, 0, sizeof(frame));
+  frame.can_id = can_id;
+  frame.can_dlc = 8;
+  frame.data[0] = (uint8_t)n;
+  frame.data[1] = (uint8_t)(n >> 8);
+  SNIFF_Frame(can_bus, frame);
+}
+
+static uint16_t test_n(const sniff_record_t * record){
+  return (uint16_t)(record->data[0] | (record->data[1] << 8));
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Checks
+//——————————————————————————————————————————————————————————————————————————————
+static void test_commands(void){
+  char reply[SNIFF_REPLY_SIZE];
+  bool ok;
+
+  SNIFF_Reset();
+  SNIFF_Poll(0, test_send);
+  ok = !test_command(1, "ids=1D4,XYZ", reply) && (0 == strcmp(reply, "Fail: invalid ids"));
+  test_check("bad id refused", ok && (0U == SNIFF_Client()));
+  test_check("reversed range refused", !test_command(1, "ids=5FF-500", reply));
+  test_check("ID above 7FF refused", !test_command(1, "ids=800", reply));
+  test_check("channel 3 refused", !test_command(1, "bus=0,3", reply));
+  test_check("every=0 refused", !test_command(1, "every=0", reply));
+  ok = !test_command(1, "rate=5", reply) && (0 == strcmp(reply, "Fail: unknown key rate"));
+  test_check("unknown key refused", ok);
+
+  ok = test_command(1, "ids=1d4,500-5FF;bus=0,2;every=4;", reply) && (0 == strcmp(reply, "OK"));
+  test_check("full form accepted", ok && (1U == SNIFF_Client()));
+  ok = !test_command(2, "", reply) && (0 == strcmp(reply, "Fail: sniffer used by another client"));
+  test_check("second client refused", ok && (1U == SNIFF_Client()));
+  test_check("other client cannot stop it", !test_command(2, "off", reply) && (1U == SNIFF_Client()));
+  test_check("owner changes its filter", test_command(1, "", reply) && (1U == SNIFF_Client()));
+  test_check("off frees the sniffer", test_command(1, "off", reply) && (0U == SNIFF_Client()));
+  SNIFF_Poll(0, test_send);
+}
+
+static void test_filter(void){
+  char reply[SNIFF_REPLY_SIZE];
+  uint32_t i;
+  bool ok;
+
+  SNIFF_Reset();
+  test_clear();
+  test_frame(CAN_CHANNEL_0, 0x1D4, 99);     //nobody sniffing: not stored
+  test_command(1, "ids=1D4,500-50F;bus=0,2", reply);
+  SNIFF_Poll(0, test_send);
+  test_frame(CAN_CHANNEL_0, 0x1D4, 1);
+  test_frame(CAN_CHANNEL_1, 0x1D4, 2);      //channel not selected
+  test_frame(CAN_CHANNEL_2, 0x505, 3);
+  test_frame(CAN_CHANNEL_0, 0x510, 4);      //outside the range
+  test_frame(CAN_CHANNEL_0, 0x1DA, 5);
+  test_frame(CAN_CHANNEL_2, CAN_EFF_FLAG | 0x18FF1234, 6); //29-bit ID, only with ids=all
+  test_frame(CAN_CHANNEL_2, 0x50F, 7);
+
+  SNIFF_Poll(10, test_send);
+  test_check("partial batch waits", 0U == test_message_count);
+  SNIFF_Poll(60, test_send);
+  ok = (1U == test_message_count) && (3 == test_headers[0].count) && (0U == test_headers[0].sequence) &&
+       (0U == test_headers[0].dropped) && !test_bad_message;
+  test_check("one message after SNIFF_BATCH_MS", ok);
+  ok = (3U == test_record_count) && (0x1D4 == test_records[0].can_id) && (CAN_CHANNEL_0 == test_records[0].can_bus) &&
+       (1 == test_n(&test_records[0])) && (0x505 == test_records[1].can_id) && (CAN_CHANNEL_2 == test_records[1].can_bus) &&
+       (0x50F == test_records[2].can_id) && (7 == test_n(&test_records[2])) && (8 == test_records[2].can_dlc);
+  test_check("IDs and channels filtered", ok);
+
+  test_clear();
+  test_command(1, "ids=1DA;every=4", reply);
+  SNIFF_Poll(100, test_send);
+  for(i = 0; i < 16; i++){
+    test_frame(CAN_CHANNEL_1, 0x1DA, (uint16_t)i);
+  }
+  SNIFF_Poll(200, test_send);
+  SNIFF_Poll(250, test_send);
+  ok = (4U == test_record_count) && (0 == test_n(&test_records[0])) && (4 == test_n(&test_records[1])) &&
+       (8 == test_n(&test_records[2])) && (12 == test_n(&test_records[3]));
+  test_check("every=4 keeps frames 0, 4, 8, 12", ok);
+
+  test_clear();
+  test_command(1, "", reply);
+  SNIFF_Poll(300, test_send);
+  test_frame(CAN_CHANNEL_2, CAN_EFF_FLAG | 0x18FF1234, 1);
+  SNIFF_Poll(400, test_send);
+  SNIFF_Poll(450, test_send);
+  test_check("29-bit ID passes ids=all", (1U == test_record_count) && ((CAN_EFF_FLAG | 0x18FF1234) == test_records[0].can_id));
+}
+
+static void test_batches(void){
+  char reply[SNIFF_REPLY_SIZE];
+  uint32_t i;
+  bool ok;
+
+  SNIFF_Reset();
+  test_clear();
+  test_command(1, "", reply);
+  SNIFF_Poll(0, test_send);
+  for(i = 0; i < 100; i++){
+    test_frame(CAN_CHANNEL_0, 0x5BC, (uint16_t)i);
+  }
+  SNIFF_Poll(10, test_send);
+  test_check("full batch sent at once", (1U == test_message_count) && (SNIFF_BATCH_RECORDS == test_headers[0].count));
+  SNIFF_Poll(20, test_send);
+  test_check("rest waits for SNIFF_BATCH_MS", 1U == test_message_count);
+  SNIFF_Poll(60, test_send);
+  ok = (2U == test_message_count) && ((100 - SNIFF_BATCH_RECORDS) == test_headers[1].count) &&
+       (1U == test_headers[1].sequence) && (100U == test_record_count) && (99 == test_n(&test_records[99]));
+  test_check("rest sent, sequence 1", ok);
+}
+
+static void test_backpressure(void){
+  char reply[SNIFF_REPLY_SIZE];
+  uint32_t received;
+  uint32_t i;
+  bool ordered = true;
+  bool ok;
+
+  SNIFF_Reset();
+  test_clear();
+  test_command(1, "ids=1D4", reply);
+  SNIFF_Poll(0, test_send);
+
+  //Websocket queue full: the ring fills up, the rest is counted
+  test_busy = true;
+  for(i = 0; i < 300; i++){
+    test_frame(CAN_CHANNEL_1, 0x1D4, (uint16_t)i);
+  }
+  SNIFF_Poll(10, test_send);
+  for(; i < 400; i++){
+    test_frame(CAN_CHANNEL_1, 0x1D4, (uint16_t)i);
+  }
+  SNIFF_Poll(20, test_send);
+  test_check("nothing sent while busy", 0U == test_message_count);
+
+  test_busy = false;
+  SNIFF_Poll(30, test_send);
+  SNIFF_Poll(100, test_send);
+  received = test_record_count;
+  for(i = 1; i < received; i++){
+    if(test_n(&test_records[i]) <= test_n(&test_records[i - 1])){
+      ordered = false;
+    }
+  }
+  printf("  400 frames, %u received, %u dropped\n", (unsigned)received,
+         (unsigned)test_headers[(test_message_count > 0U) ? (test_message_count - 1U) : 0U].dropped);
+  ok = (0U != test_message_count) && ((received + test_headers[test_message_count - 1U].dropped) == 400U);
+  test_check("received + dropped = sent", ok && (received == (SNIFF_BATCH_RECORDS + SNIFF_RING_SIZE)));
+  test_check("frames in order, oldest kept", ordered && (0 == test_n(&test_records[0])));
+
+  //Drops add up over the stream
+  test_clear();
+  test_busy = true;
+  for(i = 0; i < (SNIFF_RING_SIZE + 5); i++){
+    test_frame(CAN_CHANNEL_1, 0x1D4, (uint16_t)i);
+  }
+  SNIFF_Poll(200, test_send);
+  test_busy = false;
+  for(i = 0; i < 8; i++){
+    SNIFF_Poll(210 + (i * SNIFF_BATCH_MS), test_send);
+  }
+  ok = (0U != test_message_count) && (85U == test_headers[test_message_count - 1U].dropped) &&
+       (SNIFF_RING_SIZE == test_record_count);
+  test_check("dropped counts since the command", ok);
+
+  test_gone = true;
+  test_frame(CAN_CHANNEL_1, 0x1D4, 1);
+  SNIFF_Poll(1000, test_send);
+  SNIFF_Poll(1050, test_send);
+  test_check("closed client stops the sniffer", 0U == SNIFF_Client());
+  test_gone = false;
+  test_frame(CAN_CHANNEL_1, 0x1D4, 2);
+  test_clear();
+  SNIFF_Poll(2000, test_send);
+  test_check("nothing sent after the stop", 0U == test_message_count);
+}
+
+int main(int argc, char ** argv){
+  printf("Sniffer message, %u + %u x %u bytes:\n", (unsigned)sizeof(sniff_header_t), (unsigned)SNIFF_BATCH_RECORDS,
+         (unsigned)sizeof(sniff_record_t));
+  test_commands();
+  printf("Filter and decimation:\n");
+  test_filter();
+  printf("Batching:\n");
+  test_batches();
+  printf("Backpressure:\n");
+  test_backpressure();
+  printf("%s\n", (0U == test_failures) ? "PASS" : "FAIL");
+  return (0U == test_failures) ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Lock-free ring (spsc_ring.h): ordering, drop and high water accounting
+// 10.16.2026: A producer thread plays the ISR or bridge loop, a consumer thread the drain
+//——————————————————————————————————————————————————————————————————————————————
+// Usage: spsc_ring_test [-n frames]   exit code 1 when a check fails
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include <unistd.h>
+#include <thread>
+#include "canframe.h"
+#include "config.h"
+#include "spsc_ring.h"
+
+typedef spsc_ring<can_frame_t, TXBUFFER_SIZE> test_ring_t;
+
+static uint32_t test_failures = 0;
+
+static void test_check(const char * name, bool ok){
+  printf("  %-44s %s\n", name, ok ? "ok" : "FAIL");
+  if(!ok){
+    test_failures++;
+  }
+}
+
+//Frame n: data[0..3] = n, data[4..7] = ~n; a consumer seeing a mismatch read a half-written slot
+static void test_fill(can_frame_t * frame, uint32_t n){
+  uint32_t inv = ~n;
+
+  frame->can_id = n & 0x7FF;
+  frame->can_dlc = 8;
+  memcpy(&frame->data[0], &n, 4);
+  memcpy(&frame->data[4], &inv, 4);
+  frame->rx_cycles = n;
+}
+
+static bool test_whole(const can_frame_t * frame, uint32_t * n){
+  uint32_t inv;
+
+  memcpy(n, &frame->data[0], 4);
+  memcpy(&inv, &frame->data[4], 4);
+  return (inv == ~(*n)) && (frame->can_id == (*n & 0x7FF)) && (frame->rx_cycles == *n) && (8 == frame->can_dlc);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Single task
+//——————————————————————————————————————————————————————————————————————————————
+static void test_fill_to_full(void){
+  test_ring_t ring;
+  can_frame_t frame;
+  uint32_t n;
+  uint32_t seen;
+  bool ok = true;
+
+  for(n = 0; n < TXBUFFER_SIZE; n++){
+    test_fill(&frame, n);
+    ok = ok && ring.push(frame);
+  }
+  test_check("capacity accepted", ok && (TXBUFFER_SIZE == ring.count()) && (0U == ring.dropped));
+  test_fill(&frame, n);
+  test_check("full ring refuses push", !ring.push(frame) && (1U == ring.dropped));
+  test_check("full ring refuses back", (NULL == ring.back()) && (2U == ring.dropped));
+  test_check("high water at capacity", TXBUFFER_SIZE == ring.high_water);
+
+  for(n = 0; n < TXBUFFER_SIZE; n++){
+    ok = ok && (NULL != ring.front()) && test_whole(ring.front(), &seen) && (seen == n);
+    ring.pop();
+  }
+  test_check("oldest first, nothing overwritten", ok && ring.empty() && (NULL == ring.front()));
+  test_check("pushed counts accepted frames", TXBUFFER_SIZE == ring.pushed);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Producer thread against a consumer thread
+//——————————————————————————————————————————————————————————————————————————————
+typedef struct {
+  uint32_t received;
+  uint32_t torn;
+  uint32_t out_of_order;
+  uint32_t gaps;                  //sequence numbers skipped, the frames the producer dropped
+  uint32_t next;                  //sequence number after the last frame read
+} test_consumer_t;
+
+static std::atomic<bool> test_done(false);
+
+static void test_consume(test_ring_t * ring, test_consumer_t * result, uint32_t pace){
+  can_frame_t * frame;
+  uint32_t expected = 0;
+  uint32_t n;
+
+  for(;;){
+    frame = ring->front();
+    if(NULL == frame){
+      if(test_done.load(std::memory_order_acquire) && ring->empty()){
+        break;
+      }
+      std::this_thread::yield();
+      continue;
+    }
+    if(!test_whole(frame, &n)){
+      result->torn++;
+    }
+    else if(n < expected){
+      result->out_of_order++;
+    }
+    else{
+      result->gaps += n - expected;
+      expected = n + 1U;
+      result->next = expected;
+    }
+    ring->pop();
+    result->received++;
+    if((0U != pace) && (0U == (result->received % pace))){
+      std::this_thread::yield();  //the drain waits for its next tick
+    }
+  }
+}
+
+//retry: the producer tries a refused frame again (lossless), else it drops it and moves on
+static void test_threads(const char * name, uint32_t frames, bool in_place, bool retry, uint32_t pace){
+  test_ring_t ring;
+  test_consumer_t result;
+  can_frame_t frame;
+  can_frame_t * slot;
+  uint32_t refused = 0;
+  uint32_t accepted = 0;
+  uint32_t n;
+  bool ok;
+
+  memset(&result, 0, sizeof(result));
+  test_done.store(false);
+  std::thread consumer(test_consume, &ring, &result, pace);
+
+  for(n = 0; n < frames; n++){
+    for(;;){
+      if(in_place){
+        slot = ring.back();
+        ok = (NULL != slot);
+        if(ok){
+          test_fill(slot, n);
+          ring.publish();
+        }
+      }
+      else{
+        test_fill(&frame, n);
+        ok = ring.push(frame);
+      }
+      if(ok){
+        accepted++;
+        break;
+      }
+      refused++;
+      if(!retry){
+        break;
+      }
+      std::this_thread::yield();
+    }
+    if(0U == (n % 64U)){
+      std::this_thread::yield();
+    }
+  }
+  test_done.store(true, std::memory_order_release);
+  consumer.join();
+
+  printf("  %s: %u frames, %u received, %u dropped, high water %u\n", name, (unsigned)frames,
+         (unsigned)result.received, (unsigned)ring.dropped, (unsigned)ring.high_water);
+  test_check("no half-written frame read", 0U == result.torn);
+  test_check("frames in order", 0U == result.out_of_order);
+  test_check("pushed = received", (ring.pushed == result.received) && (accepted == result.received));
+  test_check("dropped counts every refusal", ring.dropped == refused);
+  if(retry){
+    test_check("nothing lost", (frames == result.received) && (0U == result.gaps));
+  }
+  else{
+    test_check("received + dropped = sent", (result.received + ring.dropped) == frames);
+    test_check("each drop is a gap in the sequence", (result.gaps + (frames - result.next)) == ring.dropped);
+  }
+  ok = (ring.high_water <= TXBUFFER_SIZE) && ((0U == ring.dropped) || (TXBUFFER_SIZE == ring.high_water));
+  test_check("high water within capacity, full on drops", ok);
+}
+
+int main(int argc, char ** argv){
+  uint32_t frames = 200000;
+  int opt;
+
+  while((opt = getopt(argc, argv, "n:")) != -1){
+    switch(opt){
+      case 'n':
+        frames = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-n frames]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  printf("Ring of %u frames:\n", (unsigned)TXBUFFER_SIZE);
+  test_fill_to_full();
+  printf("Producer and consumer threads:\n");
+  test_threads("push, retry when full", frames, false, true, 0);
+  test_threads("back/publish, slow consumer", frames, true, false, 1);
+  printf("%s\n", (0U == test_failures) ? "PASS" : "FAIL");
+  return (0U == test_failures) ? 0 : 1;
+}
@@ -0,0 +1,480 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Synthesized inverter messages in every LEAF_SYNTH_MODE, checked on the virtual bus
+// 10.16.2026: Periods, lock to the VCM frames per channel, rolling content and the behaviour when the VCM stops
+//——————————————————————————————————————————————————————————————————————————————
+// Built three times (host/Makefile): synth_test with the default SCHED_MODE_VCM_TRIGGERED,
+// synth_test_free with SCHED_MODE_FREE_RUNNING and synth_test_locked with SCHED_MODE_PHASE_LOCKED,
+// the last two with MESSAGE_0x1F2 for the 0x1F2 group.
+// The engine runs as in bridge_sim against a VCM that changes sides:
+//   phase A  0x1F2/0x284/0x50C from CAN2 (as wired in the vehicle)
+//   phase B  VCM silent
+//   phase C  the same frames from CAN1, at another phase
+// Checked per channel and synthesized ID:
+//  - frame count of each phase against the period (0x4B9 twice per 0x50C, as the triggered handler)
+//  - triggered and phase locked: every frame right after the VCM frame it follows, on the channel
+//    it is answered on (CAN1 copies after CAN2, CAN2 copies of 0x5CD and the 0x1F2 group after CAN1)
+//  - rolling counters step by one on each channel (shared prepare of the CAN1/CAN2 copies)
+//  - VCM stopping: triggered stops at once, phase locked after SCHED_SYNC_TIMEOUT_MS,
+//    free running keeps its period
+//  - scheduler statistics (sent, skipped, jitter) against the bus and SCHED_ResetStats
+//
+// Usage: synth_test   exit code 1 when a check fails
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include "config.h"
+#include "can_driver.h"
+#include "can_bridge_manager_common.h"
+#include "helper_functions.h"
+#include "frame_scheduler.h"
+#include "sim_clock.h"
+#include "virtual_can.h"
+#include "bridge_loop.h"
+
+#define TEST_PHASE_A_US     0ULL
+#define TEST_PHASE_B_US     10000000ULL
+#define TEST_PHASE_C_US     12000000ULL
+#define TEST_END_US         17000000ULL
+#define TEST_DRAIN_US       1000000ULL   //after phase C, longer than SCHED_SYNC_TIMEOUT_MS
+#define TEST_PHASES         3       //A, B, C; the drain after phase C counts apart
+
+#define TEST_LOCK_US        5000U   //frame on the wire at most this long after its VCM frame
+#define TEST_INTERVAL_US    2000U   //largest |interval - period| on the wire
+#define TEST_MAX_JITTER_US  1500U   //largest scheduler jitter (1 ms slots, T_POLLING passes)
+
+static uint32_t test_failures = 0;
+
+static void test_check(const char * name, bool ok){
+  printf("  %-52s %s\n", name, ok ? "ok" : "FAIL");
+  if(!ok){
+    test_failures++;
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// VCM frames of each phase
+//——————————————————————————————————————————————————————————————————————————————
+typedef struct {
+  uint8_t  can_bus;
+  uint16_t can_id;
+  uint8_t  can_dlc;
+  uint16_t period_ms;
+  uint16_t phase_ms;
+  uint64_t start_us;
+  uint64_t end_us;
+} test_vcm_t;
+
+static const test_vcm_t test_vcm[] = {
+  { CAN_CHANNEL_2, 0x1F2, 8,  10,  4, TEST_PHASE_A_US, TEST_PHASE_B_US },
+  { CAN_CHANNEL_2, 0x284, 8,  20,  5, TEST_PHASE_A_US, TEST_PHASE_B_US },
+  { CAN_CHANNEL_2, 0x50C, 6, 100,  8, TEST_PHASE_A_US, TEST_PHASE_B_US },
+  { CAN_CHANNEL_1, 0x1F2, 8,  10,  7, TEST_PHASE_C_US, TEST_END_US },
+  { CAN_CHANNEL_1, 0x284, 8,  20, 13, TEST_PHASE_C_US, TEST_END_US },
+  { CAN_CHANNEL_1, 0x50C, 6, 100, 57, TEST_PHASE_C_US, TEST_END_US },
+};
+#define TEST_VCM_COUNT (sizeof(test_vcm) / sizeof(test_vcm[0]))
+
+//——————————————————————————————————————————————————————————————————————————————
+// Synthesized messages and what each mode sends where
+//——————————————————————————————————————————————————————————————————————————————
+typedef struct {
+  uint16_t can_id;
+  uint16_t period_ms;
+  uint8_t  per_period;    //frames per period
+  uint16_t sync_id;
+  bool     to_can2;       //also answered on CAN2 when the VCM frame comes from CAN1
+} test_synth_t;
+
+static const test_synth_t test_synth[] = {
+  { 0x355,   40, 1, 0x284, false },
+  { 0x4B9,  100, 2, 0x50C, false },
+  { 0x625,  100, 1, 0x50C, false },
+  { 0x5C5,  100, 1, 0x50C, false },
+  { 0x3B8,  100, 1, 0x50C, false },
+  { 0x5EC,  500, 1, 0x50C, false },
+  { 0x5EB,  500, 1, 0x50C, false },
+  { 0x5CD, 1000, 1, 0x50C, true  },
+#ifdef MESSAGE_0x1F2
+  { 0x1C2,   10, 1, 0x1F2, true  },
+  { 0x108,   10, 1, 0x1F2, true  },
+  { 0x1CB,   10, 1, 0x1F2, true  },
+  { 0x1ED,   10, 1, 0x1F2, true  },
+#endif
+};
+#define TEST_SYNTH_COUNT (sizeof(test_synth) / sizeof(test_synth[0]))
+
+typedef struct {
+  uint32_t count[TEST_PHASES + 1];
+  uint64_t last_us;           //previous frame on the wire
+  uint8_t  last_phase;
+  uint32_t max_interval_err;  //|interval - period|, duplicates within a period skipped
+  uint32_t lock_errors;       //frames too far from their VCM frame
+  uint32_t content_errors;    //rolling counter did not step by one
+  uint32_t frames;
+  bool     has_content;
+  uint8_t  content;           //last rolling value
+} test_track_t;
+
+static test_track_t test_track[CAN_CHANNEL_COUNT][TEST_SYNTH_COUNT];
+static uint64_t test_vcm_rx[CAN_CHANNEL_COUNT][3];    //last 0x1F2/0x284/0x50C injection per channel
+static uint32_t test_unknown = 0;                      //frames that are neither forwarded nor synthesized
+
+static uint8_t test_mode(void){
+  return LEAF_SYNTH_MODE;
+}
+
+static uint8_t test_phase(uint64_t now_us){
+  if(now_us < TEST_PHASE_B_US){
+    return 0U;
+  }
+  if(now_us < TEST_PHASE_C_US){
+    return 1U;
+  }
+  return (now_us < TEST_END_US) ? 2U : TEST_PHASES;
+}
+
+static int test_vcm_index(uint16_t can_id){
+  switch(can_id){
+    case 0x1F2: return 0;
+    case 0x284: return 1;
+    case 0x50C: return 2;
+    default:    return -1;
+  }
+}
+
+static int test_synth_index(uint32_t can_id){
+  uint32_t i;
+  for(i = 0; i < TEST_SYNTH_COUNT; i++){
+    if(test_synth[i].can_id == can_id){
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+//Rolling value of the frame and whether next follows prev (the same value again is a duplicate of 0x4B9)
+static bool test_content(uint16_t can_id, const can_frame_t &frame, uint8_t * value){
+  switch(can_id){
+    case 0x4B9: *value = frame.data[0]; return true;
+    case 0x3B8: *value = frame.data[2]; return true;
+    case 0x5CD: *value = frame.data[1]; return true;
+    case 0x1C2: *value = frame.data[0]; return true;
+    case 0x108: *value = frame.data[1]; return true;
+    default:    return false;
+  }
+}
+
+static bool test_content_next(uint16_t can_id, uint8_t prev, uint8_t next){
+  switch(can_id){
+    case 0x4B9: return (next == prev) || (next == ((prev >= 79U) ? 64U : (prev + 1U)));
+    case 0x3B8: return next == ((prev >= 14U) ? 0U : (prev + 1U));
+    case 0x5CD: return next == (((prev + 4U) > 238U) ? 2U : (prev + 4U));
+    case 0x1C2: return next == ((prev >= 95U) ? 80U : (prev + 1U));
+    case 0x108: return next == ((prev + 1U) & 0x0FU);
+    default:    return true;
+  }
+}
+
+static void test_on_tx(uint8_t can_bus, const can_frame_t &frame, uint64_t done_us){
+  int s = test_synth_index(frame.can_id);
+  const test_synth_t * synth;
+  test_track_t * track;
+  uint8_t phase = test_phase(done_us);
+  uint8_t value;
+
+  if(s < 0){
+    if(test_vcm_index((uint16_t)frame.can_id) < 0){
+      test_unknown++;
+    }
+    return;
+  }
+  synth = &test_synth[s];
+  track = &test_track[can_bus][s];
+  track->count[phase]++;
+
+  if((0U != track->last_us) && (track->last_phase == phase) &&
+     ((done_us - track->last_us) >= ((uint64_t)synth->period_ms * 500U))){
+    int64_t err = (int64_t)(done_us - track->last_us) - ((int64_t)synth->period_ms * 1000);
+    uint32_t abs_err = (uint32_t)((err < 0) ? -err : err);
+    if(abs_err > track->max_interval_err){
+      track->max_interval_err = abs_err;
+    }
+  }
+  track->last_us = done_us;
+  track->last_phase = phase;
+
+  //Locked to the VCM frame of the other side while it is there; free running keeps its phase from boot
+  if((SCHED_MODE_FREE_RUNNING != test_mode()) && ((0U == phase) || (2U == phase))){
+    uint8_t source = (CAN_CHANNEL_1 == can_bus) ? CAN_CHANNEL_2 : CAN_CHANNEL_1;
+    uint64_t rx_us = test_vcm_rx[source][test_vcm_index(synth->sync_id)];
+    if((0U == rx_us) || (done_us < rx_us) || ((done_us - rx_us) > TEST_LOCK_US)){
+      track->lock_errors++;
+    }
+  }
+
+  //The triggered handlers send before they step the content: the first frame after boot is the template
+  track->frames++;
+  if(test_content(synth->can_id, frame, &value)){
+    if(track->has_content && (track->frames > 2U) && !test_content_next(synth->can_id, track->content, value)){
+      track->content_errors++;
+    }
+    track->has_content = true;
+    track->content = value;
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Scenario
+//——————————————————————————————————————————————————————————————————————————————
+static void test_build_vcm(const test_vcm_t * msg, uint32_t count, can_frame_t &frame){
+  uint8_t i;
+  frame.can_id = msg->can_id;
+  frame.can_dlc = msg->can_dlc;
+  memset(frame.data, 0, sizeof(frame.data));
+  for(i = 0; i < msg->can_dlc; i++){
+    frame.data[i] = (uint8_t)((count + i) & 0x0F);
+  }
+  if(0x1F2 == msg->can_id){
+    frame.data[2] = 0x60;   //charging idle, the synthesized messages are allowed
+  }
+  if(8U == msg->can_dlc){
+    calc_crc8(&frame);
+  }
+}
+
+static void test_run(uint64_t end_us, bool schedule){
+  static uint32_t vcm_count[TEST_VCM_COUNT];
+  static uint64_t now_us = 0U;
+  uint32_t i;
+
+  for(; now_us < end_us; now_us += T_POLLING){
+    SIM_Clock_Tick(now_us);
+    for(i = 0; i < TEST_VCM_COUNT; i++){
+      const test_vcm_t * msg = &test_vcm[i];
+      uint64_t due_us = msg->start_us + (((uint64_t)msg->phase_ms + ((uint64_t)vcm_count[i] * msg->period_ms)) * 1000U);
+      if((due_us <= now_us) && (due_us < msg->end_us)){
+        can_frame_t frame;
+        test_build_vcm(msg, vcm_count[i], frame);
+        VCAN_Inject(msg->can_bus, frame);
+        test_vcm_rx[msg->can_bus][test_vcm_index(msg->can_id)] = now_us;
+        vcm_count[i]++;
+      }
+    }
+    if(schedule){
+      HOST_BridgePass();
+    }else{
+      Schedule_Buffer_Check_CAN();    //only empty the transmit buffers, no new synthesized frame
+    }
+    VCAN_Advance(now_us + T_POLLING);
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Checks
+//——————————————————————————————————————————————————————————————————————————————
+//Frames of a synthesized ID expected on can_bus in one phase, -1: only checked against the stop time
+static int32_t test_expected(uint8_t can_bus, const test_synth_t * synth, uint8_t phase){
+  static const uint64_t length_us[TEST_PHASES] = {
+    TEST_PHASE_B_US - TEST_PHASE_A_US, TEST_PHASE_C_US - TEST_PHASE_B_US, TEST_END_US - TEST_PHASE_C_US
+  };
+  int32_t full = (int32_t)((length_us[phase] / ((uint64_t)synth->period_ms * 1000U)) * synth->per_period);
+
+  if(SCHED_MODE_FREE_RUNNING == test_mode()){
+    return (CAN_CHANNEL_1 == can_bus) ? full : 0;
+  }
+  switch(phase){
+    case 0:  return (CAN_CHANNEL_1 == can_bus) ? full : 0;
+    case 1:  return (CAN_CHANNEL_1 == can_bus) ? -1 : 0;
+    default: return ((CAN_CHANNEL_2 == can_bus) && synth->to_can2) ? full : 0;
+  }
+}
+
+static void test_periods(void){
+  static const char * const phase_names[TEST_PHASES] = {"A", "B", "C"};
+  char name[64];
+  uint8_t can_bus;
+  uint8_t phase;
+  uint32_t i;
+
+  for(phase = 0; phase < TEST_PHASES; phase++){
+    for(can_bus = CAN_CHANNEL_1; can_bus <= CAN_CHANNEL_2; can_bus++){
+      for(i = 0; i < TEST_SYNTH_COUNT; i++){
+        int32_t expected = test_expected(can_bus, &test_synth[i], phase);
+        int32_t count = (int32_t)test_track[can_bus][i].count[phase];
+        bool ok;
+
+        if(expected < 0){
+          continue;
+        }
+        //One period either way at the phase edges; none means none
+        ok = (0 == expected) ? (0 == count) :
+             ((count >= (expected - test_synth[i].per_period)) && (count <= (expected + test_synth[i].per_period)));
+        if(!ok || (0 != expected)){
+          snprintf(name, sizeof(name), "phase %s CAN%u 0x%03X %d frames (%d)", phase_names[phase], (unsigned)can_bus,
+                   (unsigned)test_synth[i].can_id, (int)count, (int)expected);
+          test_check(name, ok);
+        }
+      }
+    }
+  }
+}
+
+static void test_lock_and_content(void){
+  char name[64];
+  uint8_t can_bus;
+  uint32_t i;
+
+  for(can_bus = CAN_CHANNEL_1; can_bus <= CAN_CHANNEL_2; can_bus++){
+    for(i = 0; i < TEST_SYNTH_COUNT; i++){
+      const test_track_t * track = &test_track[can_bus][i];
+      if(0U == (track->count[0] + track->count[1] + track->count[2] + track->count[TEST_PHASES])){
+        continue;
+      }
+      snprintf(name, sizeof(name), "CAN%u 0x%03X interval within %u us of %u ms (%u)", (unsigned)can_bus,
+               (unsigned)test_synth[i].can_id, (unsigned)TEST_INTERVAL_US, (unsigned)test_synth[i].period_ms,
+               (unsigned)track->max_interval_err);
+      test_check(name, track->max_interval_err <= TEST_INTERVAL_US);
+      if(SCHED_MODE_FREE_RUNNING != test_mode()){
+        snprintf(name, sizeof(name), "CAN%u 0x%03X after its VCM frame (%u late)", (unsigned)can_bus,
+                 (unsigned)test_synth[i].can_id, (unsigned)track->lock_errors);
+        test_check(name, 0U == track->lock_errors);
+      }
+      if(track->has_content){
+        snprintf(name, sizeof(name), "CAN%u 0x%03X rolling content (%u steps wrong)", (unsigned)can_bus,
+                 (unsigned)test_synth[i].can_id, (unsigned)track->content_errors);
+        test_check(name, 0U == track->content_errors);
+      }
+    }
+  }
+}
+
+//VCM silent from TEST_PHASE_B_US: when does each mode stop sending
+static void test_vcm_stop(void){
+  uint64_t stop_us;
+  bool ok = true;
+  uint32_t bridged = 0U;
+  uint32_t i;
+
+  switch(test_mode()){
+    case SCHED_MODE_FREE_RUNNING: stop_us = TEST_PHASE_C_US; break;
+    case SCHED_MODE_PHASE_LOCKED: stop_us = TEST_PHASE_B_US + (SCHED_SYNC_TIMEOUT_MS * 1000U); break;
+    default:                      stop_us = TEST_PHASE_B_US; break;
+  }
+  for(i = 0; i < TEST_SYNTH_COUNT; i++){
+    const test_track_t * track = &test_track[CAN_CHANNEL_1][i];
+    //At most the frames up to the stop, plus the one already queued at the edge
+    uint32_t limit = (uint32_t)(((stop_us - TEST_PHASE_B_US) / ((uint64_t)test_synth[i].period_ms * 1000U)) + 1U) *
+                     test_synth[i].per_period;
+    if(track->count[1] > limit){
+      ok = false;
+    }
+    if(0x284 == test_synth[i].sync_id){
+      bridged += track->count[1];
+    }
+  }
+  test_check("VCM silent: no frame past the stop time of the mode", ok);
+  switch(test_mode()){
+    case SCHED_MODE_FREE_RUNNING:
+      test_check("VCM silent: free running keeps sending", bridged >= 49U);
+    break;
+    case SCHED_MODE_PHASE_LOCKED:
+      //0x355 (40 ms) bridges the gap until the timeout
+      test_check("VCM silent: phase locked sends until the timeout", bridged >= ((SCHED_SYNC_TIMEOUT_MS / 40U) - 1U));
+    break;
+    default:
+      test_check("VCM silent: triggered stops at once", bridged <= 1U);
+    break;
+  }
+}
+
+static void test_statistics(void){
+  sched_stats_t stats;
+  uint32_t wire[TEST_SYNTH_COUNT];
+  uint32_t sent[TEST_SYNTH_COUNT];
+  uint32_t max_jitter = 0U;
+  uint32_t skipped = 0U;
+  bool ok = true;
+  uint8_t can_bus;
+  uint8_t phase;
+  uint8_t n;
+  int s;
+  uint32_t i;
+
+  if(SCHED_MODE_VCM_TRIGGERED == test_mode()){
+    test_check("no scheduler entries in the triggered mode", 0U == SCHED_Count());
+    return;
+  }
+
+  memset(wire, 0, sizeof(wire));
+  memset(sent, 0, sizeof(sent));
+  for(can_bus = 0; can_bus < CAN_CHANNEL_COUNT; can_bus++){
+    for(i = 0; i < TEST_SYNTH_COUNT; i++){
+      for(phase = 0; phase <= TEST_PHASES; phase++){
+        wire[i] += test_track[can_bus][i].count[phase];
+      }
+    }
+  }
+  for(n = 0; n < SCHED_Count(); n++){
+    if(!SCHED_GetStats(n, &stats) || ((s = test_synth_index(stats.can_id)) < 0)){
+      ok = false;
+      continue;
+    }
+    sent[s] += stats.sent;
+    skipped += stats.skipped;
+    if(stats.max_jitter_us > max_jitter){
+      max_jitter = stats.max_jitter_us;
+    }
+  }
+  for(i = 0; i < TEST_SYNTH_COUNT; i++){
+    if(sent[i] != wire[i]){
+      printf("  0x%03X scheduler sent %u, %u on the wire\n", (unsigned)test_synth[i].can_id, (unsigned)sent[i], (unsigned)wire[i]);
+      ok = false;
+    }
+  }
+  test_check("scheduler sent counts match the bus", ok);
+
+  char name[64];
+  snprintf(name, sizeof(name), "scheduler max jitter %u us", (unsigned)max_jitter);
+  test_check(name, max_jitter <= TEST_MAX_JITTER_US);
+  if(SCHED_MODE_PHASE_LOCKED == test_mode()){
+    test_check("silent VCM periods counted as skipped", skipped > 0U);
+  }else{
+    test_check("free running skips nothing", 0U == skipped);
+  }
+
+  SCHED_ResetStats();
+  ok = true;
+  for(n = 0; n < SCHED_Count(); n++){
+    if(SCHED_GetStats(n, &stats) && ((0U != stats.sent) || (0U != stats.skipped) || (0U != stats.avg_jitter_us) ||
+                                     (0U != stats.max_jitter_us))){
+      ok = false;
+    }
+  }
+  test_check("SCHED_ResetStats clears every statistic", ok);
+}
+
+int main(int argc, char ** argv){
+  static const char * const mode_names[] = {"SCHED_MODE_VCM_TRIGGERED", "SCHED_MODE_FREE_RUNNING", "SCHED_MODE_PHASE_LOCKED"};
+
+  memset(test_track, 0, sizeof(test_track));
+  memset(test_vcm_rx, 0, sizeof(test_vcm_rx));
+
+  SIM_Clock_Set(0U);
+  HOST_BridgeInit();
+  VCAN_SetTxCallback(test_on_tx);
+  test_run(TEST_END_US + TEST_DRAIN_US, true);
+  test_run(TEST_END_US + TEST_DRAIN_US + 50000U, false);
+
+  printf("LEAF_SYNTH_MODE %s, %u scheduler entries\n", mode_names[test_mode()], (unsigned)SCHED_Count());
+  printf("Frames per phase (A: VCM on CAN2, B: silent, C: VCM on CAN1):\n");
+  test_periods();
+  printf("Intervals, lock and rolling content:\n");
+  test_lock_and_content();
+  printf("VCM stops:\n");
+  test_vcm_stop();
+  printf("Statistics:\n");
+  test_statistics();
+  test_check("no unexpected frame on the bus", 0U == test_unknown);
+  printf("%s\n", (0U == test_failures) ? "PASS" : "FAIL");
+  return (0U == test_failures) ? 0 : 1;
+}
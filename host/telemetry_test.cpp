@@ -0,0 +1,208 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Websocket telemetry (telemetry.h): decoding, per-client rate, merging, backpressure
+// 10.16.2026: A fake transport stands in for AsyncWebSocket; it can report a full queue or a gone client
+//——————————————————————————————————————————————————————————————————————————————
+// Usage: telemetry_test   exit code 1 when a check fails
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include "can_signal.h"
+#include "leaf_signals.h"
+#include "telemetry.h"
+
+#define TEST_SENT_MAX   64
+
+static uint32_t test_failures = 0;
+
+static void test_check(const char * name, bool ok){
+  printf("  %-44s %s\n", name, ok ? "ok" : "FAIL");
+  if(!ok){
+    test_failures++;
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Fake transport
+//——————————————————————————————————————————————————————————————————————————————
+typedef struct {
+  uint32_t      client_id;
+  telem_frame_t frame;
+} test_sent_t;
+
+static test_sent_t test_sent[TEST_SENT_MAX];
+static uint32_t test_sent_count = 0;
+static uint32_t test_busy_id = 0;       //client whose queue is full
+static uint32_t test_gone_id = 0;       //client that closed
+
+static telem_send_result_t test_send(uint32_t client_id, const uint8_t * data, size_t len){
+  if(client_id == test_gone_id){
+    return TELEM_GONE;
+  }
+  if(client_id == test_busy_id){
+    return TELEM_BUSY;
+  }
+  if((test_sent_count < TEST_SENT_MAX) && (len == sizeof(telem_frame_t))){
+    test_sent[test_sent_count].client_id = client_id;
+    memcpy(&test_sent[test_sent_count].frame, data, len);
+    test_sent_count++;
+  }
+  return TELEM_SENT;
+}
+
+static uint32_t test_sent_to(uint32_t client_id, const telem_frame_t ** last){
+  uint32_t count = 0;
+  uint32_t i;
+
+  for(i = 0; i < test_sent_count; i++){
+    if(test_sent[i].client_id == client_id){
+      count++;
+      *last = &test_sent[i].frame;
+    }
+  }
+  return count;
+}
+
+static void test_poll_range(uint32_t from_ms, uint32_t to_ms){
+  for(uint32_t t = from_ms; t < to_ms; t += HOUSEKEEPING_TASK_PERIOD_MS){
+    TELEM_Poll(t, test_send);
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Frames
+//——————————————————————————————————————————————————————————————————————————————
+static void test_frame(uint16_t can_id, can_frame_t * frame){
+  memset(frame, 0, sizeof(*frame));
+  frame->can_id = can_id;
+  frame->can_dlc = 8;
+}
+
+static void test_torque(int16_t demand){
+  can_frame_t frame;
+  test_frame(0x1D4, &frame);
+  SIG_Set<LEAF_1D4_TORQUE>(frame.data, demand);
+  TELEM_Frame(frame);
+}
+
+static void test_vehicle(void){
+  can_frame_t frame;
+
+  test_torque(-120);
+  test_frame(0x1DA, &frame);
+  SIG_Set<LEAF_1DA_TORQUE>(frame.data, 300);
+  TELEM_Frame(frame);
+  test_frame(0x11A, &frame);
+  SIG_Set<LEAF_11A_SHIFTER>(frame.data, 4);
+  SIG_Set<LEAF_11A_ECO>(frame.data, 1);
+  TELEM_Frame(frame);
+  test_frame(0x55B, &frame);
+  SIG_Set<LEAF_55B_LB_SOC>(frame.data, 873);
+  TELEM_Frame(frame);
+  test_frame(0x1DB, &frame);
+  SIG_Set<LEAF_1DB_SOC>(frame.data, 87);
+  TELEM_Frame(frame);
+  test_frame(0x284, &frame);
+  SIG_Set<LEAF_284_SPEED>(frame.data, 50 * 98);
+  TELEM_Frame(frame);
+  test_frame(0x5BC, &frame);      //not a telemetry ID
+  TELEM_Frame(frame);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Checks
+//——————————————————————————————————————————————————————————————————————————————
+static void test_values(void){
+  const telem_frame_t * last = NULL;
+  bool ok;
+
+  TELEM_Reset();
+  test_sent_count = 0;
+  test_check("subscribe", TELEM_Subscribe(1, 10) && (1 == TELEM_Clients()));
+  TELEM_Poll(0, test_send);
+  test_check("nothing decoded yet", (1 == test_sent_to(1, &last)) && (0 == last->valid));
+
+  test_vehicle();
+  TELEM_Poll(100, test_send);
+  ok = (2 == test_sent_to(1, &last)) && ('T' == last->magic[0]) && ('M' == last->magic[1]) &&
+       (TELEM_VERSION == last->version) && (1 == last->sample) && (100 == last->now_ms);
+  test_check("frame header", ok);
+  ok = (-120 == last->torque_demand) && (300 == last->torque_response) && (4 == last->shift) && (1 == last->eco) &&
+       (873 == last->soc) && (87 == last->soc_display) && ((50 * 16) == last->speed);
+  test_check("values decoded", ok);
+  ok = (TELEM_VALID_TORQUE_DEMAND | TELEM_VALID_TORQUE_RESPONSE | TELEM_VALID_SHIFT | TELEM_VALID_SOC |
+        TELEM_VALID_SOC_DISPLAY | TELEM_VALID_SPEED) == last->valid;
+  test_check("valid flags, no charge status yet", ok);
+  test_check("6 updates merged into one frame", 6 == last->merged);
+}
+
+static void test_rates(void){
+  const telem_frame_t * last = NULL;
+  uint32_t fast;
+  uint32_t slow;
+
+  TELEM_Reset();
+  test_sent_count = 0;
+  test_check("rate above the limit refused", !TELEM_Subscribe(7, TELEM_MAX_RATE_HZ + 1));
+  TELEM_Subscribe(1, 2);
+  TELEM_Subscribe(2, TELEM_MAX_RATE_HZ);
+  test_poll_range(0, 1000);
+  slow = test_sent_to(1, &last);
+  fast = test_sent_to(2, &last);
+  test_check("2 Hz client: 2 frames in 1 s", 2 == slow);
+  test_check("50 Hz client: 50 frames in 1 s", TELEM_MAX_RATE_HZ == fast);
+
+  TELEM_Subscribe(1, 0);
+  test_check("rate 0 unsubscribes", 1 == TELEM_Clients());
+  TELEM_Subscribe(3, 1);
+  TELEM_Subscribe(4, 1);
+  TELEM_Subscribe(5, 1);
+  test_check("table full", !TELEM_Subscribe(6, 1) && (TELEM_MAX_CLIENTS == TELEM_Clients()));
+  test_check("rate change keeps the slot", TELEM_Subscribe(5, 5) && (TELEM_MAX_CLIENTS == TELEM_Clients()));
+}
+
+static void test_backpressure(void){
+  const telem_frame_t * last = NULL;
+  uint32_t before;
+  bool ok;
+
+  TELEM_Reset();
+  test_sent_count = 0;
+  TELEM_Subscribe(1, 10);
+  TELEM_Subscribe(2, 10);
+  TELEM_Poll(0, test_send);
+
+  //Client 2 stalls for 3 periods while the torque keeps changing
+  test_busy_id = 2;
+  for(uint32_t t = 100; t < 400; t += 10){
+    test_torque((int16_t)t);
+    TELEM_Poll(t, test_send);
+  }
+  test_busy_id = 0;
+  before = test_sent_to(1, &last);
+  test_check("other client not held up", 4 == before);
+
+  test_torque(-5);
+  TELEM_Poll(400, test_send);
+  ok = (2 == test_sent_to(2, &last)) && (3 == last->skipped) && (31 == last->merged) && (-5 == last->torque_demand) &&
+       (1 == last->sample);
+  test_check("stalled client: skipped, merged, latest", ok);
+
+  TELEM_Poll(500, test_send);
+  test_check("skipped cleared after a send", (3 == test_sent_to(2, &last)) && (0 == last->skipped) && (0 == last->merged));
+
+  test_gone_id = 1;
+  TELEM_Poll(600, test_send);
+  test_gone_id = 0;
+  test_check("closed client dropped", 1 == TELEM_Clients());
+}
+
+int main(int argc, char ** argv){
+  printf("Telemetry frame, %u bytes:\n", (unsigned)sizeof(telem_frame_t));
+  test_values();
+  printf("Per-client rate:\n");
+  test_rates();
+  printf("Backpressure:\n");
+  test_backpressure();
+  printf("%s\n", (0U == test_failures) ? "PASS" : "FAIL");
+  return (0U == test_failures) ? 0 : 1;
+}
@@ -0,0 +1,410 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Fixed-point torque scaling (torque_scale.h) against the former double math
+// 10.16.2026: Exhaustive comparison over the 12-bit torque field, timing of both versions
+// 10.16.2026: Torque maps (torque_map.h): compiled grid against the breakpoint map, text form, swaps
+//——————————————————————————————————————————————————————————————————————————————
+// The legacy_* functions are the 0x1D4/0x1DA arithmetic of can_bridge_manager_leaf.cpp before
+// the fixed-point rewrite, on the same volatile uint16_t variables. Every 12-bit input is run
+// through both versions for each profile:
+//  - positive torque (stock, 110kW, 160kW) and the 0x1DA response must be bit-identical,
+//    except where the legacy result overflowed the 12-bit field into the opposite sign; there
+//    the fixed-point result must be saturated
+//  - regen: the legacy code scaled the one's complement ((|t| - 1) * k + 1), the fixed-point
+//    version scales |t| itself, so results may differ by one bit (0.25 Nm), never more
+//  - runtime multipliers (0.001 steps from 0.1 to 4.0): within one bit of the double result
+//  - maps: the constant time grid lookup within one bit of a float bilinear interpolation of the
+//    breakpoint map, parse/format round trip, rejected definitions, swap grace period
+// The timings are host timings; x86 has a double precision FPU, the ESP32 does not (there the
+// legacy version calls the software float library), so the host ratio understates the gain.
+//
+// Usage: torque_scale_test [-n iterations]   exit code 1 on a mismatch
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include <unistd.h>
+#include "torque_scale.h"
+#include "torque_map.h"
+#include "sim_clock.h"
+#include "bench_util.h"
+
+//Profile multipliers as in can_bridge_manager_leaf.cpp
+#define TEST_MULTIPLIER_110       0.9
+#define TEST_MULTIPLIER_160       1.6
+#define TEST_MULTIPLIER_REGEN     1.10
+#define TEST_MULTIPLIER_RESPONSE  0.5
+
+#define TEST_BATCH                4096U   //one pass over the 12-bit field per timed batch
+
+static volatile uint16_t torqueDemand = 0;
+static volatile uint16_t torqueResponse = 0;
+
+//——————————————————————————————————————————————————————————————————————————————
+// Legacy double math, returns the 12-bit field written back to data[2]:data[3]
+//——————————————————————————————————————————————————————————————————————————————
+static uint16_t legacy_power(uint16_t raw, double multiplier){
+  torqueDemand = raw;
+  torqueDemand = (torqueDemand >> 4);
+  torqueDemand = (torqueDemand * multiplier);
+  torqueDemand = (torqueDemand << 4);
+  return (uint16_t)((torqueDemand >> 4) & 0x0FFF);
+}
+
+static uint16_t legacy_regen(uint16_t raw, double multiplier){
+  torqueDemand = raw;
+  torqueDemand = ~torqueDemand;
+  torqueDemand = (torqueDemand >> 4);
+  torqueDemand = (torqueDemand * multiplier);
+  torqueDemand = (torqueDemand << 4);
+  torqueDemand = ~torqueDemand;
+  return (uint16_t)((torqueDemand >> 4) & 0x0FFF);
+}
+
+static uint16_t legacy_response(uint16_t demand){
+  torqueResponse = (demand * TEST_MULTIPLIER_RESPONSE);
+  return torqueResponse;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Fixed-point versions, same interface
+//——————————————————————————————————————————————————————————————————————————————
+static int16_t test_field_to_torque(uint16_t field){
+  return (int16_t)((int16_t)(field << 4) >> 4);
+}
+
+static uint16_t fixed_scale(uint16_t raw, uint32_t mul_q16){
+  can_frame_t frame;
+  frame.data[2] = (uint8_t)(raw >> 8);
+  frame.data[3] = (uint8_t)raw;
+  torqueDemand = TSCALE_Raw1D4(TSCALE_Torque12(TSCALE_Get1D4(frame), mul_q16));
+  return (uint16_t)((torqueDemand >> 4) & 0x0FFF);
+}
+
+static uint16_t fixed_response(uint16_t demand){
+  torqueResponse = TSCALE_Raw<TSCALE_Q16(TEST_MULTIPLIER_RESPONSE)>(demand);
+  return torqueResponse;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Comparisons
+//——————————————————————————————————————————————————————————————————————————————
+typedef struct {
+  uint32_t identical;
+  uint32_t saturated;     //legacy wrapped into the opposite sign, fixed-point saturated
+  uint32_t max_error;     //in bits of the 12-bit field
+  uint32_t failures;
+} test_result_t;
+
+static void test_account(test_result_t * result, int32_t expected, int32_t legacy, int32_t fixed, uint32_t tolerance){
+  uint32_t error;
+
+  if(legacy == fixed) {
+    result->identical++;
+    return;
+  }
+  if((expected > TSCALE_TORQUE_MAX) || (expected < TSCALE_TORQUE_MIN)) {
+    //Out of the field: the legacy value wrapped, the fixed-point one must sit at the limit
+    if(fixed == ((expected > 0) ? TSCALE_TORQUE_MAX : TSCALE_TORQUE_MIN)) {
+      result->saturated++;
+    } else {
+      result->failures++;
+    }
+    return;
+  }
+  error = (uint32_t)((legacy > fixed) ? (legacy - fixed) : (fixed - legacy));
+  if(error > result->max_error) {
+    result->max_error = error;
+  }
+  if(error > tolerance) {
+    result->failures++;
+  }
+}
+
+static bool test_report(const char * name, const test_result_t * result, uint32_t total){
+  printf("  %-16s %5u/%u identical, %4u saturated, max error %u bit%s\n", name, (unsigned)result->identical,
+         (unsigned)total, (unsigned)result->saturated, (unsigned)result->max_error,
+         (result->failures > 0U) ? " FAIL" : "");
+  return (0U == result->failures);
+}
+
+static bool test_power(const char * name, double multiplier){
+  test_result_t result;
+  uint16_t field;
+
+  memset(&result, 0, sizeof(result));
+  for(field = 0; field <= 0x7FFU; field++) {
+    int32_t expected = (int32_t)(field * multiplier);
+    test_account(&result, expected, test_field_to_torque(legacy_power((uint16_t)(field << 4), multiplier)),
+                 test_field_to_torque(fixed_scale((uint16_t)(field << 4), TSCALE_Q16(multiplier))), 0U);
+  }
+  return test_report(name, &result, 0x800U);
+}
+
+static bool test_regen(const char * name, double multiplier){
+  test_result_t result;
+  uint16_t field;
+
+  memset(&result, 0, sizeof(result));
+  for(field = 0x800U; field <= 0xFFFU; field++) {
+    int32_t torque = test_field_to_torque(field);
+    int32_t expected = -(int32_t)((-torque) * multiplier);
+    test_account(&result, expected, test_field_to_torque(legacy_regen((uint16_t)(field << 4), multiplier)),
+                 test_field_to_torque(fixed_scale((uint16_t)(field << 4), TSCALE_Q16(multiplier))), 1U);
+  }
+  return test_report(name, &result, 0x800U);
+}
+
+static bool test_response(void){
+  test_result_t result;
+  uint16_t demand;
+
+  memset(&result, 0, sizeof(result));
+  for(demand = 0; demand <= 0xFFFU; demand++) {
+    test_account(&result, 0, legacy_response(demand), fixed_response(demand), 0U);
+  }
+  return test_report("response_0.5", &result, 0x1000U);
+}
+
+//Any runtime multiplier: within one bit of the truncated double product over the signed range
+static bool test_runtime(void){
+  test_result_t result;
+  uint32_t permille;
+  uint16_t field;
+  uint32_t total = 0;
+
+  memset(&result, 0, sizeof(result));
+  for(permille = 100U; permille <= 4000U; permille++) {
+    double multiplier = permille / 1000.0;
+    uint32_t mul_q16 = TSCALE_Q16(multiplier);
+    for(field = 0; field <= 0xFFFU; field += 7U) {
+      int32_t torque = test_field_to_torque(field);
+      int32_t expected = (int32_t)(torque * multiplier);   //truncated toward zero
+      int32_t fixed = TSCALE_Torque12((int16_t)torque, mul_q16);
+      int32_t clamped = (expected > TSCALE_TORQUE_MAX) ? TSCALE_TORQUE_MAX : ((expected < TSCALE_TORQUE_MIN) ? TSCALE_TORQUE_MIN : expected);
+      test_account(&result, clamped, clamped, fixed, 1U);
+      total++;
+    }
+  }
+  return test_report("runtime_0.1-4.0", &result, total);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Maps
+//——————————————————————————————————————————————————————————————————————————————
+//Breakpoints on the grid (multiples of 128 raw, 8 km/h) and off it
+static const char * const test_maps[] = {
+  "map=power;x=0,512,1024,2047;y=0,32,64,120;v=1000,1200,1400,1600,1000,1100,1300,1500,900,1000,1200,1400,800,900,1000,1100",
+  "map=regen;x=0,300,1500;y=0;v=500,1100,2500",
+  "map=power;x=100,700,1900;y=5,47;v=1600,700,3900,0,1000,4000",
+};
+#define TEST_MAP_COUNT (sizeof(test_maps) / sizeof(test_maps[0]))
+
+//Float reference: bilinear over the breakpoints, clamped outside
+static float test_map_ref(const tmap_def_t * def, float x, float y){
+  float tx = 0.0f;
+  float ty = 0.0f;
+  uint8_t ix = 0;
+  uint8_t iy = 0;
+  uint8_t iy1;
+
+  while((ix < (def->nx - 2)) && (x >= def->x[ix + 1])) { ix++; }
+  tx = (x - def->x[ix]) / (float)(def->x[ix + 1] - def->x[ix]);
+  tx = (tx < 0.0f) ? 0.0f : ((tx > 1.0f) ? 1.0f : tx);
+  if(def->ny > 1) {
+    while((iy < (def->ny - 2)) && (y >= def->y[iy + 1])) { iy++; }
+    ty = (y - def->y[iy]) / (float)(def->y[iy + 1] - def->y[iy]);
+    ty = (ty < 0.0f) ? 0.0f : ((ty > 1.0f) ? 1.0f : ty);
+  }
+  iy1 = (def->ny > 1) ? (iy + 1) : iy;
+  float bottom = def->v[iy][ix] + ((def->v[iy][ix + 1] - (float)def->v[iy][ix]) * tx);
+  float top = def->v[iy1][ix] + ((def->v[iy1][ix + 1] - (float)def->v[iy1][ix]) * tx);
+  return bottom + ((top - bottom) * ty);
+}
+
+static bool test_maps_lookup(void){
+  char text[TMAP_TEXT_SIZE];
+  tmap_def_t def;
+  test_result_t result;
+  int16_t scaled;
+  int32_t expected;
+  uint32_t total;
+  uint32_t kmh16;
+  uint16_t field;
+  uint8_t m;
+  bool pass = true;
+  int8_t map;
+
+  for(m = 0; m < TEST_MAP_COUNT; m++) {
+    map = TMAP_Parse(test_maps[m], &def);
+    SIM_Clock_Advance(TMAP_GRACE_MS * 1000U);
+    if((map < 0) || !TMAP_Load((uint8_t)map, &def)) {
+      printf("  map %u: rejected\n", (unsigned)m);
+      pass = false;
+      continue;
+    }
+
+    //Text form round trip
+    TMAP_Format((uint8_t)map, text, sizeof(text));
+    if(0 != strcmp(text, test_maps[m])) {
+      printf("  map %u: formatted as %s\n", (unsigned)m, text);
+      pass = false;
+    }
+
+    //Grid lookup against the float reference; with on-grid breakpoints (map 0) the two are the same
+    //function, off-grid ones only agree on the grid points, so those maps are checked there
+    memset(&result, 0, sizeof(result));
+    total = 0;
+    for(kmh16 = 0; kmh16 <= (140U * 16U); kmh16 += ((0 != m) ? 128U : 5U)) {
+      for(field = 0; field <= 0xFFFU; field += ((0 != m) ? 128U : 1U)) {
+        int32_t torque = test_field_to_torque(field);
+        float multiplier = test_map_ref(&def, (float)((torque < 0) ? ((torque < -2047) ? 2047 : -torque) : torque),
+                                        (float)((kmh16 > (128U * 16U - 1U)) ? (128U * 16U - 1U) : kmh16) / 16.0f) / 1000.0f;
+        expected = (int32_t)(torque * multiplier);
+        expected = (expected > TSCALE_TORQUE_MAX) ? TSCALE_TORQUE_MAX : ((expected < TSCALE_TORQUE_MIN) ? TSCALE_TORQUE_MIN : expected);
+        if(!TMAP_Apply((uint8_t)map, (int16_t)torque, (uint16_t)kmh16, &scaled)) {
+          result.failures++;
+        } else {
+          test_account(&result, expected, expected, scaled, 1U);
+        }
+        total++;
+      }
+    }
+    snprintf(text, sizeof(text), "map%u_%s", (unsigned)m, TMAP_Name((uint8_t)map));
+    pass = test_report(text, &result, total) && pass;
+  }
+  return pass;
+}
+
+static bool test_maps_control(void){
+  static const char * const invalid[] = {
+    "map=power;x=0,512,512;y=0;v=1000,1000,1000",     //axis not increasing
+    "map=power;x=0,512;y=0,30;v=1000,1000,1000",      //value count
+    "map=power;x=0,512;y=0;v=1000,4001",              //multiplier above 4.0
+    "map=power;x=0,2048;y=0;v=1000,1000",             //torque axis beyond 12 bit
+    "map=power;x=0,512;y=0,129;v=1000,1000,1000,1000", //speed axis beyond the grid
+    "map=power;x=0;y=0;v=1000",                       //single torque breakpoint
+    "map=turbo;x=0,512;y=0;v=1000,1000",              //unknown map
+    "map=power;x=0,5x2;y=0;v=1000,1000",              //junk
+  };
+  tmap_def_t def;
+  int16_t scaled;
+  uint8_t i;
+  bool pass = true;
+
+  for(i = 0; i < (sizeof(invalid) / sizeof(invalid[0])); i++) {
+    if(TMAP_Parse(invalid[i], &def) >= 0) {
+      printf("  accepted invalid map %s\n", invalid[i]);
+      pass = false;
+    }
+  }
+
+  //A second swap within the grace period is refused, accepted after it
+  SIM_Clock_Advance(TMAP_GRACE_MS * 1000U);
+  TMAP_Parse("map=regen;x=0,2047;y=0;v=1000,2000", &def);
+  if(!TMAP_Load(TMAP_REGEN, &def) || TMAP_Load(TMAP_REGEN, &def)) {
+    printf("  swap grace period not applied\n");
+    pass = false;
+  }
+  SIM_Clock_Advance(TMAP_GRACE_MS * 1000U);
+  if(!TMAP_Load(TMAP_REGEN, &def)) {
+    printf("  swap refused after the grace period\n");
+    pass = false;
+  }
+
+  //"off" removes the map, the fixed multipliers apply again
+  if((TMAP_REGEN != TMAP_Parse("map=regen;off", &def)) || (0 != def.nx)) {
+    printf("  map=regen;off not parsed\n");
+    pass = false;
+  }
+  TMAP_Unload(TMAP_REGEN);
+  if(TMAP_Apply(TMAP_REGEN, -100, 0, &scaled) || TMAP_Active(TMAP_REGEN)) {
+    printf("  unloaded map still applied\n");
+    pass = false;
+  }
+
+  printf("  %-16s %s\n", "map_control", pass ? "ok" : "FAIL");
+  return pass;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Timing
+//——————————————————————————————————————————————————————————————————————————————
+template <uint16_t (*SCALE)(uint16_t)>
+static void test_time(const char * name, uint32_t iterations){
+  bench_timer_t timer;
+  uint32_t done;
+  uint32_t i;
+  uint16_t out;
+  uint8_t repeat;
+
+  for(repeat = 0; repeat < BENCH_REPEAT; repeat++) {
+    BENCH_Clear(&timer);
+    for(done = 0; done < iterations; done += TEST_BATCH) {
+      BENCH_Start(&timer);
+      for(i = 0; i < TEST_BATCH; i++) {
+        out = SCALE((uint16_t)(i << 4));
+        BENCH_Use(out);
+      }
+      BENCH_Stop(&timer, TEST_BATCH);
+    }
+    BENCH_Record(name, &timer);
+  }
+  BENCH_Report(name);
+}
+
+static uint16_t time_legacy_160(uint16_t raw){ return legacy_power(raw & 0x7FF0U, TEST_MULTIPLIER_160); }
+static uint16_t time_fixed_160(uint16_t raw){ return fixed_scale(raw & 0x7FF0U, TSCALE_Get(TSCALE_POWER_160)); }
+static uint16_t time_legacy_regen(uint16_t raw){ return legacy_regen(raw | 0x8000U, TEST_MULTIPLIER_REGEN); }
+static uint16_t time_fixed_regen(uint16_t raw){ return fixed_scale(raw | 0x8000U, TSCALE_Get(TSCALE_REGEN)); }
+static uint16_t time_map_power(uint16_t raw){
+  int16_t scaled = 0;
+  TMAP_Apply(TMAP_POWER, (int16_t)(raw >> 5), (uint16_t)(raw >> 4), &scaled);
+  return (uint16_t)scaled;
+}
+static uint16_t time_legacy_response(uint16_t raw){ return legacy_response(raw >> 4); }
+static uint16_t time_fixed_response(uint16_t raw){ return fixed_response(raw >> 4); }
+
+int main(int argc, char ** argv){
+  uint32_t iterations = 4096U * 256U;
+  bool pass = true;
+  int opt;
+
+  while(-1 != (opt = getopt(argc, argv, "n:"))) {
+    switch(opt) {
+      case 'n': iterations = (uint32_t)strtoul(optarg, NULL, 10); break;
+      default:
+        fprintf(stderr, "usage: %s [-n iterations]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  printf("Fixed-point torque scaling against the double math:\n");
+  pass = test_power("power_stock", 1.0) && pass;
+  pass = test_power("power_110kw", TEST_MULTIPLIER_110) && pass;
+  pass = test_power("power_160kw", TEST_MULTIPLIER_160) && pass;
+  pass = test_regen("regen", TEST_MULTIPLIER_REGEN) && pass;
+  pass = test_response() && pass;
+  pass = test_runtime() && pass;
+  SIM_Clock_Set(0U);
+  pass = test_maps_lookup() && pass;
+  pass = test_maps_control() && pass;
+
+  BENCH_Init();
+  TSCALE_Set(TSCALE_POWER_160, TSCALE_Q16(TEST_MULTIPLIER_160));
+  TSCALE_Set(TSCALE_REGEN, TSCALE_Q16(TEST_MULTIPLIER_REGEN));
+  printf("Per value, best of %u%s:\n", (unsigned)BENCH_REPEAT,
+         BENCH_InstructionsAvailable() ? "" : " (instruction counter not available)");
+  test_time<time_legacy_160>("power_160kw_double", iterations);
+  test_time<time_fixed_160>("power_160kw_q16", iterations);
+  SIM_Clock_Advance(TMAP_GRACE_MS * 1000U);
+  tmap_def_t def;
+  TMAP_Parse(test_maps[0], &def);
+  TMAP_Load(TMAP_POWER, &def);
+  test_time<time_map_power>("power_map_bilinear", iterations);
+  test_time<time_legacy_regen>("regen_double", iterations);
+  test_time<time_fixed_regen>("regen_q16", iterations);
+  test_time<time_legacy_response>("response_double", iterations);
+  test_time<time_fixed_response>("response_q16", iterations);
+
+  printf("%s\n", pass ? "PASS" : "FAIL");
+  return pass ? 0 : 1;
+}
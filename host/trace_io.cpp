@@ -0,0 +1,247 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: CAN trace files for the host build: candump -l and Vector ASC, read and write
+// 10.16.2026: Trace replay through the bridge engine
+//——————————————————————————————————————————————————————————————————————————————
+// Timestamps are kept as integer microseconds all the way through (no floating point), so a
+// trace written by the replay is bit-exact from run to run.
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include <strings.h>
+#include "trace_io.h"
+
+//——————————————————————————————————————————————————————————————————————————————
+// Parsing helpers
+//——————————————————————————————————————————————————————————————————————————————
+static int trace_hex_digit(char c){
+  if((c >= '0') && (c <= '9')) { return c - '0'; }
+  if((c >= 'A') && (c <= 'F')) { return c - 'A' + 10; }
+  if((c >= 'a') && (c <= 'f')) { return c - 'a' + 10; }
+  return -1;
+}
+
+//"<seconds>.<fraction>" to microseconds, fraction truncated or padded to 6 digits
+static bool trace_parse_time(const char * sec, const char * frac, uint64_t * time_us){
+  uint64_t us = 0;
+  uint8_t i;
+
+  if(('\0' == *sec) || !isdigit((unsigned char)*sec)) {
+    return false;
+  }
+  for(i = 0; i < 6; i++) {
+    us = us * 10U;
+    if(isdigit((unsigned char)*frac)) {
+      us += (uint64_t)(*frac - '0');
+      frac++;
+    }
+  }
+  *time_us = (strtoull(sec, NULL, 10) * 1000000ULL) + us;
+  return true;
+}
+
+uint8_t TRACE_FormatOf(const char * path){
+  size_t len = strlen(path);
+  if((len >= 4) && (0 == strcasecmp(path + len - 4, ".asc"))) {
+    return TRACE_FORMAT_ASC;
+  }
+  return TRACE_FORMAT_CANDUMP;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// candump -l: "(<sec>.<usec>) <iface> <id>#<data>", 3 hex digits for 11-bit, 8 for 29-bit IDs
+//——————————————————————————————————————————————————————————————————————————————
+static int trace_parse_candump(const char * line, trace_frame_t * out){
+  char sec[24];
+  char frac[24];
+  const char * p;
+  char * end;
+  int n = 0;
+  int hi;
+  int lo;
+
+  if(3 != sscanf(line, " (%23[0-9].%23[0-9]) %15s %n", sec, frac, out->channel, &n) || (0 == n)) {
+    return 0;   //not a frame line
+  }
+  if(!trace_parse_time(sec, frac, &out->time_us)) {
+    return -1;
+  }
+  p = line + n;
+  out->frame.can_id = (uint32_t)strtoul(p, &end, 16);
+  if(('#' != *end) || (end == p)) {
+    return -1;
+  }
+  if((end - p) == 8) {
+    out->frame.can_id = CAN_EFF_FLAG | (out->frame.can_id & CAN_EFF_MASK);
+  } else if(out->frame.can_id > CAN_SFF_MASK) {
+    return -1;
+  }
+  p = end + 1;
+  if('#' == *p) {
+    return -1;  //CAN FD frame
+  }
+  out->frame.can_dlc = 0;
+  memset(out->frame.data, 0, sizeof(out->frame.data));
+  if(('R' == *p) || ('r' == *p)) {
+    return 1;   //remote frame, no payload
+  }
+  while((out->frame.can_dlc < CAN_MAX_DLEN) && ((hi = trace_hex_digit(p[0])) >= 0) && ((lo = trace_hex_digit(p[1])) >= 0)) {
+    out->frame.data[out->frame.can_dlc++] = (uint8_t)((hi << 4) | lo);
+    p += 2;
+  }
+  return 1;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Vector ASC: "<sec>.<frac> <channel> <id>[x] Rx|Tx d <dlc> <byte> ..." or "... Rx|Tx r [<dlc>]",
+// a trailing x marks a 29-bit ID
+//——————————————————————————————————————————————————————————————————————————————
+static int trace_parse_asc(const char * line, trace_frame_t * out){
+  char sec[24];
+  char frac[24];
+  char id[16];
+  char dir[8];
+  char type;
+  unsigned dlc = 0;
+  unsigned value;
+  const char * p;
+  char * end;
+  int n = 0;
+  uint8_t i;
+
+  //Header lines (date, base, Begin Triggerblock, comments) do not start with a timestamp
+  if(2 != sscanf(line, " %23[0-9].%23[0-9]", sec, frac)) {
+    return 0;
+  }
+  if((6 != sscanf(line, " %23[0-9].%23[0-9] %15s %15s %7s %c%n", sec, frac, out->channel, id, dir, &type, &n)) || (0 == n)) {
+    return -1;  //error frames, statistics lines, ...
+  }
+  p = line + n;
+  if('d' == type) {
+    if(1 != sscanf(p, " %u%n", &dlc, &n)) {
+      return -1;
+    }
+    p += n;
+  } else if('r' != type) {
+    return -1;
+  }
+  //Remote frames: the DLC is optional and there is no payload
+  if((trace_hex_digit(id[0]) < 0) || (dlc > CAN_MAX_DLEN)) {
+    return -1;
+  }
+  if(!trace_parse_time(sec, frac, &out->time_us)) {
+    return -1;
+  }
+  out->frame.can_id = (uint32_t)strtoul(id, &end, 16);
+  if((('x' == *end) || ('X' == *end)) && ('\0' == end[1])) {
+    out->frame.can_id = CAN_EFF_FLAG | (out->frame.can_id & CAN_EFF_MASK);
+  } else if(('\0' != *end) || (out->frame.can_id > CAN_SFF_MASK)) {
+    return -1;
+  }
+  out->frame.can_dlc = ('r' == type) ? 0U : (uint8_t)dlc;
+  memset(out->frame.data, 0, sizeof(out->frame.data));
+  for(i = 0; i < out->frame.can_dlc; i++) {
+    if(1 != sscanf(p, " %2x%n", &value, &n)) {
+      return -1;
+    }
+    out->frame.data[i] = (uint8_t)value;
+    p += n;
+  }
+  return 1;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Reader
+//——————————————————————————————————————————————————————————————————————————————
+bool TRACE_Open(trace_reader_t * reader, const char * path){
+  memset(reader, 0, sizeof(*reader));
+  reader->format = TRACE_FormatOf(path);
+  reader->file = fopen(path, "r");
+  return (NULL != reader->file);
+}
+
+bool TRACE_Read(trace_reader_t * reader, trace_frame_t * out){
+  char line[TRACE_LINE_LEN];
+  int result;
+
+  if(NULL == reader->file) {
+    return false;
+  }
+  while(NULL != fgets(line, sizeof(line), reader->file)) {
+    if(TRACE_FORMAT_ASC == reader->format) {
+      result = trace_parse_asc(line, out);
+    } else {
+      result = trace_parse_candump(line, out);
+    }
+    if(result > 0) {
+      reader->frames++;
+      return true;
+    }
+    if(result < 0) {
+      reader->skipped++;
+    }
+  }
+  return false;
+}
+
+void TRACE_Close(trace_reader_t * reader){
+  if(NULL != reader->file) {
+    fclose(reader->file);
+    reader->file = NULL;
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Writer
+//——————————————————————————————————————————————————————————————————————————————
+bool TRACE_Create(trace_writer_t * writer, const char * path){
+  memset(writer, 0, sizeof(*writer));
+  writer->format = TRACE_FormatOf(path);
+  writer->file = fopen(path, "w");
+  if(NULL == writer->file) {
+    return false;
+  }
+  if(TRACE_FORMAT_ASC == writer->format) {
+    fprintf(writer->file, "date Thu Jan 1 00:00:00.000 am 1970\n");
+    fprintf(writer->file, "base hex  timestamps absolute\n");
+    fprintf(writer->file, "no internal events logged\n");
+    fprintf(writer->file, "Begin Triggerblock\n");
+  }
+  return true;
+}
+
+void TRACE_Write(trace_writer_t * writer, uint64_t time_us, const char * channel, const can_frame_t &frame){
+  unsigned long long sec = (unsigned long long)(time_us / 1000000ULL);
+  unsigned long usec = (unsigned long)(time_us % 1000000ULL);
+  bool ext = (0U != (frame.can_id & CAN_EFF_FLAG));
+  unsigned long id = (unsigned long)(frame.can_id & (ext ? CAN_EFF_MASK : CAN_SFF_MASK));
+  uint8_t i;
+
+  if(NULL == writer->file) {
+    return;
+  }
+  if(TRACE_FORMAT_ASC == writer->format) {
+    fprintf(writer->file, ext ? "%llu.%06lu %s  %lXx            Tx   d %u" : "%llu.%06lu %s  %lX             Tx   d %u",
+            sec, usec, channel, id, (unsigned)frame.can_dlc);
+    for(i = 0; i < frame.can_dlc; i++) {
+      fprintf(writer->file, " %02X", frame.data[i]);
+    }
+  } else {
+    fprintf(writer->file, ext ? "(%llu.%06lu) %s %08lX#" : "(%llu.%06lu) %s %03lX#", sec, usec, channel, id);
+    for(i = 0; i < frame.can_dlc; i++) {
+      fprintf(writer->file, "%02X", frame.data[i]);
+    }
+  }
+  fputc('\n', writer->file);
+  writer->frames++;
+}
+
+void TRACE_Finish(trace_writer_t * writer){
+  if(NULL == writer->file) {
+    return;
+  }
+  if(TRACE_FORMAT_ASC == writer->format) {
+    fprintf(writer->file, "End TriggerBlock\n");
+  }
+  fclose(writer->file);
+  writer->file = NULL;
+}
@@ -0,0 +1,48 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: CAN trace files for the host build: candump -l and Vector ASC, read and write
+// 10.16.2026: Trace replay through the bridge engine
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef TRACE_IO_H
+#define TRACE_IO_H
+
+#include <Arduino.h>
+#include "canframe.h"
+
+#define TRACE_FORMAT_CANDUMP  (0U)  //"(1436509052.249713) can0 1D4#6E6E00000744300A"
+#define TRACE_FORMAT_ASC      (1U)  //"   12.249713 1  1D4             Rx   d 8 6E 6E 00 00 07 44 30 0A"
+
+#define TRACE_NAME_LEN        16    //interface name (candump) or channel number (ASC)
+#define TRACE_LINE_LEN        256
+
+typedef struct {
+  uint64_t    time_us;                  //timestamp as recorded
+  char        channel[TRACE_NAME_LEN];
+  can_frame_t frame;
+} trace_frame_t;
+
+typedef struct {
+  FILE *   file;
+  uint8_t  format;
+  uint32_t frames;      //frames read
+  uint32_t skipped;     //frame lines that could not be used (CAN FD, error frames, malformed)
+} trace_reader_t;
+
+typedef struct {
+  FILE *   file;
+  uint8_t  format;
+  uint32_t frames;      //frames written
+} trace_writer_t;
+
+//The format follows the file name: *.asc is Vector ASC, anything else candump
+uint8_t TRACE_FormatOf(const char * path);
+
+bool TRACE_Open(trace_reader_t * reader, const char * path);
+bool TRACE_Read(trace_reader_t * reader, trace_frame_t * out);
+void TRACE_Close(trace_reader_t * reader);
+
+bool TRACE_Create(trace_writer_t * writer, const char * path);
+void TRACE_Write(trace_writer_t * writer, uint64_t time_us, const char * channel, const can_frame_t &frame);
+void TRACE_Finish(trace_writer_t * writer);
+
+#endif //TRACE_IO_H
@@ -0,0 +1,261 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Replay of recorded CAN traces through the bridge engine on the host build
+// 10.16.2026: candump -l / Vector ASC input, every emitted frame captured to an output trace
+// 10.16.2026: -s prints the per-ID bus statistics of the replayed traffic (JSON, as on /busstats)
+//——————————————————————————————————————————————————————————————————————————————
+// The recording drives the simulated clock: each frame is delivered to its bridge channel at the
+// T_POLLING tick of its timestamp and the bridge passes run in between exactly as in the
+// simulation, so the output only depends on the input trace and the engine build. Comparing the
+// output traces of two firmware builds (diff/cmp) shows every frame that changed.
+//
+// By default the replay runs as fast as possible and reports the throughput; -r paces it to the
+// original timing on the wall clock.
+//
+// Channel mapping (-m, repeatable): <trace channel>=<bridge channel>, e.g. -m can0=2 -m can1=1
+// (candump interface names, ASC channel numbers). Without -m the first channel seen in the
+// trace is the VCM side (CAN2) and the second the inverter side (CAN1); other channels are ignored.
+// Output frames carry the trace channel name mapped to their bridge channel.
+//
+// Usage: bridge_replay -i input(.log|.asc) [-o output(.log|.asc)] [-m chan=bus]... [-r] [-s]
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include <unistd.h>
+#include <time.h>
+#include <chrono>
+#include "config.h"
+#include "can_bridge_manager_common.h"
+#include "sim_clock.h"
+#include "virtual_can.h"
+#include "bridge_loop.h"
+#include "trace_io.h"
+#include "bus_stats.h"
+
+#define REPLAY_MAX_MAPPINGS   8
+#define REPLAY_DRAIN_MS       50U   //quiet time after the last frame so everything queued leaves the bridge
+#define REPLAY_UNMAPPED       0xFFU
+
+typedef struct {
+  char    channel[TRACE_NAME_LEN];
+  uint8_t can_bus;
+} replay_mapping_t;
+
+static replay_mapping_t replay_map[REPLAY_MAX_MAPPINGS];
+static uint8_t replay_map_count = 0;
+static bool replay_auto_map = true;
+static char replay_out_name[VCAN_CHANNELS][TRACE_NAME_LEN];
+
+static trace_writer_t replay_out;
+static uint64_t replay_base_us = 0;     //trace time of simulated time 0
+static uint32_t replay_in[VCAN_CHANNELS];
+static uint32_t replay_out_count[VCAN_CHANNELS];
+static uint32_t replay_unmapped = 0;
+static uint32_t replay_dropped = 0;
+
+//——————————————————————————————————————————————————————————————————————————————
+// Channel mapping
+//——————————————————————————————————————————————————————————————————————————————
+static bool replay_add_mapping(const char * channel, uint8_t can_bus){
+  if((replay_map_count >= REPLAY_MAX_MAPPINGS) || (can_bus >= VCAN_CHANNELS)) {
+    return false;
+  }
+  snprintf(replay_map[replay_map_count].channel, TRACE_NAME_LEN, "%s", channel);
+  replay_map[replay_map_count].can_bus = can_bus;
+  replay_map_count++;
+  if('\0' == replay_out_name[can_bus][0]) {
+    snprintf(replay_out_name[can_bus], TRACE_NAME_LEN, "%s", channel);
+  }
+  return true;
+}
+
+static bool replay_parse_mapping(const char * arg){
+  char channel[TRACE_NAME_LEN];
+  unsigned can_bus;
+
+  if(2 != sscanf(arg, "%15[^=]=%u", channel, &can_bus)) {
+    return false;
+  }
+  replay_auto_map = false;
+  return replay_add_mapping(channel, (uint8_t)can_bus);
+}
+
+static uint8_t replay_bus_of(const char * channel){
+  static const uint8_t auto_order[] = { CAN_CHANNEL_2, CAN_CHANNEL_1 };
+  uint8_t i;
+
+  for(i = 0; i < replay_map_count; i++) {
+    if(0 == strcmp(replay_map[i].channel, channel)) {
+      return replay_map[i].can_bus;
+    }
+  }
+  if(replay_auto_map && (replay_map_count < sizeof(auto_order))) {
+    uint8_t can_bus = auto_order[replay_map_count];
+    replay_add_mapping(channel, can_bus);
+    return can_bus;
+  }
+  return REPLAY_UNMAPPED;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Output capture
+//——————————————————————————————————————————————————————————————————————————————
+static void replay_on_tx(uint8_t can_bus, const can_frame_t &frame, uint64_t done_us){
+  replay_out_count[can_bus]++;
+  if('\0' == replay_out_name[can_bus][0]) {
+    snprintf(replay_out_name[can_bus], TRACE_NAME_LEN, "bridge%u", (unsigned)can_bus);
+  }
+  TRACE_Write(&replay_out, replay_base_us + done_us, replay_out_name[can_bus], frame);
+}
+
+//Real time pacing: wait until the wall clock has caught up with the simulated time
+static void replay_pace(std::chrono::steady_clock::time_point wall_start, uint64_t now_us){
+  std::chrono::steady_clock::time_point due = wall_start + std::chrono::microseconds(now_us);
+  std::chrono::steady_clock::time_point wall = std::chrono::steady_clock::now();
+  if(due > wall) {
+    usleep((useconds_t)std::chrono::duration_cast<std::chrono::microseconds>(due - wall).count());
+  }
+}
+
+int main(int argc, char ** argv){
+  const char * in_path = NULL;
+  const char * out_path = NULL;
+  bool realtime = false;
+  bool bus_stats = false;
+  trace_reader_t in;
+  trace_frame_t next;
+  bool have;
+  uint64_t now_us;
+  uint64_t end_us = 0;
+  uint32_t total_in = 0;
+  uint32_t total_out = 0;
+  uint32_t i;
+  int opt;
+  bool pass = true;
+
+  while(-1 != (opt = getopt(argc, argv, "i:o:m:rs"))) {
+    switch(opt) {
+      case 'i': in_path = optarg; break;
+      case 'o': out_path = optarg; break;
+      case 'm':
+        if(!replay_parse_mapping(optarg)) {
+          fprintf(stderr, "invalid mapping %s, expected <trace channel>=<0..%u>\n", optarg, (unsigned)(VCAN_CHANNELS - 1));
+          return 2;
+        }
+      break;
+      case 'r': realtime = true; break;
+      case 's': bus_stats = true; break;
+      default:
+        in_path = NULL;
+      break;
+    }
+  }
+  if(NULL == in_path) {
+    fprintf(stderr, "usage: %s -i input(.log|.asc) [-o output(.log|.asc)] [-m chan=bus]... [-r] [-s]\n", argv[0]);
+    return 2;
+  }
+  if(!TRACE_Open(&in, in_path)) {
+    fprintf(stderr, "cannot open %s\n", in_path);
+    return 2;
+  }
+  if((NULL != out_path) && !TRACE_Create(&replay_out, out_path)) {
+    fprintf(stderr, "cannot create %s\n", out_path);
+    return 2;
+  }
+
+  //Resolve the channel mapping up front so output frames are named consistently from the start
+  while(TRACE_Read(&in, &next)) {
+    replay_bus_of(next.channel);
+  }
+  TRACE_Close(&in);
+  if(!TRACE_Open(&in, in_path)) {
+    fprintf(stderr, "cannot reopen %s\n", in_path);
+    return 2;
+  }
+
+  SIM_Clock_Set(0U);
+  HOST_BridgeInit();
+  VCAN_SetTxCallback(replay_on_tx);
+
+  have = TRACE_Read(&in, &next);
+  if(have) {
+    //Simulated time 0 is the tick boundary before the first frame
+    replay_base_us = next.time_us - (next.time_us % T_POLLING);
+  }
+
+  std::chrono::steady_clock::time_point wall_start = std::chrono::steady_clock::now();
+
+  for(now_us = 0U; have || (now_us < end_us); now_us += T_POLLING) {
+    SIM_Clock_Tick(now_us);
+
+    //Frames arrive at the start of the tick they fall into (late timestamps: right away)
+    while(have && ((next.time_us < replay_base_us) || ((next.time_us - replay_base_us) <= now_us))) {
+      uint8_t can_bus = replay_bus_of(next.channel);
+      if(REPLAY_UNMAPPED == can_bus) {
+        replay_unmapped++;
+      } else if(VCAN_Inject(can_bus, next.frame)) {
+        replay_in[can_bus]++;
+      } else {
+        replay_dropped++;
+      }
+      have = TRACE_Read(&in, &next);
+      if(!have) {
+        end_us = now_us + (REPLAY_DRAIN_MS * 1000U);
+      }
+    }
+
+    HOST_BridgePass();
+    VCAN_Advance(now_us + T_POLLING);
+
+    if(realtime) {
+      replay_pace(wall_start, now_us);
+    }
+  }
+
+  std::chrono::steady_clock::time_point wall_end = std::chrono::steady_clock::now();
+  double wall_s = std::chrono::duration<double>(wall_end - wall_start).count();
+  double sim_s = (double)now_us / 1e6;
+
+  TRACE_Close(&in);
+  TRACE_Finish(&replay_out);
+
+  //——— Report
+  for(i = 0; i < VCAN_CHANNELS; i++) {
+    total_in += replay_in[i];
+    total_out += replay_out_count[i];
+  }
+  printf("Input %s: %u frames, %u lines skipped, %u frames on unmapped channels\n", in_path,
+         (unsigned)in.frames, (unsigned)in.skipped, (unsigned)replay_unmapped);
+  for(i = 0; i < replay_map_count; i++) {
+    printf("  %-8s -> CAN%u\n", replay_map[i].channel, (unsigned)replay_map[i].can_bus);
+  }
+  for(i = 0; i < VCAN_CHANNELS; i++) {
+    if((replay_in[i] > 0U) || (replay_out_count[i] > 0U)) {
+      printf("  CAN%u: %8u in %8u out\n", (unsigned)i, (unsigned)replay_in[i], (unsigned)replay_out_count[i]);
+    }
+  }
+  printf("Replayed %.3f s of trace in %.3f s (%.1fx), %.0f frames/s in, %.0f frames/s out\n",
+         sim_s, wall_s, (wall_s > 0.0) ? (sim_s / wall_s) : 0.0,
+         (wall_s > 0.0) ? (total_in / wall_s) : 0.0, (wall_s > 0.0) ? (total_out / wall_s) : 0.0);
+  if(NULL != out_path) {
+    printf("Output %s: %u frames\n", out_path, (unsigned)replay_out.frames);
+  }
+  if(bus_stats) {
+    BUSSTAT_WriteJson(Serial);
+    printf("\n");
+  }
+
+  //——— Losses inside the bridge make a before/after comparison meaningless
+  if(replay_dropped > 0U) {
+    printf("FAIL: %u frames lost at the receive queues\n", (unsigned)replay_dropped);
+    pass = false;
+  }
+  for(i = 0; i < VCAN_CHANNELS; i++) {
+    tx_buffer_stats_t tstats;
+    if(buffer_get_stats(i, &tstats) && (tstats.dropped > 0U)) {
+      printf("FAIL: CAN%u transmit buffer dropped %u frames\n", (unsigned)i, (unsigned)tstats.dropped);
+      pass = false;
+    }
+  }
+
+  return pass ? 0 : 1;
+}
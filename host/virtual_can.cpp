@@ -0,0 +1,266 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: In-memory virtual CAN bus for the host build (replaces can_driver.cpp)
+// 10.16.2026: Host build of the bridge engine, see host/Makefile
+//——————————————————————————————————————————————————————————————————————————————
+// Implements the can_driver.h API on top of per-channel queues:
+//  - VCAN_Inject() is the wire side of a receive: the frame is queued for the bridge with the
+//    current simulated time, like the ACAN2515 receive queue or the CAN2 ISR ring.
+//  - CANx_Transmit() hands a frame to the controller, which accepts up to its transmit depth.
+//  - VCAN_Advance() puts the accepted frames on the wire one after the other at VCAN_BITRATE
+//    and reports each completed frame through the transmit callback.
+//  - Each frame the bridge reads advances the simulated clock by VCAN_RX_PROCESS_US.
+// Arbitration against the received traffic on the same wire is not modelled.
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include "can_driver.h"
+#include "spsc_ring.h"
+#include "virtual_can.h"
+#include "sim_clock.h"
+
+typedef struct {
+  can_frame_t frame;
+  uint64_t    time_us;    //reception time (rx) or acceptance time (tx)
+} vcan_entry_t;
+
+typedef struct {
+  spsc_ring<vcan_entry_t, VCAN_RX_QUEUE_SIZE> rx;
+  spsc_ring<vcan_entry_t, VCAN_TX_QUEUE_SIZE> tx;
+  uint8_t       tx_depth;
+  uint64_t      bus_free_us;  //end of the frame currently on the wire
+  vcan_stats_t  stats;
+} vcan_channel_t;
+
+static vcan_channel_t vcan[VCAN_CHANNELS];
+static vcan_tx_callback_t vcan_tx_callback = NULL;
+
+//——————————————————————————————————————————————————————————————————————————————
+// Virtual bus control
+//——————————————————————————————————————————————————————————————————————————————
+void VCAN_Reset(void){
+  uint8_t i;
+  for(i = 0; i < VCAN_CHANNELS; i++) {
+    while(NULL != vcan[i].rx.front()) {
+      vcan[i].rx.pop();
+    }
+    while(NULL != vcan[i].tx.front()) {
+      vcan[i].tx.pop();
+    }
+    vcan[i].rx.pushed = 0U;
+    vcan[i].rx.dropped = 0U;
+    vcan[i].rx.high_water = 0U;
+    vcan[i].tx.pushed = 0U;
+    vcan[i].tx.dropped = 0U;
+    vcan[i].tx.high_water = 0U;
+    vcan[i].tx_depth = (CAN_CHANNEL_2 == i) ? VCAN_SJA1000_TX_DEPTH : VCAN_MCP2515_TX_DEPTH;
+    vcan[i].bus_free_us = 0U;
+    memset(&vcan[i].stats, 0, sizeof(vcan[i].stats));
+  }
+}
+
+void VCAN_SetTxCallback(vcan_tx_callback_t callback){
+  vcan_tx_callback = callback;
+}
+
+void VCAN_SetTxDepth(uint8_t can_bus, uint8_t depth){
+  if((can_bus < VCAN_CHANNELS) && (depth > 0U) && (depth <= VCAN_TX_QUEUE_SIZE)) {
+    vcan[can_bus].tx_depth = depth;
+  }
+}
+
+bool VCAN_Inject(uint8_t can_bus, const can_frame_t &frame){
+  vcan_entry_t entry;
+
+  if(can_bus >= VCAN_CHANNELS) {
+    return false;
+  }
+  entry.frame = frame;
+  entry.frame.rx_cycles = CAN_RxStamp();
+  entry.time_us = SIM_Clock_Now();
+  if(false == vcan[can_bus].rx.push(entry)) {
+    vcan[can_bus].stats.rx_dropped++;
+    return false;
+  }
+  vcan[can_bus].stats.rx_injected++;
+  return true;
+}
+
+//Nominal frame length without stuffing: 11-bit identifier, 47 overhead bits incl. interframe space
+uint32_t VCAN_FrameTimeUs(uint8_t dlc){
+  return ((47UL + (8UL * dlc)) * 1000000UL) / VCAN_BITRATE;
+}
+
+void VCAN_Advance(uint64_t now_us){
+  uint8_t i;
+  for(i = 0; i < VCAN_CHANNELS; i++) {
+    vcan_channel_t * ch = &vcan[i];
+    vcan_entry_t * entry;
+
+    while(NULL != (entry = ch->tx.front())) {
+      uint64_t start_us = (ch->bus_free_us > entry->time_us) ? ch->bus_free_us : entry->time_us;
+      uint64_t done_us = start_us + VCAN_FrameTimeUs(entry->frame.can_dlc);
+      if(done_us > now_us) {
+        break;
+      }
+      ch->bus_free_us = done_us;
+      ch->stats.tx_sent++;
+      if(NULL != vcan_tx_callback) {
+        vcan_tx_callback(i, entry->frame, done_us);
+      }
+      ch->tx.pop();
+    }
+  }
+}
+
+bool VCAN_GetStats(uint8_t can_bus, vcan_stats_t * stats){
+  if((can_bus >= VCAN_CHANNELS) || (NULL == stats)) {
+    return false;
+  }
+  *stats = vcan[can_bus].stats;
+  return true;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Controller side helpers
+//——————————————————————————————————————————————————————————————————————————————
+static bool vcan_transmit(uint8_t can_bus, const can_frame_t &frame){
+  vcan_channel_t * ch = &vcan[can_bus];
+  vcan_entry_t entry;
+
+  if(ch->tx.count() >= ch->tx_depth) {
+    ch->stats.tx_refused++;
+    return false;
+  }
+  entry.frame = frame;
+  entry.time_us = SIM_Clock_Now();
+  ch->tx.push(entry);
+  ch->stats.tx_accepted++;
+  return true;
+}
+
+static bool vcan_transmit_message(uint8_t can_bus, const CANMessage &message){
+  can_frame_t frame;
+  frame.can_id = message.ext ? (message.id | CAN_EFF_FLAG) : message.id;
+  frame.can_dlc = message.len;
+  memcpy(frame.data, message.data, sizeof(frame.data));
+  return vcan_transmit(can_bus, frame);
+}
+
+//Frame as the driver delivers it, ingress timestamp in rx_cycles
+static void vcan_read_frame(uint8_t can_bus, can_frame_t &frame){
+  vcan_entry_t * entry = vcan[can_bus].rx.front();
+  if(NULL != entry) {
+    frame = entry->frame;
+    vcan[can_bus].rx.pop();
+    vcan[can_bus].stats.rx_read++;
+    SIM_Clock_Advance(VCAN_RX_PROCESS_US);
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// can_driver.h API
+//——————————————————————————————————————————————————————————————————————————————
+void CAN_Init(void){
+  VCAN_Reset();
+}
+
+void CAN_Rx_Monitor(void){
+}
+
+void CAN_RxBudgetExhausted(uint8_t can_bus){
+  if(can_bus < VCAN_CHANNELS) {
+    vcan[can_bus].stats.budget_exhausted++;
+  }
+}
+
+bool CAN_GetRxStats(uint8_t can_bus, can_rx_stats_t * stats){
+  if((can_bus > CAN_CHANNEL_1) || (NULL == stats)) {
+    return false;
+  }
+  stats->frames           = vcan[can_bus].stats.rx_read;
+  stats->budget_exhausted = vcan[can_bus].stats.budget_exhausted;
+  stats->queue_full       = vcan[can_bus].stats.rx_dropped;
+  stats->hw_overflow      = 0U;
+  stats->queue_size       = VCAN_RX_QUEUE_SIZE;
+  stats->queue_peak       = vcan[can_bus].rx.high_water;
+  return true;
+}
+
+#ifdef CAN_CH0_ENABLED
+bool CAN0_Transmit(const CANMessage &frame){
+  return vcan_transmit_message(CAN_CHANNEL_0, frame);
+}
+
+bool CAN0_NewFrameIsAvailable(void){
+  return !vcan[CAN_CHANNEL_0].rx.empty();
+}
+
+void CAN0_ReadNewFrame(can_frame_t &frame){
+  vcan_read_frame(CAN_CHANNEL_0, frame);
+}
+#endif //CAN_CH0_ENABLED
+
+#ifdef CAN_CH1_ENABLED
+bool CAN1_Transmit(const CANMessage &frame){
+  return vcan_transmit_message(CAN_CHANNEL_1, frame);
+}
+
+bool CAN1_NewFrameIsAvailable(void){
+  return !vcan[CAN_CHANNEL_1].rx.empty();
+}
+
+void CAN1_ReadNewFrame(can_frame_t &frame){
+  vcan_read_frame(CAN_CHANNEL_1, frame);
+}
+#endif //CAN_CH1_ENABLED
+
+#ifdef CAN_CH2_ENABLED
+void CAN2_Init(void){
+}
+
+void CAN2_onReceive(int packetSize){
+  (void)packetSize;
+}
+
+bool CAN2_Transmit(const can_frame_t &tx_frame){
+  return vcan_transmit(CAN_CHANNEL_2, tx_frame);
+}
+
+void CAN2_SetRxNotifyTask(TaskHandle_t task){
+  (void)task;
+}
+
+bool CAN2_NewFrameIsAvailable(void){
+  return !vcan[CAN_CHANNEL_2].rx.empty();
+}
+
+can_frame_t * CAN2_PeekFrame(uint32_t * timestamp){
+  vcan_entry_t * entry = vcan[CAN_CHANNEL_2].rx.front();
+  if(NULL == entry) {
+    return NULL;
+  }
+  if(NULL != timestamp) {
+    *timestamp = entry->frame.rx_cycles;
+  }
+  return &entry->frame;
+}
+
+void CAN2_ReleaseFrame(void){
+  if(NULL != vcan[CAN_CHANNEL_2].rx.front()) {
+    vcan[CAN_CHANNEL_2].rx.pop();
+    vcan[CAN_CHANNEL_2].stats.rx_read++;
+    SIM_Clock_Advance(VCAN_RX_PROCESS_US);    //handled in its ring slot, released when done
+  }
+}
+
+void CAN2_GetRxStats(can2_rx_stats_t * stats){
+  stats->isr_count       = vcan[CAN_CHANNEL_2].stats.rx_injected;
+  stats->isr_last_cycles = 0U;
+  stats->isr_avg_cycles  = 0U;
+  stats->isr_max_cycles  = 0U;
+  stats->queue_count     = vcan[CAN_CHANNEL_2].rx.count();
+  stats->queue_size      = vcan[CAN_CHANNEL_2].rx.capacity();
+  stats->queue_peak      = vcan[CAN_CHANNEL_2].rx.high_water;
+  stats->dropped         = vcan[CAN_CHANNEL_2].stats.rx_dropped;
+}
+#endif //CAN_CH2_ENABLED
@@ -0,0 +1,48 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: In-memory virtual CAN bus for the host build (replaces can_driver.cpp)
+// 10.16.2026: Host build of the bridge engine, see host/Makefile
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef VIRTUAL_CAN_H
+#define VIRTUAL_CAN_H
+
+#include <Arduino.h>
+#include "canframe.h"
+
+#define VCAN_CHANNELS         3
+#define VCAN_RX_QUEUE_SIZE    256     //frames waiting for the bridge, per channel (power of two)
+#define VCAN_TX_QUEUE_SIZE    16      //upper limit of the controller transmit depth (power of two)
+#define VCAN_BITRATE          500000UL
+
+//Bridge task time per received frame (controller read, handler, queueing), added to the simulated
+//clock when the bridge reads the frame: the RX->TX latency of a frame then grows with the frames
+//handled before it in the same pass. A modelled value, not a measurement of the target.
+#define VCAN_RX_PROCESS_US    20U
+
+//Controller transmit depth, as on the target: MCP2515 3 TXB with 2 driver queue entries each,
+//SJA1000 a single transmit buffer
+#define VCAN_MCP2515_TX_DEPTH 9
+#define VCAN_SJA1000_TX_DEPTH 1
+
+//Called when a frame has completely left a controller onto the wire
+typedef void (*vcan_tx_callback_t)(uint8_t can_bus, const can_frame_t &frame, uint64_t done_us);
+
+typedef struct {
+  uint32_t rx_injected;   //frames delivered to the controller
+  uint32_t rx_dropped;    //frames lost because the receive queue was full
+  uint32_t rx_read;       //frames read by the bridge
+  uint32_t tx_accepted;   //frames the bridge handed to the controller
+  uint32_t tx_refused;    //transmit calls that found the controller full
+  uint32_t tx_sent;       //frames on the wire
+  uint32_t budget_exhausted;
+} vcan_stats_t;
+
+void VCAN_Reset(void);
+void VCAN_SetTxCallback(vcan_tx_callback_t callback);
+void VCAN_SetTxDepth(uint8_t can_bus, uint8_t depth);
+bool VCAN_Inject(uint8_t can_bus, const can_frame_t &frame);
+void VCAN_Advance(uint64_t now_us);
+uint32_t VCAN_FrameTimeUs(uint8_t dlc);
+bool VCAN_GetStats(uint8_t can_bus, vcan_stats_t * stats);
+
+#endif //VIRTUAL_CAN_H
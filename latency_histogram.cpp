@@ -0,0 +1,68 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Log2-bucket latency histogram
+// 10.16.2026: Used for transmit queue wait time per CAN ID class
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include "latency_histogram.h"
+
+//——————————————————————————————————————————————————————————————————————————————
+// Clear all buckets
+//——————————————————————————————————————————————————————————————————————————————
+void HIST_Reset(latency_hist_t * hist){
+  uint8_t i;
+  for(i = 0; i < LATENCY_HIST_BUCKETS; i++){
+    hist->bucket[i] = 0;
+  }
+  hist->count = 0;
+  hist->max   = 0;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Record one sample, bucket index is the bit length of the value
+//——————————————————————————————————————————————————————————————————————————————
+void HIST_Record(latency_hist_t * hist, uint32_t value_us){
+  uint8_t idx = 0;
+  if(value_us != 0U){
+    idx = 32 - __builtin_clz(value_us);
+    if(idx >= LATENCY_HIST_BUCKETS){
+      idx = LATENCY_HIST_BUCKETS - 1;
+    }
+  }
+  hist->bucket[idx] = hist->bucket[idx] + 1U;
+  hist->count = hist->count + 1U;
+  if(value_us > hist->max){
+    hist->max = value_us;
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Upper bound (us) of the bucket holding the given percentile, capped at the largest recorded
+// value (a bucket bound can be far above anything seen), 0 when empty
+//——————————————————————————————————————————————————————————————————————————————
+uint32_t HIST_Percentile(const latency_hist_t * hist, uint8_t percent){
+  uint32_t total = hist->count;
+  uint32_t target;
+  uint32_t sum = 0;
+  uint32_t bound;
+  uint8_t i;
+
+  if(total == 0U){
+    return 0;
+  }
+
+  //Smallest rank covering the percentile: ceil(total * percent / 100)
+  target = (uint32_t)(((uint64_t)total * percent + 99U) / 100U);
+  for(i = 0; i < LATENCY_HIST_BUCKETS; i++){
+    sum += hist->bucket[i];
+    if(sum >= target){
+      break;
+    }
+  }
+
+  if(i >= (LATENCY_HIST_BUCKETS - 1)){
+    return hist->max;
+  }
+  bound = (i == 0) ? 0 : ((1UL << i) - 1U);
+  return (bound < hist->max) ? bound : hist->max;
+}
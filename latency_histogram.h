@@ -0,0 +1,26 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Log2-bucket latency histogram
+// 10.16.2026: Used for transmit queue wait time per CAN ID class
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <Arduino.h>
+
+//Bucket 0 holds 0us, bucket i (i >= 1) holds [2^(i-1), 2^i - 1] us.
+//The last bucket also collects everything above 2^(LATENCY_HIST_BUCKETS-2) us (~1s).
+#define LATENCY_HIST_BUCKETS  22
+
+//Single writer; readers in other contexts may see a bucket update before the count update.
+typedef struct {
+  volatile uint32_t bucket[LATENCY_HIST_BUCKETS];
+  volatile uint32_t count;
+  volatile uint32_t max;
+} latency_hist_t;
+
+void HIST_Reset(latency_hist_t * hist);
+void HIST_Record(latency_hist_t * hist, uint32_t value_us);
+uint32_t HIST_Percentile(const latency_hist_t * hist, uint8_t percent);
+
+#endif //LATENCY_HISTOGRAM_H
@@ -0,0 +1,423 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: LEAF signal descriptors and message decoders/encoders (can_signal.h)
+// Generated by host/dbc_gen from leaf.dbc, do not edit: change the DBC and run make gen in host/
+//——————————————————————————————————————————————————————————————————————————————
+// LEAF ZE0/AZE0 EV-CAN, e-NV200 (same layout), signals used by the CAN bridge
+// Start bits in DBC numbering: bit n is bit (n % 8) of data[n / 8], Motorola signals start at
+// their MSB. Struct members hold raw values, physical = raw * factor (noted per signal).
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef LEAF_SIGNALS_H
+#define LEAF_SIGNALS_H
+
+#include "can_signal.h"
+
+//——————————————————————————————————————————————————————————————————————————————
+// 0x11A VCM_11A, 8 bytes from VCM: VCM shifter
+//——————————————————————————————————————————————————————————————————————————————
+#define LEAF_11A_ID    0x11A
+#define LEAF_11A_DLC   8
+
+typedef sig_def< 7,  4> LEAF_11A_SHIFTER; //0 park, 2 reverse, 3 neutral, 4 drive
+typedef sig_def<12,  1> LEAF_11A_ECO;
+
+typedef struct {
+  uint8_t  SHIFTER;
+  uint8_t  ECO;
+} leaf_11a_t;
+
+static inline void LEAF_Decode_11A(const uint8_t * data, leaf_11a_t * msg){
+  msg->SHIFTER = (uint8_t)SIG_Raw<LEAF_11A_SHIFTER>(data);
+  msg->ECO = (uint8_t)SIG_Raw<LEAF_11A_ECO>(data);
+}
+
+//Payload bits not covered by a signal are kept
+static inline void LEAF_Encode_11A(const leaf_11a_t * msg, uint8_t * data){
+  SIG_Set<LEAF_11A_SHIFTER>(data, msg->SHIFTER);
+  SIG_Set<LEAF_11A_ECO>(data, msg->ECO);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// 0x1D4 VCM_1D4, 8 bytes from VCM: VCM torque demand
+//——————————————————————————————————————————————————————————————————————————————
+#define LEAF_1D4_ID    0x1D4
+#define LEAF_1D4_DLC   8
+
+typedef sig_def<23, 12, SIG_MOTOROLA, SIG_SIGNED, 1, 4> LEAF_1D4_TORQUE;  //0.25 Nm
+typedef sig_def<49,  2>                                 LEAF_1D4_COUNTER;
+typedef sig_def<63,  8>                                 LEAF_1D4_CRC8;
+
+typedef struct {
+  int16_t  TORQUE;
+  uint8_t  COUNTER;
+  uint8_t  CRC8;
+} leaf_1d4_t;
+
+static inline void LEAF_Decode_1D4(const uint8_t * data, leaf_1d4_t * msg){
+  msg->TORQUE = (int16_t)SIG_Get<LEAF_1D4_TORQUE>(data);
+  msg->COUNTER = (uint8_t)SIG_Raw<LEAF_1D4_COUNTER>(data);
+  msg->CRC8 = (uint8_t)SIG_Raw<LEAF_1D4_CRC8>(data);
+}
+
+//Payload bits not covered by a signal are kept
+static inline void LEAF_Encode_1D4(const leaf_1d4_t * msg, uint8_t * data){
+  SIG_Set<LEAF_1D4_TORQUE>(data, msg->TORQUE);
+  SIG_Set<LEAF_1D4_COUNTER>(data, msg->COUNTER);
+  SIG_Set<LEAF_1D4_CRC8>(data, msg->CRC8);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// 0x1DA INV_1DA, 8 bytes from INV: Inverter torque response
+//——————————————————————————————————————————————————————————————————————————————
+#define LEAF_1DA_ID    0x1DA
+#define LEAF_1DA_DLC   8
+
+typedef sig_def<18, 11, SIG_MOTOROLA, SIG_SIGNED, 1, 2> LEAF_1DA_TORQUE; //0.5 Nm, negative: regen
+
+typedef struct {
+  int16_t  TORQUE;
+} leaf_1da_t;
+
+static inline void LEAF_Decode_1DA(const uint8_t * data, leaf_1da_t * msg){
+  msg->TORQUE = (int16_t)SIG_Get<LEAF_1DA_TORQUE>(data);
+}
+
+//Payload bits not covered by a signal are kept
+static inline void LEAF_Encode_1DA(const leaf_1da_t * msg, uint8_t * data){
+  SIG_Set<LEAF_1DA_TORQUE>(data, msg->TORQUE);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// 0x1DB LBC_1DB, 8 bytes from LBC: LBC battery status
+//——————————————————————————————————————————————————————————————————————————————
+#define LEAF_1DB_ID    0x1DB
+#define LEAF_1DB_DLC   8
+
+typedef sig_def< 7, 11, SIG_MOTOROLA, SIG_SIGNED, 1, 2>   LEAF_1DB_LB_CURRENT; //0.5 A
+typedef sig_def<23, 10, SIG_MOTOROLA, SIG_UNSIGNED, 1, 2> LEAF_1DB_LB_VOLTAGE; //0.5 V
+typedef sig_def<39,  8>                                   LEAF_1DB_SOC;        //1 %, shown on the dash
+typedef sig_def<49,  2>                                   LEAF_1DB_MPR1DB;
+typedef sig_def<63,  8>                                   LEAF_1DB_CRC8;
+
+typedef struct {
+  int16_t  LB_CURRENT;
+  uint16_t LB_VOLTAGE;
+  uint8_t  SOC;
+  uint8_t  MPR1DB;
+  uint8_t  CRC8;
+} leaf_1db_t;
+
+static inline void LEAF_Decode_1DB(const uint8_t * data, leaf_1db_t * msg){
+  msg->LB_CURRENT = (int16_t)SIG_Get<LEAF_1DB_LB_CURRENT>(data);
+  msg->LB_VOLTAGE = (uint16_t)SIG_Raw<LEAF_1DB_LB_VOLTAGE>(data);
+  msg->SOC = (uint8_t)SIG_Raw<LEAF_1DB_SOC>(data);
+  msg->MPR1DB = (uint8_t)SIG_Raw<LEAF_1DB_MPR1DB>(data);
+  msg->CRC8 = (uint8_t)SIG_Raw<LEAF_1DB_CRC8>(data);
+}
+
+//Payload bits not covered by a signal are kept
+static inline void LEAF_Encode_1DB(const leaf_1db_t * msg, uint8_t * data){
+  SIG_Set<LEAF_1DB_LB_CURRENT>(data, msg->LB_CURRENT);
+  SIG_Set<LEAF_1DB_LB_VOLTAGE>(data, msg->LB_VOLTAGE);
+  SIG_Set<LEAF_1DB_SOC>(data, msg->SOC);
+  SIG_Set<LEAF_1DB_MPR1DB>(data, msg->MPR1DB);
+  SIG_Set<LEAF_1DB_CRC8>(data, msg->CRC8);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// 0x1DC LBC_1DC, 8 bytes from LBC: LBC power limits
+//——————————————————————————————————————————————————————————————————————————————
+#define LEAF_1DC_ID    0x1DC
+#define LEAF_1DC_DLC   8
+
+typedef sig_def< 7, 10, SIG_MOTOROLA, SIG_UNSIGNED, 1, 4> LEAF_1DC_LB_POUT;       //0.25 kW
+typedef sig_def<13, 10, SIG_MOTOROLA, SIG_UNSIGNED, 1, 4> LEAF_1DC_LB_PIN;        //0.25 kW
+typedef sig_def<19, 10>                                   LEAF_1DC_LB_BPCMAX;
+typedef sig_def<25,  2>                                   LEAF_1DC_LB_PIN_STATUS;
+typedef sig_def<39,  3>                                   LEAF_1DC_LB_BPCUPRATE;
+typedef sig_def<36,  3>                                   LEAF_1DC_LB_CODECON;
+typedef sig_def<33,  8>                                   LEAF_1DC_LB_CODE1;
+typedef sig_def<41,  8>                                   LEAF_1DC_LB_CODE2;
+typedef sig_def<49,  2>                                   LEAF_1DC_MPR1DC;
+typedef sig_def<63,  8>                                   LEAF_1DC_CRC8;
+
+typedef struct {
+  uint16_t LB_POUT;
+  uint16_t LB_PIN;
+  uint16_t LB_BPCMAX;
+  uint8_t  LB_PIN_STATUS;
+  uint8_t  LB_BPCUPRATE;
+  uint8_t  LB_CODECON;
+  uint8_t  LB_CODE1;
+  uint8_t  LB_CODE2;
+  uint8_t  MPR1DC;
+  uint8_t  CRC8;
+} leaf_1dc_t;
+
+static inline void LEAF_Decode_1DC(const uint8_t * data, leaf_1dc_t * msg){
+  msg->LB_POUT = (uint16_t)SIG_Raw<LEAF_1DC_LB_POUT>(data);
+  msg->LB_PIN = (uint16_t)SIG_Raw<LEAF_1DC_LB_PIN>(data);
+  msg->LB_BPCMAX = (uint16_t)SIG_Raw<LEAF_1DC_LB_BPCMAX>(data);
+  msg->LB_PIN_STATUS = (uint8_t)SIG_Raw<LEAF_1DC_LB_PIN_STATUS>(data);
+  msg->LB_BPCUPRATE = (uint8_t)SIG_Raw<LEAF_1DC_LB_BPCUPRATE>(data);
+  msg->LB_CODECON = (uint8_t)SIG_Raw<LEAF_1DC_LB_CODECON>(data);
+  msg->LB_CODE1 = (uint8_t)SIG_Raw<LEAF_1DC_LB_CODE1>(data);
+  msg->LB_CODE2 = (uint8_t)SIG_Raw<LEAF_1DC_LB_CODE2>(data);
+  msg->MPR1DC = (uint8_t)SIG_Raw<LEAF_1DC_MPR1DC>(data);
+  msg->CRC8 = (uint8_t)SIG_Raw<LEAF_1DC_CRC8>(data);
+}
+
+//Payload bits not covered by a signal are kept
+static inline void LEAF_Encode_1DC(const leaf_1dc_t * msg, uint8_t * data){
+  SIG_Set<LEAF_1DC_LB_POUT>(data, msg->LB_POUT);
+  SIG_Set<LEAF_1DC_LB_PIN>(data, msg->LB_PIN);
+  SIG_Set<LEAF_1DC_LB_BPCMAX>(data, msg->LB_BPCMAX);
+  SIG_Set<LEAF_1DC_LB_PIN_STATUS>(data, msg->LB_PIN_STATUS);
+  SIG_Set<LEAF_1DC_LB_BPCUPRATE>(data, msg->LB_BPCUPRATE);
+  SIG_Set<LEAF_1DC_LB_CODECON>(data, msg->LB_CODECON);
+  SIG_Set<LEAF_1DC_LB_CODE1>(data, msg->LB_CODE1);
+  SIG_Set<LEAF_1DC_LB_CODE2>(data, msg->LB_CODE2);
+  SIG_Set<LEAF_1DC_MPR1DC>(data, msg->MPR1DC);
+  SIG_Set<LEAF_1DC_CRC8>(data, msg->CRC8);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// 0x1F2 VCM_1F2, 8 bytes from VCM: VCM charger control
+//——————————————————————————————————————————————————————————————————————————————
+#define LEAF_1F2_ID    0x1F2
+#define LEAF_1F2_DLC   8
+
+typedef sig_def< 7,  1> LEAF_1F2_TCSOC;
+typedef sig_def<21,  2> LEAF_1F2_CHG_STA_RQ;
+typedef sig_def<49,  2> LEAF_1F2_MPRUN;
+typedef sig_def<63,  8> LEAF_1F2_CRC8;
+
+typedef struct {
+  uint8_t  TCSOC;
+  uint8_t  CHG_STA_RQ;
+  uint8_t  MPRUN;
+  uint8_t  CRC8;
+} leaf_1f2_t;
+
+static inline void LEAF_Decode_1F2(const uint8_t * data, leaf_1f2_t * msg){
+  msg->TCSOC = (uint8_t)SIG_Raw<LEAF_1F2_TCSOC>(data);
+  msg->CHG_STA_RQ = (uint8_t)SIG_Raw<LEAF_1F2_CHG_STA_RQ>(data);
+  msg->MPRUN = (uint8_t)SIG_Raw<LEAF_1F2_MPRUN>(data);
+  msg->CRC8 = (uint8_t)SIG_Raw<LEAF_1F2_CRC8>(data);
+}
+
+//Payload bits not covered by a signal are kept
+static inline void LEAF_Encode_1F2(const leaf_1f2_t * msg, uint8_t * data){
+  SIG_Set<LEAF_1F2_TCSOC>(data, msg->TCSOC);
+  SIG_Set<LEAF_1F2_CHG_STA_RQ>(data, msg->CHG_STA_RQ);
+  SIG_Set<LEAF_1F2_MPRUN>(data, msg->MPRUN);
+  SIG_Set<LEAF_1F2_CRC8>(data, msg->CRC8);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// 0x284 ABS_284, 8 bytes from ABS: ABS wheel speed
+//——————————————————————————————————————————————————————————————————————————————
+#define LEAF_284_ID    0x284
+#define LEAF_284_DLC   8
+
+typedef sig_def<39, 16, SIG_MOTOROLA, SIG_UNSIGNED, 1, 98> LEAF_284_SPEED; //0.0102041 km/h, 98 per km/h as calibrated against the dash
+
+typedef struct {
+  uint16_t SPEED;
+} leaf_284_t;
+
+static inline void LEAF_Decode_284(const uint8_t * data, leaf_284_t * msg){
+  msg->SPEED = (uint16_t)SIG_Raw<LEAF_284_SPEED>(data);
+}
+
+//Payload bits not covered by a signal are kept
+static inline void LEAF_Encode_284(const leaf_284_t * msg, uint8_t * data){
+  SIG_Set<LEAF_284_SPEED>(data, msg->SPEED);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// 0x50B VCM_50B, 7 bytes from VCM: VCM wake up
+//——————————————————————————————————————————————————————————————————————————————
+#define LEAF_50B_ID    0x50B
+#define LEAF_50B_DLC   7
+
+typedef sig_def<18,  1> LEAF_50B_CANMASK;
+typedef sig_def<31,  2> LEAF_50B_WAKEUP_SLEEP_CMD;
+
+typedef struct {
+  uint8_t  CANMASK;
+  uint8_t  WAKEUP_SLEEP_CMD;
+} leaf_50b_t;
+
+static inline void LEAF_Decode_50B(const uint8_t * data, leaf_50b_t * msg){
+  msg->CANMASK = (uint8_t)SIG_Raw<LEAF_50B_CANMASK>(data);
+  msg->WAKEUP_SLEEP_CMD = (uint8_t)SIG_Raw<LEAF_50B_WAKEUP_SLEEP_CMD>(data);
+}
+
+//Payload bits not covered by a signal are kept
+static inline void LEAF_Encode_50B(const leaf_50b_t * msg, uint8_t * data){
+  SIG_Set<LEAF_50B_CANMASK>(data, msg->CANMASK);
+  SIG_Set<LEAF_50B_WAKEUP_SLEEP_CMD>(data, msg->WAKEUP_SLEEP_CMD);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// 0x50C VCM_50C, 6 bytes from VCM: VCM
+//——————————————————————————————————————————————————————————————————————————————
+#define LEAF_50C_ID    0x50C
+#define LEAF_50C_DLC   6
+
+typedef sig_def<25,  2> LEAF_50C_PRUN;
+typedef sig_def<39,  8> LEAF_50C_ALU_Q_LBC;
+typedef sig_def<47,  8> LEAF_50C_CRC8;
+
+typedef struct {
+  uint8_t  PRUN;
+  uint8_t  ALU_Q_LBC;
+  uint8_t  CRC8;
+} leaf_50c_t;
+
+static inline void LEAF_Decode_50C(const uint8_t * data, leaf_50c_t * msg){
+  msg->PRUN = (uint8_t)SIG_Raw<LEAF_50C_PRUN>(data);
+  msg->ALU_Q_LBC = (uint8_t)SIG_Raw<LEAF_50C_ALU_Q_LBC>(data);
+  msg->CRC8 = (uint8_t)SIG_Raw<LEAF_50C_CRC8>(data);
+}
+
+//Payload bits not covered by a signal are kept
+static inline void LEAF_Encode_50C(const leaf_50c_t * msg, uint8_t * data){
+  SIG_Set<LEAF_50C_PRUN>(data, msg->PRUN);
+  SIG_Set<LEAF_50C_ALU_Q_LBC>(data, msg->ALU_Q_LBC);
+  SIG_Set<LEAF_50C_CRC8>(data, msg->CRC8);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// 0x55B LBC_55B, 8 bytes from LBC: LBC state of charge
+//——————————————————————————————————————————————————————————————————————————————
+#define LEAF_55B_ID    0x55B
+#define LEAF_55B_DLC   8
+
+typedef sig_def< 7, 10, SIG_MOTOROLA, SIG_UNSIGNED, 1, 10> LEAF_55B_LB_SOC; //0.1 %
+typedef sig_def<63,  8>                                    LEAF_55B_CRC8;
+
+typedef struct {
+  uint16_t LB_SOC;
+  uint8_t  CRC8;
+} leaf_55b_t;
+
+static inline void LEAF_Decode_55B(const uint8_t * data, leaf_55b_t * msg){
+  msg->LB_SOC = (uint16_t)SIG_Raw<LEAF_55B_LB_SOC>(data);
+  msg->CRC8 = (uint8_t)SIG_Raw<LEAF_55B_CRC8>(data);
+}
+
+//Payload bits not covered by a signal are kept
+static inline void LEAF_Encode_55B(const leaf_55b_t * msg, uint8_t * data){
+  SIG_Set<LEAF_55B_LB_SOC>(data, msg->LB_SOC);
+  SIG_Set<LEAF_55B_CRC8>(data, msg->CRC8);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// 0x5BC LBC_5BC, 8 bytes from LBC: LBC capacity
+//——————————————————————————————————————————————————————————————————————————————
+#define LEAF_5BC_ID    0x5BC
+#define LEAF_5BC_DLC   8
+
+typedef sig_def< 7, 10> LEAF_5BC_LB_CAPR;
+typedef sig_def<13, 10> LEAF_5BC_LB_FULLCAP;
+typedef sig_def<19,  4> LEAF_5BC_LB_CAPSEG;
+typedef sig_def<31,  8> LEAF_5BC_LB_AVET;
+typedef sig_def<39,  7> LEAF_5BC_LB_SOH;        //1 %
+typedef sig_def<32,  1> LEAF_5BC_LB_CAPSW;
+typedef sig_def<47,  3> LEAF_5BC_LB_RLIMIT;
+typedef sig_def<42,  1> LEAF_5BC_LB_CAPBALCOMP;
+typedef sig_def<41,  5> LEAF_5BC_LB_RCHGTCON;
+typedef sig_def<52, 13> LEAF_5BC_LB_RCHGTIM;
+
+typedef struct {
+  uint16_t LB_CAPR;
+  uint16_t LB_FULLCAP;
+  uint8_t  LB_CAPSEG;
+  uint8_t  LB_AVET;
+  uint8_t  LB_SOH;
+  uint8_t  LB_CAPSW;
+  uint8_t  LB_RLIMIT;
+  uint8_t  LB_CAPBALCOMP;
+  uint8_t  LB_RCHGTCON;
+  uint16_t LB_RCHGTIM;
+} leaf_5bc_t;
+
+static inline void LEAF_Decode_5BC(const uint8_t * data, leaf_5bc_t * msg){
+  msg->LB_CAPR = (uint16_t)SIG_Raw<LEAF_5BC_LB_CAPR>(data);
+  msg->LB_FULLCAP = (uint16_t)SIG_Raw<LEAF_5BC_LB_FULLCAP>(data);
+  msg->LB_CAPSEG = (uint8_t)SIG_Raw<LEAF_5BC_LB_CAPSEG>(data);
+  msg->LB_AVET = (uint8_t)SIG_Raw<LEAF_5BC_LB_AVET>(data);
+  msg->LB_SOH = (uint8_t)SIG_Raw<LEAF_5BC_LB_SOH>(data);
+  msg->LB_CAPSW = (uint8_t)SIG_Raw<LEAF_5BC_LB_CAPSW>(data);
+  msg->LB_RLIMIT = (uint8_t)SIG_Raw<LEAF_5BC_LB_RLIMIT>(data);
+  msg->LB_CAPBALCOMP = (uint8_t)SIG_Raw<LEAF_5BC_LB_CAPBALCOMP>(data);
+  msg->LB_RCHGTCON = (uint8_t)SIG_Raw<LEAF_5BC_LB_RCHGTCON>(data);
+  msg->LB_RCHGTIM = (uint16_t)SIG_Raw<LEAF_5BC_LB_RCHGTIM>(data);
+}
+
+//Payload bits not covered by a signal are kept
+static inline void LEAF_Encode_5BC(const leaf_5bc_t * msg, uint8_t * data){
+  SIG_Set<LEAF_5BC_LB_CAPR>(data, msg->LB_CAPR);
+  SIG_Set<LEAF_5BC_LB_FULLCAP>(data, msg->LB_FULLCAP);
+  SIG_Set<LEAF_5BC_LB_CAPSEG>(data, msg->LB_CAPSEG);
+  SIG_Set<LEAF_5BC_LB_AVET>(data, msg->LB_AVET);
+  SIG_Set<LEAF_5BC_LB_SOH>(data, msg->LB_SOH);
+  SIG_Set<LEAF_5BC_LB_CAPSW>(data, msg->LB_CAPSW);
+  SIG_Set<LEAF_5BC_LB_RLIMIT>(data, msg->LB_RLIMIT);
+  SIG_Set<LEAF_5BC_LB_CAPBALCOMP>(data, msg->LB_CAPBALCOMP);
+  SIG_Set<LEAF_5BC_LB_RCHGTCON>(data, msg->LB_RCHGTCON);
+  SIG_Set<LEAF_5BC_LB_RCHGTIM>(data, msg->LB_RCHGTIM);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// 0x5C0 LBC_5C0, 8 bytes from LBC: LBC history
+//——————————————————————————————————————————————————————————————————————————————
+#define LEAF_5C0_ID    0x5C0
+#define LEAF_5C0_DLC   8
+
+typedef sig_def< 7,  2> LEAF_5C0_LB_HIS_DATA_SW;
+typedef sig_def< 3,  4> LEAF_5C0_LB_HIS_HLVOL_TIMS;
+typedef sig_def<15,  7> LEAF_5C0_LB_HIS_TEMP_WUP;
+typedef sig_def<23,  7> LEAF_5C0_LB_HIS_TEMP;
+typedef sig_def<31,  8> LEAF_5C0_LB_HIS_INTG_CUR;
+typedef sig_def<39,  7> LEAF_5C0_LB_HIS_DEG_REGI;
+typedef sig_def<47,  6> LEAF_5C0_LB_HIS_CELL_VOL;
+typedef sig_def<63,  8> LEAF_5C0_LB_DTC;
+
+typedef struct {
+  uint8_t  LB_HIS_DATA_SW;
+  uint8_t  LB_HIS_HLVOL_TIMS;
+  uint8_t  LB_HIS_TEMP_WUP;
+  uint8_t  LB_HIS_TEMP;
+  uint8_t  LB_HIS_INTG_CUR;
+  uint8_t  LB_HIS_DEG_REGI;
+  uint8_t  LB_HIS_CELL_VOL;
+  uint8_t  LB_DTC;
+} leaf_5c0_t;
+
+static inline void LEAF_Decode_5C0(const uint8_t * data, leaf_5c0_t * msg){
+  msg->LB_HIS_DATA_SW = (uint8_t)SIG_Raw<LEAF_5C0_LB_HIS_DATA_SW>(data);
+  msg->LB_HIS_HLVOL_TIMS = (uint8_t)SIG_Raw<LEAF_5C0_LB_HIS_HLVOL_TIMS>(data);
+  msg->LB_HIS_TEMP_WUP = (uint8_t)SIG_Raw<LEAF_5C0_LB_HIS_TEMP_WUP>(data);
+  msg->LB_HIS_TEMP = (uint8_t)SIG_Raw<LEAF_5C0_LB_HIS_TEMP>(data);
+  msg->LB_HIS_INTG_CUR = (uint8_t)SIG_Raw<LEAF_5C0_LB_HIS_INTG_CUR>(data);
+  msg->LB_HIS_DEG_REGI = (uint8_t)SIG_Raw<LEAF_5C0_LB_HIS_DEG_REGI>(data);
+  msg->LB_HIS_CELL_VOL = (uint8_t)SIG_Raw<LEAF_5C0_LB_HIS_CELL_VOL>(data);
+  msg->LB_DTC = (uint8_t)SIG_Raw<LEAF_5C0_LB_DTC>(data);
+}
+
+//Payload bits not covered by a signal are kept
+static inline void LEAF_Encode_5C0(const leaf_5c0_t * msg, uint8_t * data){
+  SIG_Set<LEAF_5C0_LB_HIS_DATA_SW>(data, msg->LB_HIS_DATA_SW);
+  SIG_Set<LEAF_5C0_LB_HIS_HLVOL_TIMS>(data, msg->LB_HIS_HLVOL_TIMS);
+  SIG_Set<LEAF_5C0_LB_HIS_TEMP_WUP>(data, msg->LB_HIS_TEMP_WUP);
+  SIG_Set<LEAF_5C0_LB_HIS_TEMP>(data, msg->LB_HIS_TEMP);
+  SIG_Set<LEAF_5C0_LB_HIS_INTG_CUR>(data, msg->LB_HIS_INTG_CUR);
+  SIG_Set<LEAF_5C0_LB_HIS_DEG_REGI>(data, msg->LB_HIS_DEG_REGI);
+  SIG_Set<LEAF_5C0_LB_HIS_CELL_VOL>(data, msg->LB_HIS_CELL_VOL);
+  SIG_Set<LEAF_5C0_LB_DTC>(data, msg->LB_DTC);
+}
+
+#endif //LEAF_SIGNALS_H
@@ -0,0 +1,104 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Live bridge configuration, double-buffered snapshot read lock-free by the CAN path
+// 10.16.2026: Replaces the Vehicle_Selection/Inverter_Upgrade_110Kw_160Kw/... globals that the web
+//             task wrote one by one while the bridge task read them on every frame
+// 10.17.2026: LCFG_Request queues a config still in its grace period, the housekeeping task publishes it
+//——————————————————————————————————————————————————————————————————————————————
+
+#include "live_config.h"
+
+static portMUX_TYPE lcfg_mux = portMUX_INITIALIZER_UNLOCKED;   //writers and LCFG_Snapshot()
+
+//Buffer 0 holds the factory selections (all 0, as CFG_Defaults) until PREF_Init publishes
+static live_config_t lcfg_buffer[2];
+
+std::atomic<const live_config_t *> lcfg_active(&lcfg_buffer[0]);
+
+static std::atomic<uint32_t> lcfg_published(0U);    //swaps, written by the writers
+static std::atomic<uint32_t> lcfg_seen(0U);         //swaps the bridge task has passed a boundary after
+
+static live_config_t lcfg_pending;                  //requested during a grace period, under lcfg_mux
+static bool          lcfg_has_pending = false;
+
+//——————————————————————————————————————————————————————————————————————————————
+// Reader
+//——————————————————————————————————————————————————————————————————————————————
+void LCFG_Quiescent(void){
+  lcfg_seen.store(lcfg_published.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Writers
+//——————————————————————————————————————————————————————————————————————————————
+void LCFG_Init(const live_config_t * cfg){
+  portENTER_CRITICAL(&lcfg_mux);
+  lcfg_buffer[0] = *cfg;
+  lcfg_buffer[0].generation = 0;
+  lcfg_active.store(&lcfg_buffer[0], std::memory_order_release);
+  lcfg_published.store(0U, std::memory_order_relaxed);
+  lcfg_seen.store(0U, std::memory_order_release);
+  lcfg_has_pending = false;
+  portEXIT_CRITICAL(&lcfg_mux);
+}
+
+//Under lcfg_mux: the swap, when the inactive buffer is free
+static bool lcfg_swap(const live_config_t * cfg){
+  const live_config_t * active;
+  live_config_t * next;
+  uint32_t published = lcfg_published.load(std::memory_order_relaxed);
+
+  //The inactive buffer is free once the bridge task passed a boundary after the last swap
+  if(lcfg_seen.load(std::memory_order_acquire) != published){
+    return false;
+  }
+  active = lcfg_active.load(std::memory_order_relaxed);
+  next = (active == &lcfg_buffer[0]) ? &lcfg_buffer[1] : &lcfg_buffer[0];
+  *next = *cfg;
+  next->generation = (uint16_t)(active->generation + 1U);
+  lcfg_active.store(next, std::memory_order_release);
+  lcfg_published.store(published + 1U, std::memory_order_release);
+  return true;
+}
+
+bool LCFG_Publish(const live_config_t * cfg){
+  bool done;
+
+  portENTER_CRITICAL(&lcfg_mux);
+  done = lcfg_swap(cfg);
+  if(done){
+    lcfg_has_pending = false;   //older than this one
+  }
+  portEXIT_CRITICAL(&lcfg_mux);
+  return done;
+}
+
+bool LCFG_Request(const live_config_t * cfg){
+  bool done;
+
+  portENTER_CRITICAL(&lcfg_mux);
+  done = lcfg_swap(cfg);
+  lcfg_has_pending = !done;
+  if(!done){
+    lcfg_pending = *cfg;
+  }
+  portEXIT_CRITICAL(&lcfg_mux);
+  return done;
+}
+
+bool LCFG_PublishPending(void){
+  bool done = false;
+
+  portENTER_CRITICAL(&lcfg_mux);
+  if(lcfg_has_pending && lcfg_swap(&lcfg_pending)){
+    lcfg_has_pending = false;
+    done = true;
+  }
+  portEXIT_CRITICAL(&lcfg_mux);
+  return done;
+}
+
+void LCFG_Snapshot(live_config_t * cfg){
+  portENTER_CRITICAL(&lcfg_mux);
+  *cfg = lcfg_has_pending ? lcfg_pending : *lcfg_active.load(std::memory_order_acquire);
+  portEXIT_CRITICAL(&lcfg_mux);
+}
@@ -0,0 +1,67 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Live bridge configuration, double-buffered snapshot read lock-free by the CAN path
+// 10.16.2026: Replaces the Vehicle_Selection/Inverter_Upgrade_110Kw_160Kw/... globals that the web
+//             task wrote one by one while the bridge task read them on every frame
+// 10.17.2026: LCFG_Request queues a config still in its grace period, the housekeeping task publishes it
+//——————————————————————————————————————————————————————————————————————————————
+// The OTA selections of config.h live in one live_config_t. The bridge task loads the active
+// snapshot pointer once per frame (LCFG_Get) and takes every decision of that frame from it: no
+// lock, no copy, and a settings change never shows up half applied.
+//
+// Writers (web task, websocket, boot) build a complete new config and LCFG_Publish() it: it is
+// copied into the buffer the bridge does not use and made active with one pointer store, so it
+// applies from the next frame on. The retired buffer may still be read by the frame in progress.
+// The bridge task marks each pass boundary with LCFG_Quiescent(); the retired buffer is only
+// rewritten once a boundary was passed after the swap (quiescent state RCU, grace period = one
+// bridge pass, at most T_POLLING). A publish before that returns false, the writer retries.
+// Writers that must not wait (AsyncTCP handlers) use LCFG_Request(): published at once when the
+// grace period is over, otherwise kept as the pending config (a newer request replaces it) that the
+// housekeeping task publishes with LCFG_PublishPending() after the next bridge pass.
+//
+// Other readers (housekeeping, web pages) take a copy with LCFG_Snapshot(), which excludes the
+// writers with a short critical section; the bridge task never takes it. The copy is the pending
+// config when there is one, so a change built on it keeps the changes requested before.
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef LIVE_CONFIG_H
+#define LIVE_CONFIG_H
+
+#include <Arduino.h>
+#include <atomic>
+
+typedef struct {
+  uint8_t  vehicle;           //Vehicle_Selection_xxx
+  uint8_t  inverter;          //Inverter_Upgrade_xxx
+  uint8_t  battery;           //Battery_Selection_xxx
+  uint8_t  battery_saver;     //BatterySaver_xxx
+  uint8_t  glide;             //Glide_In_Drive_xxx
+  uint8_t  current_control;   //CurrentControl_xxx
+  uint16_t generation;        //publishes since boot, wraps
+} live_config_t;
+
+extern std::atomic<const live_config_t *> lcfg_active;
+
+//Bridge task: the snapshot for this frame, one load (also the web task: it is the only publisher)
+static inline const live_config_t * LCFG_Get(void){
+  return lcfg_active.load(std::memory_order_acquire);
+}
+
+//Bridge task, between passes: no snapshot of an earlier pass is held any more
+void LCFG_Quiescent(void);
+
+//Boot (or a host program) while no bridge task runs: config active at once, no grace period
+void LCFG_Init(const live_config_t * cfg);
+
+//Web task: false while the previous publish is still in its grace period (nothing changed, retry)
+bool LCFG_Publish(const live_config_t * cfg);
+
+//Web task, never waits: true when active at once, false when queued for LCFG_PublishPending()
+bool LCFG_Request(const live_config_t * cfg);
+
+//Housekeeping task, every pass: publish the queued config once the grace period is over, true when done
+bool LCFG_PublishPending(void);
+
+//Any task but the bridge: consistent copy of the pending config, else of the active one
+void LCFG_Snapshot(live_config_t * cfg);
+
+#endif //LIVE_CONFIG_H
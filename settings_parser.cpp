@@ -0,0 +1,155 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Settings parser for /settings and the websocket "set" command, no heap use
+// 10.16.2026: Replaces the String based parser of WebRequestProcessing() (fields at fixed positions)
+//——————————————————————————————————————————————————————————————————————————————
+
+#include "settings_parser.h"
+
+#define SETP_MAX_VALUES   6
+
+typedef struct {
+  const char * name;
+  uint8_t      count;
+  const char * values[SETP_MAX_VALUES];   //index = config.h code
+} setp_key_t;
+
+static const setp_key_t setp_keys[SETP_KEY_COUNT] = {
+  { "Vehicle",        5, { "LEAF", "ENV200", "ZE0", "AZE0", "ZE1" } },
+  { "Inverter",       3, { "110", "160", "0" } },
+  { "Battery",        5, { "24", "30", "40", "62", "-1" } },
+  { "BatterySaver",   4, { "50", "60", "80", "0" } },
+  { "Glide",          2, { "1", "0" } },
+  { "Capacity",       2, { "1", "0" } },
+  { "CurrentControl", 6, { "1", "2", "3", "4", "6", "-1" } },
+};
+
+static_assert(SETP_KEY_COUNT <= 8, "setp_result_t.present is a byte");
+
+//——————————————————————————————————————————————————————————————————————————————
+// Tokenizer
+//——————————————————————————————————————————————————————————————————————————————
+static bool setp_token_char(char ch){
+  return isalnum((unsigned char)ch) || (ch == '-') || (ch == '_') || (ch == '.') || (ch == '+');
+}
+
+//Blanks and quotes around tokens
+static bool setp_blank(char ch){
+  return (ch == ' ') || (ch == '\t') || (ch == '\r') || (ch == '\n') || (ch == '"') || (ch == '\'');
+}
+
+//Between pairs: blanks, pair separators and the braces of a JSON object
+static bool setp_separator(char ch){
+  return setp_blank(ch) || (ch == ',') || (ch == ';') || (ch == '&') || (ch == '{') || (ch == '}');
+}
+
+static size_t setp_token(const char * text, size_t len, size_t pos){
+  while((pos < len) && setp_token_char(text[pos])){
+    pos++;
+  }
+  return pos;
+}
+
+static bool setp_equal(const char * token, size_t len, const char * name){
+  return (0 == strncmp(token, name, len)) && ('\0' == name[len]);
+}
+
+static void setp_error(setp_result_t * result, const char * what, const char * token, size_t len){
+  if(0U == result->errors){
+    snprintf(result->error, sizeof(result->error), "%s '%.*s'", what, (int)((len > 24U) ? 24U : len), token);
+  }
+  if(result->errors < 0xFFU){
+    result->errors++;
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Parse / format
+//——————————————————————————————————————————————————————————————————————————————
+bool SETP_Parse(const char * text, size_t len, setp_result_t * result){
+  size_t pos = 0;
+  size_t key;
+  size_t key_end;
+  size_t value;
+  size_t value_end;
+  uint8_t k;
+  uint8_t v;
+
+  memset(result, 0, sizeof(*result));
+
+  for(;;){
+    while((pos < len) && setp_separator(text[pos])){
+      pos++;
+    }
+    if(pos >= len){
+      break;
+    }
+    key = pos;
+    key_end = setp_token(text, len, pos);
+    if(key_end == key){
+      setp_error(result, "unexpected", &text[pos], 1);
+      break;
+    }
+    pos = key_end;
+    while((pos < len) && setp_blank(text[pos])){
+      pos++;
+    }
+    if((pos >= len) || ((text[pos] != ':') && (text[pos] != '='))){
+      setp_error(result, "no value for", &text[key], key_end - key);
+      break;
+    }
+    pos++;
+    while((pos < len) && setp_blank(text[pos])){
+      pos++;
+    }
+    value = pos;
+    value_end = setp_token(text, len, pos);
+    pos = value_end;
+
+    for(k = 0; (k < SETP_KEY_COUNT) && !setp_equal(&text[key], key_end - key, setp_keys[k].name); k++){
+    }
+    if(k >= SETP_KEY_COUNT){
+      setp_error(result, "unknown key", &text[key], key_end - key);
+      continue;
+    }
+    for(v = 0; (v < setp_keys[k].count) && !setp_equal(&text[value], value_end - value, setp_keys[k].values[v]); v++){
+    }
+    if(v >= setp_keys[k].count){
+      setp_error(result, "invalid value for", &text[key], key_end - key);
+      continue;
+    }
+    result->value[k] = v;
+    result->present |= (uint8_t)(1U << k);
+  }
+
+  return (0U == result->errors);
+}
+
+size_t SETP_Format(const setp_result_t * settings, char * buf, size_t len){
+  size_t pos = 0;
+  uint8_t k;
+  int n;
+
+  if(0U == len){
+    return 0;
+  }
+  buf[0] = '\0';
+  for(k = 0; (k < SETP_KEY_COUNT) && (pos < len); k++){
+    const char * value = SETP_ValueName(k, settings->value[k]);
+    if((0U == (settings->present & (1U << k))) || (NULL == value)){
+      continue;
+    }
+    n = snprintf(buf + pos, len - pos, "%s%s=%s", (pos == 0U) ? "" : ";", setp_keys[k].name, value);
+    if(n > 0){
+      pos += (size_t)n;
+    }
+  }
+  return (pos < len) ? pos : (len - 1U);
+}
+
+const char * SETP_KeyName(uint8_t key){
+  return (key < SETP_KEY_COUNT) ? setp_keys[key].name : "";
+}
+
+const char * SETP_ValueName(uint8_t key, uint8_t value){
+  return ((key < SETP_KEY_COUNT) && (value < setp_keys[key].count)) ? setp_keys[key].values[value] : NULL;
+}
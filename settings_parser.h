@@ -0,0 +1,54 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Settings parser for /settings and the websocket "set" command, no heap use
+// 10.16.2026: Replaces the String based parser of WebRequestProcessing() (fields at fixed positions)
+//——————————————————————————————————————————————————————————————————————————————
+// Accepted forms, one or more key/value pairs in any order:
+//   {"Vehicle": "LEAF", "Inverter": "110", ...}     JSON object as posted by index.html
+//   Vehicle=LEAF;Inverter=110                        websocket "set", query strings ('&' also separates)
+// Keys and values are matched in place in the caller's buffer (no NUL needed, nothing copied).
+// A key or value is a run of letters, digits, '-', '_', '.' and '+'; quotes are optional.
+// Values are the radio button values of index.html; their index in setp_keys is the code of
+// config.h (Vehicle_Selection_xxx, Inverter_Upgrade_xxx, ...).
+//
+// Unknown keys and invalid values are counted and the first one is described in result->error;
+// the remaining pairs are still parsed, so a page with an extra field keeps working. A syntax
+// error (key without ':' or '=') ends the parse.
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef SETTINGS_PARSER_H
+#define SETTINGS_PARSER_H
+
+#include <Arduino.h>
+
+#define SETP_ERROR_SIZE   48
+#define SETP_TEXT_SIZE    160   //SETP_Format() of every key
+
+enum {
+  SETP_VEHICLE = 0,     //Vehicle_Selection
+  SETP_INVERTER,        //Inverter_Upgrade_110Kw_160Kw
+  SETP_BATTERY,         //Battery_Selection
+  SETP_BATTERY_SAVER,   //Battery_Saver
+  SETP_GLIDE,           //Glide_In_Drive
+  SETP_CAPACITY,        //on the page, no setting behind it yet
+  SETP_CURRENT_CONTROL, //Current_Control
+  SETP_KEY_COUNT
+};
+
+typedef struct {
+  uint8_t present;                    //bit (1 << SETP_xxx) per key with a valid value
+  uint8_t value[SETP_KEY_COUNT];      //code per key, valid where present
+  uint8_t errors;                     //unknown keys, invalid values, syntax error
+  char    error[SETP_ERROR_SIZE];     //first error, "" if none
+} setp_result_t;
+
+//Parses len characters of text into result (cleared first), true without errors
+bool SETP_Parse(const char * text, size_t len, setp_result_t * result);
+
+//"Vehicle=LEAF;Inverter=110;..." of the keys present in settings, returns the length
+size_t SETP_Format(const setp_result_t * settings, char * buf, size_t len);
+
+const char * SETP_KeyName(uint8_t key);
+//Form value of a code, NULL when out of range
+const char * SETP_ValueName(uint8_t key, uint8_t value);
+
+#endif //SETTINGS_PARSER_H
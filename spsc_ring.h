@@ -0,0 +1,100 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Lock-free single-producer/single-consumer ring buffer
+// 10.16.2026: Replaces the flat tx buffers that clamped at the last slot and silently overwrote it
+// 10.16.2026: In-place producer access (back/publish)
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <Arduino.h>
+#include <atomic>
+
+//——————————————————————————————————————————————————————————————————————————————
+// Ring buffer with wrap-around and atomic head/tail.
+// Exactly one context may push (e.g. the CAN2 ISR or BridgeTask) and exactly one context may
+// pop (BridgeTask draining the channel, or the housekeeping task for the event log). head/tail are free running 32-bit counters, so the
+// number of stored items is always (head - tail) and no slot is wasted to tell full from empty.
+// N must be a power of two.
+//——————————————————————————————————————————————————————————————————————————————
+template <typename T, uint32_t N>
+struct spsc_ring {
+  static_assert((N >= 2U) && ((N & (N - 1U)) == 0U), "spsc_ring size must be a power of two");
+
+  T                     slot[N];
+  std::atomic<uint32_t> head;       // next slot to write, owned by the producer
+  std::atomic<uint32_t> tail;       // next slot to read, owned by the consumer
+
+  // Statistics, written by the producer only. Readers in other contexts get a consistent
+  // 32-bit value but not a consistent set.
+  volatile uint32_t     pushed;     // frames accepted
+  volatile uint32_t     dropped;    // frames refused because the ring was full
+  volatile uint32_t     high_water; // highest fill level seen
+
+  spsc_ring() : head(0U), tail(0U), pushed(0U), dropped(0U), high_water(0U) {}
+
+  static uint32_t capacity(void) { return N; }
+
+  uint32_t count(void) const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+  }
+
+  bool empty(void) const { return count() == 0U; }
+
+  // Producer side: copy item into the next free slot. Returns false (and counts a drop) when full.
+  bool push(const T &item) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t used = h - tail.load(std::memory_order_acquire);
+    if(used >= N) {
+      dropped = dropped + 1U;
+      return false;
+    }
+    slot[h & (N - 1U)] = item;
+    head.store(h + 1U, std::memory_order_release);
+
+    pushed = pushed + 1U;
+    if(used + 1U > high_water) {
+      high_water = used + 1U;
+    }
+    return true;
+  }
+
+  // Producer side, in place: next free slot or NULL (and a counted drop) when full.
+  // The item becomes visible to the consumer with publish().
+  T * back(void) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if((h - tail.load(std::memory_order_acquire)) >= N) {
+      dropped = dropped + 1U;
+      return NULL;
+    }
+    return &slot[h & (N - 1U)];
+  }
+
+  // Producer side: hand the slot returned by back() to the consumer.
+  void publish(void) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t used = h + 1U - tail.load(std::memory_order_acquire);
+    head.store(h + 1U, std::memory_order_release);
+
+    pushed = pushed + 1U;
+    if(used > high_water) {
+      high_water = used;
+    }
+  }
+
+  // Consumer side: oldest item or NULL when empty. The slot stays valid until pop().
+  T * front(void) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if(t == head.load(std::memory_order_acquire)) {
+      return NULL;
+    }
+    return &slot[t & (N - 1U)];
+  }
+
+  // Consumer side: release the slot returned by front().
+  void pop(void) {
+    tail.store(tail.load(std::memory_order_relaxed) + 1U, std::memory_order_release);
+  }
+};
+
+#endif //SPSC_RING_H
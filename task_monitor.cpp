@@ -0,0 +1,104 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Per-task CPU load and stack headroom accounting
+// 10.16.2026: Bridge task (core 1) and housekeeping task (core 0)
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include "task_monitor.h"
+
+//——————————————————————————————————————————————————————————————————————————————
+// Each task measures its own passes (TASKMON_PassBegin/End), so the busy counters have a
+// single writer and need no lock. TASKMON_Update() runs once per second from the housekeeping
+// task and turns the busy time into a load figure for the elapsed window.
+//——————————————————————————————————————————————————————————————————————————————
+typedef struct {
+  const char *      name;
+  TaskHandle_t      handle;
+  uint8_t           core;
+  uint8_t           priority;
+  volatile uint32_t busy_us;        //accumulated busy time, written by the task itself
+  volatile uint32_t runs;
+  volatile uint32_t max_pass_us;
+  uint32_t          last_busy_us;   //busy_us at the previous update
+  uint32_t          load_permille;
+} task_monitor_t;
+
+static task_monitor_t task_monitor[TASK_ID_COUNT];
+static uint32_t window_start_us = 0;
+
+//——————————————————————————————————————————————————————————————————————————————
+// Registration (setup, before the task starts)
+//——————————————————————————————————————————————————————————————————————————————
+void TASKMON_Register(uint8_t id, const char * name, TaskHandle_t handle, uint8_t core, uint8_t priority){
+  if(id < TASK_ID_COUNT){
+    task_monitor[id].name     = name;
+    task_monitor[id].handle   = handle;
+    task_monitor[id].core     = core;
+    task_monitor[id].priority = priority;
+  }
+  window_start_us = micros();
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Busy time accounting, called by the monitored task around each pass
+//——————————————————————————————————————————————————————————————————————————————
+uint32_t TASKMON_PassBegin(void){
+  return micros();
+}
+
+void TASKMON_PassEnd(uint8_t id, uint32_t start_us){
+  uint32_t pass_us = micros() - start_us;
+
+  if(id < TASK_ID_COUNT){
+    task_monitor[id].busy_us = task_monitor[id].busy_us + pass_us;
+    task_monitor[id].runs = task_monitor[id].runs + 1U;
+    if(pass_us > task_monitor[id].max_pass_us){
+      task_monitor[id].max_pass_us = pass_us;
+    }
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Load computation (housekeeping task, once per second)
+//——————————————————————————————————————————————————————————————————————————————
+void TASKMON_Update(void){
+  uint32_t now_us = micros();
+  uint32_t window_us = now_us - window_start_us;
+  uint8_t i;
+
+  if(window_us == 0U){
+    return;
+  }
+  for(i = 0; i < TASK_ID_COUNT; i++){
+    uint32_t busy = task_monitor[i].busy_us;
+    uint32_t delta = busy - task_monitor[i].last_busy_us;
+    task_monitor[i].last_busy_us = busy;
+    task_monitor[i].load_permille = (uint32_t)(((uint64_t)delta * 1000U) / window_us);
+  }
+  window_start_us = now_us;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Report
+//——————————————————————————————————————————————————————————————————————————————
+bool TASKMON_Get(uint8_t id, task_stats_t * stats){
+  if((id >= TASK_ID_COUNT) || (NULL == task_monitor[id].handle)){
+    return false;
+  }
+  stats->name          = task_monitor[id].name;
+  stats->core          = task_monitor[id].core;
+  stats->priority      = task_monitor[id].priority;
+  stats->runs          = task_monitor[id].runs;
+  stats->load_permille = task_monitor[id].load_permille;
+  stats->max_pass_us   = task_monitor[id].max_pass_us;
+  //On ESP32 the high water mark is reported in bytes
+  stats->stack_free    = uxTaskGetStackHighWaterMark(task_monitor[id].handle);
+  return true;
+}
+
+void TASKMON_Reset(void){
+  uint8_t i;
+  for(i = 0; i < TASK_ID_COUNT; i++){
+    task_monitor[i].max_pass_us = 0U;
+  }
+}
@@ -0,0 +1,32 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Per-task CPU load and stack headroom accounting
+// 10.16.2026: Bridge task (core 1) and housekeeping task (core 0)
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef TASK_MONITOR_H
+#define TASK_MONITOR_H
+
+#include <Arduino.h>
+
+#define TASK_ID_BRIDGE        (0U)
+#define TASK_ID_HOUSEKEEPING  (1U)
+#define TASK_ID_COUNT         (2U)
+
+typedef struct {
+  const char * name;
+  uint8_t  core;
+  uint8_t  priority;
+  uint32_t runs;           //passes since boot
+  uint32_t load_permille;  //busy time over the last TASKMON_Update() window, 0..1000
+  uint32_t max_pass_us;    //longest single pass since the last reset
+  uint32_t stack_free;     //lowest free stack seen by FreeRTOS, in bytes
+} task_stats_t;
+
+void TASKMON_Register(uint8_t id, const char * name, TaskHandle_t handle, uint8_t core, uint8_t priority);
+uint32_t TASKMON_PassBegin(void);
+void TASKMON_PassEnd(uint8_t id, uint32_t start_us);
+void TASKMON_Update(void);
+bool TASKMON_Get(uint8_t id, task_stats_t * stats);
+void TASKMON_Reset(void);
+
+#endif //TASK_MONITOR_H
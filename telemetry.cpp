@@ -0,0 +1,283 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Live vehicle telemetry streamed as binary websocket frames, per-client rate
+// 10.16.2026: Torque, shifter, SOC and charging state of the bridged traffic, queue depths and latency
+//——————————————————————————————————————————————————————————————————————————————
+
+#include "telemetry.h"
+#include "can_bridge_manager_common.h"
+#include "can_driver.h"
+#include "leaf_signals.h"
+#include <atomic>
+
+//Values as received, written by the bridge task only
+typedef struct {
+  int16_t  torque_demand;
+  int16_t  torque_response;
+  uint16_t soc;
+  uint16_t speed;
+  uint8_t  soc_display;
+  uint8_t  shift;
+  uint8_t  eco;
+  uint8_t  charge;
+  uint8_t  valid;
+} telem_values_t;
+
+typedef struct {
+  uint32_t id;
+  uint16_t period_ms;       //0: free slot
+  uint32_t last_ms;         //last send or skipped period
+  uint32_t last_updates;    //telem_seq / 2 at the last send
+  uint32_t sample;
+  uint16_t skipped;
+} telem_client_t;
+
+static telem_values_t telem_values;
+static std::atomic<uint32_t> telem_seq(0U);   //odd while the bridge task writes telem_values
+
+static portMUX_TYPE telem_mux = portMUX_INITIALIZER_UNLOCKED;    //telem_clients
+static telem_client_t telem_clients[TELEM_MAX_CLIENTS];
+
+//——————————————————————————————————————————————————————————————————————————————
+// Bridge task
+//——————————————————————————————————————————————————————————————————————————————
+static inline void telem_begin(uint32_t * seq){
+  *seq = telem_seq.load(std::memory_order_relaxed);
+  telem_seq.store(*seq + 1U, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+static inline void telem_end(uint32_t seq, uint8_t valid){
+  telem_values.valid |= valid;
+  telem_seq.store(seq + 2U, std::memory_order_release);
+}
+
+void TELEM_Frame(const can_frame_t &frame){
+  uint32_t seq;
+
+  switch(frame.can_id){
+    case 0x1D4:
+      telem_begin(&seq);
+      telem_values.torque_demand = (int16_t)SIG_Get<LEAF_1D4_TORQUE>(frame.data);
+      telem_end(seq, TELEM_VALID_TORQUE_DEMAND);
+      break;
+    case 0x1DA:
+      telem_begin(&seq);
+      telem_values.torque_response = (int16_t)SIG_Get<LEAF_1DA_TORQUE>(frame.data);
+      telem_end(seq, TELEM_VALID_TORQUE_RESPONSE);
+      break;
+    case 0x11A:
+      telem_begin(&seq);
+      telem_values.shift = (uint8_t)SIG_Raw<LEAF_11A_SHIFTER>(frame.data);
+      telem_values.eco = (uint8_t)SIG_Raw<LEAF_11A_ECO>(frame.data);
+      telem_end(seq, TELEM_VALID_SHIFT);
+      break;
+    case 0x55B:
+      telem_begin(&seq);
+      telem_values.soc = (uint16_t)SIG_Raw<LEAF_55B_LB_SOC>(frame.data);
+      telem_end(seq, TELEM_VALID_SOC);
+      break;
+    case 0x1DB:
+      telem_begin(&seq);
+      telem_values.soc_display = (uint8_t)SIG_Raw<LEAF_1DB_SOC>(frame.data);
+      telem_end(seq, TELEM_VALID_SOC_DISPLAY);
+      break;
+    case 0x1F2:
+      telem_begin(&seq);
+      telem_values.charge = (uint8_t)SIG_Raw<LEAF_1F2_CHG_STA_RQ>(frame.data);
+      telem_end(seq, TELEM_VALID_CHARGE);
+      break;
+    case 0x284:
+      telem_begin(&seq);
+      telem_values.speed = (uint16_t)((SIG_Raw<LEAF_284_SPEED>(frame.data) * 16U) / LEAF_284_SPEED::scale_den);
+      telem_end(seq, TELEM_VALID_SPEED);
+      break;
+    default:
+      break;
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Readers
+//——————————————————————————————————————————————————————————————————————————————
+//Consistent copy of the values; returns the number of updates since boot
+static uint32_t telem_read(telem_values_t * values){
+  uint32_t before;
+  uint32_t after;
+
+  do {
+    before = telem_seq.load(std::memory_order_acquire);
+    memcpy(values, &telem_values, sizeof(*values));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    after = telem_seq.load(std::memory_order_relaxed);
+  } while((before != after) || (0U != (before & 1U)));
+
+  return before / 2U;
+}
+
+//Common part of the frame, the per-client fields are filled in by TELEM_Poll()
+static void telem_build(telem_frame_t * frame, uint32_t now_ms){
+  telem_values_t values;
+  tx_buffer_stats_t tx;
+  can2_rx_stats_t rx;
+  const latency_hist_t * hist;
+  uint8_t can_bus;
+
+  telem_read(&values);
+  memset(frame, 0, sizeof(*frame));
+  frame->magic[0]        = TELEM_MAGIC0;
+  frame->magic[1]        = TELEM_MAGIC1;
+  frame->version         = TELEM_VERSION;
+  frame->valid           = values.valid;
+  frame->now_ms          = now_ms;
+  frame->torque_demand   = values.torque_demand;
+  frame->torque_response = values.torque_response;
+  frame->soc             = values.soc;
+  frame->speed           = values.speed;
+  frame->soc_display     = values.soc_display;
+  frame->shift           = values.shift;
+  frame->eco             = values.eco;
+  frame->charge          = values.charge;
+
+  for(can_bus = 0; can_bus < CAN_CHANNEL_COUNT; can_bus++){
+    if(buffer_get_stats(can_bus, &tx)){
+      frame->tx_queue[can_bus] = (uint16_t)((tx.count > 0xFFFFU) ? 0xFFFFU : tx.count);
+    }
+  }
+  CAN2_GetRxStats(&rx);
+  frame->rx_queue = (uint16_t)((rx.queue_count > 0xFFFFU) ? 0xFFFFU : rx.queue_count);
+
+  hist = buffer_get_class_latency_hist(CAN_ID_CLASS_TORQUE);
+  if(NULL != hist){
+    frame->latency_p50_us = HIST_Percentile(hist, 50);
+    frame->latency_p99_us = HIST_Percentile(hist, 99);
+    frame->latency_max_us = hist->max;
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Subscriptions
+//——————————————————————————————————————————————————————————————————————————————
+bool TELEM_Subscribe(uint32_t client_id, uint16_t rate_hz){
+  telem_client_t * slot = NULL;
+  uint8_t i;
+
+  if(0U == rate_hz){
+    TELEM_Unsubscribe(client_id);
+    return true;
+  }
+  if(rate_hz > TELEM_MAX_RATE_HZ){
+    return false;
+  }
+
+  portENTER_CRITICAL(&telem_mux);
+  for(i = 0; i < TELEM_MAX_CLIENTS; i++){
+    if((0U != telem_clients[i].period_ms) && (telem_clients[i].id == client_id)){
+      slot = &telem_clients[i];   //rate change, counters kept
+      break;
+    }
+    if((NULL == slot) && (0U == telem_clients[i].period_ms)){
+      slot = &telem_clients[i];
+    }
+  }
+  if(NULL != slot){
+    if((0U == slot->period_ms) || (slot->id != client_id)){
+      memset(slot, 0, sizeof(*slot));
+      slot->id = client_id;
+      slot->last_ms = millis() - 0x80000000UL;    //first frame on the next poll
+      slot->last_updates = telem_seq.load(std::memory_order_acquire) / 2U;
+    }
+    slot->period_ms = (uint16_t)(1000U / rate_hz);
+  }
+  portEXIT_CRITICAL(&telem_mux);
+
+  return (NULL != slot);
+}
+
+void TELEM_Unsubscribe(uint32_t client_id){
+  uint8_t i;
+
+  portENTER_CRITICAL(&telem_mux);
+  for(i = 0; i < TELEM_MAX_CLIENTS; i++){
+    if(telem_clients[i].id == client_id){
+      telem_clients[i].period_ms = 0;
+    }
+  }
+  portEXIT_CRITICAL(&telem_mux);
+}
+
+uint8_t TELEM_Clients(void){
+  uint8_t count = 0;
+  uint8_t i;
+
+  for(i = 0; i < TELEM_MAX_CLIENTS; i++){
+    if(0U != telem_clients[i].period_ms){
+      count++;
+    }
+  }
+  return count;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Housekeeping task
+//——————————————————————————————————————————————————————————————————————————————
+uint8_t TELEM_Poll(uint32_t now_ms, telem_send_t send){
+  telem_frame_t frame;
+  telem_client_t client;
+  telem_send_result_t result;
+  uint32_t updates;
+  bool built = false;
+  uint8_t sent = 0;
+  uint8_t i;
+
+  for(i = 0; i < TELEM_MAX_CLIENTS; i++){
+    portENTER_CRITICAL(&telem_mux);
+    client = telem_clients[i];
+    portEXIT_CRITICAL(&telem_mux);
+    if((0U == client.period_ms) || ((uint32_t)(now_ms - client.last_ms) < client.period_ms)){
+      continue;
+    }
+
+    //Values sampled once per poll, shared by the clients due now
+    if(!built){
+      telem_build(&frame, now_ms);
+      built = true;
+    }
+    updates = telem_seq.load(std::memory_order_acquire) / 2U;
+    frame.sample  = client.sample;
+    frame.merged  = (uint16_t)(((updates - client.last_updates) > 0xFFFFU) ? 0xFFFFU : (updates - client.last_updates));
+    frame.skipped = client.skipped;
+
+    //Not under telem_mux: the transport may take its own locks
+    result = send(client.id, (const uint8_t *)&frame, sizeof(frame));
+
+    portENTER_CRITICAL(&telem_mux);
+    if((telem_clients[i].id == client.id) && (0U != telem_clients[i].period_ms)){
+      if(TELEM_SENT == result){
+        telem_clients[i].sample++;
+        telem_clients[i].skipped = 0;
+        telem_clients[i].last_updates = updates;
+        sent++;
+      }
+      else if(TELEM_BUSY == result){
+        if(telem_clients[i].skipped < 0xFFFFU){
+          telem_clients[i].skipped++;   //values keep merging until the next period
+        }
+      }
+      else{
+        telem_clients[i].period_ms = 0;
+      }
+      telem_clients[i].last_ms = now_ms;
+    }
+    portEXIT_CRITICAL(&telem_mux);
+  }
+
+  return sent;
+}
+
+void TELEM_Reset(void){
+  portENTER_CRITICAL(&telem_mux);
+  memset(telem_clients, 0, sizeof(telem_clients));
+  portEXIT_CRITICAL(&telem_mux);
+  memset(&telem_values, 0, sizeof(telem_values));
+  telem_seq.store(0U, std::memory_order_release);
+}
@@ -0,0 +1,91 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Live vehicle telemetry streamed as binary websocket frames, per-client rate
+// 10.16.2026: Torque, shifter, SOC and charging state of the bridged traffic, queue depths and latency
+//——————————————————————————————————————————————————————————————————————————————
+// The bridge task only stores the decoded values of a few IDs (TELEM_Frame, before translation,
+// so torque and SOC are what the ECUs sent). It writes them under a sequence counter; a reader
+// copies the set and retries when the counter moved, so the bridge never waits. Every CAN update
+// overwrites the previous one: between two sends of a client the values are merged into the
+// latest state and telem_frame_t.merged tells how many updates that state stands for.
+//
+// The housekeeping task calls TELEM_Poll(): each subscribed client whose period elapsed gets one
+// telem_frame_t, serialized there. The send callback reports backpressure (websocket queue full):
+// the client then skips that period (telem_frame_t.skipped) and keeps merging, so a slow client
+// lowers its own rate and never holds up the bridge or the other clients.
+//
+// Websocket: "telemetry <hz>" subscribes the sending client (1..TELEM_MAX_RATE_HZ), "telemetry 0"
+// stops it. Frames are binary messages, little endian, see telem_frame_t.
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "canframe.h"
+#include "config.h"
+
+#define TELEM_MAX_CLIENTS     4
+#define TELEM_MAX_RATE_HZ     50
+
+#define TELEM_MAGIC0          'T'
+#define TELEM_MAGIC1          'M'
+#define TELEM_VERSION         1
+
+//telem_frame_t.valid: values received at least once since boot
+#define TELEM_VALID_TORQUE_DEMAND    (1U << 0)   //0x1D4
+#define TELEM_VALID_TORQUE_RESPONSE  (1U << 1)   //0x1DA
+#define TELEM_VALID_SHIFT            (1U << 2)   //0x11A
+#define TELEM_VALID_SOC              (1U << 3)   //0x55B
+#define TELEM_VALID_SOC_DISPLAY      (1U << 4)   //0x1DB
+#define TELEM_VALID_CHARGE           (1U << 5)   //0x1F2
+#define TELEM_VALID_SPEED            (1U << 6)   //0x284
+
+typedef struct __attribute__((packed)) {
+  uint8_t  magic[2];                      //"TM"
+  uint8_t  version;                       //TELEM_VERSION
+  uint8_t  valid;                         //TELEM_VALID_xxx
+  uint32_t now_ms;
+  uint32_t sample;                        //frames sent to this client
+  uint16_t merged;                        //CAN updates merged into this frame, saturated
+  uint16_t skipped;                       //periods skipped for backpressure before this frame
+  int16_t  torque_demand;                 //0x1D4 VCM demand, 0.25 Nm
+  int16_t  torque_response;               //0x1DA inverter response, 0.5 Nm
+  uint16_t soc;                           //0x55B LBC SOC, 0.1 %
+  uint16_t speed;                         //0x284, km/h * 16
+  uint8_t  soc_display;                   //0x1DB SOC, %
+  uint8_t  shift;                         //0x11A shifter code
+  uint8_t  eco;                           //0x11A eco switch
+  uint8_t  charge;                        //0x1F2 charge status request
+  uint16_t tx_queue[CAN_CHANNEL_COUNT];   //frames waiting per transmit buffer
+  uint16_t rx_queue;                      //CAN2 frames waiting for the bridge task
+  uint32_t latency_p50_us;                //RX->TX latency of the torque class (0x1D4/0x1DA)
+  uint32_t latency_p99_us;
+  uint32_t latency_max_us;
+} telem_frame_t;
+
+static_assert(sizeof(telem_frame_t) == (42 + (2 * CAN_CHANNEL_COUNT)), "telem_frame_t is sent as is");
+
+//TELEM_Poll() transport: send one frame to a client
+typedef enum {
+  TELEM_SENT = 0,
+  TELEM_BUSY,       //queue full, skip this period
+  TELEM_GONE,       //client closed, drop the subscription
+} telem_send_result_t;
+
+typedef telem_send_result_t (*telem_send_t)(uint32_t client_id, const uint8_t * data, size_t len);
+
+//Bridge task: decode the few telemetry IDs of a received frame, others return at once
+void TELEM_Frame(const can_frame_t &frame);
+
+//Any task: rate_hz 0 unsubscribes; false when rate_hz is too high or no slot is free
+bool TELEM_Subscribe(uint32_t client_id, uint16_t rate_hz);
+void TELEM_Unsubscribe(uint32_t client_id);
+uint8_t TELEM_Clients(void);
+
+//Housekeeping task: send to the clients that are due, returns the frames sent
+uint8_t TELEM_Poll(uint32_t now_ms, telem_send_t send);
+
+//Reset values and subscriptions (host programs)
+void TELEM_Reset(void);
+
+#endif //TELEMETRY_H
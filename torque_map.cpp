@@ -0,0 +1,330 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Runtime torque and regen maps (demand torque x vehicle speed), stored in NVS
+// 10.16.2026: Breakpoint maps compiled into uniform Q12 grids, bilinear lookup in constant time
+// 10.17.2026: tmap_def under tmap_mux, TMAP_GetDef runs on the housekeeping task while TMAP_Load runs on AsyncTCP
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include "torque_map.h"
+#include "torque_scale.h"
+
+#define TMAP_GRID_POINTS  (TMAP_GRID_CELLS + 1)
+#define TMAP_FRAC_MASK    ((1U << TMAP_TORQUE_SHIFT) - 1U)
+#define TMAP_SPEED_LIMIT  ((TMAP_GRID_CELLS << TMAP_SPEED_SHIFT) - 1U)   //km/h * 16
+
+#if ((TMAP_GRID_CELLS << TMAP_TORQUE_SHIFT) != (TMAP_X_MAX + 1))
+#error "The torque axis of the grid must cover the 12-bit magnitude"
+#endif
+
+//Compiled map: multiplier in Q12 at each grid point, [speed][torque]
+typedef struct {
+  uint16_t q12[TMAP_GRID_POINTS][TMAP_GRID_POINTS];
+} tmap_grid_t;
+
+static tmap_grid_t tmap_grid[TMAP_COUNT][2];
+static tmap_grid_t * volatile tmap_active[TMAP_COUNT];   //NULL: no map, fixed multipliers
+static tmap_def_t tmap_def[TMAP_COUNT];                  //as loaded, for TMAP_GetDef/TMAP_Format
+static portMUX_TYPE tmap_mux = portMUX_INITIALIZER_UNLOCKED;   //tmap_def with tmap_active, for other tasks than the bridge
+static bool tmap_swapped[TMAP_COUNT];
+static uint32_t tmap_swap_ms[TMAP_COUNT];
+
+static const char * const tmap_names[TMAP_COUNT] = {"power", "regen"};
+
+//——————————————————————————————————————————————————————————————————————————————
+// Validation
+//——————————————————————————————————————————————————————————————————————————————
+static bool tmap_axis_valid(const uint16_t * axis, uint8_t count, uint16_t limit){
+  uint8_t i;
+  for(i = 0; i < count; i++){
+    if((axis[i] > limit) || ((i > 0) && (axis[i] <= axis[i - 1]))){
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TMAP_Valid(const tmap_def_t * def){
+  uint8_t i;
+  uint8_t j;
+
+  if((TMAP_VERSION != def->version) || (def->nx < 2) || (def->nx > TMAP_MAX_POINTS) ||
+     (def->ny < 1) || (def->ny > TMAP_MAX_POINTS)){
+    return false;
+  }
+  if(!tmap_axis_valid(def->x, def->nx, TMAP_X_MAX) || !tmap_axis_valid(def->y, def->ny, TMAP_Y_MAX)){
+    return false;
+  }
+  for(j = 0; j < def->ny; j++){
+    for(i = 0; i < def->nx; i++){
+      if(def->v[j][i] > TMAP_V_MAX){
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Compilation (load time only, float math is fine here)
+//——————————————————————————————————————————————————————————————————————————————
+//Segment of value on a breakpoint axis and the position inside it (0..1), clamped at the ends
+static uint8_t tmap_locate(const uint16_t * axis, uint8_t count, float value, float * t){
+  uint8_t i;
+
+  if((count < 2) || (value <= axis[0])){
+    *t = 0.0f;
+    return 0;
+  }
+  for(i = 0; i < (count - 1); i++){
+    if(value < axis[i + 1]){
+      *t = (value - axis[i]) / (float)(axis[i + 1] - axis[i]);
+      return i;
+    }
+  }
+  *t = 1.0f;
+  return count - 2;
+}
+
+static float tmap_eval(const tmap_def_t * def, float x, float y){
+  float tx;
+  float ty;
+  uint8_t ix = tmap_locate(def->x, def->nx, x, &tx);
+  uint8_t iy = tmap_locate(def->y, def->ny, y, &ty);
+  uint8_t iy1 = (def->ny > 1) ? (iy + 1) : iy;
+  float bottom = def->v[iy][ix] + ((def->v[iy][ix + 1] - (float)def->v[iy][ix]) * tx);
+  float top = def->v[iy1][ix] + ((def->v[iy1][ix + 1] - (float)def->v[iy1][ix]) * tx);
+
+  return bottom + ((top - bottom) * ty);
+}
+
+static void tmap_compile(const tmap_def_t * def, tmap_grid_t * grid){
+  uint8_t i;
+  uint8_t j;
+  float permille;
+
+  for(j = 0; j < TMAP_GRID_POINTS; j++){
+    for(i = 0; i < TMAP_GRID_POINTS; i++){
+      permille = tmap_eval(def, (float)(i << TMAP_TORQUE_SHIFT), (float)(j * TMAP_SPEED_CELL_KMH));
+      grid->q12[j][i] = (uint16_t)((permille * 4096.0f / 1000.0f) + 0.5f);
+    }
+  }
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Load / unload (web or startup context)
+//——————————————————————————————————————————————————————————————————————————————
+bool TMAP_Load(uint8_t map, const tmap_def_t * def){
+  tmap_grid_t * grid;
+
+  if((map >= TMAP_COUNT) || !TMAP_Valid(def)){
+    return false;
+  }
+  //The buffer about to be rewritten may have been in use until the last swap
+  if(tmap_swapped[map] && ((millis() - tmap_swap_ms[map]) < TMAP_GRACE_MS)){
+    return false;
+  }
+  grid = (tmap_active[map] == &tmap_grid[map][0]) ? &tmap_grid[map][1] : &tmap_grid[map][0];
+  tmap_compile(def, grid);
+
+  portENTER_CRITICAL(&tmap_mux);
+  tmap_def[map] = *def;
+  __sync_synchronize();     //grid contents visible before the pointer
+  tmap_active[map] = grid;
+  tmap_swapped[map] = true;
+  tmap_swap_ms[map] = millis();
+  portEXIT_CRITICAL(&tmap_mux);
+  return true;
+}
+
+void TMAP_Unload(uint8_t map){
+  if(map >= TMAP_COUNT){
+    return;
+  }
+  portENTER_CRITICAL(&tmap_mux);
+  tmap_active[map] = NULL;
+  tmap_swapped[map] = true;
+  tmap_swap_ms[map] = millis();
+  portEXIT_CRITICAL(&tmap_mux);
+}
+
+bool TMAP_Active(uint8_t map){
+  return (map < TMAP_COUNT) && (NULL != tmap_active[map]);
+}
+
+//Any task: the definition and its active flag from the same load
+bool TMAP_GetDef(uint8_t map, tmap_def_t * def){
+  bool active;
+
+  if(map >= TMAP_COUNT){
+    return false;
+  }
+  portENTER_CRITICAL(&tmap_mux);
+  active = (NULL != tmap_active[map]);
+  if(active){
+    *def = tmap_def[map];
+  }
+  portEXIT_CRITICAL(&tmap_mux);
+  return active;
+}
+
+const char * TMAP_Name(uint8_t map){
+  return (map < TMAP_COUNT) ? tmap_names[map] : "";
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Text form
+//——————————————————————————————————————————————————————————————————————————————
+//Comma separated list up to ';' or the end, returns false on junk or too many values
+static bool tmap_parse_list(const char * p, uint16_t * out, uint8_t max, uint8_t * count){
+  char * end;
+  unsigned long value;
+
+  *count = 0;
+  while(('\0' != *p) && (';' != *p)){
+    value = strtoul(p, &end, 10);
+    if((end == p) || (value > 0xFFFFUL) || (*count >= max)){
+      return false;
+    }
+    out[(*count)++] = (uint16_t)value;
+    p = end;
+    if(',' == *p){
+      p++;
+    }else if(('\0' != *p) && (';' != *p)){
+      return false;
+    }
+  }
+  return true;
+}
+
+int8_t TMAP_Parse(const char * text, tmap_def_t * def){
+  uint16_t values[TMAP_MAX_POINTS * TMAP_MAX_POINTS];
+  uint8_t value_count = 0;
+  int8_t map = -1;
+  const char * p = text;
+  uint8_t i;
+  bool off = false;
+
+  memset(def, 0, sizeof(*def));
+  def->version = TMAP_VERSION;
+
+  while('\0' != *p){
+    if(0 == strncmp(p, "map=", 4)){
+      for(i = 0; i < TMAP_COUNT; i++){
+        size_t len = strlen(tmap_names[i]);
+        if((0 == strncmp(p + 4, tmap_names[i], len)) && ((';' == p[4 + len]) || ('\0' == p[4 + len]))){
+          map = (int8_t)i;
+        }
+      }
+    }else if(0 == strncmp(p, "off", 3)){
+      off = true;
+    }else if(0 == strncmp(p, "x=", 2)){
+      if(!tmap_parse_list(p + 2, def->x, TMAP_MAX_POINTS, &def->nx)){
+        return -1;
+      }
+    }else if(0 == strncmp(p, "y=", 2)){
+      if(!tmap_parse_list(p + 2, def->y, TMAP_MAX_POINTS, &def->ny)){
+        return -1;
+      }
+    }else if(0 == strncmp(p, "v=", 2)){
+      if(!tmap_parse_list(p + 2, values, TMAP_MAX_POINTS * TMAP_MAX_POINTS, &value_count)){
+        return -1;
+      }
+    }
+    p = strchr(p, ';');
+    if(NULL == p){
+      break;
+    }
+    p++;
+  }
+
+  if((map < 0) || off){
+    def->nx = 0;
+    def->ny = 0;
+    return map;
+  }
+  if((def->nx == 0) || (def->ny == 0) || (value_count != (def->nx * def->ny))){
+    return -1;
+  }
+  for(i = 0; i < value_count; i++){
+    def->v[i / def->nx][i % def->nx] = values[i];
+  }
+  return TMAP_Valid(def) ? map : -1;
+}
+
+static void tmap_append_list(char * buf, size_t len, size_t * pos, const char * key, const uint16_t * values, uint8_t count){
+  uint8_t i;
+  int n;
+
+  for(i = 0; (i < count) && (*pos < len); i++){
+    n = snprintf(buf + *pos, len - *pos, "%s%u", (i == 0) ? key : ",", values[i]);
+    if(n > 0){
+      *pos += (size_t)n;
+    }
+  }
+}
+
+size_t TMAP_Format(uint8_t map, char * buf, size_t len){
+  tmap_def_t def;
+  size_t pos;
+  uint8_t j;
+  int n;
+
+  if((map >= TMAP_COUNT) || (len == 0)){
+    return 0;
+  }
+  n = snprintf(buf, len, "map=%s", tmap_names[map]);
+  pos = (n > 0) ? (size_t)n : 0;
+  if(!TMAP_GetDef(map, &def)){
+    n = snprintf(buf + pos, (pos < len) ? (len - pos) : 0, ";off");
+    pos += (n > 0) ? (size_t)n : 0;
+    return (pos < len) ? pos : (len - 1);
+  }
+  tmap_append_list(buf, len, &pos, ";x=", def.x, def.nx);
+  tmap_append_list(buf, len, &pos, ";y=", def.y, def.ny);
+  for(j = 0; j < def.ny; j++){
+    tmap_append_list(buf, len, &pos, (j == 0) ? ";v=" : ",", def.v[j], def.nx);
+  }
+  return (pos < len) ? pos : (len - 1);
+}
+
+//——————————————————————————————————————————————————————————————————————————————
+// Lookup (bridge task)
+//——————————————————————————————————————————————————————————————————————————————
+bool TMAP_Apply(uint8_t map, int16_t torque, uint16_t speed_kmh16, int16_t * scaled){
+  const tmap_grid_t * grid;
+  uint32_t x;
+  uint32_t y;
+  uint32_t ix;
+  uint32_t iy;
+  uint32_t fx;
+  uint32_t fy;
+  uint32_t bottom;
+  uint32_t top;
+  uint32_t q12;
+
+  if(map >= TMAP_COUNT){
+    return false;
+  }
+  grid = tmap_active[map];    //one load: the whole lookup uses the same grid
+  if(NULL == grid){
+    return false;
+  }
+
+  x = (uint32_t)((torque < 0) ? -torque : torque);
+  if(x > TMAP_X_MAX){
+    x = TMAP_X_MAX;
+  }
+  y = (speed_kmh16 > TMAP_SPEED_LIMIT) ? TMAP_SPEED_LIMIT : speed_kmh16;
+  ix = x >> TMAP_TORQUE_SHIFT;
+  fx = x & TMAP_FRAC_MASK;
+  iy = y >> TMAP_SPEED_SHIFT;
+  fy = y & TMAP_FRAC_MASK;
+
+  //Q12 * 2^7 per axis, at most 2^28
+  bottom = ((uint32_t)grid->q12[iy][ix] * ((1U << TMAP_TORQUE_SHIFT) - fx)) + ((uint32_t)grid->q12[iy][ix + 1] * fx);
+  top    = ((uint32_t)grid->q12[iy + 1][ix] * ((1U << TMAP_TORQUE_SHIFT) - fx)) + ((uint32_t)grid->q12[iy + 1][ix + 1] * fx);
+  q12 = ((bottom * ((1U << TMAP_SPEED_SHIFT) - fy)) + (top * fy)) >> (TMAP_TORQUE_SHIFT + TMAP_SPEED_SHIFT);
+
+  *scaled = TSCALE_Torque12(torque, q12 << 4);
+  return true;
+}
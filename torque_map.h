@@ -0,0 +1,79 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Runtime torque and regen maps (demand torque x vehicle speed), stored in NVS
+// 10.16.2026: Breakpoint maps compiled into uniform Q12 grids, bilinear lookup in constant time
+//——————————————————————————————————————————————————————————————————————————————
+// A map as edited and stored (tmap_def_t) has up to TMAP_MAX_POINTS breakpoints per axis:
+//   x: demand torque magnitude, raw 12-bit units of the 0x1D4 field (0..2047)
+//   y: vehicle speed in km/h (0x284)
+//   v: torque multiplier in permille at each breakpoint (1000 = unchanged)
+// TMAP_Load() resamples it onto a fixed grid of (TMAP_GRID_CELLS + 1)^2 points, 128 raw torque
+// units by TMAP_SPEED_CELL_KMH km/h per cell. The 0x1D4 path then finds its cell with two
+// shifts (no breakpoint search) and interpolates the four corners in integer math.
+//
+// Each map has two grids: TMAP_Load() compiles into the one the bridge does not use and
+// publishes it with a single pointer store, so the bridge task sees either the old or the new
+// map, never a half-written one. The buffer that was just retired may still be read by a lookup
+// that started before the swap; it is only rewritten after TMAP_GRACE_MS (a lookup takes < 1 us).
+// The stored definition is copied in and out under a critical section, TMAP_GetDef() is safe from
+// the housekeeping task (PREF_Save) while the web handlers load a map.
+//
+// Text form (web UI and /torquemap), one map per request:
+//   map=power;x=0,512,1024,2047;y=0,30,60,120;v=<nx*ny permille values, row by row of y>
+//   map=regen;off   (removes the map, the fixed multipliers of torque_scale.h apply again)
+// The power map only applies with a 110 kW or 160 kW inverter upgrade selected, like the fixed
+// power multipliers; the regen map follows REGEN_TUNING_ENABLED.
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef TORQUE_MAP_H
+#define TORQUE_MAP_H
+
+#include <Arduino.h>
+
+#define TMAP_MAX_POINTS       8         //breakpoints per axis
+#define TMAP_GRID_CELLS       16        //cells per axis of the compiled grid
+#define TMAP_TORQUE_SHIFT     7         //128 raw torque units per cell (16 * 128 = 2048)
+#define TMAP_SPEED_SHIFT      7         //speed in km/h * 16, 128 units (8 km/h) per cell
+#define TMAP_SPEED_CELL_KMH   8         //grid covers 0..128 km/h, clamped above
+#define TMAP_X_MAX            2047
+#define TMAP_Y_MAX            (TMAP_GRID_CELLS * TMAP_SPEED_CELL_KMH)   //km/h, the last grid row
+#define TMAP_V_MAX            4000      //permille, TSCALE_Q16_MAX
+#define TMAP_GRACE_MS         10
+#define TMAP_TEXT_SIZE        512
+
+#define TMAP_VERSION          1
+
+enum {
+  TMAP_POWER = 0,       //positive torque demand
+  TMAP_REGEN,           //negative torque demand (magnitude)
+  TMAP_COUNT
+};
+
+//Stored form (NVS blob, little endian, naturally aligned: no padding)
+typedef struct {
+  uint8_t  version;                                   //TMAP_VERSION
+  uint8_t  nx;                                        //2..TMAP_MAX_POINTS
+  uint8_t  ny;                                        //1..TMAP_MAX_POINTS
+  uint8_t  reserved;
+  uint16_t x[TMAP_MAX_POINTS];                        //strictly increasing
+  uint16_t y[TMAP_MAX_POINTS];                        //strictly increasing
+  uint16_t v[TMAP_MAX_POINTS][TMAP_MAX_POINTS];       //[y][x], permille
+} tmap_def_t;
+
+static_assert(sizeof(tmap_def_t) == (4 + (4 * TMAP_MAX_POINTS) + (2 * TMAP_MAX_POINTS * TMAP_MAX_POINTS)), "tmap_def_t is stored as is");
+
+//Validation and resampling (any context, not the bridge task)
+bool TMAP_Valid(const tmap_def_t * def);
+bool TMAP_Load(uint8_t map, const tmap_def_t * def);   //false: invalid map, or a swap within TMAP_GRACE_MS
+void TMAP_Unload(uint8_t map);
+bool TMAP_Active(uint8_t map);
+bool TMAP_GetDef(uint8_t map, tmap_def_t * def);
+
+//Text form, see above. Parse returns the map index or -1; "off" leaves def->nx at 0.
+int8_t TMAP_Parse(const char * text, tmap_def_t * def);
+size_t TMAP_Format(uint8_t map, char * buf, size_t len);
+const char * TMAP_Name(uint8_t map);
+
+//Bridge task: scaled 12-bit torque, or the torque unchanged when no map is loaded (false)
+bool TMAP_Apply(uint8_t map, int16_t torque, uint16_t speed_kmh16, int16_t * scaled);
+
+#endif //TORQUE_MAP_H
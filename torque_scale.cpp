@@ -0,0 +1,24 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Fixed-point torque and regen scaling of the 0x1D4 demand and 0x1DA response
+// 10.16.2026: Runtime Q16 multipliers per profile
+//——————————————————————————————————————————————————————————————————————————————
+
+#include <Arduino.h>
+#include "torque_scale.h"
+
+static volatile uint32_t tscale_q16[TSCALE_PROFILE_COUNT] = { TSCALE_Q16_ONE, TSCALE_Q16_ONE, TSCALE_Q16_ONE };
+
+bool TSCALE_Set(uint8_t profile, uint32_t mul_q16){
+  if((profile >= TSCALE_PROFILE_COUNT) || (0U == mul_q16) || (mul_q16 > TSCALE_Q16_MAX)){
+    return false;
+  }
+  tscale_q16[profile] = mul_q16;
+  return true;
+}
+
+uint32_t TSCALE_Get(uint8_t profile){
+  if(profile >= TSCALE_PROFILE_COUNT){
+    return TSCALE_Q16_ONE;
+  }
+  return tscale_q16[profile];
+}
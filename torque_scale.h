@@ -0,0 +1,84 @@
+//——————————————————————————————————————————————————————————————————————————————
+// Description: Fixed-point torque and regen scaling of the 0x1D4 demand and 0x1DA response
+// 10.16.2026: Q16 multipliers with saturation to the 12-bit signed torque field, no double math
+// 10.16.2026: 0x1D4 torque field read through its signal descriptor (leaf_signals.h)
+//——————————————————————————————————————————————————————————————————————————————
+// 0x1D4 carries the torque demand as a 12-bit two's complement value in data[2] and the high
+// nibble of data[3]. The ESP32 has no double precision FPU, so the former "torque * 1.6"
+// ran through the software float library on every torque frame; here a multiplier k is the
+// integer round-up of k * 65536 and a scaled value is one 32-bit multiply and a shift.
+//
+// Rounding: the magnitude is truncated (toward zero), which is what the double to integer
+// conversion did, and the multiplier is rounded up so the profile multipliers (0.9, 1.6,
+// 1.1, 0.5) give bit-identical results on the positive torque range. Results beyond the
+// 12-bit field saturate at -2048 / 2047 instead of wrapping into the opposite sign.
+//
+// Multipliers known at build time go through the template versions (the multiply by a
+// constant is specialized by the compiler, 0.5 becomes a shift); the per-profile multipliers
+// of the 0x1D4 rewrite are runtime values (TSCALE_Set) preset from can_bridge_manager_leaf.cpp.
+//——————————————————————————————————————————————————————————————————————————————
+
+#ifndef TORQUE_SCALE_H
+#define TORQUE_SCALE_H
+
+#include <Arduino.h>
+#include "canframe.h"
+#include "leaf_signals.h"
+
+#define TSCALE_Q16_ONE        65536UL
+#define TSCALE_Q16_MAX        (4UL * TSCALE_Q16_ONE)   //multipliers up to 4.0 (2047 * 4.0 stays inside 32 bit)
+#define TSCALE_TORQUE_MIN     (-2048)
+#define TSCALE_TORQUE_MAX     2047
+
+//Runtime multipliers of the 0x1D4 rewrite
+enum {
+  TSCALE_POWER_110 = 0,     //positive torque, EM57 motor with 110kW inverter
+  TSCALE_POWER_160,         //positive torque, EM57 motor with 160kW inverter
+  TSCALE_REGEN,             //negative torque (regen), any profile
+  TSCALE_PROFILE_COUNT
+};
+
+//Multiplier k as Q16, rounded up (evaluated by the compiler for constant k)
+constexpr uint32_t TSCALE_Q16(double k){
+  return ((double)(uint32_t)(k * 65536.0) < (k * 65536.0)) ? ((uint32_t)(k * 65536.0) + 1U) : (uint32_t)(k * 65536.0);
+}
+
+//12-bit signed torque of a 0x1D4 frame (data[2], high nibble of data[3]), sign extended
+static inline int16_t TSCALE_Get1D4(const can_frame_t &frame){
+  return (int16_t)SIG_Get<LEAF_1D4_TORQUE>(frame.data);
+}
+
+//data[2]:data[3] of a 12-bit signed torque, low nibble of data[3] cleared
+static inline uint16_t TSCALE_Raw1D4(int16_t torque){
+  return (uint16_t)((uint16_t)torque << 4);
+}
+
+//Signed torque times a Q16 multiplier: magnitude truncated, result saturated to 12 bit
+static inline int16_t TSCALE_Torque12(int16_t torque, uint32_t mul_q16){
+  uint32_t magnitude = (uint32_t)((torque < 0) ? -torque : torque);
+  int32_t scaled = (int32_t)((magnitude * mul_q16) >> 16);
+
+  if(torque < 0){
+    return (int16_t)((scaled > -TSCALE_TORQUE_MIN) ? TSCALE_TORQUE_MIN : -scaled);
+  }
+  return (int16_t)((scaled > TSCALE_TORQUE_MAX) ? TSCALE_TORQUE_MAX : scaled);
+}
+
+template <uint32_t MUL_Q16>
+static inline int16_t TSCALE_Torque12(int16_t torque){
+  static_assert((MUL_Q16 > 0U) && (MUL_Q16 <= TSCALE_Q16_MAX), "torque multiplier out of range");
+  return TSCALE_Torque12(torque, MUL_Q16);
+}
+
+//Unsigned raw field times a Q16 multiplier, truncated, no saturation (caller masks the field)
+template <uint32_t MUL_Q16>
+static inline uint16_t TSCALE_Raw(uint16_t raw){
+  static_assert((MUL_Q16 > 0U) && (MUL_Q16 <= TSCALE_Q16_MAX), "multiplier out of range");
+  return (uint16_t)(((uint32_t)raw * MUL_Q16) >> 16);
+}
+
+//Runtime multipliers, a single 32-bit store each (safe to change while the bridge runs)
+bool TSCALE_Set(uint8_t profile, uint32_t mul_q16);
+uint32_t TSCALE_Get(uint8_t profile);
+
+#endif //TORQUE_SCALE_H